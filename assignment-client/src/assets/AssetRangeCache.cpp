@@ -0,0 +1,129 @@
+//
+//  AssetRangeCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetRangeCache.h"
+
+uint qHash(const AssetRangeCache::Key& key, uint seed) {
+    return qHash(key.hash, seed) ^ qHash(key.fromInclusive, seed) ^ qHash(key.toExclusive, seed + 1);
+}
+
+void AssetRangeCache::setByteBudget(qint64 byteBudget) {
+    std::lock_guard<std::mutex> lock { _mutex };
+    _byteBudget = byteBudget;
+    evictToBudget();
+}
+
+AssetRange AssetRangeCache::get(const QString& hash, const ByteRange& requestedRange, Loader loader) {
+    Key key { hash, requestedRange.fromInclusive, requestedRange.toExclusive };
+
+    std::unique_lock<std::mutex> lock { _mutex };
+
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        // move the entry to the front of the LRU list
+        _entries.splice(_entries.begin(), _entries, it.value());
+        ++_stats.hits;
+        _stats.bytesServed += it.value()->range.data.size();
+        return it.value()->range;
+    }
+
+    auto pending = _pendingLoads.find(key);
+    if (pending != _pendingLoads.end()) {
+        auto future = pending.value().future;
+        ++_stats.coalesced;
+        lock.unlock();
+
+        auto range = future.get();
+        if (range.isStreamed) {
+            // the file of a streamed range is read through by the request that opened it, so open our own
+            return loader();
+        }
+
+        lock.lock();
+        _stats.bytesServed += range.data.size();
+        return range;
+    }
+
+    ++_stats.misses;
+    std::promise<AssetRange> promise;
+    quint64 generation = _generation;
+    _pendingLoads.insert(key, { promise.get_future().share(), generation });
+    lock.unlock();
+
+    AssetRange range = loader();
+    promise.set_value(range);
+
+    lock.lock();
+    _stats.bytesServed += range.data.size();
+
+    // an invalidate of the asset drops our pending load, and a newer load of the same range may have taken its place
+    auto pending = _pendingLoads.find(key);
+    if (pending != _pendingLoads.end() && pending.value().generation == generation) {
+        _pendingLoads.erase(pending);
+    }
+
+    // only data we actually read is worth keeping, errors and streamed ranges are cheap to answer again,
+    // and what we read may be of a file removed by an invalidate while we were reading
+    if (generation == _generation && range.error == AssetServerError::NoError && !range.isStreamed
+        && range.data.size() > 0 && range.data.size() <= _byteBudget) {
+        insert(key, range);
+    }
+
+    return range;
+}
+
+void AssetRangeCache::invalidate(const QString& hash) {
+    std::lock_guard<std::mutex> lock { _mutex };
+
+    // loads in progress may have read the old file, later requests have to go to disk again
+    ++_generation;
+    for (auto it = _pendingLoads.begin(); it != _pendingLoads.end();) {
+        if (it.key().hash == hash) {
+            it = _pendingLoads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->key.hash == hash) {
+            _stats.bytesCached -= it->range.data.size();
+            _index.remove(it->key);
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+AssetRangeCache::Stats AssetRangeCache::getStats() const {
+    std::lock_guard<std::mutex> lock { _mutex };
+
+    Stats stats = _stats;
+    stats.numEntries = (int)_entries.size();
+    return stats;
+}
+
+void AssetRangeCache::insert(const Key& key, const AssetRange& range) {
+    _entries.push_front({ key, range });
+    _index.insert(key, _entries.begin());
+    _stats.bytesCached += range.data.size();
+
+    evictToBudget();
+}
+
+void AssetRangeCache::evictToBudget() {
+    while (_stats.bytesCached > _byteBudget && !_entries.empty()) {
+        auto& leastRecentlyUsed = _entries.back();
+        _stats.bytesCached -= leastRecentlyUsed.range.data.size();
+        _index.remove(leastRecentlyUsed.key);
+        _entries.pop_back();
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  AssetRangeCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetRangeCache_h
+#define hifi_AssetRangeCache_h
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "AssetUtils.h"
+#include "ByteRange.h"
+
+// What a SendAssetTask needs to answer an AssetGet for one range of one asset.
+struct AssetRange {
+    AssetServerError error { AssetServerError::NoError };
+    QByteArray data; // empty when the range is streamed from the file instead
+    bool isStreamed { false };
+    std::shared_ptr<QFile> file; // the open asset file a streamed range is read from, by one request only
+    DataOffset start { 0 };
+    DataOffset size { 0 };
+};
+
+// LRU cache of recently served asset ranges, shared by the SendAssetTasks.
+// Concurrent requests for the same range wait on the first one's read instead of going to disk themselves.
+class AssetRangeCache {
+public:
+    using Loader = std::function<AssetRange()>;
+
+    struct Stats {
+        quint64 hits { 0 };
+        quint64 misses { 0 };
+        quint64 coalesced { 0 };
+        quint64 bytesServed { 0 };
+        qint64 bytesCached { 0 };
+        int numEntries { 0 };
+    };
+
+    void setByteBudget(qint64 byteBudget);
+
+    // returns the cached range, or the result of loader - which is only run by one of any concurrent callers
+    AssetRange get(const QString& hash, const ByteRange& requestedRange, Loader loader);
+
+    // drops any cached ranges of an asset whose file was removed
+    void invalidate(const QString& hash);
+
+    Stats getStats() const;
+
+private:
+    struct Key {
+        QString hash;
+        int64_t fromInclusive;
+        int64_t toExclusive;
+
+        bool operator==(const Key& other) const {
+            return fromInclusive == other.fromInclusive && toExclusive == other.toExclusive && hash == other.hash;
+        }
+    };
+    friend uint qHash(const Key& key, uint seed);
+
+    struct Entry {
+        Key key;
+        AssetRange range;
+    };
+    using Entries = std::list<Entry>;
+
+    // a load only ends up in the cache if no asset was invalidated while it was reading
+    struct PendingLoad {
+        std::shared_future<AssetRange> future;
+        quint64 generation;
+    };
+
+    void insert(const Key& key, const AssetRange& range);
+    void evictToBudget();
+
+    mutable std::mutex _mutex;
+    qint64 _byteBudget { 0 };
+    Entries _entries; // most recently used first
+    QHash<Key, Entries::iterator> _index;
+    QHash<Key, PendingLoad> _pendingLoads;
+    quint64 _generation { 0 }; // bumped by every invalidate
+    Stats _stats;
+};
+
+#endif // hifi_AssetRangeCache_h
@@ -12,6 +12,7 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
@@ -145,6 +146,13 @@ void AssetServer::completeSetup() {
                     " (" << maxBandwidth << "bits/s)";
     }
 
+    static const QString CACHE_SIZE_OPTION = "cache_size";
+    static const int DEFAULT_CACHE_SIZE_MB = 256;
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto cacheSizeMB = assetServerObject[CACHE_SIZE_OPTION].toInt(DEFAULT_CACHE_SIZE_MB);
+    _rangeCache->setByteBudget(std::max(cacheSizeMB, 0) * BYTES_PER_MEGABYTE);
+    qInfo() << "Caching up to" << cacheSizeMB << "MB of recently requested asset data in memory.";
+
     // get the path to the asset folder from the domain server settings
     static const QString ASSETS_PATH_OPTION = "assets_path";
     auto assetsJSONValue = assetServerObject[ASSETS_PATH_OPTION];
@@ -194,6 +202,10 @@ void AssetServer::completeSetup() {
         }
 
         nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
+
+        // answering a get only hands it to the task pool, which is safe to do off of our thread now that
+        // the files directory is set, so gets no longer wait behind mapping operations and uploads
+        nodeList->getPacketReceiver().setWorkerQueueForTypes({ PacketType::AssetGet }, "AssetGet");
     } else {
         qCritical() << "Asset Server assignment will not continue because mapping file could not be loaded.";
         setFinished(true);
@@ -218,6 +230,7 @@ void AssetServer::cleanupUnmappedFiles() {
                 QFile removeableFile { fileInfo.absoluteFilePath() };
 
                 if (removeableFile.remove()) {
+                    _rangeCache->invalidate(fileInfo.fileName());
                     qDebug() << "\tDeleted" << fileInfo.fileName() << "from asset files directory since it is unmapped.";
                 } else {
                     qDebug() << "\tAttempt to delete unmapped file" << fileInfo.fileName() << "failed";
@@ -388,7 +401,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _rangeCache);
     _taskPool.start(task);
 }
 
@@ -484,6 +497,16 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
 
+    auto cacheStats = _rangeCache->getStats();
+    QJsonObject rangeCacheStats;
+    rangeCacheStats["1. Hits"] = (double)cacheStats.hits;
+    rangeCacheStats["2. Misses"] = (double)cacheStats.misses;
+    rangeCacheStats["3. Coalesced"] = (double)cacheStats.coalesced;
+    rangeCacheStats["4. Served (bytes)"] = (double)cacheStats.bytesServed;
+    rangeCacheStats["5. Cached (bytes)"] = (double)cacheStats.bytesCached;
+    rangeCacheStats["6. Entries"] = cacheStats.numEntries;
+    serverStats["Asset Cache"] = rangeCacheStats;
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -672,6 +695,7 @@ bool AssetServer::deleteMappings(AssetPathList& paths) {
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
 
             if (removeableFile.remove()) {
+                _rangeCache->invalidate(hash);
                 qDebug() << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
             } else {
                 qDebug() << "\tAttempt to delete unmapped file" << hash << "failed";
@@ -12,11 +12,14 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <memory>
+
 #include <QtCore/QDir>
 #include <QtCore/QThreadPool>
 
 #include <ThreadedAssignment.h>
 
+#include "AssetRangeCache.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -68,6 +71,9 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
     QThreadPool _taskPool;
+
+    // shared with the SendAssetTasks, which may outlive a request's handler
+    std::shared_ptr<AssetRangeCache> _rangeCache { std::make_shared<AssetRangeCache>() };
 };
 
 #endif
@@ -11,7 +11,9 @@
 
 #include "SendAssetTask.h"
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 
 #include <QFile>
 
@@ -26,15 +28,107 @@
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+namespace {
+    // larger ranges are streamed into the send queue as it drains, instead of being read into memory up front
+    const qint64 STREAMED_ASSET_THRESHOLD = 1024 * 1024;
+    const qint64 STREAMED_ASSET_CHUNK_SIZE = 64 * 1024;
+
+    struct AssetFileStream {
+        std::shared_ptr<QFile> file;
+        uchar* mappedData { nullptr };
+        qint64 position { 0 };
+        qint64 remaining { 0 };
+    };
+}
+
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             std::shared_ptr<AssetRangeCache> rangeCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _rangeCache(rangeCache)
 {
     
 }
 
+AssetRange SendAssetTask::readFileRange(const QString& filePath, const QString& hexHash, ByteRange byteRange) {
+    AssetRange range;
+
+    auto file = std::make_shared<QFile>(filePath);
+
+    if (file->open(QIODevice::ReadOnly)) {
+
+        // first fixup the range based on the now known file size
+        byteRange.fixupRange(file->size());
+
+        // check if we're being asked to read data that we just don't have
+        // because of the file size
+        if (file->size() < byteRange.fromInclusive || file->size() < byteRange.toExclusive) {
+            range.error = AssetServerError::InvalidByteRange;
+            qCDebug(networking) << "Bad byte range: " << hexHash << " "
+                << byteRange.fromInclusive << ":" << byteRange.toExclusive;
+        } else {
+            // we have a valid byte range, a negative one reads back from the end of the file
+            range.size = byteRange.size();
+            range.start = byteRange.fromInclusive >= 0 ? byteRange.fromInclusive : file->size() + byteRange.fromInclusive;
+
+            if (range.size > STREAMED_ASSET_THRESHOLD) {
+                // keep the file we just checked the range against open for the stream
+                range.isStreamed = true;
+                range.file = file;
+                return range;
+            }
+
+            file->seek(range.start);
+            range.data = file->read(range.size);
+        }
+        file->close();
+    } else {
+        qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
+        range.error = AssetServerError::AssetNotFound;
+    }
+
+    return range;
+}
+
+void SendAssetTask::streamFileRange(NLPacketList& packetList, std::shared_ptr<QFile> file, qint64 start, qint64 size) {
+    auto stream = std::make_shared<AssetFileStream>();
+    stream->file = file;
+    stream->remaining = size;
+
+    // map only the requested range, the pages are read in by the OS as the send queue gets to them
+    stream->mappedData = file->map(start, size);
+    if (!stream->mappedData && !file->seek(start)) {
+        // the first read fails and ends the reply
+        qCWarning(networking) << "Failed to seek streamed asset" << file->fileName() << "to" << start;
+    }
+
+    // called from the send queue whenever it needs more packets for this reply
+    packetList.setStreamSource([stream](udt::PacketList& packetList) {
+        qint64 chunkSize = std::min(stream->remaining, STREAMED_ASSET_CHUNK_SIZE);
+
+        if (stream->mappedData) {
+            packetList.write(reinterpret_cast<const char*>(stream->mappedData) + stream->position, chunkSize);
+        } else {
+            QByteArray chunk = stream->file->read(chunkSize);
+            if (chunk.size() < chunkSize) {
+                // end the reply here, the client fails a reply that is shorter than the size it was promised
+                qCWarning(networking) << "Failed to read streamed asset" << stream->file->fileName()
+                    << "at" << stream->position << "- ending the reply";
+                stream->remaining = 0;
+                return false;
+            }
+            packetList.write(chunk);
+        }
+
+        stream->position += chunkSize;
+        stream->remaining -= chunkSize;
+
+        return stream->remaining > 0;
+    });
+}
+
 void SendAssetTask::run() {
     MessageID messageID;
     ByteRange byteRange;
@@ -64,50 +158,24 @@ void SendAssetTask::run() {
         replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
-        
-        QFile file { filePath };
 
-        if (file.open(QIODevice::ReadOnly)) {
+        auto loadRange = [&] {
+            return readFileRange(filePath, hexHash, byteRange);
+        };
+        AssetRange range = _rangeCache ? _rangeCache->get(hexHash, byteRange, loadRange) : loadRange();
 
-            // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+        replyPacketList->writePrimitive(range.error);
 
-            // check if we're being asked to read data that we just don't have
-            // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
-                replyPacketList->writePrimitive(AssetServerError::InvalidByteRange);
-                qCDebug(networking) << "Bad byte range: " << hexHash << " "
-                    << byteRange.fromInclusive << ":" << byteRange.toExclusive;
-            } else {
-                // we have a valid byte range, handle it and send the asset
-                auto size = byteRange.size();
+        if (range.error == AssetServerError::NoError) {
+            replyPacketList->writePrimitive(range.size);
 
-                if (byteRange.fromInclusive >= 0) {
-
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
-                } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
-
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
-                    replyPacketList->writePrimitive(AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
-                }
-
-                qCDebug(networking) << "Sending asset: " << hexHash;
+            if (range.isStreamed) {
+                streamFileRange(*replyPacketList, range.file, range.start, range.size);
+            } else {
+                replyPacketList->write(range.data);
             }
-            file.close();
-        } else {
-            qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
-            replyPacketList->writePrimitive(AssetServerError::AssetNotFound);
+
+            qCDebug(networking) << "Sending asset: " << hexHash;
         }
     }
 
@@ -12,27 +12,36 @@
 #ifndef hifi_SendAssetTask_h
 #define hifi_SendAssetTask_h
 
+#include <memory>
+
 #include <QtCore/QByteArray>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include "AssetRangeCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
 
 class NLPacket;
+class NLPacketList;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  std::shared_ptr<AssetRangeCache> rangeCache = nullptr);
 
     void run() override;
 
 private:
+    static AssetRange readFileRange(const QString& filePath, const QString& hexHash, ByteRange byteRange);
+    static void streamFileRange(NLPacketList& packetList, std::shared_ptr<QFile> file, qint64 start, qint64 size);
+
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    std::shared_ptr<AssetRangeCache> _rangeCache;
 };
 
 #endif
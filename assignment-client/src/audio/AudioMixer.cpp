@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <cmath>
+#include <limits>
 #include <thread>
 
 #include <QtCore/QJsonArray>
@@ -241,6 +243,7 @@ void AudioMixer::sendStatsPacket() {
     statsObject["useDynamicJitterBuffers"] = _numStaticJitterFrames == DISABLE_STATIC_JITTER_FRAMES;
 
     statsObject["threads"] = _slavePool.numThreads();
+    statsObject["work_stealing"] = _slavePool.scheduler() == AudioMixerSlavePool::Scheduler::WorkStealing;
 
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
     statsObject["throttling_ratio"] = _throttlingRatio;
@@ -284,6 +287,14 @@ void AudioMixer::sendStatsPacket() {
     mixStats["%_hrtf_throttle_mixes"] = percentageForMixStats(_stats.hrtfThrottleRenders);
     mixStats["%_manual_stereo_mixes"] = percentageForMixStats(_stats.manualStereoMixes);
     mixStats["%_manual_echo_mixes"] = percentageForMixStats(_stats.manualEchoMixes);
+    mixStats["%_hrtf_cached_mixes"] = percentageForMixStats(_stats.hrtfCacheHits + _stats.hrtfCacheMisses);
+
+    int hrtfCacheLookups = _stats.hrtfCacheHits + _stats.hrtfCacheMisses;
+    mixStats["%_hrtf_cache_hit_rate"] = (hrtfCacheLookups > 0) ?
+        QString::number((float(_stats.hrtfCacheHits) / hrtfCacheLookups) * 100.0f, 'f', 2) : QString("0.0");
+
+    mixStats["avg_culled_nodes_per_listener"] = (_stats.sumListeners > 0) ?
+        (float)_stats.sumCulledNodes / (float)_stats.sumListeners : 0.0f;
 
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
@@ -379,15 +390,20 @@ void AudioMixer::start() {
                 std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
                     _stats.sumStreams += prepareFrame(node, frame);
                 });
+                indexSources(cbegin, cend);
             }
 
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                _slavePool.mix(cbegin, cend, frame, _throttlingRatio, &_sourceGrid, &_hrtfCache);
             }
         });
 
+        if (_hrtfCache.isEnabled()) {
+            _hrtfCache.nextFrame(frame);
+        }
+
         // gather stats
         _slavePool.each([&](AudioMixerSlave& slave) {
             _stats.accumulate(slave.stats);
@@ -496,6 +512,72 @@ int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame)
     return data->checkBuffersBeforeFrameSend();
 }
 
+void AudioMixer::indexSources(NodeList::const_iterator begin, NodeList::const_iterator end) {
+    // each source is audible as far as its own gain carries it under the weakest attenuation where it is
+    _indexedSources.clear();
+    float maxRadius = 0.0f;
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
+        if (data == nullptr) {
+            return;
+        }
+
+        for (auto& streamPair : data->getAudioStreams()) {
+            auto& stream = *streamPair.second;
+            glm::vec3 position = stream.getPosition();
+
+            float sourceGain = 1.0f;
+            if (stream.getType() == PositionalAudioStream::Injector) {
+                sourceGain = static_cast<const InjectedAudioStream&>(stream).getAttenuationRatio();
+            }
+
+            float attenuation = _attenuationPerDoublingInDistance;
+            for (int i = 0; i < _zoneSettings.length(); ++i) {
+                if (_audioZones[_zoneSettings[i].source].contains(position)) {
+                    attenuation = std::min(attenuation, _zoneSettings[i].coefficient);
+                }
+            }
+
+            float radius = computeAudibilityRadius(attenuation, sourceGain);
+            if (std::isfinite(radius)) {
+                maxRadius = std::max(maxRadius, radius);
+            }
+            _indexedSources.push_back({ node, position, radius });
+        }
+    });
+
+    _sourceGrid.reset(maxRadius);
+    for (auto& source : _indexedSources) {
+        _sourceGrid.insert(source.node, source.position, source.radius);
+    }
+    _indexedSources.clear();
+}
+
+float AudioMixer::computeAudibilityRadius(float attenuationPerDoublingInDistance, float sourceGain) {
+    // gains below this are treated as inaudible (-60dB)
+    const float AUDIBILITY_THRESHOLD = 0.001f;
+
+    if (sourceGain <= 0.0f) {
+        return 0.0f;
+    }
+
+    // translate the attenuation to gain per log2(distance), as in computeGain
+    float g = 1.0f - attenuationPerDoublingInDistance;
+    if (g >= 1.0f - EPSILON) {
+        // no attenuation: the source is audible everywhere
+        return std::numeric_limits<float>::infinity();
+    }
+    g = std::max(g, EPSILON);
+
+    // solve sourceGain * g ^ log2(distance) = threshold for distance
+    float radius = std::exp2(std::log2(AUDIBILITY_THRESHOLD / sourceGain) / std::log2(g));
+    if (!std::isfinite(radius) || radius >= (float)TREE_SCALE) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return radius;
+}
+
 void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
@@ -521,6 +603,29 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                 _slavePool.setNumThreads(numThreads);
             }
         }
+
+        const QString SCHEDULER = "scheduler";
+        const QString WORK_STEALING_SCHEDULER = "work_stealing";
+        bool workStealing = audioThreadingGroupObject[SCHEDULER].toString() == WORK_STEALING_SCHEDULER;
+        _slavePool.setScheduler(workStealing ?
+            AudioMixerSlavePool::Scheduler::WorkStealing : AudioMixerSlavePool::Scheduler::Queue);
+        qDebug() << "Audio mixer scheduler:" << (workStealing ? "work stealing" : "queue");
+
+        const QString PIN_THREADS = "pin_threads";
+        bool pinThreads = audioThreadingGroupObject[PIN_THREADS].toBool();
+        _slavePool.setPinThreads(pinThreads);
+        qDebug() << "Audio mixer thread pinning:" << (pinThreads ? "enabled" : "disabled");
+
+        const QString HRTF_CACHE = "hrtf_cache";
+        bool hrtfCache = audioThreadingGroupObject[HRTF_CACHE].toBool();
+        _hrtfCache.clear();
+        _hrtfCache.setEnabled(hrtfCache);
+        qDebug() << "Shared HRTF renders:" << (hrtfCache ? "enabled" : "disabled");
+
+        const QString HRTF_CACHE_MIN_LISTENERS = "hrtf_cache_min_listeners";
+        bool ok;
+        int minListeners = audioThreadingGroupObject[HRTF_CACHE_MIN_LISTENERS].toString().toInt(&ok);
+        _hrtfCache.setMinListeners(ok ? std::max(minListeners, 1) : AudioHRTFCache::DEFAULT_MIN_LISTENERS);
     }
 
     if (settingsObject.contains(AUDIO_BUFFER_GROUP_KEY)) {
@@ -724,6 +829,13 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
     }
+
+    float radius = computeAudibilityRadius(_attenuationPerDoublingInDistance, 1.0f);
+    if (std::isfinite(radius)) {
+        qDebug() << "Culling audio sources of unity gain further than" << radius << "meters";
+    } else {
+        qDebug() << "Audio sources are not culled by distance outside of attenuating zones";
+    }
 }
 
 AudioMixer::Timer::Timing::Timing(uint64_t& sum) : _sum(sum) {
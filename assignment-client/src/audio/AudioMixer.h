@@ -73,6 +73,11 @@ private:
     // pop a frame from any streams on the node
     // returns the number of available streams
     int prepareFrame(const SharedNodePointer& node, unsigned int frame);
+    // index the position of each stream on the nodes
+    void indexSources(NodeList::const_iterator begin, NodeList::const_iterator end);
+
+    // distance past which a source of the given gain can't be heard, or infinity if that distance is unbounded
+    static float computeAudibilityRadius(float attenuationPerDoublingInDistance, float sourceGain);
 
     AudioMixerClientData* getOrCreateClientData(Node* node);
 
@@ -90,6 +95,14 @@ private:
     AudioMixerStats _stats;
 
     AudioMixerSlavePool _slavePool;
+    AudioMixerSourceGrid _sourceGrid;
+    struct IndexedSource {
+        SharedNodePointer node;
+        glm::vec3 position;
+        float radius;
+    };
+    std::vector<IndexedSource> _indexedSources;
+    AudioHRTFCache _hrtfCache;
 
     class Timer {
     public:
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <random>
 
 #include <QtCore/QDebug>
@@ -124,6 +125,13 @@ void AudioMixerClientData::parsePerAvatarGainSet(ReceivedMessage& message, const
     message.readPrimitive(&packedGain);
     float gain = unpackFloatGainFromByte(packedGain);
     hrtfForStream(avatarUuid, QUuid()).setGainAdjustment(gain);
+
+    _maxGainAdjustment = 1.0f;
+    for (auto& nodeSources : _nodeSourcesHRTFMap) {
+        for (auto& source : nodeSources.second) {
+            _maxGainAdjustment = std::max(_maxGainAdjustment, source.second.hrtf.getGainAdjustment());
+        }
+    }
     qDebug() << "Setting gain adjustment for hrtf[" << uuid << "][" << avatarUuid << "] to " << gain;
 }
 
@@ -18,6 +18,7 @@
 
 #include <AABox.h>
 #include <AudioHRTF.h>
+#include <AudioHRTFCache.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
 
@@ -51,7 +52,16 @@ public:
     // they are not thread-safe
 
     // returns a new or existing HRTF object for the given stream from the given node
-    AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) { return _nodeSourcesHRTFMap[nodeID][streamID]; }
+    AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) { return _nodeSourcesHRTFMap[nodeID][streamID].hrtf; }
+
+    // returns the HRTF object for the given stream along with how it was rendered for this listener,
+    // to render it with through AudioHRTFCache
+    AudioHRTFCache::ListenerSource& listenerSourceForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) {
+        return _nodeSourcesHRTFMap[nodeID][streamID];
+    }
+
+    // the largest per-avatar gain this listener has set, sources it boosts can be heard past the culling radius
+    float getMaxGainAdjustment() const { return _maxGainAdjustment; }
 
     // removes an AudioHRTF object for a given stream
     void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
@@ -108,6 +118,10 @@ public:
     bool getRequestsDomainListData() { return _requestsDomainListData; }
     void setRequestsDomainListData(bool requesting) { _requestsDomainListData = requesting; }
 
+    // number of streams mixed for this listener in its last mix, used to weigh it when scheduling
+    int getNumMixedStreams() const { return _numMixedStreams; }
+    void setNumMixedStreams(int numMixedStreams) { _numMixedStreams = numMixedStreams; }
+
 signals:
     void injectorStreamFinished(const QUuid& streamIdentifier);
 
@@ -162,9 +176,10 @@ private:
     using NodeSourcesIgnoreMap = tbb::concurrent_unordered_map<QUuid, IgnoreNodeCache, IgnoreNodeCacheHasher>;
     NodeSourcesIgnoreMap _nodeSourcesIgnoreMap;
 
-    using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
+    using HRTFMap = std::unordered_map<QUuid, AudioHRTFCache::ListenerSource>;
     using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
     NodeSourcesHRTFMap _nodeSourcesHRTFMap;
+    float _maxGainAdjustment { 1.0f };
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
@@ -181,6 +196,8 @@ private:
 
     bool _shouldMuteClient { false };
     bool _requestsDomainListData { false };
+
+    int _numMixedStreams { 0 };
 };
 
 #endif // hifi_AudioMixerClientData_h
@@ -28,6 +28,7 @@
 #include <UUID.h>
 
 #include "AudioRingBuffer.h"
+#include "AudioMixKernels.h"
 #include "AudioMixer.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
@@ -60,11 +61,14 @@ void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSourceGrid* grid, AudioHRTFCache* hrtfCache) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _grid = grid;
+    _hrtfCache = hrtfCache;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -91,6 +95,7 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
 
         // mix the audio
         bool mixHasAudio = prepareMix(node);
+        data->setNumMixedStreams(_numMixedStreams);
 
         // send audio packet
         if (mixHasAudio || data->shouldFlushEncoder()) {
@@ -127,6 +132,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
+    _numMixedStreams = 0;
 
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
@@ -145,7 +151,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     auto mixStart = p_high_resolution_clock::now();
 #endif
 
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+    auto mixNode = [&](const SharedNodePointer& node) {
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         if (!nodeData) {
             return;
@@ -189,7 +195,27 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                 }
             }
         }
-    });
+    };
+
+    // a listener that boosted someone's gain may hear them past their audibility radius, so it visits every node
+    if (_grid && _grid->isEnabled() && listenerData->getMaxGainAdjustment() <= 1.0f) {
+        // only visit the listener itself and the sources it is within the audibility radius of
+        mixNode(listener);
+
+        _grid->query(listenerAudioStream->getPosition(), _audibleNodes);
+        int numVisited = 1;
+        for (const SharedNodePointer& node : _audibleNodes) {
+            if (!(*node == *listener)) {
+                mixNode(node);
+                ++numVisited;
+            }
+        }
+        _audibleNodes.clear();
+
+        stats.sumCulledNodes += std::max((int)std::distance(_begin, _end) - numVisited, 0);
+    } else {
+        std::for_each(_begin, _end, mixNode);
+    }
 
     if (isThrottling) {
         // pop the loudest nodes off the heap and mix their streams
@@ -224,13 +250,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     // check for silent audio before limiting
     // limiting uses a dither and can only guarantee abs(sample) <= 1
-    bool hasAudio = false;
-    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-        if (_mixSamples[i] != 0.0f) {
-            hasAudio = true;
-            break;
-        }
-    }
+    bool hasAudio = !mixIsSilent(_mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
     // use the per listener AudioLimiter to render the mixed data
     listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
@@ -252,6 +272,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         bool throttle) {
     ++stats.totalMixes;
+    ++_numMixedStreams;
 
     // to reduce artifacts we call the HRTF functor for every source, even if throttled or silent
     // this ensures the correct tail from last mixed block and the correct spatialization of next first block
@@ -266,6 +287,22 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
     const int HRTF_DATASET_INDEX = 1;
 
+    // get the existing listener-source HRTF object, or create a new one
+    auto streamID = streamToAdd.getStreamIdentifier();
+    auto& listenerSource = listenerNodeData.listenerSourceForStream(sourceNodeID, streamID);
+
+    // quiet renders still go through the cache if the source was heard through a shared bucket in the last frame,
+    // so that they crossfade back to the listener's own HRTF
+    auto renderSilent = [&](int16_t* input, float silentGain) {
+        if (_hrtfCache && AudioHRTFCache::isInBucket(listenerSource, _frame)) {
+            _hrtfCache->render(listenerSource, false, sourceNodeID, streamID, input, _mixSamples,
+                               HRTF_DATASET_INDEX, azimuth, distance, silentGain, _frame);
+        } else {
+            AudioHRTFCache::hrtfToRender(listenerSource, _frame).renderSilent(input, _mixSamples, HRTF_DATASET_INDEX,
+                    azimuth, distance, silentGain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        }
+    };
+
     if (!streamToAdd.lastPopSucceeded()) {
         bool forceSilentBlock = true;
 
@@ -289,12 +326,8 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
             // call renderSilent with a forced silent block to reduce artifacts
             // (this is not done for stereo streams since they do not go through the HRTF)
             if (!streamToAdd.isStereo() && !isEcho) {
-                // get the existing listener-source HRTF object, or create a new one
-                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
-
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
-                hrtf.renderSilent(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                                  AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+                renderSilent(silentMonoBlock, gain);
 
                 ++stats.hrtfSilentRenders;
             }
@@ -308,9 +341,8 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     // stereo sources are not passed through HRTF
     if (streamToAdd.isStereo()) {
-        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-            _mixSamples[i] += float(streamPopOutput[i] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        mixAccumulateInt16(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
         ++stats.manualStereoMixes;
         return;
@@ -318,25 +350,18 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     // echo sources are not passed through HRTF
     if (isEcho) {
-        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i += 2) {
-            auto monoSample = float(streamPopOutput[i / 2] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-            _mixSamples[i] += monoSample;
-            _mixSamples[i + 1] += monoSample;
-        }
+        streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        mixAccumulateInt16MonoToStereo(_bufferSamples, _mixSamples, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
         ++stats.manualEchoMixes;
         return;
     }
 
-    // get the existing listener-source HRTF object, or create a new one
-    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
-
     streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
     if (streamToAdd.getLastPopOutputLoudness() == 0.0f) {
         // call renderSilent to reduce artifacts
-        hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        renderSilent(_bufferSamples, gain);
 
         ++stats.hrtfSilentRenders;
         return;
@@ -344,15 +369,29 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     if (throttle) {
         // call renderSilent with actual frame data and a gain of 0.0f to reduce artifacts
-        hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
-                          AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        renderSilent(_bufferSamples, 0.0f);
 
         ++stats.hrtfThrottleRenders;
         return;
     }
 
-    hrtf.render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    if (_hrtfCache) {
+        // sources heard by many listeners share a render per (azimuth, distance, gain) bucket
+        bool useBucket = _hrtfCache->touch(sourceNodeID, streamID);
+        bool isHit = _hrtfCache->render(listenerSource, useBucket, sourceNodeID, streamID, _bufferSamples, _mixSamples,
+                                        HRTF_DATASET_INDEX, azimuth, distance, gain, _frame);
+        if (!useBucket) {
+            ++stats.hrtfRenders;
+        } else if (isHit) {
+            ++stats.hrtfCacheHits;
+        } else {
+            ++stats.hrtfCacheMisses;
+        }
+        return;
+    }
+
+    AudioHRTFCache::hrtfToRender(listenerSource, _frame).render(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX,
+            azimuth, distance, gain, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
     ++stats.hrtfRenders;
 }
@@ -14,11 +14,13 @@
 
 #include <AABox.h>
 #include <AudioHRTF.h>
+#include <AudioHRTFCache.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 #include <NodeList.h>
 
+#include "AudioMixerSourceGrid.h"
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
@@ -34,7 +36,10 @@ public:
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    //   if the grid is enabled, each listener only mixes the sources it finds in the grid
+    //   if the cache is enabled, widely heard sources are rendered through it
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSourceGrid* grid = nullptr, AudioHRTFCache* hrtfCache = nullptr);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -57,11 +62,17 @@ private:
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // listener state
+    int _numMixedStreams { 0 };
+    std::vector<SharedNodePointer> _audibleNodes;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSourceGrid* _grid { nullptr };
+    AudioHRTFCache* _hrtfCache { nullptr };
 };
 
 #endif // hifi_AudioMixerSlave_h
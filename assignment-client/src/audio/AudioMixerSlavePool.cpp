@@ -12,6 +12,15 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "AudioMixerClientData.h"
+
 #include "AudioMixerSlavePool.h"
 
 void AudioMixerSlaveThread::run() {
@@ -46,6 +55,11 @@ void AudioMixerSlaveThread::wait() {
         _pool._configure(*this);
     }
     _function = _pool._function;
+
+    int cpu = _pool._pinThreads ? _index % std::max(1, QThread::idealThreadCount()) : -1;
+    if (cpu != _pinnedCPU) {
+        pin(cpu);
+    }
 }
 
 void AudioMixerSlaveThread::notify(bool stopping) {
@@ -61,7 +75,60 @@ void AudioMixerSlaveThread::notify(bool stopping) {
 }
 
 bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+    if (_pool._scheduler == AudioMixerSlavePool::Scheduler::Queue) {
+        return _pool._queue.try_pop(node);
+    }
+
+    // drain our own work first...
+    if (take(node)) {
+        return true;
+    }
+
+    // ...then steal from the other slaves, starting with our neighbor
+    auto& slaves = _pool._slaves;
+    int numSlaves = (int)slaves.size();
+    for (int i = 1; i < numSlaves; ++i) {
+        if (slaves[(_index + i) % numSlaves]->take(node)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool AudioMixerSlaveThread::take(SharedNodePointer& node) {
+    // the owner and any thieves share a single cursor, so each node is claimed exactly once
+    size_t index = _next.fetch_add(1, std::memory_order_relaxed);
+    if (index < _work.size()) {
+        node = _work[index];
+        return true;
+    }
+    return false;
+}
+
+void AudioMixerSlaveThread::pin(int cpu) {
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (cpu < 0) {
+        // unpin: allow all cores
+        int numCPUs = std::max(1, QThread::idealThreadCount());
+        for (int i = 0; i < numCPUs; ++i) {
+            CPU_SET(i, &cpuSet);
+        }
+    } else {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+        qWarning("%s: could not set affinity of slave %d to cpu %d", __FUNCTION__, _index, cpu);
+    }
+#else
+    if (cpu >= 0) {
+        qWarning("%s: thread pinning is not supported on this platform", __FUNCTION__);
+    }
+#endif
+    _pinnedCPU = cpu;
 }
 
 #ifdef AUDIO_SINGLE_THREADED
@@ -71,16 +138,25 @@ static AudioMixerSlave slave;
 void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
     _function = &AudioMixerSlave::processPackets;
     _configure = [](AudioMixerSlave& slave) {};
+    _cost = nullptr;
     run(begin, end);
 }
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        const AudioMixerSourceGrid* grid, AudioHRTFCache* hrtfCache) {
     _function = &AudioMixerSlave::mix;
     _configure = [&](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, _grid, _hrtfCache);
+    };
+    // weigh each listener by the number of streams it mixed last frame
+    _cost = [](const SharedNodePointer& node) {
+        AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
+        return data ? 1 + data->getNumMixedStreams() : 1;
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _grid = grid;
+    _hrtfCache = hrtfCache;
 
     run(begin, end);
 }
@@ -95,10 +171,15 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
         _function(slave, node);
     });
 #else
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.emplace(node);
-    });
+    if (_scheduler == Scheduler::Queue) {
+        // fill the queue
+        std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+            _queue.emplace(node);
+        });
+    } else {
+        // fill the per-slave work
+        distribute(_begin, _end);
+    }
 
     {
         Lock lock(_mutex);
@@ -117,9 +198,45 @@ void AudioMixerSlavePool::run(ConstIter begin, ConstIter end) {
     }
 
     assert(_queue.empty());
+
+    // release the node references held by this frame
+    for (auto& slave : _slaves) {
+        slave->_work.clear();
+    }
 #endif
 }
 
+void AudioMixerSlavePool::distribute(ConstIter begin, ConstIter end) {
+    _weightedNodes.clear();
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        _weightedNodes.emplace_back(_cost ? _cost(node) : 1, node);
+    });
+
+    // heaviest first, so that each slave starts on its most expensive work and steals end up being cheap
+    std::stable_sort(_weightedNodes.begin(), _weightedNodes.end(),
+        [](const std::pair<int, SharedNodePointer>& a, const std::pair<int, SharedNodePointer>& b) {
+            return a.first > b.first;
+        });
+
+    for (auto& slave : _slaves) {
+        slave->_work.clear();
+        slave->_load = 0;
+        slave->_next.store(0, std::memory_order_relaxed);
+    }
+
+    // greedily assign each node to the least loaded slave
+    for (auto& weightedNode : _weightedNodes) {
+        auto& slave = *std::min_element(_slaves.begin(), _slaves.end(),
+            [](const std::unique_ptr<AudioMixerSlaveThread>& a, const std::unique_ptr<AudioMixerSlaveThread>& b) {
+                return a->_load < b->_load;
+            });
+        slave->_load += weightedNode.first;
+        slave->_work.push_back(weightedNode.second);
+    }
+
+    _weightedNodes.clear();
+}
+
 void AudioMixerSlavePool::each(std::function<void(AudioMixerSlave& slave)> functor) {
 #ifdef AUDIO_SINGLE_THREADED
     functor(slave);
@@ -163,7 +280,7 @@ void AudioMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
+            auto slave = new AudioMixerSlaveThread(*this, (int)_slaves.size());
             slave->start();
             _slaves.emplace_back(slave);
         }
@@ -12,6 +12,7 @@
 #ifndef hifi_AudioMixerSlavePool_h
 #define hifi_AudioMixerSlavePool_h
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
@@ -31,7 +32,7 @@ class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool) : _pool(pool) {}
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, int index) : _pool(pool), _index(index) {}
 
     void run() override final;
 
@@ -42,9 +43,22 @@ private:
     void notify(bool stopping);
     bool try_pop(SharedNodePointer& node);
 
+    // claim the next node from this slave's own work (thread-safe, called by owner and thieves)
+    bool take(SharedNodePointer& node);
+
+    // pin (or unpin, if cpu < 0) this thread to a core
+    void pin(int cpu);
+
     AudioMixerSlavePool& _pool;
+    const int _index;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     bool _stop { false };
+    int _pinnedCPU { -1 };
+
+    // work-stealing state (written by the pool between frames)
+    std::vector<SharedNodePointer> _work;
+    std::atomic<size_t> _next { 0 };
+    int _load { 0 };
 };
 
 // Slave pool for audio mixers
@@ -58,6 +72,11 @@ class AudioMixerSlavePool {
 public:
     using ConstIter = NodeList::const_iterator;
 
+    enum class Scheduler {
+        Queue,          // all slaves pop from a single shared queue
+        WorkStealing    // nodes are cost-weighted into per-slave work, idle slaves steal from busy ones
+    };
+
     AudioMixerSlavePool(int numThreads = QThread::idealThreadCount()) { setNumThreads(numThreads); }
     ~AudioMixerSlavePool() { resize(0); }
 
@@ -65,7 +84,8 @@ public:
     void processPackets(ConstIter begin, ConstIter end);
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            const AudioMixerSourceGrid* grid = nullptr, AudioHRTFCache* hrtfCache = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -73,10 +93,20 @@ public:
     void setNumThreads(int numThreads);
     int numThreads() { return _numThreads; }
 
+    void setScheduler(Scheduler scheduler) { _scheduler = scheduler; }
+    Scheduler scheduler() { return _scheduler; }
+
+    // pin each slave thread to its own core (applied at the start of the next frame)
+    void setPinThreads(bool pinThreads) { _pinThreads = pinThreads; }
+    bool pinThreads() { return _pinThreads; }
+
 private:
     void run(ConstIter begin, ConstIter end);
     void resize(int numThreads);
 
+    // split [begin, end) across the slaves, balancing the summed cost of each slave's work
+    void distribute(ConstIter begin, ConstIter end);
+
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
 
     friend void AudioMixerSlaveThread::wait();
@@ -89,6 +119,9 @@ private:
     ConditionVariable _poolCondition;
     void (AudioMixerSlave::*_function)(const SharedNodePointer& node);
     std::function<void(AudioMixerSlave&)> _configure;
+    std::function<int(const SharedNodePointer&)> _cost;
+    Scheduler _scheduler { Scheduler::Queue };
+    bool _pinThreads { false };
     int _numThreads { 0 };
     int _numStarted { 0 }; // guarded by _mutex
     int _numFinished { 0 }; // guarded by _mutex
@@ -96,8 +129,11 @@ private:
 
     // frame state
     Queue _queue;
+    std::vector<std::pair<int, SharedNodePointer>> _weightedNodes;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    const AudioMixerSourceGrid* _grid { nullptr };
+    AudioHRTFCache* _hrtfCache { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
@@ -0,0 +1,83 @@
+//
+//  AudioMixerSourceGrid.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <glm/gtx/norm.hpp>
+
+#include "AudioMixerSourceGrid.h"
+
+void AudioMixerSourceGrid::reset(float cellSize) {
+    _cells.clear();
+    _unboundedNodes.clear();
+
+    // cells are as large as the largest radius, so a query never touches more than 3x3x3 cells
+    _cellSize = std::max(cellSize, 0.0f);
+    _inverseCellSize = isEnabled() ? 1.0f / _cellSize : 0.0f;
+}
+
+void AudioMixerSourceGrid::insert(const SharedNodePointer& node, const glm::vec3& position, float radius) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    if (!std::isfinite(radius)) {
+        _unboundedNodes.push_back(node);
+        return;
+    }
+
+    assert(radius <= _cellSize);
+    _cells[keyForCell(cellForPosition(position))].push_back({ position, radius * radius, node });
+}
+
+void AudioMixerSourceGrid::query(const glm::vec3& position, std::vector<SharedNodePointer>& nodes) const {
+    nodes.clear();
+    if (!isEnabled()) {
+        return;
+    }
+
+    nodes.insert(nodes.end(), _unboundedNodes.begin(), _unboundedNodes.end());
+
+    glm::ivec3 minCell = cellForPosition(position - glm::vec3(_cellSize));
+    glm::ivec3 maxCell = cellForPosition(position + glm::vec3(_cellSize));
+
+    for (int x = minCell.x; x <= maxCell.x; ++x) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+            for (int z = minCell.z; z <= maxCell.z; ++z) {
+                auto it = _cells.find(keyForCell(glm::ivec3(x, y, z)));
+                if (it == _cells.end()) {
+                    continue;
+                }
+
+                for (const Source& source : it->second) {
+                    if (glm::distance2(source.position, position) <= source.radiusSquared) {
+                        nodes.push_back(source.node);
+                    }
+                }
+            }
+        }
+    }
+
+    // nodes with several nearby streams are only visited once
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+}
+
+AudioMixerSourceGrid::Key AudioMixerSourceGrid::keyForCell(const glm::ivec3& cell) const {
+    // pack 21 bits per axis, which covers +/- 1M cells
+    const int64_t MASK = (1 << 21) - 1;
+    return ((int64_t)(cell.x & MASK) << 42) | ((int64_t)(cell.y & MASK) << 21) | (int64_t)(cell.z & MASK);
+}
+
+glm::ivec3 AudioMixerSourceGrid::cellForPosition(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position * _inverseCellSize));
+}
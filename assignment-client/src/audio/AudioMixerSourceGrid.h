@@ -0,0 +1,57 @@
+//
+//  AudioMixerSourceGrid.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSourceGrid_h
+#define hifi_AudioMixerSourceGrid_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Node.h>
+
+// Spatial hash of audio source positions, rebuilt once per frame by the AudioMixer
+//   Each source is indexed with its own audibility radius, which depends on its gain and the attenuation where it is.
+//   Building is not thread-safe; once built, the grid may be queried concurrently by the slaves.
+class AudioMixerSourceGrid {
+public:
+    // empty the grid for a new frame, with cells as large as the largest finite radius that will be inserted
+    // a cell size of zero disables culling for the frame (isEnabled() returns false)
+    void reset(float cellSize);
+    float getCellSize() const { return _cellSize; }
+    bool isEnabled() const { return _cellSize > 0.0f; }
+
+    // add a source of node at position, audible within radius of it (a node may be added once for each of its streams)
+    // a source with an infinite radius is audible everywhere
+    void insert(const SharedNodePointer& node, const glm::vec3& position, float radius);
+
+    // fill nodes with each node that has a source audible at position, without duplicates
+    void query(const glm::vec3& position, std::vector<SharedNodePointer>& nodes) const;
+
+private:
+    using Key = int64_t;
+    struct Source {
+        glm::vec3 position;
+        float radiusSquared;
+        SharedNodePointer node;
+    };
+    using Cell = std::vector<Source>;
+
+    Key keyForCell(const glm::ivec3& cell) const;
+    glm::ivec3 cellForPosition(const glm::vec3& position) const;
+
+    std::unordered_map<Key, Cell> _cells;
+    std::vector<SharedNodePointer> _unboundedNodes;
+    float _cellSize { 0.0f };
+    float _inverseCellSize { 0.0f };
+};
+
+#endif // hifi_AudioMixerSourceGrid_h
@@ -21,6 +21,9 @@ void AudioMixerStats::reset() {
     hrtfThrottleRenders = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    hrtfCacheHits = 0;
+    hrtfCacheMisses = 0;
+    sumCulledNodes = 0;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -36,6 +39,9 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    hrtfCacheHits += otherStats.hrtfCacheHits;
+    hrtfCacheMisses += otherStats.hrtfCacheMisses;
+    sumCulledNodes += otherStats.sumCulledNodes;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
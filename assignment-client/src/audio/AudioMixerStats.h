@@ -30,6 +30,11 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int hrtfCacheHits { 0 };
+    int hrtfCacheMisses { 0 };
+
+    int sumCulledNodes { 0 };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
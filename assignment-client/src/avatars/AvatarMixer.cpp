@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <chrono>
 #include <memory>
@@ -140,12 +141,28 @@ void AvatarMixer::start() {
             _displayNameManagementElapsedTime += (end - start);
         }
 
+        // encode the detail tiers of each avatar once, to be shared by every receiver
+        if (_sharedAvatarEncoding) {
+            auto start = usecTimestampNow();
+            nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+                _slavePool.encodeAvatarData(cbegin, cend, _quantizedJointData);
+            }, &lockWait, &nodeTransform, &functor);
+            auto end = usecTimestampNow();
+            _encodeAvatarDataElapsedTime += (end - start);
+        }
+
         // this is where we need to put the real work...
         {
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
-                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio);
+                const AvatarMixerAvatarGrid* avatarGrid = nullptr;
+                if (_avatarGrid.isEnabled()) {
+                    indexAvatars(cbegin, cend);
+                    avatarGrid = &_avatarGrid;
+                }
+                _slavePool.broadcastAvatarData(cbegin, cend, _lastFrameTimestamp, _maxKbpsPerNode, _throttlingRatio,
+                                               _sharedAvatarEncoding, _quantizedJointData, avatarGrid);
                 auto end = usecTimestampNow();
                 _broadcastAvatarDataInner += (end - start);
             }, &lockWait, &nodeTransform, &functor);
@@ -507,6 +524,10 @@ void AvatarMixer::sendStatsPacket() {
     processQueuedAvatarDataPacketsStats["2_lockWait"] = TIGHT_LOOP_STAT_UINT64(_processQueuedAvatarDataPacketsLockWaitElapsedTime);
     parallelTasks["processQueuedAvatarDataPackets"] = processQueuedAvatarDataPacketsStats;
 
+    QJsonObject encodeAvatarDataStats;
+    encodeAvatarDataStats["1_total"] = TIGHT_LOOP_STAT_UINT64(_encodeAvatarDataElapsedTime);
+    parallelTasks["encodeAvatarData"] = encodeAvatarDataStats;
+
     QJsonObject broadcastAvatarDataStats;
 
     broadcastAvatarDataStats["1_total"] = TIGHT_LOOP_STAT_UINT64(_broadcastAvatarDataElapsedTime);
@@ -552,12 +573,19 @@ void AvatarMixer::sendStatsPacket() {
         float averageOverBudgetAvatars = averageNodes ? stats.overBudgetAvatars / averageNodes : 0.0f;
         slaveObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+        float averageSharedEncodes = averageNodes ? stats.numSharedEncodes / averageNodes : 0.0f;
+        slaveObject["sent_8_averageSharedEncodes"] = TIGHT_LOOP_STAT(averageSharedEncodes);
+
+        float averageOthersConsidered = averageNodes ? stats.numOthersConsidered / averageNodes : 0.0f;
+        slaveObject["sent_9_averageOthersConsidered"] = TIGHT_LOOP_STAT(averageOthersConsidered);
+
         slaveObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(stats.processIncomingPacketsElapsedTime);
         slaveObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(stats.ignoreCalculationElapsedTime);
         slaveObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(stats.toByteArrayElapsedTime);
         slaveObject["timing_4_avatarDataPacking"] = TIGHT_LOOP_STAT_UINT64(stats.avatarDataPackingElapsedTime);
         slaveObject["timing_5_packetSending"] = TIGHT_LOOP_STAT_UINT64(stats.packetSendingElapsedTime);
         slaveObject["timing_6_jobElapsedTime"] = TIGHT_LOOP_STAT_UINT64(stats.jobElapsedTime);
+        slaveObject["timing_7_encodeAvatarData"] = TIGHT_LOOP_STAT_UINT64(stats.encodeAvatarDataElapsedTime);
 
         slavesObject[QString::number(slaveNumber)] = slaveObject;
         slaveNumber++;
@@ -585,12 +613,19 @@ void AvatarMixer::sendStatsPacket() {
     float averageOverBudgetAvatars = averageNodes ? aggregateStats.overBudgetAvatars / averageNodes : 0.0f;
     slavesAggregatObject["sent_7_averageOverBudgetAvatars"] = TIGHT_LOOP_STAT(averageOverBudgetAvatars);
 
+    float averageSharedEncodes = averageNodes ? aggregateStats.numSharedEncodes / averageNodes : 0.0f;
+    slavesAggregatObject["sent_8_averageSharedEncodes"] = TIGHT_LOOP_STAT(averageSharedEncodes);
+
+    float averageOthersConsidered = averageNodes ? aggregateStats.numOthersConsidered / averageNodes : 0.0f;
+    slavesAggregatObject["sent_9_averageOthersConsidered"] = TIGHT_LOOP_STAT(averageOthersConsidered);
+
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
     slavesAggregatObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.toByteArrayElapsedTime);
     slavesAggregatObject["timing_4_avatarDataPacking"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.avatarDataPackingElapsedTime);
     slavesAggregatObject["timing_5_packetSending"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.packetSendingElapsedTime);
     slavesAggregatObject["timing_6_jobElapsedTime"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.jobElapsedTime);
+    slavesAggregatObject["timing_7_encodeAvatarData"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.encodeAvatarDataElapsedTime);
 
     statsObject["slaves_aggregate"] = slavesAggregatObject;
     statsObject["slaves_individual"] = slavesObject;
@@ -644,6 +679,8 @@ void AvatarMixer::sendStatsPacket() {
     _sumIdentityPackets = 0;
     _numTightLoopFrames = 0;
 
+    _encodeAvatarDataElapsedTime = 0;
+
     _broadcastAvatarDataElapsedTime = 0;
     _broadcastAvatarDataInner = 0;
     _broadcastAvatarDataLockWait = 0;
@@ -714,6 +751,20 @@ void AvatarMixer::handlePacketVersionMismatch(PacketType type, const HifiSockAdd
     }
 }
 
+void AvatarMixer::indexAvatars(NodeList::const_iterator begin, NodeList::const_iterator end) {
+    _avatarGrid.clear();
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        auto nodeData = reinterpret_cast<const AvatarMixerClientData*>(node->getLinkedData());
+        if (nodeData) {
+            glm::vec3 position = nodeData->getPosition();
+            glm::vec3 halfScale = position - nodeData->getGlobalBoundingBoxCorner();
+            float radius = glm::max(halfScale.x, glm::max(halfScale.y, halfScale.z));
+            _avatarGrid.insert(node, position, radius);
+        }
+    });
+}
+
 void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     const QString AVATAR_MIXER_SETTINGS_KEY = "avatar_mixer";
     QJsonObject avatarMixerGroupObject = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject();
@@ -746,6 +797,21 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         qCDebug(avatars) << "Avatar mixer will automatically determine number of threads to use. Using:" << _slavePool.numThreads() << "threads.";
     }
 
+    const QString SHARED_AVATAR_ENCODING = "shared_avatar_encoding";
+    _sharedAvatarEncoding = avatarMixerGroupObject[SHARED_AVATAR_ENCODING].toBool();
+    qCDebug(avatars) << "Avatar mixer shared avatar encoding is" << (_sharedAvatarEncoding ? "enabled" : "disabled");
+
+    const QString QUANTIZED_JOINT_DATA = "quantized_joint_data";
+    _quantizedJointData = avatarMixerGroupObject[QUANTIZED_JOINT_DATA].toBool(false);
+    qCDebug(avatars) << "Avatar mixer quantized joint data is" << (_quantizedJointData ? "enabled" : "disabled");
+
+    const QString AVATAR_GRID_DISTANCE = "avatar_grid_distance";
+    _avatarGrid.setDistance((float)avatarMixerGroupObject[AVATAR_GRID_DISTANCE].toDouble(0.0));
+    if (_avatarGrid.isEnabled()) {
+        qCDebug(avatars) << "Avatar mixer will fully consider avatars within" << _avatarGrid.getDistance()
+                         << "meters or in view of each receiver.";
+    }
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_SCALE_OPTION = "min_avatar_scale";
@@ -19,6 +19,7 @@
 #include <PortableHighResolutionClock.h>
 
 #include <ThreadedAssignment.h>
+#include "AvatarMixerAvatarGrid.h"
 #include "AvatarMixerClientData.h"
 
 #include "AvatarMixerSlavePool.h"
@@ -61,6 +62,9 @@ private:
 
     void manageDisplayName(const SharedNodePointer& node);
 
+    // rebuild the avatar grid from the avatars of this frame
+    void indexAvatars(NodeList::const_iterator begin, NodeList::const_iterator end);
+
     p_high_resolution_clock::time_point _lastFrameTimestamp;
 
     // FIXME - new throttling - use these values somehow
@@ -74,6 +78,9 @@ private:
     int _sumIdentityPackets { 0 };
 
     float _maxKbpsPerNode = 0.0f;
+    bool _sharedAvatarEncoding { false };
+    bool _quantizedJointData { false };
+    AvatarMixerAvatarGrid _avatarGrid;
 
     float _domainMinimumScale { MIN_AVATAR_SCALE };
     float _domainMaximumScale { MAX_AVATAR_SCALE };
@@ -87,6 +94,8 @@ private:
     quint64 _avatarDataPackingElapsedTime { 0 };
     quint64 _packetSendingElapsedTime { 0 };
 
+    quint64 _encodeAvatarDataElapsedTime { 0 }; // total time spent encoding the shared avatar data tiers since last stats window
+
     quint64 _broadcastAvatarDataElapsedTime { 0 }; // total time spent in broadcastAvatarData since last stats window
     quint64 _broadcastAvatarDataInner { 0 };
     quint64 _broadcastAvatarDataLockWait { 0 };
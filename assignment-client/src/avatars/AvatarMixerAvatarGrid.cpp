@@ -0,0 +1,131 @@
+//
+//  AvatarMixerAvatarGrid.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <glm/gtx/norm.hpp>
+
+#include <AABox.h>
+
+#include "AvatarMixerAvatarGrid.h"
+
+void AvatarMixerAvatarGrid::setDistance(float distance) {
+    _distance = std::max(distance, 0.0f);
+
+    // cells are as large as the distance, so the distance part of a query touches few cells
+    _inverseCellSize = isEnabled() ? 1.0f / _distance : 0.0f;
+    clear();
+}
+
+void AvatarMixerAvatarGrid::clear() {
+    _avatars.clear();
+    _cells.clear();
+    _cellIndices.clear();
+    _maxRadius = 0.0f;
+}
+
+void AvatarMixerAvatarGrid::insert(const SharedNodePointer& node, const glm::vec3& position, float radius) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    uint32_t avatarIndex = (uint32_t)_avatars.size();
+    _avatars.push_back({ position, radius, node });
+    _maxRadius = std::max(_maxRadius, radius);
+
+    auto result = _cellIndices.emplace(keyForCell(cellForPosition(position)), (uint32_t)_cells.size());
+    if (result.second) {
+        _cells.push_back({ position - glm::vec3(radius), position + glm::vec3(radius), {} });
+    }
+
+    Cell& cell = _cells[result.first->second];
+    cell.minimum = glm::min(cell.minimum, position - glm::vec3(radius));
+    cell.maximum = glm::max(cell.maximum, position + glm::vec3(radius));
+    cell.avatars.push_back(avatarIndex);
+}
+
+void AvatarMixerAvatarGrid::query(const ViewFrustum& view, std::vector<uint32_t>& indices) const {
+    indices.clear();
+    if (!isEnabled() || _cells.empty()) {
+        return;
+    }
+
+    // bounds of the keyhole and of the distance around the view
+    const glm::vec3 viewPosition = view.getPosition();
+    glm::vec3 minimum = viewPosition - glm::vec3(std::max(_distance, view.getCenterRadius()));
+    glm::vec3 maximum = viewPosition + glm::vec3(std::max(_distance, view.getCenterRadius()));
+    for (const glm::vec3& corner : { view.getNearTopLeft(), view.getNearTopRight(), view.getNearBottomLeft(),
+                                     view.getNearBottomRight(), view.getFarTopLeft(), view.getFarTopRight(),
+                                     view.getFarBottomLeft(), view.getFarBottomRight() }) {
+        minimum = glm::min(minimum, corner);
+        maximum = glm::max(maximum, corner);
+    }
+
+    // the cells an avatar touching those bounds can be filed in
+    glm::vec3 minimumCellPosition = glm::floor((minimum - _maxRadius) * _inverseCellSize);
+    glm::vec3 maximumCellPosition = glm::floor((maximum + _maxRadius) * _inverseCellSize);
+    glm::dvec3 extent = glm::dvec3(maximumCellPosition - minimumCellPosition) + 1.0;
+    double numCellsInBounds = extent.x * extent.y * extent.z;
+
+    // keys only tell apart the cells within +/- 1M of the origin
+    const float MAX_CELL = (float)((1 << 20) - 1);
+    bool isInKeyRange = glm::all(glm::greaterThanEqual(minimumCellPosition, glm::vec3(-MAX_CELL))) &&
+        glm::all(glm::lessThanEqual(maximumCellPosition, glm::vec3(MAX_CELL)));
+
+    if (isInKeyRange && numCellsInBounds < (double)_cells.size()) {
+        glm::ivec3 minimumCell(minimumCellPosition);
+        glm::ivec3 maximumCell(maximumCellPosition);
+        glm::ivec3 cell;
+        for (cell.x = minimumCell.x; cell.x <= maximumCell.x; ++cell.x) {
+            for (cell.y = minimumCell.y; cell.y <= maximumCell.y; ++cell.y) {
+                for (cell.z = minimumCell.z; cell.z <= maximumCell.z; ++cell.z) {
+                    auto it = _cellIndices.find(keyForCell(cell));
+                    if (it != _cellIndices.end()) {
+                        queryCell(_cells[it->second], view, indices);
+                    }
+                }
+            }
+        }
+    } else {
+        // a far clip much larger than the distance covers more cells than are occupied
+        for (const Cell& cell : _cells) {
+            queryCell(cell, view, indices);
+        }
+    }
+}
+
+void AvatarMixerAvatarGrid::queryCell(const Cell& cell, const ViewFrustum& view, std::vector<uint32_t>& indices) const {
+    const glm::vec3 viewPosition = view.getPosition();
+
+    AABox bounds(cell.minimum, cell.maximum - cell.minimum);
+    bool isNear = bounds.touchesSphere(viewPosition, _distance);
+    if (!isNear && !view.boxIntersectsKeyhole(bounds)) {
+        return;
+    }
+
+    for (uint32_t index : cell.avatars) {
+        const Avatar& avatar = _avatars[index];
+        float nearDistance = _distance + avatar.radius;
+        if (glm::distance2(avatar.position, viewPosition) <= nearDistance * nearDistance ||
+            view.sphereIntersectsKeyhole(avatar.position, avatar.radius)) {
+            indices.push_back(index);
+        }
+    }
+}
+
+AvatarMixerAvatarGrid::Key AvatarMixerAvatarGrid::keyForCell(const glm::ivec3& cell) const {
+    // pack 21 bits per axis, which covers +/- 1M cells
+    const int64_t MASK = (1 << 21) - 1;
+    return ((int64_t)(cell.x & MASK) << 42) | ((int64_t)(cell.y & MASK) << 21) | (int64_t)(cell.z & MASK);
+}
+
+glm::ivec3 AvatarMixerAvatarGrid::cellForPosition(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position * _inverseCellSize));
+}
@@ -0,0 +1,70 @@
+//
+//  AvatarMixerAvatarGrid.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarMixerAvatarGrid_h
+#define hifi_AvatarMixerAvatarGrid_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Node.h>
+#include <ViewFrustum.h>
+
+// Loose spatial hash of avatar positions, rebuilt once per broadcast frame by the AvatarMixer
+//   Building is not thread-safe; once built, the grid may be queried concurrently by the slaves.
+class AvatarMixerAvatarGrid {
+public:
+    // avatars within distance of a receiver are always considered, whether or not they are in view
+    // a distance of zero disables the grid (isEnabled() returns false)
+    void setDistance(float distance);
+    float getDistance() const { return _distance; }
+    bool isEnabled() const { return _distance > 0.0f; }
+
+    void clear();
+
+    // add the avatar of node, with a bounding sphere of radius around position
+    void insert(const SharedNodePointer& node, const glm::vec3& position, float radius);
+
+    size_t size() const { return _avatars.size(); }
+    const SharedNodePointer& getNode(size_t index) const { return _avatars[index].node; }
+
+    // fill indices with each avatar that is within the keyhole of view, or within the distance of its position
+    // only the cells the keyhole and distance overlap are visited, or every occupied cell if that is fewer
+    void query(const ViewFrustum& view, std::vector<uint32_t>& indices) const;
+
+private:
+    using Key = int64_t;
+    struct Avatar {
+        glm::vec3 position;
+        float radius;
+        SharedNodePointer node;
+    };
+    struct Cell {
+        // bounds of the avatars in the cell, which may overlap neighbouring cells
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        std::vector<uint32_t> avatars;
+    };
+
+    Key keyForCell(const glm::ivec3& cell) const;
+    glm::ivec3 cellForPosition(const glm::vec3& position) const;
+    void queryCell(const Cell& cell, const ViewFrustum& view, std::vector<uint32_t>& indices) const;
+
+    std::vector<Avatar> _avatars;
+    std::vector<Cell> _cells;
+    std::unordered_map<Key, uint32_t> _cellIndices;
+    float _distance { 0.0f };
+    float _inverseCellSize { 0.0f };
+    float _maxRadius { 0.0f }; // avatars are filed by position, so a query has to reach this much past its bounds
+};
+
+#endif // hifi_AvatarMixerAvatarGrid_h
@@ -65,6 +65,32 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     // compute the offset to the data payload
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
+void AvatarMixerClientData::encodeSharedAvatarData(bool quantizedJointData) {
+    quint64 now = usecTimestampNow();
+
+    // the tiers do not depend on the receiver, so there is nothing to track per joint
+    _sharedLastSentJoints.resize(_avatar->getJointCount());
+
+    AvatarDataPacket::HasFlags hasFlagsOut;
+    const bool dropFaceTracking = false;
+    const bool distanceAdjust = false;
+    const glm::vec3 viewerPosition;
+
+    const bool recordSentJoints = true;
+    _sharedAvatarData.full = _avatar->toByteArray(AvatarData::SendAllData, 0, _sharedLastSentJoints,
+        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &_sharedAvatarData.fullJoints, nullptr,
+        quantizedJointData, recordSentJoints);
+    _sharedAvatarData.minimum = _avatar->toByteArray(AvatarData::MinimumData, 0, _sharedLastSentJoints,
+        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, nullptr);
+    _sharedAvatarData.minimumDelta = _avatar->toByteArray(AvatarData::MinimumData, _sharedAvatarData.encodeTime,
+        _sharedLastSentJoints, hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, nullptr);
+    _sharedAvatarData.palMinimum = _avatar->toByteArray(AvatarData::PALMinimum, 0, _sharedLastSentJoints,
+        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, nullptr);
+
+    _sharedAvatarData.previousEncodeTime = _sharedAvatarData.encodeTime;
+    _sharedAvatarData.encodeTime = now;
+}
+
 uint64_t AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastTimes.find(nodeUUID);
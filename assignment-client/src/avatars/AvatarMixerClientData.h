@@ -110,6 +110,18 @@ public:
 
     ViewFrustum getViewFrustom() const { return _currentViewFrustum; }
 
+    // where the next slice of avatars outside of this node's view starts, when the avatar grid is in use
+    size_t getOutOfViewCursor() const { return _outOfViewCursor; }
+    void setOutOfViewCursor(size_t cursor) { _outOfViewCursor = cursor; }
+
+    // the camera position and direction all other avatars were last considered for, when the avatar grid is in use
+    const glm::vec3& getFullRefreshPosition() const { return _fullRefreshPosition; }
+    const glm::vec3& getFullRefreshDirection() const { return _fullRefreshDirection; }
+    void setFullRefreshView(const glm::vec3& position, const glm::vec3& direction) {
+        _fullRefreshPosition = position;
+        _fullRefreshDirection = direction;
+    }
+
     quint64 getLastOtherAvatarEncodeTime(QUuid otherAvatar) {
         quint64 result = 0;
         if (_lastOtherAvatarEncodeTime.find(otherAvatar) != _lastOtherAvatarEncodeTime.end()) {
@@ -127,6 +139,20 @@ public:
     void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
     int processPackets(); // returns number of packets processed
 
+    // the detail tiers of this avatar, encoded once per frame and shared by every receiver
+    struct SharedAvatarData {
+        QByteArray full;            // SendAllData
+        QByteArray minimum;         // MinimumData, with every field
+        QByteArray minimumDelta;    // MinimumData, with the fields changed since the previous encode
+        QByteArray palMinimum;      // PALMinimum
+        QVector<JointData> fullJoints; // the joints a receiver of the full tier holds
+        quint64 encodeTime { 0 };
+        quint64 previousEncodeTime { 0 };
+    };
+
+    void encodeSharedAvatarData(bool quantizedJointData);
+    const SharedAvatarData& getSharedAvatarData() const { return _sharedAvatarData; }
+
 private:
     struct PacketQueue : public std::queue<QSharedPointer<ReceivedMessage>> {
         QWeakPointer<Node> node;
@@ -134,6 +160,8 @@ private:
     PacketQueue _packetQueue;
 
     AvatarSharedPointer _avatar { new AvatarData() };
+    SharedAvatarData _sharedAvatarData;
+    QVector<JointData> _sharedLastSentJoints;
 
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
@@ -162,6 +190,9 @@ private:
     int _recentOtherAvatarsOutOfView { 0 };
     QString _baseDisplayName{}; // The santized key used in determinging unique sessionDisplayName, so that we can remove from dictionary.
     bool _requestsDomainListData { false };
+    size_t _outOfViewCursor { 0 };
+    glm::vec3 _fullRefreshPosition;
+    glm::vec3 _fullRefreshDirection;
 };
 
 #endif // hifi_AvatarMixerClientData_h
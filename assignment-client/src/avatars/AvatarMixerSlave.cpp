@@ -29,6 +29,7 @@
 
 
 #include "AvatarMixer.h"
+#include "AvatarMixerAvatarGrid.h"
 #include "AvatarMixerClientData.h"
 #include "AvatarMixerSlave.h"
 
@@ -38,14 +39,24 @@ void AvatarMixerSlave::configure(ConstIter begin, ConstIter end) {
     _end = end;
 }
 
+void AvatarMixerSlave::configureEncode(ConstIter begin, ConstIter end, bool quantizedJointData) {
+    _begin = begin;
+    _end = end;
+    _quantizedJointData = quantizedJointData;
+}
+
 void AvatarMixerSlave::configureBroadcast(ConstIter begin, ConstIter end, 
                                 p_high_resolution_clock::time_point lastFrameTimestamp,
-                                float maxKbpsPerNode, float throttlingRatio) {
+                                float maxKbpsPerNode, float throttlingRatio, bool sharedAvatarEncoding,
+                                bool quantizedJointData, const AvatarMixerAvatarGrid* avatarGrid) {
     _begin = begin;
     _end = end;
     _lastFrameTimestamp = lastFrameTimestamp;
     _maxKbpsPerNode = maxKbpsPerNode;
     _throttlingRatio = throttlingRatio;
+    _sharedAvatarEncoding = sharedAvatarEncoding;
+    _quantizedJointData = quantizedJointData;
+    _avatarGrid = avatarGrid;
 }
 
 void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
@@ -65,6 +76,16 @@ void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     _stats.processIncomingPacketsElapsedTime += (end - start);
 }
 
+void AvatarMixerSlave::encodeAvatarData(const SharedNodePointer& node) {
+    auto start = usecTimestampNow();
+    auto nodeData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
+    if (nodeData) {
+        nodeData->encodeSharedAvatarData(_quantizedJointData);
+    }
+    auto end = usecTimestampNow();
+    _stats.encodeAvatarDataElapsedTime += (end - start);
+}
+
 
 int AvatarMixerSlave::sendIdentityPacket(const AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode) {
     QByteArray individualData = nodeData->getConstAvatarData()->identityByteArray();
@@ -77,6 +98,80 @@ int AvatarMixerSlave::sendIdentityPacket(const AvatarMixerClientData* nodeData,
 }
 
 static const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 45;
+static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
+
+// with the avatar grid, avatars outside of a receiver's view and distance are refreshed over this many frames (~200ms)
+static const size_t OUT_OF_VIEW_REFRESH_FRAMES = AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND / 5;
+
+// and all of them are considered again once the receiver turns or moves this much, since the view we have
+// lags the receiver's by a round trip and the avatars coming into view may be a refresh out of date
+static const float FULL_REFRESH_MIN_DOT = 0.9f; // ~25 degrees
+static const float FULL_REFRESH_DISTANCE_SCALE = 0.5f; // of the grid distance
+
+QByteArray AvatarMixerSlave::sharedAvatarDataBytes(const AvatarMixerClientData* otherNodeData, AvatarData::AvatarDataDetail detail,
+                    quint64 lastEncodeForOther, const QVector<JointData>& lastSentJointsForOther,
+                    QVector<JointData>& sentJointsForOther, glm::vec3 viewerPosition) {
+    const auto& sharedData = otherNodeData->getSharedAvatarData();
+
+    // nodes that joined after this frame's encode have no tiers yet
+    if (sharedData.encodeTime == 0) {
+        return QByteArray();
+    }
+
+    // the delta tier only holds the fields changed since the previous frame's encode,
+    // so it is only complete for receivers that were sent this avatar since then
+    bool isCurrent = lastEncodeForOther != 0 && lastEncodeForOther >= sharedData.previousEncodeTime;
+
+    QByteArray bytes;
+    switch (detail) {
+        case AvatarData::PALMinimum:
+            bytes = sharedData.palMinimum;
+            break;
+        case AvatarData::MinimumData:
+            bytes = isCurrent ? sharedData.minimumDelta : sharedData.minimum;
+            break;
+        case AvatarData::SendAllData:
+            bytes = sharedData.full;
+            // the full tier resyncs every joint this receiver has for the avatar
+            sentJointsForOther = sharedData.fullJoints;
+            break;
+        case AvatarData::CullSmallData: {
+            const QByteArray& header = isCurrent ? sharedData.minimumDelta : sharedData.minimum;
+            bytes = QByteArray(header.size() + udt::MAX_PACKET_SIZE, 0);
+            memcpy(bytes.data(), header.constData(), header.size());
+
+            // the joint data is the last section of the packet, so flag it and append this receiver's joint deltas
+            AvatarDataPacket::HasFlags hasFlags;
+            memcpy(&hasFlags, bytes.constData(), sizeof(hasFlags));
+            hasFlags |= AvatarDataPacket::PACKET_HAS_JOINT_DATA;
+            if (_quantizedJointData) {
+                hasFlags |= AvatarDataPacket::PACKET_HAS_QUANTIZED_JOINT_DATA;
+            }
+            memcpy(bytes.data(), &hasFlags, sizeof(hasFlags));
+
+            const bool sendAll = false;
+            const bool cullSmallChanges = true;
+            const bool distanceAdjust = true;
+            const bool recordSentJoints = true;
+            auto destinationBuffer = reinterpret_cast<unsigned char*>(bytes.data()) + header.size();
+            int maxJointBytes = bytes.size() - header.size();
+            int numJointBytes = otherNodeData->getConstAvatarData()->packJointData(destinationBuffer, maxJointBytes,
+                sendAll, cullSmallChanges, lastSentJointsForOther, distanceAdjust, viewerPosition, &sentJointsForOther,
+                _quantizedJointData, recordSentJoints);
+            bytes.resize(header.size() + numJointBytes);
+            break;
+        }
+        default:
+            // NoData is cheaper to build than to share
+            return QByteArray();
+    }
+
+    // leave oversized avatars to the per-receiver encode, which knows how to trim them
+    if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
+        return QByteArray();
+    }
+    return bytes;
+}
 
 void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
     quint64 start = usecTimestampNow();
@@ -160,7 +255,7 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
         QList<AvatarSharedPointer> avatarList;
         std::unordered_map<AvatarSharedPointer, SharedNodePointer> avatarDataToNodes;
 
-        std::for_each(_begin, _end, [&](const SharedNodePointer& otherNode) {
+        auto considerNode = [&](const SharedNodePointer& otherNode) {
             const AvatarMixerClientData* otherNodeData = reinterpret_cast<const AvatarMixerClientData*>(otherNode->getLinkedData());
 
             // theoretically it's possible for a Node to be in the NodeList (and therefore end up here),
@@ -171,10 +266,47 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
                 avatarList << otherAvatar;
                 avatarDataToNodes[otherAvatar] = otherNode;
             }
-        });
+        };
 
         AvatarSharedPointer thisAvatar = nodeData->getAvatarSharedPointer();
         ViewFrustum cameraView = nodeData->getViewFrustom();
+
+        // the PAL lists every avatar, so it bypasses the grid
+        bool needsFullRefresh = true;
+        if (_avatarGrid && !PALIsOpen) {
+            float refreshDistance = FULL_REFRESH_DISTANCE_SCALE * _avatarGrid->getDistance();
+            needsFullRefresh =
+                glm::dot(cameraView.getDirection(), nodeData->getFullRefreshDirection()) < FULL_REFRESH_MIN_DOT ||
+                glm::distance2(cameraView.getPosition(), nodeData->getFullRefreshPosition()) > refreshDistance * refreshDistance;
+        }
+
+        if (!needsFullRefresh) {
+            // consider the avatars in view or within the grid distance...
+            std::vector<uint32_t> indices;
+            _avatarGrid->query(cameraView, indices);
+            std::sort(indices.begin(), indices.end());
+            for (uint32_t index : indices) {
+                considerNode(_avatarGrid->getNode(index));
+            }
+
+            // ...and a slice of the others, so that every avatar is still refreshed
+            size_t numAvatars = _avatarGrid->size();
+            if (numAvatars > 0) {
+                size_t sliceSize = (numAvatars + OUT_OF_VIEW_REFRESH_FRAMES - 1) / OUT_OF_VIEW_REFRESH_FRAMES;
+                size_t cursor = nodeData->getOutOfViewCursor() % numAvatars;
+                for (size_t i = 0; i < sliceSize; ++i) {
+                    uint32_t index = (uint32_t)((cursor + i) % numAvatars);
+                    if (!std::binary_search(indices.begin(), indices.end(), index)) {
+                        considerNode(_avatarGrid->getNode(index));
+                    }
+                }
+                nodeData->setOutOfViewCursor((cursor + sliceSize) % numAvatars);
+            }
+        } else {
+            std::for_each(_begin, _end, considerNode);
+            nodeData->setFullRefreshView(cameraView.getPosition(), cameraView.getDirection());
+        }
+        _stats.numOthersConsidered += avatarList.size();
         std::priority_queue<AvatarPriority> sortedAvatars;
         AvatarData::sortAvatars(avatarList, cameraView, sortedAvatars,
 
@@ -334,29 +466,48 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
             bool includeThisAvatar = true;
             auto lastEncodeForOther = nodeData->getLastOtherAvatarEncodeTime(otherNode->getUUID());
             QVector<JointData>& lastSentJointsForOther = nodeData->getLastOtherAvatarSentJoints(otherNode->getUUID());
+            if (_quantizedJointData && nodeData->getLastBroadcastTime(otherNode->getUUID()) == 0) {
+                // the receiver holds no joints for an avatar it has not been sent, so don't predict from any
+                lastSentJointsForOther.fill(JointData());
+            }
+            // quantized joint deltas are predicted from what the receiver holds, which only changes if these bytes are sent
+            QVector<JointData> sentJointsForOther = lastSentJointsForOther;
             bool distanceAdjust = true;
             glm::vec3 viewerPosition = myPosition;
             AvatarDataPacket::HasFlags hasFlagsOut; // the result of the toByteArray
             bool dropFaceTracking = false;
 
             quint64 start = usecTimestampNow();
-            QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther, 
-                                            hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+            QByteArray bytes;
+            if (_sharedAvatarEncoding) {
+                bytes = sharedAvatarDataBytes(otherNodeData, detail, lastEncodeForOther, lastSentJointsForOther,
+                                              sentJointsForOther, viewerPosition);
+            }
+            if (bytes.isEmpty()) {
+                bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
+                                            hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &sentJointsForOther,
+                                            nullptr, _quantizedJointData);
+            } else {
+                _stats.numSharedEncodes++;
+            }
             quint64 end = usecTimestampNow();
             _stats.toByteArrayElapsedTime += (end - start);
 
-            static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
             if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
                 qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
 
                 dropFaceTracking = true; // first try dropping the facial data
+                sentJointsForOther = lastSentJointsForOther;
                 bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                    hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &sentJointsForOther,
+                    nullptr, _quantizedJointData);
 
                 if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
                     qCWarning(avatars) << "otherAvatar.toByteArray() without facial data resulted in very large buffer:" << bytes.size() << "... reduce to MinimumData";
+                    sentJointsForOther = lastSentJointsForOther;
                     bytes = otherAvatar->toByteArray(AvatarData::MinimumData, lastEncodeForOther, lastSentJointsForOther,
-                        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &lastSentJointsForOther);
+                        hasFlagsOut, dropFaceTracking, distanceAdjust, viewerPosition, &sentJointsForOther,
+                        nullptr, _quantizedJointData);
                 }
 
                 if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
@@ -368,6 +519,7 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
             if (includeThisAvatar) {
                 numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
                 numAvatarDataBytes += avatarPacketList->write(bytes);
+                lastSentJointsForOther = sentJointsForOther;
 
                 if (detail != AvatarData::NoData) {
                     _stats.numOthersIncluded++;
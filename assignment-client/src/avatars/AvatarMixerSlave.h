@@ -12,6 +12,9 @@
 #ifndef hifi_AvatarMixerSlave_h
 #define hifi_AvatarMixerSlave_h
 
+#include <AvatarData.h>
+
+class AvatarMixerAvatarGrid;
 class AvatarMixerClientData;
 
 class AvatarMixerSlaveStats {
@@ -26,7 +29,10 @@ public:
     int numIdentityPackets { 0 };
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
+    int numSharedEncodes { 0 };
+    int numOthersConsidered { 0 };
 
+    quint64 encodeAvatarDataElapsedTime { 0 };
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
     quint64 packetSendingElapsedTime { 0 };
@@ -46,7 +52,10 @@ public:
         numIdentityPackets = 0;
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
+        numSharedEncodes = 0;
+        numOthersConsidered = 0;
 
+        encodeAvatarDataElapsedTime = 0;
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
         packetSendingElapsedTime = 0;
@@ -65,7 +74,10 @@ public:
         numIdentityPackets += rhs.numIdentityPackets;
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
+        numSharedEncodes += rhs.numSharedEncodes;
+        numOthersConsidered += rhs.numOthersConsidered;
 
+        encodeAvatarDataElapsedTime += rhs.encodeAvatarDataElapsedTime;
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
         packetSendingElapsedTime += rhs.packetSendingElapsedTime;
@@ -81,11 +93,14 @@ public:
     using ConstIter = NodeList::const_iterator;
 
     void configure(ConstIter begin, ConstIter end);
+    void configureEncode(ConstIter begin, ConstIter end, bool quantizedJointData);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
-                    float maxKbpsPerNode, float throttlingRatio);
+                    float maxKbpsPerNode, float throttlingRatio, bool sharedAvatarEncoding, bool quantizedJointData,
+                    const AvatarMixerAvatarGrid* avatarGrid = nullptr);
 
     void processIncomingPackets(const SharedNodePointer& node);
+    void encodeAvatarData(const SharedNodePointer& node);
     void broadcastAvatarData(const SharedNodePointer& node);
 
     void harvestStats(AvatarMixerSlaveStats& stats);
@@ -93,6 +108,12 @@ public:
 private:
     int sendIdentityPacket(const AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode);
 
+    // builds the bytes for another avatar from the tiers shared by every receiver,
+    // returns an empty array if this receiver needs its own encode
+    QByteArray sharedAvatarDataBytes(const AvatarMixerClientData* otherNodeData, AvatarData::AvatarDataDetail detail,
+                    quint64 lastEncodeForOther, const QVector<JointData>& lastSentJointsForOther,
+                    QVector<JointData>& sentJointsForOther, glm::vec3 viewerPosition);
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
@@ -100,6 +121,9 @@ private:
     p_high_resolution_clock::time_point _lastFrameTimestamp;
     float _maxKbpsPerNode { 0.0f };
     float _throttlingRatio { 0.0f };
+    bool _sharedAvatarEncoding { false };
+    bool _quantizedJointData { false };
+    const AvatarMixerAvatarGrid* _avatarGrid { nullptr };
 
     AvatarMixerSlaveStats _stats;
 };
@@ -75,12 +75,22 @@ void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end
     run(begin, end);
 }
 
+void AvatarMixerSlavePool::encodeAvatarData(ConstIter begin, ConstIter end, bool quantizedJointData) {
+    _function = &AvatarMixerSlave::encodeAvatarData;
+    _configure = [&](AvatarMixerSlave& slave) {
+        slave.configureEncode(begin, end, quantizedJointData);
+    };
+    run(begin, end);
+}
+
 void AvatarMixerSlavePool::broadcastAvatarData(ConstIter begin, ConstIter end, 
                                      p_high_resolution_clock::time_point lastFrameTimestamp, 
-                                     float maxKbpsPerNode, float throttlingRatio) {
+                                     float maxKbpsPerNode, float throttlingRatio, bool sharedAvatarEncoding,
+                                     bool quantizedJointData, const AvatarMixerAvatarGrid* avatarGrid) {
     _function = &AvatarMixerSlave::broadcastAvatarData;
     _configure = [&](AvatarMixerSlave& slave) { 
-        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio);
+        slave.configureBroadcast(begin, end, lastFrameTimestamp, maxKbpsPerNode, throttlingRatio,
+                                 sharedAvatarEncoding, quantizedJointData, avatarGrid);
    };
     run(begin, end);
 }
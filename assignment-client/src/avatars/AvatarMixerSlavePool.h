@@ -65,8 +65,10 @@ public:
 
     // Jobs the slave pool can do...
     void processIncomingPackets(ConstIter begin, ConstIter end);
+    void encodeAvatarData(ConstIter begin, ConstIter end, bool quantizedJointData);
     void broadcastAvatarData(ConstIter begin, ConstIter end, 
-                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio);
+                    p_high_resolution_clock::time_point lastFrameTimestamp, float maxKbpsPerNode, float throttlingRatio,
+                    bool sharedAvatarEncoding, bool quantizedJointData, const AvatarMixerAvatarGrid* avatarGrid = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AvatarMixerSlave& slave)> functor);
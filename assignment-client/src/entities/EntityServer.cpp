@@ -354,6 +354,7 @@ void EntityServer::trackViewerGone(const QUuid& sessionID) {
 QString EntityServer::serverSubclassStats() {
     QLocale locale(QLocale::English);
     QString statsString;
+    const int COLUMN_WIDTH = 24;
 
     // display memory usage stats
     statsString += "<b>Entity Server Memory Statistics</b>\r\n";
@@ -361,12 +362,32 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // display encode cache stats
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    EntityEncodeCache::Stats encodeCacheStats = tree->getEncodeCache().getStats();
+    quint64 encodeCacheLookups = encodeCacheStats.hits + encodeCacheStats.misses;
+    float encodeCacheHitRate = encodeCacheLookups > 0 ? (float)encodeCacheStats.hits / (float)encodeCacheLookups : 0.0f;
+
+    statsString += "<b>Entity Server Encode Cache Statistics</b>\r\n";
+    statsString += QString("           Cached Entities: %1\r\n")
+        .arg(locale.toString(encodeCacheStats.entries).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                      Hits: %1\r\n")
+        .arg(locale.toString(encodeCacheStats.hits).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                    Misses: %1\r\n")
+        .arg(locale.toString(encodeCacheStats.misses).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                  Hit Rate: %1 %\r\n")
+        .arg(locale.toString(encodeCacheHitRate * 100.0f, 'f', 2).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("                    Stores: %1\r\n")
+        .arg(locale.toString(encodeCacheStats.stores).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += QString("              Bytes Served: %1 bytes\r\n")
+        .arg(locale.toString(encodeCacheStats.bytesServed).rightJustified(COLUMN_WIDTH, ' '));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
 
     int viewers = 0;
-    const int COLUMN_WIDTH = 24;
 
     {
         QReadLocker locker(&_viewerSendingStatsLock);
@@ -11,11 +11,17 @@
 
 #include "EntityTreeSendThread.h"
 
+#include <algorithm>
+
 #include <EntityNodeData.h>
 #include <EntityTypes.h>
+#include <OctalCode.h>
 
 #include "EntityServer.h"
 
+// past this many changed elements it's cheaper to walk the tree from the root than to traverse each one
+const size_t MAX_CHANGED_ELEMENTS_TO_TRAVERSE = 256;
+
 void EntityTreeSendThread::preDistributionProcessing() {
     auto node = _node.toStrongRef();
     auto nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
@@ -31,15 +37,16 @@ void EntityTreeSendThread::preDistributionProcessing() {
             bool includeAncestors = flags[EntityJSONQueryProperties::INCLUDE_ANCESTORS_PROPERTY].toBool();
             bool includeDescendants = flags[EntityJSONQueryProperties::INCLUDE_DESCENDANTS_PROPERTY].toBool();
 
-            if (includeAncestors || includeDescendants) {
+            auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
+
+            if ((includeAncestors || includeDescendants)
+                && shouldResolveFlaggedExtraEntities(*entityTree, *nodeData, includeAncestors, includeDescendants)) {
                 // we need to either include the ancestors, descendants, or both for entities matching the filter
                 // included in the JSON query
 
                 // first reset our flagged extra entities so we start with an empty set
                 nodeData->resetFlaggedExtraEntities();
 
-                auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
-
                 bool requiresFullScene = false;
 
                 // enumerate the set of entity IDs we know currently match the filter
@@ -80,6 +87,103 @@ void EntityTreeSendThread::preDistributionProcessing() {
     }
 }
 
+bool EntityTreeSendThread::shouldResolveFlaggedExtraEntities(EntityTree& entityTree, EntityNodeData& nodeData,
+                                                             bool includeAncestors, bool includeDescendants) {
+    // The ancestors and descendants of the filtered entities can only change when entities are added, deleted or
+    // re-parented, or when the set of filtered entities itself changes. Otherwise the extra entities we found last
+    // time are still the right ones, and we can skip finding every filtered entity and its relatives again.
+    quint64 changeSequence = entityTree.getChangeJournal().getLastSequence();
+    QSet<QUuid> filteredEntities = nodeData.getSentFilteredEntities();
+
+    bool shouldResolve = !_hasResolvedFlaggedExtraEntities
+        || includeAncestors != _resolvedIncludeAncestors || includeDescendants != _resolvedIncludeDescendants
+        || filteredEntities != _resolvedFilteredEntities;
+
+    if (!shouldResolve) {
+        bool changesAvailable = entityTree.getChangeJournal().forEachChangeSince(_resolvedChangeSequence,
+                                                                                 [&](const EntityChange& change) {
+            shouldResolve |= change.type == EntityChange::Added || change.type == EntityChange::Deleted
+                || change.changedProperties.getHasProperty(PROP_PARENT_ID);
+        });
+        shouldResolve |= !changesAvailable;
+    }
+
+    if (shouldResolve) {
+        _hasResolvedFlaggedExtraEntities = true;
+        _resolvedIncludeAncestors = includeAncestors;
+        _resolvedIncludeDescendants = includeDescendants;
+        _resolvedFilteredEntities = filteredEntities;
+    }
+    _resolvedChangeSequence = changeSequence;
+
+    return shouldResolve;
+}
+
+void EntityTreeSendThread::startSceneTraversal(OctreeQueryNode* nodeData, bool isFullScene, bool viewFrustumChanged) {
+    auto entityTree = std::static_pointer_cast<EntityTree>(_myServer->getOctree());
+    const EntityChangeJournal& changeJournal = entityTree->getChangeJournal();
+
+    // anything changed after this will be picked up by the next scene
+    quint64 changeSequence = changeJournal.getLastSequence();
+
+    // a scene is only started with elements left in the bag when it was cut short by a view change
+    bool previousSceneCompleted = nodeData->elementBag.isEmpty();
+
+    // If our last scene went out completely and neither the view nor the query has changed, the only elements with
+    // anything new for this client are those holding entities that changed since that scene started. Rather than
+    // walking down from the root to find them, go straight to them.
+    QHash<EntityItemID, EntityChange> changesByEntity;
+    if (!isFullScene && !viewFrustumChanged && previousSceneCompleted && _hasSceneChangeSequence
+        && changeJournal.getChangesByEntitySince(_sceneChangeSequence, changesByEntity)) {
+        std::vector<OctreeElementPointer> changedElements;
+        for (auto& change : changesByEntity) {
+            // deleted entities go out in their own erase packets
+            if (change.type == EntityChange::Deleted) {
+                continue;
+            }
+            auto element = entityTree->getContainingElement(change.entityID);
+            if (element) {
+                changedElements.push_back(element);
+            }
+        }
+
+        // several changed entities can share an element
+        std::sort(changedElements.begin(), changedElements.end());
+        changedElements.erase(std::unique(changedElements.begin(), changedElements.end()), changedElements.end());
+
+        if (changedElements.size() <= MAX_CHANGED_ELEMENTS_TO_TRAVERSE) {
+            // each element is traversed along with its changed descendants, so skip any element that is
+            // (or is below) one we are already going to traverse
+            std::sort(changedElements.begin(), changedElements.end(), [](const OctreeElementPointer& a,
+                                                                          const OctreeElementPointer& b) {
+                return a->getLevel() < b->getLevel();
+            });
+
+            std::vector<OctreeElementPointer> elementsToTraverse;
+            for (auto& element : changedElements) {
+                bool isCovered = std::any_of(elementsToTraverse.begin(), elementsToTraverse.end(),
+                                             [&](const OctreeElementPointer& traversed) {
+                    return isAncestorOf(traversed->getOctalCode(), element->getOctalCode());
+                });
+                if (!isCovered) {
+                    elementsToTraverse.push_back(element);
+                }
+            }
+
+            for (auto& element : elementsToTraverse) {
+                nodeData->elementBag.insert(element);
+            }
+
+            _sceneChangeSequence = changeSequence;
+            return;
+        }
+    }
+
+    OctreeSendThread::startSceneTraversal(nodeData, isFullScene, viewFrustumChanged);
+    _sceneChangeSequence = changeSequence;
+    _hasSceneChangeSequence = true;
+}
+
 bool EntityTreeSendThread::addAncestorsToExtraFlaggedEntities(const QUuid& filteredEntityID,
                                                               EntityItem& entityItem, EntityNodeData& nodeData) {
     // check if this entity has a parent that is also an entity
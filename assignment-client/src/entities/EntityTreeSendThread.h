@@ -12,10 +12,14 @@
 #ifndef hifi_EntityTreeSendThread_h
 #define hifi_EntityTreeSendThread_h
 
+#include <QtCore/QSet>
+#include <QtCore/QUuid>
+
 #include "../octree/OctreeSendThread.h"
 
 class EntityNodeData;
 class EntityItem;
+class EntityTree;
 
 class EntityTreeSendThread : public OctreeSendThread {
 
@@ -24,12 +28,27 @@ public:
 
 protected:
     virtual void preDistributionProcessing() override;
+    virtual void startSceneTraversal(OctreeQueryNode* nodeData, bool isFullScene, bool viewFrustumChanged) override;
 
 private:
+    // returns true if the filtered entities or their relatives may have changed since we last resolved them
+    bool shouldResolveFlaggedExtraEntities(EntityTree& entityTree, EntityNodeData& nodeData,
+                                           bool includeAncestors, bool includeDescendants);
+
     // the following two methods return booleans to indicate if any extra flagged entities were new additions to set
     bool addAncestorsToExtraFlaggedEntities(const QUuid& filteredEntityID, EntityItem& entityItem, EntityNodeData& nodeData);
     bool addDescendantsToExtraFlaggedEntities(const QUuid& filteredEntityID, EntityItem& entityItem, EntityNodeData& nodeData);
 
+    // entity change journal sequence at the start of the current scene
+    quint64 _sceneChangeSequence { 0 };
+    bool _hasSceneChangeSequence { false };
+
+    // what our flagged extra entities were last resolved for
+    quint64 _resolvedChangeSequence { 0 };
+    QSet<QUuid> _resolvedFilteredEntities;
+    bool _resolvedIncludeAncestors { false };
+    bool _resolvedIncludeDescendants { false };
+    bool _hasResolvedFlaggedExtraEntities { false };
 };
 
 #endif // hifi_EntityTreeSendThread_h
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
@@ -30,40 +32,86 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto nodeChannels = _nodeChannels.find(killedNode->getUUID());
+    if (nodeChannels != _nodeChannels.end()) {
+        for (auto& channel : nodeChannels.value()) {
+            removeSubscriber(channel, killedNode->getUUID());
+        }
+        _nodeChannels.erase(nodeChannels);
+    }
+}
+
+void MessagesMixer::removeSubscriber(const QString& channel, const QUuid& nodeID) {
+    auto subscribers = _channelSubscribers.find(channel);
+    if (subscribers != _channelSubscribers.end()) {
+        auto& subscriberIDs = subscribers.value();
+        subscriberIDs.erase(std::remove(subscriberIDs.begin(), subscriberIDs.end(), nodeID), subscriberIDs.end());
+        if (subscriberIDs.empty()) {
+            _channelSubscribers.erase(subscribers);
+        }
     }
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QByteArray data;
-    QUuid senderID;
+    // only the channel is needed for routing - the rest of the payload is forwarded exactly as the sender encoded it,
+    // so the message is never decoded or re-encoded per subscriber
+    quint16 channelLength;
+    receivedMessage->readPrimitive(&channelLength);
+    QString channel = QString::fromUtf8(receivedMessage->read(channelLength));
+
+    auto subscribers = _channelSubscribers.constFind(channel);
+    if (subscribers == _channelSubscribers.constEnd()) {
+        return;
+    }
+
     bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    quint32 messageLength;
+    receivedMessage->readPrimitive(&isText);
+    receivedMessage->readPrimitive(&messageLength);
+
+    qint64 sizeWithoutSenderID = receivedMessage->getPosition() + messageLength;
+    if (receivedMessage->getSize() < sizeWithoutSenderID) {
+        qDebug() << "MessagesMixer dropping truncated message on channel" << channel << "from" << senderNode->getUUID();
+        return;
+    }
+
+    QByteArray payload = receivedMessage->getMessage();
+    if (payload.size() < sizeWithoutSenderID + NUM_BYTES_RFC4122_UUID) {
+        // match what MessagesClient::decodeMessagesPacket would have re-encoded for a packet missing its sender
+        payload.truncate(sizeWithoutSenderID);
+        payload.append(QUuid().toRfc4122());
+    }
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    for (const QUuid& subscriberID : subscribers.value()) {
+        auto node = nodeList->nodeWithUUID(subscriberID);
+        if (node && node->getActiveSocket()) {
+            // each recipient still needs its own packets for the per-connection header, but they are a straight copy
+            auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+            packetList->write(payload);
+            nodeList->sendPacketList(std::move(packetList), *node);
+        }
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    _channelSubscribers[channel] << senderNode->getUUID();
+    auto& nodeChannels = _nodeChannels[senderNode->getUUID()];
+    if (!nodeChannels.contains(channel)) {
+        nodeChannels.insert(channel);
+        _channelSubscribers[channel].push_back(senderNode->getUUID());
+    }
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    auto nodeChannels = _nodeChannels.find(senderNode->getUUID());
+    if (nodeChannels != _nodeChannels.end() && nodeChannels.value().remove(channel)) {
+        removeSubscriber(channel, senderNode->getUUID());
+        if (nodeChannels.value().isEmpty()) {
+            _nodeChannels.erase(nodeChannels);
+        }
     }
 }
 
@@ -80,6 +128,7 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+    statsObject["subscribed_channels"] = _channelSubscribers.size();
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
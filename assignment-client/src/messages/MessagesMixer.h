@@ -15,6 +15,8 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <vector>
+
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -34,7 +36,10 @@ private slots:
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    void removeSubscriber(const QString& channel, const QUuid& nodeID);
+
+    QHash<QString, std::vector<QUuid>> _channelSubscribers; // subscriber list per channel, walked on every message
+    QHash<QUuid, QSet<QString>> _nodeChannels; // channels per node, so a killed node only touches its own channels
 };
 
 #endif // hifi_MessagesMixer_h
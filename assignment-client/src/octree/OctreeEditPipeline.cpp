@@ -0,0 +1,300 @@
+//
+//  OctreeEditPipeline.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditPipeline.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+#include <SharedUtil.h>
+
+// limits on how much is applied under one hold of the tree write lock, so that send threads waiting on the read lock
+// aren't held off for long when a burst of edits comes in
+const int MAX_PACKETS_PER_BATCH = 64;
+const int MAX_EDITS_PER_BATCH = 256;
+
+// how long the threads wait for work before checking if they are stopping
+const unsigned long PIPELINE_WAIT_MSECS = 100;
+
+class OctreeEditPipeline::Worker : public GenericThread {
+public:
+    Worker(OctreeEditPipeline& pipeline, int index) : _pipeline(pipeline) {
+        setObjectName(QString("Octree Edit Decode Worker %1").arg(index));
+    }
+
+protected:
+    virtual bool process() override {
+        if (auto packet = _pipeline.takeDecodeWork()) {
+            _pipeline.prepare(*packet);
+            _pipeline.finishDecode(std::move(packet));
+        }
+        return isStillRunning();
+    }
+
+private:
+    OctreeEditPipeline& _pipeline;
+};
+
+OctreeEditPipeline::OctreeEditPipeline(OctreePointer tree, PacketTracker packetTracker, int workerCount) :
+    _tree(tree),
+    _packetTracker(packetTracker)
+{
+    setObjectName("Octree Edit Pipeline");
+
+    if (workerCount <= 0) {
+        workerCount = std::max(1, QThread::idealThreadCount());
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(new Worker(*this, i));
+        _workers.back()->initialize(true);
+    }
+
+    qDebug() << "Octree edit pipeline started with" << workerCount << "decode workers";
+}
+
+OctreeEditPipeline::~OctreeEditPipeline() {
+    // our terminating() has to run before we lose our subclass, so don't leave this to ~GenericThread
+    if (isStillRunning() && isThreaded()) {
+        terminate();
+    }
+    terminating();
+}
+
+void OctreeEditPipeline::terminating() {
+    {
+        QMutexLocker locker(&_queuesMutex);
+        _isStopping = true;
+        _decodeWorkReady.wakeAll();
+        _applyWorkReady.wakeAll();
+    }
+
+    for (auto& worker : _workers) {
+        worker->terminate();
+    }
+}
+
+void OctreeEditPipeline::queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode,
+                                     unsigned short int sequence, quint64 transitTime) {
+    QueuedPacketPointer packet { new QueuedPacket() };
+    packet->message = message;
+    packet->sendingNode = sendingNode;
+    if (sendingNode) {
+        packet->nodeUUID = sendingNode->getUUID();
+    }
+    packet->sequence = sequence;
+    packet->transitTime = transitTime;
+
+    QMutexLocker locker(&_queuesMutex);
+    if (_isStopping) {
+        return;
+    }
+
+    packet->ticket = _nextTicket++;
+    _packetsByNode[packet->nodeUUID]++;
+    _decodeQueue.push_back(std::move(packet));
+
+    int depth = (int)_decodeQueue.size();
+    if (depth > _maxDecodeQueueDepth) {
+        _maxDecodeQueueDepth = depth;
+    }
+
+    _decodeWorkReady.wakeOne();
+}
+
+bool OctreeEditPipeline::hasPacketsFrom(const QUuid& nodeUUID) const {
+    QMutexLocker locker(&_queuesMutex);
+    return _packetsByNode.value(nodeUUID, 0) > 0;
+}
+
+int OctreeEditPipeline::getDecodeQueueDepth() const {
+    QMutexLocker locker(&_queuesMutex);
+    return (int)_decodeQueue.size();
+}
+
+int OctreeEditPipeline::getApplyQueueDepth() const {
+    QMutexLocker locker(&_queuesMutex);
+    return (int)_applyQueue.size();
+}
+
+void OctreeEditPipeline::resetStats() {
+    _maxDecodeQueueDepth = 0;
+    _maxApplyQueueDepth = 0;
+    _totalBatches = 0;
+    _totalBatchedPackets = 0;
+    _totalBatchedEdits = 0;
+    _totalBatchLockTime = 0;
+}
+
+OctreeEditPipeline::QueuedPacketPointer OctreeEditPipeline::takeDecodeWork() {
+    QMutexLocker locker(&_queuesMutex);
+
+    if (_decodeQueue.empty() && !_isStopping) {
+        _decodeWorkReady.wait(&_queuesMutex, PIPELINE_WAIT_MSECS);
+    }
+
+    if (_decodeQueue.empty() || _isStopping) {
+        return QueuedPacketPointer();
+    }
+
+    QueuedPacketPointer packet = std::move(_decodeQueue.front());
+    _decodeQueue.pop_front();
+    return packet;
+}
+
+void OctreeEditPipeline::prepare(QueuedPacket& packet) {
+    quint64 startPrepare = usecTimestampNow();
+
+    ReceivedMessage& message = *packet.message;
+    packet.isPrepared = _tree->canPrepareEditPacketType(message.getType());
+
+    if (packet.isPrepared) {
+        while (message.getBytesLeftToRead() > 0) {
+            const unsigned char* editData =
+                reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+            int maxSize = message.getBytesLeftToRead();
+
+            Octree::PreparedEditPointer edit;
+            int editDataBytesRead = _tree->prepareEditPacketData(message, editData, maxSize, packet.sendingNode, edit);
+            if (edit) {
+                packet.edits.push_back(std::move(edit));
+            }
+            if (editDataBytesRead <= 0) {
+                break;
+            }
+
+            // skip to next edit record in the packet
+            message.seek(message.getPosition() + editDataBytesRead);
+        }
+    }
+
+    packet.prepareTime = usecTimestampNow() - startPrepare;
+}
+
+void OctreeEditPipeline::finishDecode(QueuedPacketPointer packet) {
+    QMutexLocker locker(&_queuesMutex);
+
+    bool isNextToApply = packet->ticket == _nextTicketToApply;
+    _applyQueue[packet->ticket] = std::move(packet);
+
+    int depth = (int)_applyQueue.size();
+    if (depth > _maxApplyQueueDepth) {
+        _maxApplyQueueDepth = depth;
+    }
+
+    if (isNextToApply) {
+        _applyWorkReady.wakeOne();
+    }
+}
+
+int OctreeEditPipeline::apply(QueuedPacket& packet) {
+    if (packet.isPrepared) {
+        for (auto& edit : packet.edits) {
+            _tree->applyPreparedEdit(*edit);
+        }
+        return (int)packet.edits.size();
+    }
+
+    ReceivedMessage& message = *packet.message;
+    int editsInPacket = 0;
+    while (message.getBytesLeftToRead() > 0) {
+        const unsigned char* editData =
+            reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+        int maxSize = message.getBytesLeftToRead();
+
+        int editDataBytesRead = _tree->processEditPacketData(message, editData, maxSize, packet.sendingNode);
+        editsInPacket++;
+        if (editDataBytesRead <= 0) {
+            break;
+        }
+
+        // skip to next edit record in the packet
+        message.seek(message.getPosition() + editDataBytesRead);
+    }
+    return editsInPacket;
+}
+
+bool OctreeEditPipeline::process() {
+    std::vector<QueuedPacketPointer> batch;
+
+    {
+        QMutexLocker locker(&_queuesMutex);
+
+        auto isNextReady = [&] {
+            return !_applyQueue.empty() && _applyQueue.begin()->first == _nextTicketToApply;
+        };
+
+        if (!isNextReady() && !_isStopping) {
+            _applyWorkReady.wait(&_queuesMutex, PIPELINE_WAIT_MSECS);
+        }
+
+        if (_isStopping) {
+            return false;
+        }
+
+        // take the run of packets that are next in order, nothing past a packet that is still being decoded
+        int editsInBatch = 0;
+        while (isNextReady() && (int)batch.size() < MAX_PACKETS_PER_BATCH && editsInBatch < MAX_EDITS_PER_BATCH) {
+            auto next = _applyQueue.begin();
+            editsInBatch += std::max(1, (int)next->second->edits.size());
+            batch.push_back(std::move(next->second));
+            _applyQueue.erase(next);
+            _nextTicketToApply++;
+        }
+    }
+
+    if (batch.empty()) {
+        return isStillRunning();
+    }
+
+    std::vector<int> editsInPackets(batch.size(), 0);
+    std::vector<quint64> applyTimes(batch.size(), 0);
+
+    quint64 startApply, startLock = usecTimestampNow();
+    _tree->withWriteLock([&] {
+        startApply = usecTimestampNow();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            quint64 startPacket = usecTimestampNow();
+            editsInPackets[i] = apply(*batch[i]);
+            applyTimes[i] = usecTimestampNow() - startPacket;
+        }
+    });
+    quint64 endApply = usecTimestampNow();
+
+    // the lock wait is shared by the whole batch, so each packet is charged its share of it
+    quint64 lockWaitTime = (startApply - startLock) / batch.size();
+
+    int editsInBatch = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const QueuedPacket& packet = *batch[i];
+        editsInBatch += editsInPackets[i];
+        _packetTracker(packet.nodeUUID, packet.sequence, packet.transitTime, editsInPackets[i],
+                       packet.prepareTime + applyTimes[i], lockWaitTime);
+    }
+
+    _totalBatches++;
+    _totalBatchedPackets += batch.size();
+    _totalBatchedEdits += editsInBatch;
+    _totalBatchLockTime += endApply - startApply;
+
+    {
+        // only now that the sequence numbers are tracked can the processor consider these senders for nacks
+        QMutexLocker locker(&_queuesMutex);
+        for (auto& packet : batch) {
+            auto it = _packetsByNode.find(packet->nodeUUID);
+            if (it != _packetsByNode.end() && --it.value() <= 0) {
+                _packetsByNode.erase(it);
+            }
+        }
+    }
+
+    return isStillRunning();
+}
@@ -0,0 +1,119 @@
+//
+//  OctreeEditPipeline.h
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditPipeline_h
+#define hifi_OctreeEditPipeline_h
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUuid>
+#include <QtCore/QWaitCondition>
+
+#include <GenericThread.h>
+#include <Node.h>
+#include <Octree.h>
+#include <ReceivedMessage.h>
+
+/// Processes the edit packets of an OctreeInboundPacketProcessor in two stages. A pool of worker threads decodes and
+/// validates the edits of each packet with Octree::prepareEditPacketData(), without the tree lock, then this thread
+/// applies the prepared edits with Octree::applyPreparedEdit(), several packets to each hold of the tree write lock.
+/// Packets are applied in the order they were queued, whatever order the workers finish them in. Packet types the tree
+/// can't prepare pass through the workers untouched and are applied with Octree::processEditPacketData().
+class OctreeEditPipeline : public GenericThread {
+    Q_OBJECT
+public:
+    /// Called from the pipeline thread once a packet has been applied, with the same arguments as
+    /// OctreeInboundPacketProcessor::trackInboundPacket()
+    using PacketTracker = std::function<void(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
+                                             int editsInPacket, quint64 processTime, quint64 lockWaitTime)>;
+
+    /// \param workerCount number of decode threads, 0 for one per core
+    OctreeEditPipeline(OctreePointer tree, PacketTracker packetTracker, int workerCount = 0);
+    virtual ~OctreeEditPipeline();
+
+    /// Queues a packet whose sequence number and sent time have already been read
+    void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode,
+                     unsigned short int sequence, quint64 transitTime);
+
+    /// true if packets from this node are still being decoded or waiting to be applied
+    bool hasPacketsFrom(const QUuid& nodeUUID) const;
+
+    int getWorkerCount() const { return (int)_workers.size(); }
+    int getDecodeQueueDepth() const;
+    int getApplyQueueDepth() const;
+    int getMaxDecodeQueueDepth() const { return _maxDecodeQueueDepth; }
+    int getMaxApplyQueueDepth() const { return _maxApplyQueueDepth; }
+    quint64 getTotalBatches() const { return _totalBatches; }
+    quint64 getAveragePacketsPerBatch() const { return _totalBatches == 0 ? 0 : _totalBatchedPackets / _totalBatches; }
+    quint64 getAverageEditsPerBatch() const { return _totalBatches == 0 ? 0 : _totalBatchedEdits / _totalBatches; }
+    quint64 getAverageLockTimePerBatch() const { return _totalBatches == 0 ? 0 : _totalBatchLockTime / _totalBatches; }
+
+    void resetStats();
+
+    virtual void terminating() override;
+
+protected:
+    /// Applies the next run of decoded packets
+    virtual bool process() override;
+
+private:
+    class Worker;
+
+    struct QueuedPacket {
+        quint64 ticket { 0 };
+        QSharedPointer<ReceivedMessage> message;
+        SharedNodePointer sendingNode;
+        QUuid nodeUUID;
+        unsigned short int sequence { 0 };
+        quint64 transitTime { 0 };
+        bool isPrepared { false }; // false for packets applied with processEditPacketData()
+        std::vector<Octree::PreparedEditPointer> edits;
+        quint64 prepareTime { 0 };
+    };
+    using QueuedPacketPointer = std::unique_ptr<QueuedPacket>;
+
+    // called from the workers
+    QueuedPacketPointer takeDecodeWork();
+    void prepare(QueuedPacket& packet);
+    void finishDecode(QueuedPacketPointer packet);
+
+    int apply(QueuedPacket& packet);
+
+    OctreePointer _tree;
+    PacketTracker _packetTracker;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    mutable QMutex _queuesMutex;
+    QWaitCondition _decodeWorkReady; // a packet was queued, or we're stopping
+    QWaitCondition _applyWorkReady; // the next packet to apply was decoded, or we're stopping
+    std::deque<QueuedPacketPointer> _decodeQueue;
+    std::map<quint64, QueuedPacketPointer> _applyQueue; // by ticket, may run ahead of _nextTicketToApply
+    QHash<QUuid, int> _packetsByNode;
+    quint64 _nextTicket { 0 };
+    quint64 _nextTicketToApply { 0 };
+    bool _isStopping { false };
+
+    std::atomic<int> _maxDecodeQueueDepth { 0 };
+    std::atomic<int> _maxApplyQueueDepth { 0 };
+    std::atomic<quint64> _totalBatches { 0 };
+    std::atomic<quint64> _totalBatchedPackets { 0 };
+    std::atomic<quint64> _totalBatchedEdits { 0 };
+    std::atomic<quint64> _totalBatchLockTime { 0 };
+};
+
+#endif // hifi_OctreeEditPipeline_h
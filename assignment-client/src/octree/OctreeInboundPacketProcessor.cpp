@@ -22,7 +22,8 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
-OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
+OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer, bool useEditPipeline,
+                                                           int editPipelineThreads) :
     _myServer(myServer),
     _receivedPacketCount(0),
     _totalTransitTime(0),
@@ -33,6 +34,22 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
+    if (useEditPipeline) {
+        _editPipeline.reset(new OctreeEditPipeline(_myServer->getOctree(),
+            [this](const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
+                   int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
+                trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+            }, editPipelineThreads));
+        _editPipeline->initialize(true);
+    }
+}
+
+void OctreeInboundPacketProcessor::terminating() {
+    _shuttingDown = true;
+    if (_editPipeline) {
+        _editPipeline->terminate();
+    }
+    ReceivedPacketProcessor::terminating();
 }
 
 void OctreeInboundPacketProcessor::resetStats() {
@@ -43,6 +60,10 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalPackets = 0;
     _lastNackTime = usecTimestampNow();
 
+    if (_editPipeline) {
+        _editPipeline->resetStats();
+    }
+
     QWriteLocker locker(&_senderStatsLock);
     _singleSenderStats.clear();
 }
@@ -139,6 +160,12 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                 qDebug() << "    ----- UNEXPECTED ---- got a packet without any edit details!!!! --------";
             }
         }
+
+        if (_editPipeline) {
+            // the pipeline decodes, applies and tracks the packet from here on
+            _editPipeline->queuePacket(message, sendingNode, sequence, transitTime);
+            return;
+        }
         
         const unsigned char* editData = nullptr;
         
@@ -261,7 +288,7 @@ int OctreeInboundPacketProcessor::sendNackPackets() {
 
         // if there are packets from _node that are waiting to be processed,
         // don't send a NACK since the missing packets may be among those waiting packets.
-        if (hasPacketsToProcessFrom(nodeUUID)) {
+        if (hasPacketsToProcessFrom(nodeUUID) || (_editPipeline && _editPipeline->hasPacketsFrom(nodeUUID))) {
             ++i;
             continue;
         }
@@ -14,8 +14,11 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <memory>
+
 #include <ReceivedPacketProcessor.h>
 
+#include "OctreeEditPipeline.h"
 #include "SequenceNumberStats.h"
 
 class OctreeServer;
@@ -58,7 +61,9 @@ typedef QHash<QUuid, SingleSenderStats>::const_iterator NodeToSenderStatsMapCons
 class OctreeInboundPacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
-    OctreeInboundPacketProcessor(OctreeServer* myServer);
+    /// \param useEditPipeline decode and validate edits on an OctreeEditPipeline's workers rather than on this thread
+    /// \param editPipelineThreads number of decode threads for the pipeline, 0 for one per core
+    OctreeInboundPacketProcessor(OctreeServer* myServer, bool useEditPipeline = false, int editPipelineThreads = 0);
 
     quint64 getAverageTransitTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalTransitTime / _totalPackets; }
     quint64 getAverageProcessTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalProcessTime / _totalPackets; }
@@ -74,7 +79,10 @@ public:
 
     NodeToSenderStatsMap getSingleSenderStats() { QReadLocker locker(&_senderStatsLock); return _singleSenderStats; }
 
-    virtual void terminating() override { _shuttingDown = true; ReceivedPacketProcessor::terminating(); }
+    /// The pipeline edits are handed to after their header is read, null unless useEditPipeline was set
+    const OctreeEditPipeline* getEditPipeline() const { return _editPipeline.get(); }
+
+    virtual void terminating() override;
 
 protected:
 
@@ -105,5 +113,7 @@ private:
 
     std::atomic<uint64_t> _lastNackTime;
     bool _shuttingDown;
+
+    std::unique_ptr<OctreeEditPipeline> _editPipeline;
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
@@ -0,0 +1,196 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeSendScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <QtCore/QDebug>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+// clients with nothing pending still get a pass this often, for anything hasPendingSendWork() can't see
+const quint64 MAX_IDLE_PASS_USECS = USECS_PER_SECOND;
+
+class OctreeSendScheduler::Worker : public GenericThread {
+public:
+    Worker(OctreeSendScheduler& scheduler, int index) : _scheduler(scheduler) {
+        setObjectName(QString("Octree Send Worker %1").arg(index));
+    }
+
+protected:
+    virtual bool process() override {
+        if (auto sendThread = _scheduler.takeReadyClient()) {
+            bool keepRunning = sendThread->processSendPass();
+            _scheduler.finishClientPass(sendThread, keepRunning);
+        }
+        return isStillRunning();
+    }
+
+private:
+    OctreeSendScheduler& _scheduler;
+};
+
+OctreeSendScheduler::OctreeSendScheduler(int workerCount) {
+    setObjectName("Octree Send Scheduler");
+
+    if (workerCount <= 0) {
+        workerCount = std::max(1, QThread::idealThreadCount());
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(new Worker(*this, i));
+        _workers.back()->initialize(true);
+    }
+
+    qDebug() << "Octree send scheduler started with" << workerCount << "workers";
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    // our terminating() has to run before we lose our subclass, so don't leave this to ~GenericThread
+    if (isStillRunning() && isThreaded()) {
+        terminate();
+    }
+    terminating();
+}
+
+void OctreeSendScheduler::terminating() {
+    {
+        QMutexLocker locker(&_clientsMutex);
+        _isStopping = true;
+        _clientsReady.wakeAll();
+    }
+
+    for (auto& worker : _workers) {
+        worker->terminate();
+    }
+}
+
+void OctreeSendScheduler::addClient(OctreeSendThread* sendThread) {
+    QMutexLocker locker(&_clientsMutex);
+    ClientState& state = _clients[sendThread];
+    state.sendThread = sendThread;
+}
+
+void OctreeSendScheduler::removeClient(OctreeSendThread* sendThread) {
+    QMutexLocker locker(&_clientsMutex);
+    auto it = _clients.find(sendThread);
+    if (it == _clients.end()) {
+        return;
+    }
+
+    while (it->second.isInFlight) {
+        _clientPassDone.wait(&_clientsMutex);
+        it = _clients.find(sendThread);
+        if (it == _clients.end()) {
+            return; // the pass finished the client itself
+        }
+    }
+
+    ClientState* state = &it->second;
+    _readyClients.erase(std::remove(_readyClients.begin(), _readyClients.end(), state), _readyClients.end());
+    _clients.erase(it);
+}
+
+bool OctreeSendScheduler::hasClient(OctreeSendThread* sendThread) const {
+    QMutexLocker locker(&_clientsMutex);
+    return _clients.find(sendThread) != _clients.end();
+}
+
+int OctreeSendScheduler::getClientCount() const {
+    QMutexLocker locker(&_clientsMutex);
+    return (int)_clients.size();
+}
+
+bool OctreeSendScheduler::process() {
+    quint64 start = usecTimestampNow();
+
+    {
+        QMutexLocker locker(&_clientsMutex);
+
+        for (auto& client : _clients) {
+            ClientState& state = client.second;
+            if (state.isQueued || state.isInFlight) {
+                continue;
+            }
+
+            if (start - state.lastPassAt >= MAX_IDLE_PASS_USECS || state.sendThread->hasPendingSendWork()) {
+                state.isQueued = true;
+                _readyClients.push_back(&state);
+            } else {
+                _totalIdleSkips++;
+            }
+        }
+
+        if (!_readyClients.empty()) {
+            // the clients that have waited the longest get serviced first
+            std::stable_sort(_readyClients.begin(), _readyClients.end(), [](const ClientState* a, const ClientState* b) {
+                return a->lastPassAt < b->lastPassAt;
+            });
+            _clientsReady.wakeAll();
+        }
+    }
+
+    if (isStillRunning()) {
+        int elapsed = (int)(usecTimestampNow() - start);
+        int usecToSleep = std::max(1, OCTREE_SEND_INTERVAL_USECS - elapsed);
+        std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
+    }
+
+    return isStillRunning();
+}
+
+OctreeSendThread* OctreeSendScheduler::takeReadyClient() {
+    QMutexLocker locker(&_clientsMutex);
+
+    if (_readyClients.empty() && !_isStopping) {
+        _clientsReady.wait(&_clientsMutex, OCTREE_SEND_INTERVAL_USECS / USECS_PER_MSEC + 1);
+    }
+
+    if (_readyClients.empty() || _isStopping) {
+        return nullptr;
+    }
+
+    ClientState* state = _readyClients.front();
+    _readyClients.pop_front();
+    state->isQueued = false;
+    state->isInFlight = true;
+    return state->sendThread;
+}
+
+void OctreeSendScheduler::finishClientPass(OctreeSendThread* sendThread, bool keepRunning) {
+    _totalPasses++;
+
+    QUuid finishedNodeUUID;
+    {
+        QMutexLocker locker(&_clientsMutex);
+        auto it = _clients.find(sendThread);
+        if (it != _clients.end()) {
+            it->second.isInFlight = false;
+            it->second.lastPassAt = usecTimestampNow();
+
+            if (!keepRunning) {
+                finishedNodeUUID = sendThread->getNodeUuid();
+                _clients.erase(it);
+            }
+        }
+        _clientPassDone.wakeAll();
+    }
+
+    if (!finishedNodeUUID.isNull()) {
+        emit clientFinished(finishedNodeUUID);
+    }
+}
@@ -0,0 +1,88 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QUuid>
+#include <QtCore/QWaitCondition>
+
+#include <GenericThread.h>
+
+class OctreeSendThread;
+
+/// Services the OctreeSendThreads of many clients from a fixed pool of worker threads instead of a thread per client.
+/// Each send interval the scheduler collects the clients that have something to do (see
+/// OctreeSendThread::hasPendingSendWork()), orders them so the ones that have waited longest go first, and hands them
+/// to the workers to run OctreeSendThread::processSendPass(). The send threads themselves run non-threaded.
+class OctreeSendScheduler : public GenericThread {
+    Q_OBJECT
+public:
+    /// \param workerCount number of worker threads, 0 for one per core
+    OctreeSendScheduler(int workerCount = 0);
+    virtual ~OctreeSendScheduler();
+
+    void addClient(OctreeSendThread* sendThread);
+
+    /// Stops scheduling this client, waiting for any pass in progress for it to finish, so it is safe to delete after.
+    void removeClient(OctreeSendThread* sendThread);
+
+    bool hasClient(OctreeSendThread* sendThread) const;
+
+    int getWorkerCount() const { return (int)_workers.size(); }
+    int getClientCount() const;
+    quint64 getTotalPasses() const { return _totalPasses; }
+    quint64 getTotalIdleSkips() const { return _totalIdleSkips; }
+
+    virtual void terminating() override;
+
+signals:
+    /// Emitted from a worker thread once a client's pass reports that it's done, the client is no longer scheduled.
+    void clientFinished(QUuid nodeUUID);
+
+protected:
+    virtual bool process() override;
+
+private:
+    class Worker;
+
+    struct ClientState {
+        OctreeSendThread* sendThread { nullptr };
+        quint64 lastPassAt { 0 };
+        bool isQueued { false };
+        bool isInFlight { false };
+    };
+
+    // called from the workers
+    OctreeSendThread* takeReadyClient();
+    void finishClientPass(OctreeSendThread* sendThread, bool keepRunning);
+
+    int _requestedWorkerCount;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    mutable QMutex _clientsMutex;
+    QWaitCondition _clientsReady; // a client was queued, or we're stopping
+    QWaitCondition _clientPassDone; // a pass finished, for removeClient()
+    std::unordered_map<OctreeSendThread*, ClientState> _clients;
+    std::deque<ClientState*> _readyClients;
+    bool _isStopping { false };
+
+    std::atomic<quint64> _totalPasses { 0 };
+    std::atomic<quint64> _totalIdleSkips { 0 };
+};
+
+#endif // hifi_OctreeSendScheduler_h
@@ -67,17 +67,45 @@ void OctreeSendThread::setIsShuttingDown() {
 
 
 bool OctreeSendThread::process() {
+    quint64  start = usecTimestampNow();
+
+    if (!processSendPass()) {
+        return false; // exit early if we're shutting down
+    }
+
+    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
+    if (isStillRunning()) {
+        // dynamically sleep until we need to fire off the next set of octree elements
+        int elapsed = (usecTimestampNow() - start);
+        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
+
+        if (usecToSleep <= 0) {
+            const int MIN_USEC_TO_SLEEP = 1;
+            usecToSleep = MIN_USEC_TO_SLEEP;
+        }
+
+        {
+            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
+            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
+        }
+
+    }
+
+    return isStillRunning();  // keep running till they terminate us
+}
+
+bool OctreeSendThread::processSendPass() {
     if (_isShuttingDown) {
         return false; // exit early if we're shutting down
     }
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
+    _hasNewQuery = false;
+
     // don't do any send processing until the initial load of the octree is complete...
     if (_myServer->isInitialLoadComplete()) {
         if (auto node = _node.lock()) {
@@ -94,29 +122,46 @@ bool OctreeSendThread::process() {
         }
     }
 
+    return !_isShuttingDown;
+}
+
+bool OctreeSendThread::hasPendingSendWork() {
     if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
+        return true; // the next pass will notice and finish us
     }
 
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
+    if (!_myServer->isInitialLoadComplete()) {
+        return false;
+    }
 
-        if (usecToSleep <= 0) {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usecToSleep = MIN_USEC_TO_SLEEP;
-        }
+    auto node = _node.lock();
+    if (!node) {
+        return true; // the next pass will notice the node is gone
+    }
 
-        {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
-        }
+    OctreeQueryNode* nodeData = static_cast<OctreeQueryNode*>(node->getLinkedData());
+    if (!nodeData || nodeData->isShuttingDown()) {
+        return false;
+    }
 
+    // the client has sent a new query, is part way through a scene, or its view is moving or just stopped moving
+    if (_hasNewQuery || !nodeData->elementBag.isEmpty() || nodeData->shouldForceFullScene()
+        || nodeData->getViewFrustumChanging() || nodeData->getViewFrustumJustStoppedChanging()) {
+        return true;
     }
 
-    return isStillRunning();  // keep running till they terminate us
+    // there's something already packed, or a stats message or re-send waiting to go out
+    if (nodeData->isPacketWaiting() || nodeData->stats.isReadyToSend() || nodeData->hasNextNackedPacket()) {
+        return true;
+    }
+
+    // something in the scene has changed since we started the last scene for this client
+    OctreeElementPointer root = _myServer->getOctree()->getRoot();
+    if (root && root->getLastChanged() > nodeData->getLastRootTimestamp()) {
+        return true;
+    }
+
+    return _myServer->hasSpecialPacketsToSend(node);
 }
 
 AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
@@ -299,6 +344,10 @@ int OctreeSendThread::handlePacketSend(SharedNodePointer node, OctreeQueryNode*
     return packetsSent;
 }
 
+void OctreeSendThread::startSceneTraversal(OctreeQueryNode* nodeData, bool isFullScene, bool viewFrustumChanged) {
+    nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
+}
+
 /// Version of octree element distributor that sends the deepest LOD level at once
 int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode* nodeData, bool viewFrustumChanged) {
 
@@ -357,6 +406,13 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     // the current view frustum for things to send.
     if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
 
+        // send what's largest on screen from where the client is now first
+        if (nodeData->getUsesFrustum()) {
+            ViewFrustum viewFrustum;
+            nodeData->copyCurrentViewFrustum(viewFrustum);
+            nodeData->elementBag.setViewFrustum(viewFrustum);
+        }
+
         // if our view has changed, we need to reset these things...
         if (viewFrustumChanged) {
             if (nodeData->moveShouldDump() || nodeData->hasLodChanged()) {
@@ -398,7 +454,7 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
                 nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
             }
         } else {
-            nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
+            startSceneTraversal(nodeData, isFullScene, viewFrustumChanged);
         }
     }
 
@@ -37,6 +37,17 @@ public:
     
     QUuid getNodeUuid() const { return _nodeUuid; }
 
+    /// Runs a single packetDistributor pass for our node without sleeping, for callers driving this non-threaded.
+    /// Returns false once the node is gone or we're shutting down.
+    bool processSendPass();
+
+    /// Cheap check of whether a pass would have anything to do: a new query, a scene in progress, packets waiting,
+    /// or changes to the tree since the last scene started.
+    bool hasPendingSendWork();
+
+    /// Called when a new query arrives from our node
+    void queryReceived() { _hasNewQuery = true; }
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -54,6 +65,10 @@ protected:
     /// Called before a packetDistributor pass to allow for pre-distribution processing
     virtual void preDistributionProcessing() {};
 
+    /// Called at the start of each scene to put the elements to traverse in the node's element bag, by default
+    /// the root, so the whole tree is walked for anything changed since the last scene
+    virtual void startSceneTraversal(OctreeQueryNode* nodeData, bool isFullScene, bool viewFrustumChanged);
+
     OctreeServer* _myServer { nullptr };
     QWeakPointer<Node> _node;
 
@@ -68,6 +83,7 @@ private:
 
     int _nodeMissingCount { 0 };
     bool _isShuttingDown { false };
+    std::atomic<bool> _hasNewQuery { true };
 };
 
 #endif // hifi_OctreeSendThread_h
@@ -432,6 +432,17 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("          Total Clients Connected: %1 clients\r\n")
             .arg(locale.toString((uint)getCurrentClientCount()).rightJustified(COLUMN_WIDTH, ' '));
 
+        if (_sendScheduler) {
+            statsString += QString("           Send Scheduler Workers: %1 threads\r\n")
+                .arg(locale.toString((uint)_sendScheduler->getWorkerCount()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("           Send Scheduler Clients: %1 clients\r\n")
+                .arg(locale.toString((uint)_sendScheduler->getClientCount()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("            Send Scheduler Passes: %1 passes\r\n")
+                .arg(locale.toString(_sendScheduler->getTotalPasses()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("        Send Scheduler Idle Skips: %1 clients\r\n")
+                .arg(locale.toString(_sendScheduler->getTotalIdleSkips()).rightJustified(COLUMN_WIDTH, ' '));
+        }
+
         quint64 oneSecondAgo = usecTimestampNow() - USECS_PER_SECOND;
 
         statsString += QString("            process() last second: %1 clients\r\n")
@@ -674,6 +685,29 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("    Packets Queue Processing OUT: %1 PPS \r\n")
             .arg(locale.toString(processedPPS, 'f', FLOAT_PRECISION).rightJustified(COLUMN_WIDTH, ' '));
 
+        if (auto editPipeline = _octreeInboundPacketProcessor->getEditPipeline()) {
+            statsString += QString("           Edit Pipeline Workers: %1 threads\r\n")
+                .arg(locale.toString((uint)editPipeline->getWorkerCount()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("            Current Decode Queue: %1 packets\r\n")
+                .arg(locale.toString((uint)editPipeline->getDecodeQueueDepth()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                Max Decode Queue: %1 packets\r\n")
+                .arg(locale.toString((uint)editPipeline->getMaxDecodeQueueDepth()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("             Current Apply Queue: %1 packets\r\n")
+                .arg(locale.toString((uint)editPipeline->getApplyQueueDepth()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                 Max Apply Queue: %1 packets\r\n")
+                .arg(locale.toString((uint)editPipeline->getMaxApplyQueueDepth()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("           Total Applied Batches: %1 batches\r\n")
+                .arg(locale.toString(editPipeline->getTotalBatches()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("           Average Packets/Batch: %1 packets\r\n")
+                .arg(locale.toString(editPipeline->getAveragePacketsPerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("             Average Edits/Batch: %1 edits\r\n")
+                .arg(locale.toString(editPipeline->getAverageEditsPerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("         Average Lock Time/Batch: %1 usecs\r\n")
+                .arg(locale.toString(editPipeline->getAverageLockTimePerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("               Revalidated Edits: %1 edits\r\n")
+                .arg(locale.toString(_tree->getTotalRevalidatedEdits()).rightJustified(COLUMN_WIDTH, ' '));
+        }
+
         statsString += QString("           Total Inbound Packets: %1 packets\r\n")
             .arg(locale.toString((uint)totalPacketsProcessed).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("          Total Inbound Elements: %1 elements\r\n")
@@ -880,13 +914,27 @@ OctreeServer::UniqueSendThread OctreeServer::newSendThread(const SharedNodePoint
 OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePointer& node) {
     auto sendThread = newSendThread(node);
     
-    // we want to be notified when the thread finishes
-    connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    if (_sendScheduler) {
+        // the scheduler's workers drive the send thread, and let us know when it finishes
+        sendThread->initialize(false);
+        _sendScheduler->addClient(sendThread.get());
+    } else {
+        // we want to be notified when the thread finishes
+        connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
+        sendThread->initialize(true);
+    }
 
     return sendThread;
 }
 
+void OctreeServer::eraseSendThread(SendThreads::iterator it) {
+    if (_sendScheduler) {
+        // make sure no worker is still using it
+        _sendScheduler->removeClient(it->second.get());
+    }
+    _sendThreads.erase(it);
+}
+
 void OctreeServer::removeSendThread() {
     // If the object has been deleted since the event was queued, sender() will return nullptr
     if (auto sendThread = qobject_cast<OctreeSendThread*>(sender())) {
@@ -895,6 +943,15 @@ void OctreeServer::removeSendThread() {
     }
 }
 
+void OctreeServer::removeScheduledSendThread(QUuid nodeUUID) {
+    // The send thread may already have been replaced by a new one for the same node, only remove it if it's the one
+    // the scheduler has finished with
+    auto it = _sendThreads.find(nodeUUID);
+    if (it != _sendThreads.end() && _sendScheduler && !_sendScheduler->hasClient(it->second.get())) {
+        _sendThreads.erase(it);
+    }
+}
+
 void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     if (!_isFinished && !_isShuttingDown) {
         // If we got a query packet, then we're talking to an agent, and we
@@ -906,9 +963,11 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<ReceivedMessage> messa
         if (it == _sendThreads.end()) {
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
         } else if (it->second->isShuttingDown()) {
-            _sendThreads.erase(it); // Remove right away and wait on thread to be
+            eraseSendThread(it); // Remove right away and wait on thread to be
             
             _sendThreads.emplace(senderNode->getUUID(), createSendThread(senderNode));
+        } else {
+            it->second->queryReceived();
         }
     }
 }
@@ -954,8 +1013,10 @@ void OctreeServer::handleOctreeFileReplacement(QSharedPointer<ReceivedMessage> m
                         gzip(jsonOctree, compressedOctree);
                     }
 
-                    // write the compressed octree data to a special file
-                    auto replacementFilePath = _persistAbsoluteFilePath.append(OctreePersistThread::REPLACEMENT_FILE_EXTENSION);
+                    // write the compressed octree data to a special file next to the file the persist thread reads,
+                    // a binary persist file falls back to reading it as gzipped JSON
+                    auto replacementFilePath = fileNameWithoutExtension(_persistAbsoluteFilePath, PERSIST_EXTENSIONS)
+                        + "." + _persistAsFileType + OctreePersistThread::REPLACEMENT_FILE_EXTENSION;
                     QFile replacementFile(replacementFilePath);
                     if (replacementFile.open(QIODevice::WriteOnly) && replacementFile.write(compressedOctree) != -1) {
                         // we've now written our replacement file, time to take the server down so it can
@@ -1112,7 +1173,11 @@ void OctreeServer::readConfiguration() {
 
         qDebug() << "persistFilePath=" << _persistFilePath;
 
-        _persistAsFileType = "json.gz";
+        if (!readOptionString("persistFileType", settingsSectionObject, _persistAsFileType)
+            || !PERSIST_EXTENSIONS.contains(_persistAsFileType)) {
+            _persistAsFileType = "json.gz";
+        }
+        qDebug() << "persistFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1167,6 +1232,16 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // Check to see if we should send from a fixed pool of threads rather than a thread per client
+    readOptionBool(QString("useSendScheduler"), settingsSectionObject, _useSendScheduler);
+    readOptionInt(QString("sendSchedulerThreads"), settingsSectionObject, _sendSchedulerThreads);
+    qDebug("useSendScheduler=%s sendSchedulerThreads=%d", debug::valueOf(_useSendScheduler), _sendSchedulerThreads);
+
+    // Check to see if we should decode and validate edits on a pool of threads before applying them
+    readOptionBool(QString("useEditPipeline"), settingsSectionObject, _useEditPipeline);
+    readOptionInt(QString("editPipelineThreads"), settingsSectionObject, _editPipelineThreads);
+    qDebug("useEditPipeline=%s editPipelineThreads=%d", debug::valueOf(_useEditPipeline), _editPipelineThreads);
+
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1331,8 +1406,16 @@ void OctreeServer::domainSettingsRequestComplete() {
     _jurisdictionSender->initialize(true);
     
     // set up our OctreeServerPacketProcessor
-    _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this);
+    _octreeInboundPacketProcessor = new OctreeInboundPacketProcessor(this, _useEditPipeline, _editPipelineThreads);
     _octreeInboundPacketProcessor->initialize(true);
+
+    // set up the pool that services all our clients, if we're not giving each one its own send thread
+    if (_useSendScheduler) {
+        _sendScheduler.reset(new OctreeSendScheduler(_sendSchedulerThreads));
+        connect(_sendScheduler.get(), &OctreeSendScheduler::clientFinished,
+                this, &OctreeServer::removeScheduledSendThread, Qt::QueuedConnection);
+        _sendScheduler->initialize(true);
+    }
     
     // Convert now to tm struct for local timezone
     tm* localtm = localtime(&_started);
@@ -1408,6 +1491,11 @@ void OctreeServer::aboutToFinish() {
         auto& sendThread = *it.second;
         sendThread.setIsShuttingDown();
     }
+
+    // stop the send scheduler's workers before the send threads they use go away
+    if (_sendScheduler) {
+        _sendScheduler->terminate();
+    }
     
     // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
     // which waits on the thread to be done before returning
@@ -1573,6 +1661,10 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        if (auto editPipeline = _octreeInboundPacketProcessor->getEditPipeline()) {
+            dataArray2["4. decodeQueue"] = (double)editPipeline->getDecodeQueueDepth();
+            dataArray2["5. applyQueue"] = (double)editPipeline->getApplyQueueDepth();
+        }
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
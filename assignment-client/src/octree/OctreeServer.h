@@ -23,6 +23,7 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -138,6 +139,7 @@ private slots:
     void handleJurisdictionRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleOctreeFileReplacement(QSharedPointer<ReceivedMessage> message);
     void removeSendThread();
+    void removeScheduledSendThread(QUuid nodeUUID);
 
 protected:
     using UniqueSendThread = std::unique_ptr<OctreeSendThread>;
@@ -159,6 +161,7 @@ protected:
     QString getStatusLink();
     
     UniqueSendThread createSendThread(const SharedNodePointer& node);
+    void eraseSendThread(SendThreads::iterator it);
     virtual UniqueSendThread newSendThread(const SharedNodePointer& node);
 
     int _argc;
@@ -202,6 +205,13 @@ protected:
     
     SendThreads _sendThreads;
 
+    bool _useSendScheduler { false };
+    int _sendSchedulerThreads { 0 };
+    std::unique_ptr<OctreeSendScheduler> _sendScheduler; // services all the send threads when _useSendScheduler is set
+
+    bool _useEditPipeline { false };
+    int _editPipelineThreads { 0 };
+
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
 
@@ -950,3 +950,16 @@ void AudioHRTF::renderSilent(int16_t* input, float* output, int index, float azi
 
     _silentState = true;
 }
+
+void AudioHRTF::reset() {
+
+    memset(_firState, 0, sizeof(_firState));
+    memset(_delayState, 0, sizeof(_delayState));
+    memset(_bqState, 0, sizeof(_bqState));
+
+    _azimuthState = 0.0f;
+    _distanceState = 0.0f;
+    _gainState = 0.0f;
+
+    _silentState = false;
+}
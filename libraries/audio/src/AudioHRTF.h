@@ -44,6 +44,11 @@ public:
     //
     void renderSilent(int16_t* input, float* output, int index, float azimuth, float distance, float gain, int numFrames);
 
+    //
+    // Clear all history, so the next render fades in from silence (the gain adjustment is kept)
+    //
+    void reset();
+
     //
     // HRTF local gain adjustment in amplitude (1.0 == unity)
     //
@@ -0,0 +1,202 @@
+//
+//  AudioHRTFCache.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+
+#include <glm/glm.hpp>
+
+#include <NumericalConstants.h>
+
+#include "AudioMixKernels.h"
+#include "AudioHRTFCache.h"
+
+// bucket sizes
+static const float AZIMUTH_STEP = TWO_PI / HRTF_AZIMUTHS;   // matches the HRTF table resolution
+static const float DISTANCE_STEPS_PER_OCTAVE = 4.0f;        // matches the distance filter resolution
+static const float GAIN_STEPS_PER_DB = 2.0f;                // half-dB steps
+
+static const int MAX_DISTANCE_STEP = 63;    // 2^(63/4) ~ 55km
+static const int MIN_GAIN_STEP = -255;      // ~ -128dB
+static const int MAX_GAIN_STEP = 64;        // +32dB
+
+// buckets not rendered for this many frames are released
+static const unsigned int MAX_BUCKET_AGE = 100;
+
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+std::size_t AudioHRTFCache::KeyHasher::operator()(const Key& key) const {
+    return qHash(key.nodeID) ^ (qHash(key.streamID) * 31) ^ (std::size_t)key.bucket * 131071;
+}
+
+bool AudioHRTFCache::touch(const QUuid& nodeID, const QUuid& streamID) {
+    if (!_isEnabled) {
+        return false;
+    }
+
+    Key key { nodeID, streamID, 0 };
+    auto it = _sources.find(key);
+    if (it == _sources.end()) {
+        // concurrent inserts of the same key resolve to a single source
+        it = _sources.insert({ key, std::make_shared<Source>() }).first;
+    }
+
+    auto& source = *it->second;
+    ++source.numListeners;
+    return source.numListenersLastFrame >= _minListeners;
+}
+
+bool AudioHRTFCache::isInBucket(const ListenerSource& listenerSource, unsigned int frame) {
+    return listenerSource.isMixed && listenerSource.bucket != OWN_HRTF && listenerSource.lastFrame + 1 == frame;
+}
+
+AudioHRTF& AudioHRTFCache::hrtfToRender(ListenerSource& listenerSource, unsigned int frame) {
+    assert(!isInBucket(listenerSource, frame));
+
+    bool isCurrent = listenerSource.isMixed && listenerSource.bucket == OWN_HRTF &&
+        (listenerSource.lastFrame + 1 == frame || listenerSource.lastFrame == frame);
+    if (!isCurrent) {
+        listenerSource.hrtf.reset();
+    }
+
+    listenerSource.bucket = OWN_HRTF;
+    listenerSource.lastFrame = frame;
+    listenerSource.isMixed = true;
+    return listenerSource.hrtf;
+}
+
+bool AudioHRTFCache::render(ListenerSource& listenerSource, bool useBucket, const QUuid& nodeID, const QUuid& streamID,
+        int16_t* input, float* output, int index, float azimuth, float distance, float gain, unsigned int frame) {
+    bool wasMixed = listenerSource.isMixed && listenerSource.lastFrame + 1 == frame;
+    uint32_t lastBucket = listenerSource.bucket;
+    uint32_t bucket = useBucket ? bucketFor(azimuth, distance, gain * listenerSource.hrtf.getGainAdjustment()) : OWN_HRTF;
+
+    listenerSource.bucket = bucket;
+    listenerSource.lastFrame = frame;
+    listenerSource.isMixed = true;
+
+    bool isHit = false;
+    if (wasMixed && bucket == lastBucket) {
+        // heard the same way as in the last frame, so the render just carries on
+        if (bucket == OWN_HRTF) {
+            listenerSource.hrtf.render(input, output, index, azimuth, distance, gain, NUM_FRAMES);
+        } else {
+            mixAccumulate(renderBucket({ nodeID, streamID, bucket }, input, index, frame, isHit), output, NUM_SAMPLES);
+        }
+        return isHit;
+    }
+
+    // render the source the new way...
+    float next[NUM_SAMPLES] = {};
+    if (bucket == OWN_HRTF) {
+        // the listener's own HRTF was not kept up to date while it was not used
+        listenerSource.hrtf.reset();
+        listenerSource.hrtf.render(input, next, index, azimuth, distance, gain, NUM_FRAMES);
+    } else {
+        memcpy(next, renderBucket({ nodeID, streamID, bucket }, input, index, frame, isHit), sizeof(next));
+    }
+
+    // ...and the old way, which was rendered in the last frame and so carries on without a discontinuity
+    float last[NUM_SAMPLES] = {};
+    if (wasMixed) {
+        if (lastBucket == OWN_HRTF) {
+            listenerSource.hrtf.render(input, last, index, azimuth, distance, gain, NUM_FRAMES);
+        } else {
+            bool isLastHit;
+            memcpy(last, renderBucket({ nodeID, streamID, lastBucket }, input, index, frame, isLastHit), sizeof(last));
+        }
+    }
+
+    // crossfade from the old render (or from silence) to the new one
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float fade = (i + 1) * (1.0f / NUM_FRAMES);
+        output[2*i+0] += last[2*i+0] + (next[2*i+0] - last[2*i+0]) * fade;
+        output[2*i+1] += last[2*i+1] + (next[2*i+1] - last[2*i+1]) * fade;
+    }
+
+    return isHit;
+}
+
+uint32_t AudioHRTFCache::bucketFor(float azimuth, float distance, float gain) {
+    int azimuthStep = (int)std::round(azimuth / AZIMUTH_STEP);
+    azimuthStep = ((azimuthStep % HRTF_AZIMUTHS) + HRTF_AZIMUTHS) % HRTF_AZIMUTHS;
+
+    int distanceStep = (int)std::round(DISTANCE_STEPS_PER_OCTAVE * std::log2(std::max(distance, 1.0f)));
+    distanceStep = glm::clamp(distanceStep, 0, MAX_DISTANCE_STEP);
+
+    int gainStep = (int)std::round(GAIN_STEPS_PER_DB * 20.0f * std::log10(std::max(gain, EPSILON)));
+    gainStep = glm::clamp(gainStep, MIN_GAIN_STEP, MAX_GAIN_STEP);
+
+    return (uint32_t)azimuthStep | ((uint32_t)distanceStep << 8) | ((uint32_t)(gainStep - MIN_GAIN_STEP) << 16);
+}
+
+const float* AudioHRTFCache::renderBucket(const Key& key, int16_t* input, int index, unsigned int frame, bool& isHit) {
+    auto it = _buckets.find(key);
+    if (it == _buckets.end()) {
+        it = _buckets.insert({ key, std::make_shared<Bucket>() }).first;
+    }
+    auto& cached = *it->second;
+
+    isHit = true;
+
+    // the first listener of the frame renders the block, the others wait for it
+    std::lock_guard<std::mutex> lock(cached.mutex);
+    if (!cached.isRendered || cached.frame != frame) {
+        // a bucket that sat idle has stale history, so it starts over from silence
+        if (cached.isRendered && cached.frame + 1 != frame) {
+            cached.hrtf.reset();
+        }
+
+        // render at the center of the bucket so every listener in it hears the same block
+        int azimuthStep = key.bucket & 0xff;
+        int distanceStep = (key.bucket >> 8) & 0xff;
+        int gainStep = (int)(key.bucket >> 16) + MIN_GAIN_STEP;
+
+        float bucketAzimuth = azimuthStep * AZIMUTH_STEP;
+        float bucketDistance = std::exp2(distanceStep / DISTANCE_STEPS_PER_OCTAVE);
+        float bucketGain = std::pow(10.0f, gainStep / (GAIN_STEPS_PER_DB * 20.0f));
+
+        memset(cached.block, 0, sizeof(cached.block));
+        cached.hrtf.render(input, cached.block, index, bucketAzimuth, bucketDistance, bucketGain, NUM_FRAMES);
+        cached.frame = frame;
+        cached.isRendered = true;
+        isHit = false;
+    }
+
+    return cached.block;
+}
+
+void AudioHRTFCache::nextFrame(unsigned int frame) {
+    for (auto it = _sources.begin(); it != _sources.end();) {
+        auto& source = *it->second;
+        int numListeners = source.numListeners.exchange(0);
+        if (numListeners == 0 && source.numListenersLastFrame == 0) {
+            it = _sources.unsafe_erase(it);
+        } else {
+            source.numListenersLastFrame = numListeners;
+            ++it;
+        }
+    }
+
+    for (auto it = _buckets.begin(); it != _buckets.end();) {
+        if (frame - it->second->frame > MAX_BUCKET_AGE) {
+            it = _buckets.unsafe_erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AudioHRTFCache::clear() {
+    _sources.clear();
+    _buckets.clear();
+}
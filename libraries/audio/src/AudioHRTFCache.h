@@ -0,0 +1,115 @@
+//
+//  AudioHRTFCache.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTFCache_h
+#define hifi_AudioHRTFCache_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <tbb/concurrent_unordered_map.h>
+
+#include <QtCore/QUuid>
+
+#include "AudioConstants.h"
+#include "AudioHRTF.h"
+
+// Shared HRTF renders of sources heard by many listeners
+//   A source heard by at least minListeners listeners in the previous frame is rendered once per
+//   (azimuth, distance, gain) bucket per frame, and listeners that fall in the same bucket reuse the block.
+//   Each listener keeps a ListenerSource per source so that what it hears stays continuous: moving to another
+//   bucket, or between a bucket and its own HRTF, crossfades from the old render to the new one over the block,
+//   and a bucket or HRTF that was not rendered in the previous frame is reset so it fades in from silence.
+//   render() may be called concurrently for different listeners; nextFrame() must be called between frames.
+class AudioHRTFCache {
+public:
+    static const int DEFAULT_MIN_LISTENERS = 8;
+    static const uint32_t OWN_HRTF = 0xffffffff;
+
+    // one listener's state for one source
+    struct ListenerSource {
+        AudioHRTF hrtf;                 // the listener's own HRTF for the source
+        uint32_t bucket { OWN_HRTF };   // what the listener heard the source through in lastFrame
+        unsigned int lastFrame { 0 };
+        bool isMixed { false };         // the source was mixed for the listener at least once
+    };
+
+    void setEnabled(bool enabled) { _isEnabled = enabled; }
+    bool isEnabled() const { return _isEnabled; }
+
+    void setMinListeners(int minListeners) { _minListeners = minListeners; }
+    int getMinListeners() const { return _minListeners; }
+
+    // mark the source as heard this frame
+    // returns true if the source is heard widely enough to be rendered through the cache
+    bool touch(const QUuid& nodeID, const QUuid& streamID);
+
+    // returns true if the listener heard the source through a shared bucket in the previous frame,
+    // in which case it has to go through render() to crossfade back to its own HRTF
+    static bool isInBucket(const ListenerSource& listenerSource, unsigned int frame);
+
+    // returns the listener's own HRTF to render this frame with, reset if it was not rendered in the previous frame
+    // (must not be used while isInBucket())
+    static AudioHRTF& hrtfToRender(ListenerSource& listenerSource, unsigned int frame);
+
+    // accumulate the listener's render of input into output: through the shared bucket for (azimuth, distance, gain)
+    // if useBucket is set, or else through the listener's own HRTF, crossfading from last frame's render if that differs
+    // returns true if the block shared with other listeners was already rendered for this frame (a cache hit)
+    bool render(ListenerSource& listenerSource, bool useBucket, const QUuid& nodeID, const QUuid& streamID,
+            int16_t* input, float* output, int index, float azimuth, float distance, float gain, unsigned int frame);
+
+    // age out stale sources and buckets (not thread-safe)
+    void nextFrame(unsigned int frame);
+
+    void clear();
+
+private:
+    struct Key {
+        QUuid nodeID;
+        QUuid streamID;
+        uint32_t bucket;
+
+        bool operator==(const Key& other) const {
+            return bucket == other.bucket && nodeID == other.nodeID && streamID == other.streamID;
+        }
+    };
+    struct KeyHasher { std::size_t operator()(const Key& key) const; };
+
+    struct Source {
+        std::atomic<int> numListeners { 0 };
+        int numListenersLastFrame { 0 };
+    };
+
+    struct Bucket {
+        std::mutex mutex;
+        AudioHRTF hrtf;
+        float block[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        unsigned int frame { 0 };
+        bool isRendered { false };
+    };
+
+    static uint32_t bucketFor(float azimuth, float distance, float gain);
+
+    // the block of the bucket for this frame, rendering it if this is the first listener of the frame
+    // (the block is not written again until the next frame)
+    const float* renderBucket(const Key& key, int16_t* input, int index, unsigned int frame, bool& isHit);
+
+    using Sources = tbb::concurrent_unordered_map<Key, std::shared_ptr<Source>, KeyHasher>;
+    using Buckets = tbb::concurrent_unordered_map<Key, std::shared_ptr<Bucket>, KeyHasher>;
+
+    Sources _sources;
+    Buckets _buckets;
+
+    bool _isEnabled { false };
+    int _minListeners { DEFAULT_MIN_LISTENERS };
+};
+
+#endif // hifi_AudioHRTFCache_h
@@ -10,6 +10,7 @@
 #include <assert.h>
 
 #include "AudioLimiter.h"
+#include "AudioMixKernels.h"
 
 #ifndef MAX
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
@@ -33,26 +34,8 @@
 
 #endif  // _MSC_VER
 
-//
-// on x86 architecture, assume that SSE2 is present
-//
-#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
-
-#include <xmmintrin.h>
-// convert float to int using round-to-nearest
-static inline int32_t floatToInt(float x) {
-    return _mm_cvt_ss2si(_mm_load_ss(&x));
-}
-
-#else 
-
-// convert float to int using round-to-nearest
-static inline int32_t floatToInt(float x) {
-    x += (x < 0.0f ? -0.5f : 0.5f); // round
-    return (int32_t)x;
-}
-
-#endif  // _M_IX86
+// frames buffered before vectorized conversion to 16-bit output
+static const int LIMITER_BLOCK = 256;
 
 static const double FIXQ31 = 2147483648.0;              // convert float to Q31
 static const double DB_TO_LOG2 = 0.16609640474436813;   // convert dB to log2
@@ -649,6 +632,8 @@ public:
 template<int N>
 void LimiterMono<N>::process(float* input, int16_t* output, int numFrames) {
 
+    float work[LIMITER_BLOCK];
+
     for (int n = 0; n < numFrames; n++) {
 
         // peak detect and convert to log2 domain
@@ -677,8 +662,12 @@ void LimiterMono<N>::process(float* input, int16_t* output, int numFrames) {
         // apply dither
         x += dither();
 
-        // store 16-bit output
-        output[n] = (int16_t)floatToInt(x);
+        // store 16-bit output, a block at a time
+        int k = n % LIMITER_BLOCK;
+        work[k] = x;
+        if (k == LIMITER_BLOCK - 1 || n == numFrames - 1) {
+            mixConvertToInt16(work, &output[n - k], k + 1);
+        }
     }
 }
 
@@ -701,6 +690,8 @@ public:
 template<int N>
 void LimiterStereo<N>::process(float* input, int16_t* output, int numFrames) {
 
+    float work[2 * LIMITER_BLOCK];
+
     for (int n = 0; n < numFrames; n++) {
 
         // peak detect and convert to log2 domain
@@ -733,9 +724,13 @@ void LimiterStereo<N>::process(float* input, int16_t* output, int numFrames) {
         x0 += d;
         x1 += d;
 
-        // store 16-bit output
-        output[2*n+0] = (int16_t)floatToInt(x0);
-        output[2*n+1] = (int16_t)floatToInt(x1);
+        // store 16-bit output, a block at a time
+        int k = n % LIMITER_BLOCK;
+        work[2*k+0] = x0;
+        work[2*k+1] = x1;
+        if (k == LIMITER_BLOCK - 1 || n == numFrames - 1) {
+            mixConvertToInt16(work, &output[2*(n - k)], 2*(k + 1));
+        }
     }
 }
 
@@ -758,6 +753,8 @@ public:
 template<int N>
 void LimiterQuad<N>::process(float* input, int16_t* output, int numFrames) {
 
+    float work[4 * LIMITER_BLOCK];
+
     for (int n = 0; n < numFrames; n++) {
 
         // peak detect and convert to log2 domain
@@ -796,11 +793,15 @@ void LimiterQuad<N>::process(float* input, int16_t* output, int numFrames) {
         x2 += d;
         x3 += d;
 
-        // store 16-bit output
-        output[4*n+0] = (int16_t)floatToInt(x0);
-        output[4*n+1] = (int16_t)floatToInt(x1);
-        output[4*n+2] = (int16_t)floatToInt(x2);
-        output[4*n+3] = (int16_t)floatToInt(x3);
+        // store 16-bit output, a block at a time
+        int k = n % LIMITER_BLOCK;
+        work[4*k+0] = x0;
+        work[4*k+1] = x1;
+        work[4*k+2] = x2;
+        work[4*k+3] = x3;
+        if (k == LIMITER_BLOCK - 1 || n == numFrames - 1) {
+            mixConvertToInt16(work, &output[4*(n - k)], 4*(k + 1));
+        }
     }
 }
 
@@ -0,0 +1,228 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include "AudioConstants.h"
+#include "AudioMixKernels.h"
+
+// the same scale the mixer has always used, so that the kernels mix exactly as before
+static const float INT16_TO_FLOAT = 1.0f / AudioConstants::MAX_SAMPLE_VALUE;
+
+//
+// portable reference code, also used for the tails of the SIMD kernels
+//
+
+static void mixAccumulate_ref(const float* input, float* output, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        output[i] += input[i];
+    }
+}
+
+static void mixAccumulateInt16_ref(const int16_t* input, float* output, float gain, int numSamples) {
+    gain *= INT16_TO_FLOAT;
+    for (int i = 0; i < numSamples; i++) {
+        output[i] += (float)input[i] * gain;
+    }
+}
+
+static void mixAccumulateInt16MonoToStereo_ref(const int16_t* input, float* output, float gain, int numFrames) {
+    gain *= INT16_TO_FLOAT;
+    for (int i = 0; i < numFrames; i++) {
+        float x = (float)input[i] * gain;
+        output[2*i+0] += x;
+        output[2*i+1] += x;
+    }
+}
+
+static bool mixIsSilent_ref(const float* input, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        if (input[i] != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void mixConvertToInt16_ref(const float* input, int16_t* output, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        float x = input[i];
+        x = (x > 32767.0f) ? 32767.0f : ((x < -32768.0f) ? -32768.0f : x);
+        output[i] = (int16_t)lrintf(x);
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+//
+// SSE2 kernels
+//
+
+static void mixAccumulate_SSE2(const float* input, float* output, int numSamples) {
+    int i = 0;
+    for (; i <= numSamples - 8; i += 8) {
+        __m128 x0 = _mm_add_ps(_mm_loadu_ps(&output[i+0]), _mm_loadu_ps(&input[i+0]));
+        __m128 x1 = _mm_add_ps(_mm_loadu_ps(&output[i+4]), _mm_loadu_ps(&input[i+4]));
+        _mm_storeu_ps(&output[i+0], x0);
+        _mm_storeu_ps(&output[i+4], x1);
+    }
+    mixAccumulate_ref(&input[i], &output[i], numSamples - i);
+}
+
+static void mixAccumulateInt16_SSE2(const int16_t* input, float* output, float gain, int numSamples) {
+    __m128 g = _mm_set1_ps(gain * INT16_TO_FLOAT);
+    int i = 0;
+    for (; i <= numSamples - 8; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        // sign-extend int16 to int32
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+        __m128 y0 = _mm_add_ps(_mm_loadu_ps(&output[i+0]), _mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+        __m128 y1 = _mm_add_ps(_mm_loadu_ps(&output[i+4]), _mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+        _mm_storeu_ps(&output[i+0], y0);
+        _mm_storeu_ps(&output[i+4], y1);
+    }
+    mixAccumulateInt16_ref(&input[i], &output[i], gain, numSamples - i);
+}
+
+static void mixAccumulateInt16MonoToStereo_SSE2(const int16_t* input, float* output, float gain, int numFrames) {
+    __m128 g = _mm_set1_ps(gain * INT16_TO_FLOAT);
+    int i = 0;
+    for (; i <= numFrames - 4; i += 4) {
+        __m128i x = _mm_loadl_epi64((const __m128i*)&input[i]);
+
+        // duplicate each sample to both channels, and sign-extend int16 to int32
+        __m128i xx = _mm_unpacklo_epi16(x, x);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(xx, xx), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(xx, xx), 16);
+
+        __m128 y0 = _mm_add_ps(_mm_loadu_ps(&output[2*i+0]), _mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+        __m128 y1 = _mm_add_ps(_mm_loadu_ps(&output[2*i+4]), _mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+        _mm_storeu_ps(&output[2*i+0], y0);
+        _mm_storeu_ps(&output[2*i+4], y1);
+    }
+    mixAccumulateInt16MonoToStereo_ref(&input[i], &output[2*i], gain, numFrames - i);
+}
+
+static bool mixIsSilent_SSE2(const float* input, int numSamples) {
+    __m128 zero = _mm_setzero_ps();
+    int i = 0;
+    for (; i <= numSamples - 8; i += 8) {
+        __m128 ne0 = _mm_cmpneq_ps(_mm_loadu_ps(&input[i+0]), zero);
+        __m128 ne1 = _mm_cmpneq_ps(_mm_loadu_ps(&input[i+4]), zero);
+        if (_mm_movemask_ps(_mm_or_ps(ne0, ne1))) {
+            return false;
+        }
+    }
+    return mixIsSilent_ref(&input[i], numSamples - i);
+}
+
+static void mixConvertToInt16_SSE2(const float* input, int16_t* output, int numSamples) {
+    __m128 lo = _mm_set1_ps(-32768.0f);
+    __m128 hi = _mm_set1_ps(32767.0f);
+    int i = 0;
+    for (; i <= numSamples - 8; i += 8) {
+        // clamp, since anything out of int32_t range converts to 0x80000000,
+        // then round-to-nearest (default MXCSR) and pack with signed saturation
+        __m128i x0 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&input[i+0]), lo), hi));
+        __m128i x1 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&input[i+4]), lo), hi));
+        _mm_storeu_si128((__m128i*)&output[i], _mm_packs_epi32(x0, x1));
+    }
+    mixConvertToInt16_ref(&input[i], &output[i], numSamples - i);
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void mixAccumulate_AVX2(const float* input, float* output, int numSamples);
+void mixAccumulateInt16_AVX2(const int16_t* input, float* output, float gain, int numSamples);
+void mixAccumulateInt16MonoToStereo_AVX2(const int16_t* input, float* output, float gain, int numFrames);
+bool mixIsSilent_AVX2(const float* input, int numSamples);
+void mixConvertToInt16_AVX2(const float* input, int16_t* output, int numSamples);
+
+void mixAccumulate(const float* input, float* output, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? mixAccumulate_AVX2 : mixAccumulate_SSE2;
+    (*f)(input, output, numSamples); // dispatch
+}
+
+void mixAccumulateInt16(const int16_t* input, float* output, float gain, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? mixAccumulateInt16_AVX2 : mixAccumulateInt16_SSE2;
+    (*f)(input, output, gain, numSamples); // dispatch
+}
+
+void mixAccumulateInt16MonoToStereo(const int16_t* input, float* output, float gain, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? mixAccumulateInt16MonoToStereo_AVX2 : mixAccumulateInt16MonoToStereo_SSE2;
+    (*f)(input, output, gain, numFrames); // dispatch
+}
+
+bool mixIsSilent(const float* input, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? mixIsSilent_AVX2 : mixIsSilent_SSE2;
+    return (*f)(input, numSamples); // dispatch
+}
+
+void mixConvertToInt16(const float* input, int16_t* output, int numSamples) {
+    static auto f = cpuSupportsAVX2() ? mixConvertToInt16_AVX2 : mixConvertToInt16_SSE2;
+    (*f)(input, output, numSamples); // dispatch
+}
+
+//
+// tails of the AVX2 kernels (compiled without AVX2, so safe to share)
+//
+
+void mixAccumulateTail(const float* input, float* output, int numSamples) {
+    mixAccumulate_ref(input, output, numSamples);
+}
+
+void mixAccumulateInt16Tail(const int16_t* input, float* output, float gain, int numSamples) {
+    mixAccumulateInt16_ref(input, output, gain, numSamples);
+}
+
+void mixAccumulateInt16MonoToStereoTail(const int16_t* input, float* output, float gain, int numFrames) {
+    mixAccumulateInt16MonoToStereo_ref(input, output, gain, numFrames);
+}
+
+bool mixIsSilentTail(const float* input, int numSamples) {
+    return mixIsSilent_ref(input, numSamples);
+}
+
+void mixConvertToInt16Tail(const float* input, int16_t* output, int numSamples) {
+    mixConvertToInt16_ref(input, output, numSamples);
+}
+
+#else   // portable reference code
+
+void mixAccumulate(const float* input, float* output, int numSamples) {
+    mixAccumulate_ref(input, output, numSamples);
+}
+
+void mixAccumulateInt16(const int16_t* input, float* output, float gain, int numSamples) {
+    mixAccumulateInt16_ref(input, output, gain, numSamples);
+}
+
+void mixAccumulateInt16MonoToStereo(const int16_t* input, float* output, float gain, int numFrames) {
+    mixAccumulateInt16MonoToStereo_ref(input, output, gain, numFrames);
+}
+
+bool mixIsSilent(const float* input, int numSamples) {
+    return mixIsSilent_ref(input, numSamples);
+}
+
+void mixConvertToInt16(const float* input, int16_t* output, int numSamples) {
+    mixConvertToInt16_ref(input, output, numSamples);
+}
+
+#endif
@@ -0,0 +1,37 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+//
+// Vectorized kernels for accumulating, testing and converting mix buffers.
+// Each kernel dispatches at runtime to AVX2 (when supported) or SSE2, with a portable
+// fallback on other architectures. Buffers need not be aligned, and any sample count is allowed.
+//
+
+// output[i] += input[i]
+void mixAccumulate(const float* input, float* output, int numSamples);
+
+// output[i] += input[i] * gain / 32767
+void mixAccumulateInt16(const int16_t* input, float* output, float gain, int numSamples);
+
+// output[2*i+0] += input[i] * gain / 32767, output[2*i+1] += input[i] * gain / 32767
+void mixAccumulateInt16MonoToStereo(const int16_t* input, float* output, float gain, int numFrames);
+
+// returns true if every sample is zero
+bool mixIsSilent(const float* input, int numSamples);
+
+// output[i] = saturate(round(input[i])), for input already scaled to 16-bit range
+void mixConvertToInt16(const float* input, int16_t* output, int numSamples);
+
+#endif // hifi_AudioMixKernels_h
@@ -0,0 +1,116 @@
+//
+//  AudioMixKernels_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "../AudioConstants.h"
+
+#ifndef __AVX2__
+#error Must be compiled with /arch:AVX2 or -mavx2 -mfma.
+#endif
+
+// scalar tails, from AudioMixKernels.cpp
+void mixAccumulateTail(const float* input, float* output, int numSamples);
+void mixAccumulateInt16Tail(const int16_t* input, float* output, float gain, int numSamples);
+void mixAccumulateInt16MonoToStereoTail(const int16_t* input, float* output, float gain, int numFrames);
+bool mixIsSilentTail(const float* input, int numSamples);
+void mixConvertToInt16Tail(const float* input, int16_t* output, int numSamples);
+
+static const float INT16_TO_FLOAT = 1.0f / AudioConstants::MAX_SAMPLE_VALUE;
+
+void mixAccumulate_AVX2(const float* input, float* output, int numSamples) {
+    int i = 0;
+    for (; i <= numSamples - 16; i += 16) {
+        __m256 x0 = _mm256_add_ps(_mm256_loadu_ps(&output[i+0]), _mm256_loadu_ps(&input[i+0]));
+        __m256 x1 = _mm256_add_ps(_mm256_loadu_ps(&output[i+8]), _mm256_loadu_ps(&input[i+8]));
+        _mm256_storeu_ps(&output[i+0], x0);
+        _mm256_storeu_ps(&output[i+8], x1);
+    }
+    mixAccumulateTail(&input[i], &output[i], numSamples - i);
+
+    _mm256_zeroupper();
+}
+
+void mixAccumulateInt16_AVX2(const int16_t* input, float* output, float gain, int numSamples) {
+    __m256 g = _mm256_set1_ps(gain * INT16_TO_FLOAT);
+    int i = 0;
+    for (; i <= numSamples - 16; i += 16) {
+        // sign-extend int16 to int32
+        __m256i x0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i+0]));
+        __m256i x1 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i+8]));
+
+        __m256 y0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x0), g, _mm256_loadu_ps(&output[i+0]));
+        __m256 y1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x1), g, _mm256_loadu_ps(&output[i+8]));
+        _mm256_storeu_ps(&output[i+0], y0);
+        _mm256_storeu_ps(&output[i+8], y1);
+    }
+    mixAccumulateInt16Tail(&input[i], &output[i], gain, numSamples - i);
+
+    _mm256_zeroupper();
+}
+
+void mixAccumulateInt16MonoToStereo_AVX2(const int16_t* input, float* output, float gain, int numFrames) {
+    __m256 g = _mm256_set1_ps(gain * INT16_TO_FLOAT);
+    int i = 0;
+    for (; i <= numFrames - 8; i += 8) {
+        // duplicate each sample to both channels, and sign-extend int16 to int32
+        __m128i x = _mm_loadu_si128((const __m128i*)&input[i]);
+        __m256i x0 = _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(x, x));
+        __m256i x1 = _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(x, x));
+
+        __m256 y0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x0), g, _mm256_loadu_ps(&output[2*i+0]));
+        __m256 y1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(x1), g, _mm256_loadu_ps(&output[2*i+8]));
+        _mm256_storeu_ps(&output[2*i+0], y0);
+        _mm256_storeu_ps(&output[2*i+8], y1);
+    }
+    mixAccumulateInt16MonoToStereoTail(&input[i], &output[2*i], gain, numFrames - i);
+
+    _mm256_zeroupper();
+}
+
+bool mixIsSilent_AVX2(const float* input, int numSamples) {
+    __m256 zero = _mm256_setzero_ps();
+    int i = 0;
+    for (; i <= numSamples - 16; i += 16) {
+        __m256 ne0 = _mm256_cmp_ps(_mm256_loadu_ps(&input[i+0]), zero, _CMP_NEQ_UQ);
+        __m256 ne1 = _mm256_cmp_ps(_mm256_loadu_ps(&input[i+8]), zero, _CMP_NEQ_UQ);
+        if (_mm256_movemask_ps(_mm256_or_ps(ne0, ne1))) {
+            _mm256_zeroupper();
+            return false;
+        }
+    }
+    _mm256_zeroupper();
+
+    return mixIsSilentTail(&input[i], numSamples - i);
+}
+
+void mixConvertToInt16_AVX2(const float* input, int16_t* output, int numSamples) {
+    __m256 lo = _mm256_set1_ps(-32768.0f);
+    __m256 hi = _mm256_set1_ps(32767.0f);
+    int i = 0;
+    for (; i <= numSamples - 16; i += 16) {
+        // clamp, since anything out of int32_t range converts to 0x80000000, then round-to-nearest (default MXCSR)
+        __m256i x0 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&input[i+0]), lo), hi));
+        __m256i x1 = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&input[i+8]), lo), hi));
+
+        // pack with signed saturation (packs within 128-bit lanes, so restore the order)
+        __m256i y = _mm256_packs_epi32(x0, x1);
+        y = _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)&output[i], y);
+    }
+    mixConvertToInt16Tail(&input[i], &output[i], numSamples - i);
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <GLMHelpers.h>
+#include <BitPacking.h>
 #include <StreamUtils.h>
 #include <UUID.h>
 #include <shared/JSONHelpers.h>
@@ -50,6 +51,7 @@ using namespace std;
 const QString AvatarData::FRAME_NAME = "com.highfidelity.recording.AvatarData";
 
 static const int TRANSLATION_COMPRESSION_RADIX = 12;
+static const float TRANSLATION_COMPRESSION_SCALE = (float)(1 << TRANSLATION_COMPRESSION_RADIX);
 static const int SENSOR_TO_WORLD_SCALE_RADIX = 10;
 static const float AUDIO_LOUDNESS_SCALE = 1024.0f;
 static const float DEFAULT_AVATAR_DENSITY = 1000.0f; // density of water
@@ -166,6 +168,56 @@ float AvatarData::getDistanceBasedMinTranslationDistance(glm::vec3 viewerPositio
     return AVATAR_MIN_TRANSLATION; // Eventually make this distance sensitive as well
 }
 
+// bits per component of an absolute joint rotation in the quantized joint data
+static const int QUANTIZED_ROTATION_MAX_BITS = 12;
+static const int QUANTIZED_ROTATION_MIN_BITS = 9;
+
+// a rotation delta is sent with fewer bits per component than an absolute rotation, at the same step size
+static const int QUANTIZED_ROTATION_DELTA_SAVED_BITS = 3;
+static const int QUANTIZED_ROTATION_SMALL_DELTA_SAVED_BITS = 6;
+
+static const int QUANTIZED_TRANSLATION_BITS = 16;
+static const int QUANTIZED_TRANSLATION_DELTA_BITS = 8;
+static const int QUANTIZED_TRANSLATION_SMALL_DELTA_BITS = 4;
+
+static const int QUANTIZED_JOINT_MODE_BITS = 2;
+enum QuantizedJointMode {
+    QuantizedJointUnchanged = 0,
+    QuantizedJointAbsolute,
+    QuantizedJointDelta,
+    QuantizedJointSmallDelta
+};
+
+int AvatarData::getDistanceBasedRotationBits(glm::vec3 viewerPosition) const {
+    auto distance = glm::distance(_globalPosition, viewerPosition);
+    int result = QUANTIZED_ROTATION_MIN_BITS;
+    if (distance < AVATAR_DISTANCE_LEVEL_1) {
+        result = QUANTIZED_ROTATION_MAX_BITS;
+    } else if (distance < AVATAR_DISTANCE_LEVEL_2) {
+        result = QUANTIZED_ROTATION_MAX_BITS - 1;
+    } else if (distance < AVATAR_DISTANCE_LEVEL_3) {
+        result = QUANTIZED_ROTATION_MAX_BITS - 2;
+    }
+    return result;
+}
+
+static glm::ivec3 translationToFixed(const glm::vec3& translation) {
+    glm::vec3 scaled = glm::round(translation * TRANSLATION_COMPRESSION_SCALE);
+    return glm::ivec3(glm::clamp(scaled, glm::vec3(INT16_MIN), glm::vec3(INT16_MAX)));
+}
+
+static glm::vec3 translationFromFixed(const glm::ivec3& fixed) {
+    return glm::vec3(fixed) / TRANSLATION_COMPRESSION_SCALE;
+}
+
+static bool fitsInSignedBits(const glm::ivec3& value, int numBits) {
+    int maxValue = (1 << (numBits - 1)) - 1;
+    int minValue = -(1 << (numBits - 1));
+    return value.x >= minValue && value.x <= maxValue &&
+        value.y >= minValue && value.y <= maxValue &&
+        value.z >= minValue && value.z <= maxValue;
+}
+
 
 // we want to track outbound data in this case...
 QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail) {
@@ -179,7 +231,8 @@ QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail) {
 
 QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
     AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust,
-    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut) const {
+    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut,
+    bool quantizedJointData, bool recordSentJoints) const {
 
     bool cullSmallChanges = (dataDetail == CullSmallData);
     bool sendAll = (dataDetail == SendAllData);
@@ -270,7 +323,8 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         | (hasParentInfo ? AvatarDataPacket::PACKET_HAS_PARENT_INFO : 0)
         | (hasAvatarLocalPosition ? AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION : 0)
         | (hasFaceTrackerInfo ? AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO : 0)
-        | (hasJointData ? AvatarDataPacket::PACKET_HAS_JOINT_DATA : 0);
+        | (hasJointData ? AvatarDataPacket::PACKET_HAS_JOINT_DATA : 0)
+        | (hasJointData && quantizedJointData ? AvatarDataPacket::PACKET_HAS_QUANTIZED_JOINT_DATA : 0);
 
     memcpy(destinationBuffer, &packetStateFlags, sizeof(packetStateFlags));
     destinationBuffer += sizeof(packetStateFlags);
@@ -468,163 +522,319 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     // If it is connected, pack up the data
     if (hasJointData) {
         auto startSection = destinationBuffer;
-        QReadLocker readLock(&_jointDataLock);
+        int maxSize = avatarDataByteArray.size() - (destinationBuffer - startPosition);
+        destinationBuffer += packJointData(destinationBuffer, maxSize, sendAll, cullSmallChanges, lastSentJointData,
+                                           distanceAdjust, viewerPosition, sentJointDataOut, quantizedJointData,
+                                           recordSentJoints);
+
+        int numBytes = destinationBuffer - startSection;
+        if (outboundDataRateOut) {
+            outboundDataRateOut->jointDataRate.increment(numBytes);
+        }
+    }
 
-        // joint rotation data
-        int numJoints = _jointData.size();
-        *destinationBuffer++ = (uint8_t)numJoints;
+    int avatarDataSize = destinationBuffer - startPosition;
+    return avatarDataByteArray.left(avatarDataSize);
+}
+
+int AvatarData::packJointData(unsigned char* destinationBuffer, int maxSize, bool sendAll, bool cullSmallChanges,
+                              const QVector<JointData>& lastSentJointData, bool distanceAdjust, glm::vec3 viewerPosition,
+                              QVector<JointData>* sentJointDataOut, bool quantizedJointData, bool recordSentJoints) const {
+    if (quantizedJointData) {
+        return packQuantizedJointData(destinationBuffer, maxSize, sendAll, cullSmallChanges, lastSentJointData,
+                                      distanceAdjust, viewerPosition, sentJointDataOut);
+    }
+
+    unsigned char* startPosition = destinationBuffer;
+    QReadLocker readLock(&_jointDataLock);
 
-        unsigned char* validityPosition = destinationBuffer;
-        unsigned char validity = 0;
-        int validityBit = 0;
+    // joint rotation data
+    int numJoints = _jointData.size();
+    *destinationBuffer++ = (uint8_t)numJoints;
+
+    unsigned char* validityPosition = destinationBuffer;
+    unsigned char validity = 0;
+    int validityBit = 0;
 
 #ifdef WANT_DEBUG
-        int rotationSentCount = 0;
-        unsigned char* beforeRotations = destinationBuffer;
+    int rotationSentCount = 0;
+    unsigned char* beforeRotations = destinationBuffer;
 #endif
 
-        if (sentJointDataOut) {
-            sentJointDataOut->resize(_jointData.size()); // Make sure the destination is resized before using it
-        }
-        float minRotationDOT = !distanceAdjust ? AVATAR_MIN_ROTATION_DOT : getDistanceBasedMinRotationDOT(viewerPosition);
+    if (sentJointDataOut) {
+        sentJointDataOut->resize(_jointData.size()); // Make sure the destination is resized before using it
+    }
+    float minRotationDOT = !distanceAdjust ? AVATAR_MIN_ROTATION_DOT : getDistanceBasedMinRotationDOT(viewerPosition);
 
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
+    for (int i = 0; i < _jointData.size(); i++) {
+        const JointData& data = _jointData[i];
 
-            // The dot product for smaller rotations is a smaller number.
-            // So if the dot() is less than the value, then the rotation is a larger angle of rotation
-            bool largeEnoughRotation = fabsf(glm::dot(data.rotation, lastSentJointData[i].rotation)) < minRotationDOT;
+        // The dot product for smaller rotations is a smaller number.
+        // So if the dot() is less than the value, then the rotation is a larger angle of rotation
+        bool largeEnoughRotation = fabsf(glm::dot(data.rotation, lastSentJointData[i].rotation)) < minRotationDOT;
 
-            if (sendAll || lastSentJointData[i].rotation != data.rotation) {
-                if (sendAll || !cullSmallChanges || largeEnoughRotation) {
-                    if (data.rotationSet) {
-                        validity |= (1 << validityBit);
+        if (sendAll || lastSentJointData[i].rotation != data.rotation) {
+            if (sendAll || !cullSmallChanges || largeEnoughRotation) {
+                if (data.rotationSet) {
+                    validity |= (1 << validityBit);
 #ifdef WANT_DEBUG
-                        rotationSentCount++;
+                    rotationSentCount++;
 #endif
-                        if (sentJointDataOut) {
-                            auto jointDataOut = *sentJointDataOut;
-                            jointDataOut[i].rotation = data.rotation;
-                        }
-
+                    if (sentJointDataOut && recordSentJoints) {
+                        auto& jointDataOut = *sentJointDataOut;
+                        jointDataOut[i].rotation = data.rotation;
                     }
+
                 }
             }
-            if (++validityBit == BITS_IN_BYTE) {
-                *destinationBuffer++ = validity;
-                validityBit = validity = 0;
-            }
         }
-        if (validityBit != 0) {
+        if (++validityBit == BITS_IN_BYTE) {
             *destinationBuffer++ = validity;
+            validityBit = validity = 0;
         }
+    }
+    if (validityBit != 0) {
+        *destinationBuffer++ = validity;
+    }
 
-        validityBit = 0;
-        validity = *validityPosition++;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (validity & (1 << validityBit)) {
-                destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
-            }
-            if (++validityBit == BITS_IN_BYTE) {
-                validityBit = 0;
-                validity = *validityPosition++;
-            }
+    validityBit = 0;
+    validity = *validityPosition++;
+    for (int i = 0; i < _jointData.size(); i++) {
+        const JointData& data = _jointData[i];
+        if (validity & (1 << validityBit)) {
+            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+        }
+        if (++validityBit == BITS_IN_BYTE) {
+            validityBit = 0;
+            validity = *validityPosition++;
         }
+    }
 
 
-        // joint translation data
-        validityPosition = destinationBuffer;
-        validity = 0;
-        validityBit = 0;
+    // joint translation data
+    validityPosition = destinationBuffer;
+    validity = 0;
+    validityBit = 0;
 
 #ifdef WANT_DEBUG
-        int translationSentCount = 0;
-        unsigned char* beforeTranslations = destinationBuffer;
+    int translationSentCount = 0;
+    unsigned char* beforeTranslations = destinationBuffer;
 #endif
 
-        float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
-
-        float maxTranslationDimension = 0.0;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (sendAll || lastSentJointData[i].translation != data.translation) {
-                if (sendAll ||
-                    !cullSmallChanges ||
-                    glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation) {
-                    if (data.translationSet) {
-                        validity |= (1 << validityBit);
+    float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
+
+    float maxTranslationDimension = 0.0;
+    for (int i = 0; i < _jointData.size(); i++) {
+        const JointData& data = _jointData[i];
+        if (sendAll || lastSentJointData[i].translation != data.translation) {
+            if (sendAll ||
+                !cullSmallChanges ||
+                glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation) {
+                if (data.translationSet) {
+                    validity |= (1 << validityBit);
 #ifdef WANT_DEBUG
-                        translationSentCount++;
+                    translationSentCount++;
 #endif
-                        maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
-                        maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
-                        maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
-
-                        if (sentJointDataOut) {
-                            auto jointDataOut = *sentJointDataOut;
-                            jointDataOut[i].translation = data.translation;
-                        }
+                    maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
+                    maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
+                    maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
 
+                    if (sentJointDataOut && recordSentJoints) {
+                        auto& jointDataOut = *sentJointDataOut;
+                        jointDataOut[i].translation = data.translation;
                     }
+
                 }
             }
-            if (++validityBit == BITS_IN_BYTE) {
-                *destinationBuffer++ = validity;
-                validityBit = validity = 0;
-            }
         }
-
-        if (validityBit != 0) {
+        if (++validityBit == BITS_IN_BYTE) {
             *destinationBuffer++ = validity;
+            validityBit = validity = 0;
         }
+    }
 
-        validityBit = 0;
-        validity = *validityPosition++;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (validity & (1 << validityBit)) {
-                destinationBuffer +=
-                    packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-            }
-            if (++validityBit == BITS_IN_BYTE) {
-                validityBit = 0;
-                validity = *validityPosition++;
-            }
+    if (validityBit != 0) {
+        *destinationBuffer++ = validity;
+    }
+
+    validityBit = 0;
+    validity = *validityPosition++;
+    for (int i = 0; i < _jointData.size(); i++) {
+        const JointData& data = _jointData[i];
+        if (validity & (1 << validityBit)) {
+            destinationBuffer +=
+                packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
         }
+        if (++validityBit == BITS_IN_BYTE) {
+            validityBit = 0;
+            validity = *validityPosition++;
+        }
+    }
 
-        // faux joints
-        Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
-        Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
-        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
-        destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
-            TRANSLATION_COMPRESSION_RADIX);
+    // faux joints
+    Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
+    Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
 
 #ifdef WANT_DEBUG
-        if (sendAll) {
-            qCDebug(avatars) << "AvatarData::toByteArray" << cullSmallChanges << sendAll
-                << "rotations:" << rotationSentCount << "translations:" << translationSentCount
-                << "largest:" << maxTranslationDimension
-                << "size:"
-                << (beforeRotations - startPosition) << "+"
-                << (beforeTranslations - beforeRotations) << "+"
-                << (destinationBuffer - beforeTranslations) << "="
-                << (destinationBuffer - startPosition);
-        }
+    if (sendAll) {
+        qCDebug(avatars) << "AvatarData::packJointData" << cullSmallChanges << sendAll
+            << "rotations:" << rotationSentCount << "translations:" << translationSentCount
+            << "largest:" << maxTranslationDimension
+            << "size:"
+            << (beforeRotations - startPosition) << "+"
+            << (beforeTranslations - beforeRotations) << "+"
+            << (destinationBuffer - beforeTranslations) << "="
+            << (destinationBuffer - startPosition);
+    }
 #endif
 
-        int numBytes = destinationBuffer - startSection;
-        if (outboundDataRateOut) {
-            outboundDataRateOut->jointDataRate.increment(numBytes);
+    return destinationBuffer - startPosition;
+}
+
+int AvatarData::packQuantizedJointData(unsigned char* destinationBuffer, int maxSize, bool sendAll, bool cullSmallChanges,
+                                       const QVector<JointData>& lastSentJointData, bool distanceAdjust,
+                                       glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut) const {
+    unsigned char* startPosition = destinationBuffer;
+    QReadLocker readLock(&_jointDataLock);
+
+    int numJoints = std::min(_jointData.size(), (int)UINT8_MAX);
+    int rotationBits = !distanceAdjust ? QUANTIZED_ROTATION_MAX_BITS : getDistanceBasedRotationBits(viewerPosition);
+    int deltaBits = rotationBits - QUANTIZED_ROTATION_DELTA_SAVED_BITS;
+    int smallDeltaBits = rotationBits - QUANTIZED_ROTATION_SMALL_DELTA_SAVED_BITS;
+    float deltaRange = smallRotationRange(deltaBits, rotationBits);
+    float smallDeltaRange = smallRotationRange(smallDeltaBits, rotationBits);
+
+    *destinationBuffer++ = (uint8_t)numJoints;
+    *destinationBuffer++ = (uint8_t)rotationBits;
+    unsigned char* numStreamBytesPosition = destinationBuffer;
+    destinationBuffer += sizeof(uint16_t);
+
+    if (sentJointDataOut) {
+        sentJointDataOut->resize(_jointData.size()); // Make sure the destination is resized before using it
+    }
+    float minRotationDOT = !distanceAdjust ? AVATAR_MIN_ROTATION_DOT : getDistanceBasedMinRotationDOT(viewerPosition);
+    float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
+
+    // the stream gets what is left after its header and the faux joints
+    const int FAUX_JOINTS_SIZE = 2 * (6 + 3 * sizeof(int16_t));
+    int maxStreamBytes = std::max(maxSize - (int)(destinationBuffer - startPosition) - FAUX_JOINTS_SIZE, 0);
+
+    // what the receiver will decode, recorded once we know the stream fit
+    std::vector<JointData> sentJoints;
+    sentJoints.reserve(numJoints);
+
+    BitWriter writer(destinationBuffer, maxStreamBytes);
+    for (int i = 0; i < numJoints; i++) {
+        const JointData& data = _jointData[i];
+
+        // copied, since sentJointDataOut may be the same vector as lastSentJointData
+        JointData last = i < lastSentJointData.size() ? lastSentJointData[i] : JointData();
+        JointData sent = last;
+
+        // the same rules as the unquantized joint data decide which joints are sent, deltas are only used
+        // when the receiver has the rotation we predict from, and never in a full update, so that full
+        // updates resync the receiver
+        bool sendRotation = data.rotationSet && (sendAll || last.rotation != data.rotation) &&
+            (sendAll || !cullSmallChanges || fabsf(glm::dot(data.rotation, last.rotation)) < minRotationDOT);
+        bool canPredict = !sendAll && last.rotationSet;
+        glm::quat delta = glm::inverse(last.rotation) * data.rotation;
+
+        if (!sendRotation) {
+            writer.write(QuantizedJointUnchanged, QUANTIZED_JOINT_MODE_BITS);
+        } else if (canPredict && isSmallRotation(delta, smallDeltaRange)) {
+            writer.write(QuantizedJointSmallDelta, QUANTIZED_JOINT_MODE_BITS);
+            sent.rotation = glm::normalize(last.rotation * packSmallRotation(writer, delta, smallDeltaBits, smallDeltaRange));
+            sent.rotationSet = true;
+        } else if (canPredict && isSmallRotation(delta, deltaRange)) {
+            writer.write(QuantizedJointDelta, QUANTIZED_JOINT_MODE_BITS);
+            sent.rotation = glm::normalize(last.rotation * packSmallRotation(writer, delta, deltaBits, deltaRange));
+            sent.rotationSet = true;
+        } else {
+            writer.write(QuantizedJointAbsolute, QUANTIZED_JOINT_MODE_BITS);
+            sent.rotation = packOrientationQuatSmallestThree(writer, data.rotation, rotationBits);
+            sent.rotationSet = true;
+        }
+
+        bool sendTranslation = data.translationSet && (sendAll || last.translation != data.translation) &&
+            (sendAll || !cullSmallChanges || glm::distance(data.translation, last.translation) > minTranslation);
+        glm::ivec3 fixed = translationToFixed(data.translation);
+        glm::ivec3 fixedDelta = fixed - translationToFixed(last.translation);
+
+        if (!sendTranslation || (!sendAll && last.translationSet && fixedDelta == glm::ivec3(0))) {
+            writer.write(QuantizedJointUnchanged, QUANTIZED_JOINT_MODE_BITS);
+        } else if (!sendAll && last.translationSet && fitsInSignedBits(fixedDelta, QUANTIZED_TRANSLATION_SMALL_DELTA_BITS)) {
+            writer.write(QuantizedJointSmallDelta, QUANTIZED_JOINT_MODE_BITS);
+            writer.writeSigned(fixedDelta.x, QUANTIZED_TRANSLATION_SMALL_DELTA_BITS);
+            writer.writeSigned(fixedDelta.y, QUANTIZED_TRANSLATION_SMALL_DELTA_BITS);
+            writer.writeSigned(fixedDelta.z, QUANTIZED_TRANSLATION_SMALL_DELTA_BITS);
+            sent.translation = translationFromFixed(fixed);
+            sent.translationSet = true;
+        } else if (!sendAll && last.translationSet && fitsInSignedBits(fixedDelta, QUANTIZED_TRANSLATION_DELTA_BITS)) {
+            writer.write(QuantizedJointDelta, QUANTIZED_JOINT_MODE_BITS);
+            writer.writeSigned(fixedDelta.x, QUANTIZED_TRANSLATION_DELTA_BITS);
+            writer.writeSigned(fixedDelta.y, QUANTIZED_TRANSLATION_DELTA_BITS);
+            writer.writeSigned(fixedDelta.z, QUANTIZED_TRANSLATION_DELTA_BITS);
+            sent.translation = translationFromFixed(fixed);
+            sent.translationSet = true;
+        } else {
+            writer.write(QuantizedJointAbsolute, QUANTIZED_JOINT_MODE_BITS);
+            writer.writeSigned(fixed.x, QUANTIZED_TRANSLATION_BITS);
+            writer.writeSigned(fixed.y, QUANTIZED_TRANSLATION_BITS);
+            writer.writeSigned(fixed.z, QUANTIZED_TRANSLATION_BITS);
+            sent.translation = translationFromFixed(fixed);
+            sent.translationSet = true;
         }
+
+        sentJoints.push_back(sent);
     }
 
-    int avatarDataSize = destinationBuffer - startPosition;
-    return avatarDataByteArray.left(avatarDataSize);
+    int numStreamBytes = writer.getNumBytes();
+    if (writer.isOverflowed()) {
+        // the receiver would decode a truncated stream, so send every joint as unchanged instead,
+        // and leave the sent joints as they were so that the next update predicts from what the receiver has
+        qCWarning(avatars) << "AvatarData::packQuantizedJointData joint data does not fit in" << maxStreamBytes
+            << "bytes, sending joints unchanged";
+        BitWriter unchangedWriter(destinationBuffer, maxStreamBytes);
+        for (int i = 0; i < numJoints; i++) {
+            unchangedWriter.write(QuantizedJointUnchanged, QUANTIZED_JOINT_MODE_BITS);
+            unchangedWriter.write(QuantizedJointUnchanged, QUANTIZED_JOINT_MODE_BITS);
+        }
+        numStreamBytes = unchangedWriter.getNumBytes();
+    } else if (sentJointDataOut) {
+        // record what the receiver will decode, so that the next deltas predict from the same value
+        std::copy(sentJoints.begin(), sentJoints.end(), sentJointDataOut->begin());
+    }
+
+    uint16_t numStreamBytesOut = (uint16_t)numStreamBytes;
+    memcpy(numStreamBytesPosition, &numStreamBytesOut, sizeof(numStreamBytesOut));
+    destinationBuffer += numStreamBytes;
+
+    // faux joints
+    Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerLeftHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
+    Transform controllerRightHandTransform = Transform(getControllerRightHandMatrix());
+    destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerRightHandTransform.getRotation());
+    destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, controllerRightHandTransform.getTranslation(),
+        TRANSLATION_COMPRESSION_RADIX);
+
+#ifdef WANT_DEBUG
+    if (sendAll) {
+        qCDebug(avatars) << "AvatarData::packQuantizedJointData" << cullSmallChanges << sendAll
+            << "rotationBits:" << rotationBits << "size:" << (destinationBuffer - startPosition);
+    }
+#endif
+
+    return destinationBuffer - startPosition;
 }
+
 // NOTE: This is never used in a "distanceAdjust" mode, so it's ok that it doesn't use a variable minimum rotation/translation
 void AvatarData::doneEncoding(bool cullSmallChanges) {
     // The server has finished sending this version of the joint-data to other nodes.  Update _lastSentJointData.
@@ -718,6 +928,7 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     bool hasAvatarLocalPosition  = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION);
     bool hasFaceTrackerInfo      = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO);
     bool hasJointData            = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA);
+    bool hasQuantizedJointData   = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_QUANTIZED_JOINT_DATA);
 
     quint64 now = usecTimestampNow();
 
@@ -975,7 +1186,89 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         _faceTrackerUpdateRate.increment();
     }
 
-    if (hasJointData) {
+    if (hasJointData && hasQuantizedJointData) {
+        auto startSection = sourceBuffer;
+
+        PACKET_READ_CHECK(QuantizedJointDataHeader, AvatarDataPacket::QUANTIZED_JOINT_DATA_HEADER_SIZE);
+        int numJoints = *sourceBuffer++;
+        int rotationBits = *sourceBuffer++;
+        uint16_t numStreamBytes;
+        memcpy(&numStreamBytes, sourceBuffer, sizeof(numStreamBytes));
+        sourceBuffer += sizeof(numStreamBytes);
+
+        if (rotationBits < QUANTIZED_ROTATION_MIN_BITS || rotationBits > QUANTIZED_ROTATION_MAX_BITS) {
+            if (shouldLogError(now)) {
+                qCWarning(avatars) << "AvatarData packet has invalid joint rotation bits" << rotationBits
+                    << getSessionUUID();
+            }
+            return buffer.size();
+        }
+        int deltaBits = rotationBits - QUANTIZED_ROTATION_DELTA_SAVED_BITS;
+        int smallDeltaBits = rotationBits - QUANTIZED_ROTATION_SMALL_DELTA_SAVED_BITS;
+        float deltaRange = smallRotationRange(deltaBits, rotationBits);
+        float smallDeltaRange = smallRotationRange(smallDeltaBits, rotationBits);
+
+        PACKET_READ_CHECK(QuantizedJointStream, numStreamBytes);
+        BitReader reader(sourceBuffer, numStreamBytes);
+
+        QWriteLocker writeLock(&_jointDataLock);
+        _jointData.resize(numJoints);
+
+        for (int i = 0; i < numJoints; i++) {
+            JointData& data = _jointData[i];
+
+            // rotation deltas and translation deltas are relative to the last values we received
+            int rotationMode = (int)reader.read(QUANTIZED_JOINT_MODE_BITS);
+            if (rotationMode == QuantizedJointAbsolute) {
+                data.rotation = unpackOrientationQuatSmallestThree(reader, rotationBits);
+            } else if (rotationMode == QuantizedJointDelta) {
+                data.rotation = glm::normalize(data.rotation * unpackSmallRotation(reader, deltaBits, deltaRange));
+            } else if (rotationMode == QuantizedJointSmallDelta) {
+                data.rotation = glm::normalize(data.rotation * unpackSmallRotation(reader, smallDeltaBits, smallDeltaRange));
+            }
+            if (rotationMode != QuantizedJointUnchanged) {
+                _hasNewJointData = true;
+                data.rotationSet = true;
+            }
+
+            int translationMode = (int)reader.read(QUANTIZED_JOINT_MODE_BITS);
+            if (translationMode != QuantizedJointUnchanged) {
+                int numBits = QUANTIZED_TRANSLATION_BITS;
+                glm::ivec3 fixed(0);
+                if (translationMode == QuantizedJointDelta) {
+                    numBits = QUANTIZED_TRANSLATION_DELTA_BITS;
+                    fixed = translationToFixed(data.translation);
+                } else if (translationMode == QuantizedJointSmallDelta) {
+                    numBits = QUANTIZED_TRANSLATION_SMALL_DELTA_BITS;
+                    fixed = translationToFixed(data.translation);
+                }
+                fixed.x += reader.readSigned(numBits);
+                fixed.y += reader.readSigned(numBits);
+                fixed.z += reader.readSigned(numBits);
+                data.translation = translationFromFixed(fixed);
+                _hasNewJointData = true;
+                data.translationSet = true;
+            }
+        }
+
+        if (reader.isOverflowed()) {
+            if (shouldLogError(now)) {
+                qCWarning(avatars) << "AvatarData packet joint stream ended early" << getSessionUUID();
+            }
+            return buffer.size();
+        }
+        sourceBuffer += numStreamBytes;
+
+        // faux joints
+        const int FAUX_JOINT_SIZE = 12;
+        PACKET_READ_CHECK(FauxJoints, 2 * FAUX_JOINT_SIZE);
+        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
+        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
+
+        int numBytesRead = sourceBuffer - startSection;
+        _jointDataRate.increment(numBytesRead);
+        _jointDataUpdateRate.increment();
+    } else if (hasJointData) {
         auto startSection = sourceBuffer;
 
         PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
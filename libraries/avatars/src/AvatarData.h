@@ -137,6 +137,7 @@ namespace AvatarDataPacket {
     const HasFlags PACKET_HAS_AVATAR_LOCAL_POSITION  = 1U << 9;
     const HasFlags PACKET_HAS_FACE_TRACKER_INFO      = 1U << 10;
     const HasFlags PACKET_HAS_JOINT_DATA             = 1U << 11;
+    const HasFlags PACKET_HAS_QUANTIZED_JOINT_DATA   = 1U << 12; // joint data uses the QuantizedJointData layout
     const size_t AVATAR_HAS_FLAGS_SIZE = 2;
 
     // NOTE: AvatarDataPackets start with a uint16_t sequence number that is not reflected in the Header structure.
@@ -239,6 +240,28 @@ namespace AvatarDataPacket {
         SixByteTrans translation[numValidTranslations];        // encodeded and compressed by packFloatVec3ToSignedTwoByteFixed()
     };
     */
+
+    // variable length structure follows, used in place of JointData when PACKET_HAS_QUANTIZED_JOINT_DATA is set
+    /*
+    struct QuantizedJointData {
+        uint8_t numJoints;
+        uint8_t rotationBits;                  // bits per component of an absolute rotation, picked by viewer distance
+        uint16_t numStreamBytes;
+        uint8_t stream[numStreamBytes];        // per joint, least significant bit first:
+                                               //   2 bit rotation mode - unchanged, absolute, delta, small delta
+                                               //     absolute - packOrientationQuatSmallestThree() at rotationBits
+                                               //     delta - packSmallRotation() of the change from the last sent rotation,
+                                               //             at rotationBits - 3 or rotationBits - 6
+                                               //   2 bit translation mode - unchanged, absolute, delta, small delta
+                                               //     absolute - 3 x 16 bit fixed point, as packFloatVec3ToSignedTwoByteFixed()
+                                               //     delta - 3 x 8 or 3 x 4 bit change in the fixed point value
+        SixByteQuat leftHandControllerRotation;  // faux joints, as in JointData
+        SixByteTrans leftHandControllerTranslation;
+        SixByteQuat rightHandControllerRotation;
+        SixByteTrans rightHandControllerTranslation;
+    };
+    */
+    const size_t QUANTIZED_JOINT_DATA_HEADER_SIZE = 4;
 }
 
 static const float MAX_AVATAR_SCALE = 1000.0f;
@@ -389,7 +412,17 @@ public:
 
     virtual QByteArray toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
         AvatarDataPacket::HasFlags& hasFlagsOut, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
-        QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr) const;
+        QVector<JointData>* sentJointDataOut, AvatarDataRate* outboundDataRateOut = nullptr,
+        bool quantizedJointData = false, bool recordSentJoints = false) const;
+
+    // packs the joint data section, which is always the last section written by toByteArray
+    // maxSize is the room left at destinationBuffer, quantized joints that don't fit in it are sent as unchanged
+    // the unquantized joints sent are only written to sentJointDataOut when recordSentJoints is set, the per-receiver
+    // encode leaves its history alone so that a culled joint lost with an unreliable packet is sent again
+    // returns the number of bytes written
+    int packJointData(unsigned char* destinationBuffer, int maxSize, bool sendAll, bool cullSmallChanges,
+        const QVector<JointData>& lastSentJointData, bool distanceAdjust, glm::vec3 viewerPosition,
+        QVector<JointData>* sentJointDataOut, bool quantizedJointData = false, bool recordSentJoints = false) const;
 
     virtual void doneEncoding(bool cullSmallChanges);
 
@@ -655,6 +688,11 @@ protected:
 
     float getDistanceBasedMinRotationDOT(glm::vec3 viewerPosition) const;
     float getDistanceBasedMinTranslationDistance(glm::vec3 viewerPosition) const;
+    int getDistanceBasedRotationBits(glm::vec3 viewerPosition) const;
+
+    int packQuantizedJointData(unsigned char* destinationBuffer, int maxSize, bool sendAll, bool cullSmallChanges,
+        const QVector<JointData>& lastSentJointData, bool distanceAdjust, glm::vec3 viewerPosition,
+        QVector<JointData>* sentJointDataOut) const;
 
     bool avatarBoundingBoxChangedSince(quint64 time) const { return _avatarBoundingBoxChanged >= time; }
     bool avatarScaleChangedSince(quint64 time) const { return _avatarScaleChanged >= time; }
@@ -0,0 +1,492 @@
+//
+//  EntityBoundsIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityBoundsIndex.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include <glm/gtx/norm.hpp>
+
+#include "EntityItem.h"
+
+const int MAX_LEAF_ENTRIES = 8;
+
+// the hierarchy is rebuilt once more than this many entries, or this fraction of the live ones, are pending or stale
+const int MIN_STALE_ENTRIES_FOR_REBUILD = 64;
+const int STALE_FRACTION_FOR_REBUILD = 8;
+
+static bool boundsTouchBox(const glm::vec3& minimum, const glm::vec3& maximum,
+                           const glm::vec3& boxMinimum, const glm::vec3& boxMaximum) {
+    return minimum.x <= boxMaximum.x && maximum.x >= boxMinimum.x &&
+        minimum.y <= boxMaximum.y && maximum.y >= boxMinimum.y &&
+        minimum.z <= boxMaximum.z && maximum.z >= boxMinimum.z;
+}
+
+static float distanceSquaredToBounds(const glm::vec3& point, const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 nearest = glm::clamp(point, minimum, maximum);
+    return glm::distance2(point, nearest);
+}
+
+// distance along the ray to where it enters the bounds, 0 if it starts inside them
+static bool rayHitsBounds(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& inverseDirection,
+                          const glm::vec3& minimum, const glm::vec3& maximum, float& distance) {
+    float nearDistance = 0.0f;
+    float farDistance = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        if (direction[axis] == 0.0f) {
+            if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float toMinimum = (minimum[axis] - origin[axis]) * inverseDirection[axis];
+        float toMaximum = (maximum[axis] - origin[axis]) * inverseDirection[axis];
+        nearDistance = std::max(nearDistance, std::min(toMinimum, toMaximum));
+        farDistance = std::min(farDistance, std::max(toMinimum, toMaximum));
+        if (nearDistance > farDistance) {
+            return false;
+        }
+    }
+    distance = nearDistance;
+    return true;
+}
+
+void EntityBoundsIndex::insert(const EntityItemPointer& entity, const AACube& bounds) {
+    QWriteLocker locker(&_lock);
+    EntityItemID entityID = entity->getEntityItemID();
+
+    auto existing = _entryByID.constFind(entityID);
+    if (existing != _entryByID.constEnd()) {
+        // an entity moving between elements is removed and added again, reuse its entry
+        int entry = existing.value();
+        if (!_entities[entry]) {
+            _liveCount++; // remove() already counted it as stale
+        } else if (entry < _treeEntryCount) {
+            _staleCount++;
+        }
+        _entities[entry] = entity;
+        setBounds(entry, bounds);
+        if (entry < _treeEntryCount) {
+            refit(entry);
+        }
+        return;
+    }
+
+    int entry = (int)_entities.size();
+    _minX.push_back(0.0f);
+    _minY.push_back(0.0f);
+    _minZ.push_back(0.0f);
+    _maxX.push_back(0.0f);
+    _maxY.push_back(0.0f);
+    _maxZ.push_back(0.0f);
+    _entities.push_back(entity);
+    _entityIDs.push_back(entityID);
+    _entryLeaves.push_back(-1);
+    setBounds(entry, bounds);
+    _entryByID.insert(entityID, entry);
+    _liveCount++;
+}
+
+void EntityBoundsIndex::remove(const EntityItemID& entityID) {
+    QWriteLocker locker(&_lock);
+    auto existing = _entryByID.find(entityID);
+    if (existing == _entryByID.end()) {
+        return;
+    }
+
+    int entry = existing.value();
+    if (entry >= _treeEntryCount) {
+        _entryByID.erase(existing);
+        removePendingEntry(entry);
+        _liveCount--;
+    } else if (_entities[entry]) {
+        // leave the entry in the hierarchy until the next rebuild, in case the entity is only changing elements
+        _entities[entry].reset();
+        _liveCount--;
+        _staleCount++;
+    }
+}
+
+void EntityBoundsIndex::clear() {
+    QWriteLocker locker(&_lock);
+    _minX.clear();
+    _minY.clear();
+    _minZ.clear();
+    _maxX.clear();
+    _maxY.clear();
+    _maxZ.clear();
+    _entities.clear();
+    _entityIDs.clear();
+    _entryLeaves.clear();
+    _entryByID.clear();
+    _nodes.clear();
+    _treeEntryCount = 0;
+    _liveCount = 0;
+    _staleCount = 0;
+}
+
+int EntityBoundsIndex::size() const {
+    QReadLocker locker(&_lock);
+    return _liveCount;
+}
+
+void EntityBoundsIndex::findEntities(const AABox& box, EntityFunctor entityFunctor) {
+    glm::vec3 boxMinimum = box.getMinimumPoint();
+    glm::vec3 boxMaximum = box.getMaximumPoint();
+
+    rebuildIfNeeded();
+    QReadLocker locker(&_lock);
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return boundsTouchBox(minimum, maximum, boxMinimum, boxMaximum);
+    }, entityFunctor);
+}
+
+void EntityBoundsIndex::findEntities(const glm::vec3& center, float radius, EntityFunctor entityFunctor) {
+    float radiusSquared = radius * radius;
+
+    rebuildIfNeeded();
+    QReadLocker locker(&_lock);
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return distanceSquaredToBounds(center, minimum, maximum) <= radiusSquared;
+    }, entityFunctor);
+}
+
+void EntityBoundsIndex::findEntities(const ViewFrustum& frustum, EntityFunctor entityFunctor) {
+    rebuildIfNeeded();
+    QReadLocker locker(&_lock);
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        AABox bounds(minimum, maximum - minimum);
+        return frustum.boxIntersectsFrustum(bounds) || frustum.boxIntersectsKeyhole(bounds);
+    }, entityFunctor);
+}
+
+void EntityBoundsIndex::findRayCandidates(const glm::vec3& origin, const glm::vec3& direction, const float& distance,
+                                          EntityFunctor entityFunctor) {
+    glm::vec3 inverseDirection;
+    for (int axis = 0; axis < 3; axis++) {
+        inverseDirection[axis] = direction[axis] == 0.0f ? 0.0f : 1.0f / direction[axis];
+    }
+
+    struct Candidate {
+        float distance;
+        int index;
+        bool operator<(const Candidate& other) const { return distance < other.distance; }
+    };
+    std::vector<Candidate> entries;
+
+    auto visitEntries = [&]() {
+        std::sort(entries.begin(), entries.end());
+        for (const auto& candidate : entries) {
+            if (candidate.distance >= distance) {
+                break;
+            }
+            entityFunctor(_entities[candidate.index]);
+        }
+        entries.clear();
+    };
+
+    auto entryDistance = [&](int entry, float& hitDistance) {
+        return _entities[entry] && rayHitsBounds(origin, direction, inverseDirection,
+                                                 glm::vec3(_minX[entry], _minY[entry], _minZ[entry]),
+                                                 glm::vec3(_maxX[entry], _maxY[entry], _maxZ[entry]), hitDistance);
+    };
+
+    rebuildIfNeeded();
+    QReadLocker locker(&_lock);
+
+    // the pending entries first, a hit among them shortens the walk through the hierarchy
+    int entryCount = (int)_entities.size();
+    for (int entry = _treeEntryCount; entry < entryCount; entry++) {
+        float candidateDistance;
+        if (entryDistance(entry, candidateDistance) && candidateDistance < distance) {
+            entries.push_back({ candidateDistance, entry });
+        }
+    }
+    visitEntries();
+
+    std::vector<Candidate> stack;
+    float rootDistance;
+    if (!_nodes.empty() &&
+        rayHitsBounds(origin, direction, inverseDirection, _nodes[0].minimum, _nodes[0].maximum, rootDistance)) {
+        stack.push_back({ rootDistance, 0 });
+    }
+
+    while (!stack.empty()) {
+        Candidate candidate = stack.back();
+        stack.pop_back();
+        if (candidate.distance >= distance) {
+            continue;
+        }
+
+        const Node& node = _nodes[candidate.index];
+        if (node.count > 0) {
+            for (int entry = node.first; entry < node.first + node.count; entry++) {
+                float candidateDistance;
+                if (entryDistance(entry, candidateDistance) && candidateDistance < distance) {
+                    entries.push_back({ candidateDistance, entry });
+                }
+            }
+            visitEntries();
+            continue;
+        }
+
+        // push the farther child first so the nearer one is searched first
+        Candidate children[2];
+        int childCount = 0;
+        for (int child = node.first; child < node.first + 2; child++) {
+            float childDistance;
+            if (rayHitsBounds(origin, direction, inverseDirection, _nodes[child].minimum, _nodes[child].maximum,
+                              childDistance) && childDistance < distance) {
+                children[childCount++] = { childDistance, child };
+            }
+        }
+        if (childCount == 2 && children[1].distance > children[0].distance) {
+            std::swap(children[0], children[1]);
+        }
+        for (int i = 0; i < childCount; i++) {
+            stack.push_back(children[i]);
+        }
+    }
+}
+
+EntityItemPointer EntityBoundsIndex::findClosestEntity(const glm::vec3& position, float radius) {
+    EntityItemPointer closestEntity;
+    float closestDistanceSquared = radius * radius;
+
+    rebuildIfNeeded();
+    QReadLocker locker(&_lock);
+    forEachCandidate([&](const glm::vec3& minimum, const glm::vec3& maximum) {
+        return distanceSquaredToBounds(position, minimum, maximum) <= closestDistanceSquared;
+    }, [&](const EntityItemPointer& entity) {
+        float distanceSquared = glm::distance2(position, entity->getPosition());
+        if (distanceSquared < closestDistanceSquared || (!closestEntity && distanceSquared <= closestDistanceSquared)) {
+            closestEntity = entity;
+            closestDistanceSquared = distanceSquared;
+        }
+    });
+    return closestEntity;
+}
+
+template <typename BoundsTest>
+void EntityBoundsIndex::forEachCandidate(BoundsTest boundsTest, const EntityFunctor& entityFunctor) {
+    auto visitEntry = [&](int entry) {
+        if (_entities[entry] && boundsTest(glm::vec3(_minX[entry], _minY[entry], _minZ[entry]),
+                                           glm::vec3(_maxX[entry], _maxY[entry], _maxZ[entry]))) {
+            entityFunctor(_entities[entry]);
+        }
+    };
+
+    std::vector<int> stack;
+    if (!_nodes.empty()) {
+        stack.push_back(0);
+    }
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+        if (!boundsTest(node.minimum, node.maximum)) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (int entry = node.first; entry < node.first + node.count; entry++) {
+                visitEntry(entry);
+            }
+        } else {
+            stack.push_back(node.first + 1);
+            stack.push_back(node.first);
+        }
+    }
+
+    int entryCount = (int)_entities.size();
+    for (int entry = _treeEntryCount; entry < entryCount; entry++) {
+        visitEntry(entry);
+    }
+}
+
+void EntityBoundsIndex::setBounds(int entry, const AACube& bounds) {
+    glm::vec3 minimum = bounds.getMinimumPoint();
+    glm::vec3 maximum = bounds.getMaximumPoint();
+    _minX[entry] = minimum.x;
+    _minY[entry] = minimum.y;
+    _minZ[entry] = minimum.z;
+    _maxX[entry] = maximum.x;
+    _maxY[entry] = maximum.y;
+    _maxZ[entry] = maximum.z;
+}
+
+void EntityBoundsIndex::refit(int entry) {
+    glm::vec3 minimum(_minX[entry], _minY[entry], _minZ[entry]);
+    glm::vec3 maximum(_maxX[entry], _maxY[entry], _maxZ[entry]);
+
+    // grow the nodes above the entry until one already holds it, nodes are never shrunk until the next rebuild
+    for (int nodeIndex = _entryLeaves[entry]; nodeIndex >= 0; nodeIndex = _nodes[nodeIndex].parent) {
+        Node& node = _nodes[nodeIndex];
+        glm::vec3 newMinimum = glm::min(node.minimum, minimum);
+        glm::vec3 newMaximum = glm::max(node.maximum, maximum);
+        if (newMinimum == node.minimum && newMaximum == node.maximum) {
+            break;
+        }
+        node.minimum = newMinimum;
+        node.maximum = newMaximum;
+    }
+}
+
+void EntityBoundsIndex::removePendingEntry(int entry) {
+    // move the last entry into the hole, pending entries aren't in any order
+    int last = (int)_entities.size() - 1;
+    if (entry != last) {
+        _minX[entry] = _minX[last];
+        _minY[entry] = _minY[last];
+        _minZ[entry] = _minZ[last];
+        _maxX[entry] = _maxX[last];
+        _maxY[entry] = _maxY[last];
+        _maxZ[entry] = _maxZ[last];
+        _entities[entry] = _entities[last];
+        _entityIDs[entry] = _entityIDs[last];
+        _entryLeaves[entry] = _entryLeaves[last];
+        _entryByID[_entityIDs[entry]] = entry;
+    }
+    _minX.pop_back();
+    _minY.pop_back();
+    _minZ.pop_back();
+    _maxX.pop_back();
+    _maxY.pop_back();
+    _maxZ.pop_back();
+    _entities.pop_back();
+    _entityIDs.pop_back();
+    _entryLeaves.pop_back();
+}
+
+bool EntityBoundsIndex::needsRebuild() const {
+    int pendingCount = (int)_entities.size() - _treeEntryCount;
+    int staleCount = _staleCount + pendingCount;
+    return staleCount > std::max(MIN_STALE_ENTRIES_FOR_REBUILD, _liveCount / STALE_FRACTION_FOR_REBUILD);
+}
+
+void EntityBoundsIndex::rebuildIfNeeded() {
+    {
+        QReadLocker locker(&_lock);
+        if (!needsRebuild()) {
+            return;
+        }
+    }
+
+    QWriteLocker locker(&_lock);
+    if (needsRebuild()) {
+        rebuild();
+    }
+}
+
+void EntityBoundsIndex::rebuild() {
+    int entryCount = (int)_entities.size();
+    std::vector<int> entries;
+    std::vector<glm::vec3> centers(entryCount);
+    entries.reserve(_liveCount);
+    for (int entry = 0; entry < entryCount; entry++) {
+        if (_entities[entry]) {
+            entries.push_back(entry);
+            centers[entry] = glm::vec3(_minX[entry] + _maxX[entry], _minY[entry] + _maxY[entry],
+                                       _minZ[entry] + _maxZ[entry]) * 0.5f;
+        }
+    }
+
+    _nodes.clear();
+    if (!entries.empty()) {
+        _nodes.reserve(2 * (entries.size() / MAX_LEAF_ENTRIES + 1));
+        _nodes.push_back(Node());
+        _nodes[0].parent = -1;
+        buildNode(0, entries, centers, 0, (int)entries.size());
+    }
+
+    // lay the entries out in leaf order, dropping the removed ones
+    int liveCount = (int)entries.size();
+    std::vector<float> minX(liveCount), minY(liveCount), minZ(liveCount);
+    std::vector<float> maxX(liveCount), maxY(liveCount), maxZ(liveCount);
+    std::vector<EntityItemPointer> entities(liveCount);
+    std::vector<EntityItemID> entityIDs(liveCount);
+    for (int i = 0; i < liveCount; i++) {
+        int entry = entries[i];
+        minX[i] = _minX[entry];
+        minY[i] = _minY[entry];
+        minZ[i] = _minZ[entry];
+        maxX[i] = _maxX[entry];
+        maxY[i] = _maxY[entry];
+        maxZ[i] = _maxZ[entry];
+        entities[i] = std::move(_entities[entry]);
+        entityIDs[i] = _entityIDs[entry];
+    }
+    _minX.swap(minX);
+    _minY.swap(minY);
+    _minZ.swap(minZ);
+    _maxX.swap(maxX);
+    _maxY.swap(maxY);
+    _maxZ.swap(maxZ);
+    _entities.swap(entities);
+    _entityIDs.swap(entityIDs);
+
+    _entryLeaves.assign(liveCount, -1);
+    for (int nodeIndex = 0; nodeIndex < (int)_nodes.size(); nodeIndex++) {
+        const Node& node = _nodes[nodeIndex];
+        for (int entry = node.first; node.count > 0 && entry < node.first + node.count; entry++) {
+            _entryLeaves[entry] = nodeIndex;
+        }
+    }
+
+    _entryByID.clear();
+    _entryByID.reserve(liveCount);
+    for (int entry = 0; entry < liveCount; entry++) {
+        _entryByID.insert(_entityIDs[entry], entry);
+    }
+
+    _treeEntryCount = liveCount;
+    _liveCount = liveCount;
+    _staleCount = 0;
+}
+
+void EntityBoundsIndex::buildNode(int nodeIndex, std::vector<int>& entries, const std::vector<glm::vec3>& centers,
+                                  int begin, int end) {
+    glm::vec3 minimum(FLT_MAX);
+    glm::vec3 maximum(-FLT_MAX);
+    glm::vec3 centerMinimum(FLT_MAX);
+    glm::vec3 centerMaximum(-FLT_MAX);
+    for (int i = begin; i < end; i++) {
+        int entry = entries[i];
+        minimum = glm::min(minimum, glm::vec3(_minX[entry], _minY[entry], _minZ[entry]));
+        maximum = glm::max(maximum, glm::vec3(_maxX[entry], _maxY[entry], _maxZ[entry]));
+        centerMinimum = glm::min(centerMinimum, centers[entry]);
+        centerMaximum = glm::max(centerMaximum, centers[entry]);
+    }
+    _nodes[nodeIndex].minimum = minimum;
+    _nodes[nodeIndex].maximum = maximum;
+
+    if (end - begin <= MAX_LEAF_ENTRIES) {
+        _nodes[nodeIndex].first = begin;
+        _nodes[nodeIndex].count = end - begin;
+        return;
+    }
+
+    // split at the median of the entry centers along the axis they are most spread out on
+    glm::vec3 spread = centerMaximum - centerMinimum;
+    int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+    int middle = begin + (end - begin) / 2;
+    std::nth_element(entries.begin() + begin, entries.begin() + middle, entries.begin() + end, [&](int a, int b) {
+        return centers[a][axis] < centers[b][axis];
+    });
+
+    int firstChild = (int)_nodes.size();
+    _nodes.resize(firstChild + 2);
+    _nodes[firstChild].parent = nodeIndex;
+    _nodes[firstChild + 1].parent = nodeIndex;
+    _nodes[nodeIndex].first = firstChild;
+    _nodes[nodeIndex].count = 0;
+
+    buildNode(firstChild, entries, centers, begin, middle);
+    buildNode(firstChild + 1, entries, centers, middle, end);
+}
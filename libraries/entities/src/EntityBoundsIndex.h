@@ -0,0 +1,106 @@
+//
+//  EntityBoundsIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBoundsIndex_h
+#define hifi_EntityBoundsIndex_h
+
+#include <functional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include <AABox.h>
+#include <AACube.h>
+#include <ViewFrustum.h>
+
+#include "EntityItemID.h"
+#include "EntityTypes.h"
+
+/// Flat spatial index of every entity in an EntityTree, used by the tree's spatial queries instead of walking the octree.
+/// Each entity is kept with the bounds of the octree element that contains it, so a query here considers exactly the
+/// entities the octree walk would have, and the caller still does the precise per-entity tests. Bounds are kept as
+/// separate arrays of floats, ordered by the leaves of a compact bounding volume hierarchy so that a leaf is a run of
+/// neighbouring entries. An entity that moves to a new element is updated in place and the hierarchy above it refit,
+/// new entities are kept in a short list that is searched linearly, and the hierarchy is rebuilt by the next query once
+/// enough of it has gone stale.
+class EntityBoundsIndex {
+public:
+    using EntityFunctor = std::function<void(const EntityItemPointer&)>;
+
+    /// Adds the entity, or updates its bounds if it is already in the index
+    void insert(const EntityItemPointer& entity, const AACube& bounds);
+    void remove(const EntityItemID& entityID);
+    void clear();
+
+    int size() const;
+
+    // NOTE: the find functions call entityFunctor with the index locked, it must not add or remove entities
+
+    /// Calls entityFunctor for each entity whose bounds touch the box
+    void findEntities(const AABox& box, EntityFunctor entityFunctor);
+
+    /// Calls entityFunctor for each entity whose bounds touch the sphere
+    void findEntities(const glm::vec3& center, float radius, EntityFunctor entityFunctor);
+
+    /// Calls entityFunctor for each entity whose bounds are in the frustum or its keyhole
+    void findEntities(const ViewFrustum& frustum, EntityFunctor entityFunctor);
+
+    /// Calls entityFunctor for each entity whose bounds the ray hits closer than distance, roughly nearest first. distance
+    /// is read again after each call, so a functor that shortens it when it finds a hit prunes the rest of the search.
+    void findRayCandidates(const glm::vec3& origin, const glm::vec3& direction, const float& distance,
+                           EntityFunctor entityFunctor);
+
+    /// The entity whose position is closest to position and within radius of it, if any
+    EntityItemPointer findClosestEntity(const glm::vec3& position, float radius);
+
+private:
+    struct Node {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int parent;
+        int first; // first child for an inner node, the children are first and first + 1; first entry for a leaf
+        int count; // number of entries for a leaf, 0 for an inner node
+    };
+
+    template <typename BoundsTest>
+    void forEachCandidate(BoundsTest boundsTest, const EntityFunctor& entityFunctor);
+
+    void setBounds(int entry, const AACube& bounds);
+    void refit(int entry);
+    void removePendingEntry(int entry);
+    bool needsRebuild() const;
+    void rebuildIfNeeded();
+    void rebuild();
+    void buildNode(int nodeIndex, std::vector<int>& entries, const std::vector<glm::vec3>& centers, int begin, int end);
+
+    mutable QReadWriteLock _lock;
+
+    // one entry per entity, [0, _treeEntryCount) are in the hierarchy and the rest are pending
+    std::vector<float> _minX;
+    std::vector<float> _minY;
+    std::vector<float> _minZ;
+    std::vector<float> _maxX;
+    std::vector<float> _maxY;
+    std::vector<float> _maxZ;
+    std::vector<EntityItemPointer> _entities; // null for a removed entry still in the hierarchy
+    std::vector<EntityItemID> _entityIDs;
+    std::vector<int> _entryLeaves;
+    QHash<EntityItemID, int> _entryByID;
+
+    std::vector<Node> _nodes;
+    int _treeEntryCount { 0 };
+    int _liveCount { 0 };
+    int _staleCount { 0 }; // entries removed from or refit in the hierarchy since it was built
+};
+
+#endif // hifi_EntityBoundsIndex_h
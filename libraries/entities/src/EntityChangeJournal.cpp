@@ -0,0 +1,79 @@
+//
+//  EntityChangeJournal.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityChangeJournal.h"
+
+void EntityChangeJournal::record(EntityChange::Type type, const EntityItemID& entityID,
+                                 const EntityPropertyFlags& changedProperties) {
+    QWriteLocker locker(&_changesLock);
+    _changes.push_back({ ++_lastSequence, entityID, type, changedProperties });
+
+    while ((int)_changes.size() > _maxChanges) {
+        _forgottenThroughSequence = _changes.front().sequence;
+        _changes.pop_front();
+    }
+}
+
+quint64 EntityChangeJournal::getLastSequence() const {
+    QReadLocker locker(&_changesLock);
+    return _lastSequence;
+}
+
+bool EntityChangeJournal::forEachChangeSince(quint64 sinceSequence,
+                                             std::function<void(const EntityChange&)> changeFunctor) const {
+    QReadLocker locker(&_changesLock);
+
+    if (sinceSequence < _forgottenThroughSequence) {
+        return false;
+    }
+
+    if (sinceSequence >= _lastSequence) {
+        return true; // nothing new
+    }
+
+    // sequence numbers are consecutive, so we can jump straight to the first change after sinceSequence
+    quint64 firstSequence = _changes.front().sequence;
+    auto it = _changes.begin() + (sinceSequence + 1 - firstSequence);
+    for (; it != _changes.end(); ++it) {
+        changeFunctor(*it);
+    }
+    return true;
+}
+
+bool EntityChangeJournal::getChangesByEntitySince(quint64 sinceSequence,
+                                                  QHash<EntityItemID, EntityChange>& changesByEntity) const {
+    return forEachChangeSince(sinceSequence, [&](const EntityChange& change) {
+        auto it = changesByEntity.find(change.entityID);
+        if (it == changesByEntity.end()) {
+            changesByEntity.insert(change.entityID, change);
+            return;
+        }
+
+        EntityChange& merged = it.value();
+        merged.sequence = change.sequence;
+        merged.changedProperties |= change.changedProperties;
+
+        if (change.type == EntityChange::Deleted || change.type == EntityChange::Added) {
+            merged.type = change.type;
+        } else if (merged.type == EntityChange::Deleted) {
+            // an entity can't change after it is deleted, but don't hide the delete if it somehow did
+        } else if (merged.type == EntityChange::Moved) {
+            merged.type = change.type;
+        }
+    });
+}
+
+void EntityChangeJournal::reset() {
+    QWriteLocker locker(&_changesLock);
+    _changes.clear();
+
+    // skip a sequence number so even a sender that was fully up to date has to start over
+    _forgottenThroughSequence = ++_lastSequence;
+}
@@ -0,0 +1,73 @@
+//
+//  EntityChangeJournal.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityChangeJournal_h
+#define hifi_EntityChangeJournal_h
+
+#include <deque>
+#include <functional>
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include "EntityItemID.h"
+#include "EntityPropertyFlags.h"
+
+class EntityChange {
+public:
+    enum Type : uint8_t {
+        Added,
+        Edited,
+        Moved, // to another element, by the simulation or along with its parent, with no property of its own edited
+        Deleted
+    };
+
+    quint64 sequence;
+    EntityItemID entityID;
+    Type type;
+    EntityPropertyFlags changedProperties;
+};
+
+/// Server side, append-only record of entity changes. Every add, edit and delete gets the next sequence number, so a
+/// sender that remembers the last sequence it has handled can find exactly what has changed since, instead of walking
+/// the tree. Only the most recent changes are kept, a sender that has fallen further behind has to walk the tree.
+class EntityChangeJournal {
+public:
+    static const int DEFAULT_MAX_CHANGES = 10000;
+
+    EntityChangeJournal(int maxChanges = DEFAULT_MAX_CHANGES) : _maxChanges(maxChanges) { }
+
+    void record(EntityChange::Type type, const EntityItemID& entityID,
+                const EntityPropertyFlags& changedProperties = EntityPropertyFlags());
+
+    /// Sequence number of the most recent change, 0 if there haven't been any
+    quint64 getLastSequence() const;
+
+    /// Calls changeFunctor for each change after sinceSequence, oldest first. Returns false without calling it at all
+    /// if some of those changes are no longer in the journal.
+    bool forEachChangeSince(quint64 sinceSequence, std::function<void(const EntityChange&)> changeFunctor) const;
+
+    /// Same as forEachChangeSince, but with one change per entity: the latest sequence, the changed properties of all of
+    /// its changes, and a type of Deleted if it was deleted last, else Added if it was added, else Edited if it was
+    /// edited, else Moved.
+    bool getChangesByEntitySince(quint64 sinceSequence, QHash<EntityItemID, EntityChange>& changesByEntity) const;
+
+    /// Forgets all changes, anyone asking for changes from before now will be told to walk the tree
+    void reset();
+
+private:
+    mutable QReadWriteLock _changesLock;
+    std::deque<EntityChange> _changes;
+    quint64 _lastSequence { 0 };
+    quint64 _forgottenThroughSequence { 0 }; // changes up to and including this sequence are no longer available
+    int _maxChanges;
+};
+
+#endif // hifi_EntityChangeJournal_h
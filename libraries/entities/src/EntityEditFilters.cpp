@@ -41,26 +41,39 @@ QList<EntityItemID> EntityEditFilters::getZonesByPosition(glm::vec3& position) {
     return zones;
 }
 
+bool EntityEditFilters::hasZoneFilters() {
+    QReadLocker locker(&_lock);
+    for (auto it = _filterDataMap.constBegin(); it != _filterDataMap.constEnd(); ++it) {
+        if (!it.key().isInvalidID()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool EntityEditFilters::filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
-        EntityTree::FilterType filterType, EntityItemID& itemID) {
+        EntityTree::FilterType filterType, EntityItemID& itemID, QList<EntityItemID>* zonesOut) {
     
     // get the ids of all the zones (plus the global entity edit filter) that the position
     // lies within
     auto zoneIDs = getZonesByPosition(position);
+    if (zonesOut) {
+        *zonesOut = zoneIDs;
+    }
     for (auto id : zoneIDs) {
         if (!itemID.isInvalidID() && id == itemID) {
             continue;
         }
         
-        // get the filter pair, etc...  
-        _lock.lockForRead();
+        // get the filter pair, etc... keep it locked while we use it, so it can't be removed out from under us
+        QReadLocker locker(&_lock);
         FilterData filterData = _filterDataMap.value(id);
-        _lock.unlock();
     
         if (filterData.valid()) {
             if (filterData.rejectAll) {
                 return false;
             }
+            QMutexLocker engineLocker(filterData.engineMutex.get());
             auto oldProperties = propertiesIn.getDesiredProperties();
             auto specifiedProperties = propertiesIn.getChangedProperties();
             propertiesIn.setDesiredProperties(specifiedProperties);
@@ -195,6 +208,7 @@ void EntityEditFilters::scriptRequestFinished(EntityItemID entityID) {
                 // put the engine in the engine map (so we don't leak them, etc...)
                 FilterData filterData;
                 filterData.engine = engine;
+                filterData.engineMutex = std::make_shared<QMutex>();
                 filterData.rejectAll = false;
                 
                 // define the uncaughtException function
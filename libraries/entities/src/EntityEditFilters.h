@@ -13,11 +13,13 @@
 
 #include <QObject>
 #include <QMap>
+#include <QMutex>
 #include <QScriptValue>
 #include <QScriptEngine>
 #include <glm/glm.hpp>
 
 #include <functional>
+#include <memory>
 
 #include "EntityItemID.h"
 #include "EntityItemProperties.h"
@@ -30,6 +32,7 @@ public:
         QScriptValue filterFn;
         std::function<bool()> uncaughtExceptions;
         QScriptEngine* engine;
+        std::shared_ptr<QMutex> engineMutex; // edits can be filtered on several threads, but an engine runs one at a time
         bool rejectAll;
         
         FilterData(): engine(nullptr), rejectAll(false) {};
@@ -42,8 +45,13 @@ public:
     void addFilter(EntityItemID entityID, QString filterURL);
     void removeFilter(EntityItemID entityID);
 
+    // zonesOut is set to the zones (and the global filter) picked by the position, whose filters were run
     bool filter(glm::vec3& position, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, 
-                EntityTree::FilterType filterType, EntityItemID& entityID);
+                EntityTree::FilterType filterType, EntityItemID& entityID, QList<EntityItemID>* zonesOut = nullptr);
+
+    // whether any filter belongs to a zone, so that which filters an edit goes through depends on where the entity is
+    bool hasZoneFilters();
+    QList<EntityItemID> getZonesByPosition(glm::vec3& position);
 
 signals:
     void filterAdded(EntityItemID id, bool success);
@@ -52,8 +60,6 @@ private slots:
     void scriptRequestFinished(EntityItemID entityID);
     
 private:
-    QList<EntityItemID> getZonesByPosition(glm::vec3& position);
-
     EntityTreePointer _tree {};
     bool _rejectAll {false};
     QScriptValue _nullObjectForFilter{};
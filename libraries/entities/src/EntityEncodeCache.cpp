@@ -0,0 +1,64 @@
+//
+//  EntityEncodeCache.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEncodeCache.h"
+
+bool EntityEncodeCache::Key::operator==(const Key& other) const {
+    return lastEdited == other.lastEdited && lastUpdated == other.lastUpdated && lastSimulated == other.lastSimulated
+        && lastChangedOnServer == other.lastChangedOnServer && requestedProperties == other.requestedProperties;
+}
+
+bool EntityEncodeCache::find(const EntityItemID& entityID, const Key& key, QByteArray& encodedData) {
+    {
+        QReadLocker locker(&_entriesLock);
+        auto it = _entries.constFind(entityID);
+        if (it != _entries.constEnd() && it->key == key) {
+            // implicitly shared, the bytes themselves are not copied
+            encodedData = it->encodedData;
+        }
+    }
+
+    if (encodedData.isEmpty()) {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    _bytesServed += encodedData.size();
+    return true;
+}
+
+void EntityEncodeCache::store(const EntityItemID& entityID, const Key& key, const QByteArray& encodedData) {
+    QWriteLocker locker(&_entriesLock);
+    _entries[entityID] = { key, encodedData };
+    _stores++;
+}
+
+void EntityEncodeCache::remove(const EntityItemID& entityID) {
+    QWriteLocker locker(&_entriesLock);
+    _entries.remove(entityID);
+}
+
+void EntityEncodeCache::clear() {
+    QWriteLocker locker(&_entriesLock);
+    _entries.clear();
+}
+
+EntityEncodeCache::Stats EntityEncodeCache::getStats() const {
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.stores = _stores;
+    stats.bytesServed = _bytesServed;
+
+    QReadLocker locker(&_entriesLock);
+    stats.entries = _entries.size();
+    return stats;
+}
@@ -0,0 +1,70 @@
+//
+//  EntityEncodeCache.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEncodeCache_h
+#define hifi_EntityEncodeCache_h
+
+#include <atomic>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+
+#include "EntityItemID.h"
+#include "EntityPropertyFlags.h"
+
+// Server side cache of the wire encoding of each entity, shared by all of the OctreeSendThreads.
+// An entity that has not changed encodes to the same bytes for every viewer, so the first send thread to encode it
+// keeps a copy here and the others splice that copy straight into their packets instead of re-encoding every property.
+// Entries are only valid for the exact property set and edit/update/simulation timestamps they were encoded with.
+class EntityEncodeCache {
+public:
+    struct Key {
+        EntityPropertyFlags requestedProperties;
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+        quint64 lastChangedOnServer { 0 };
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct Stats {
+        quint64 hits { 0 };
+        quint64 misses { 0 };
+        quint64 stores { 0 };
+        quint64 bytesServed { 0 };
+        int entries { 0 };
+    };
+
+    // returns true and sets encodedData if the cached encoding for entityID was made with a matching key
+    bool find(const EntityItemID& entityID, const Key& key, QByteArray& encodedData);
+    void store(const EntityItemID& entityID, const Key& key, const QByteArray& encodedData);
+    void remove(const EntityItemID& entityID);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        Key key;
+        QByteArray encodedData;
+    };
+
+    mutable QReadWriteLock _entriesLock;
+    QHash<EntityItemID, Entry> _entries;
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _stores { 0 };
+    std::atomic<quint64> _bytesServed { 0 };
+};
+
+#endif // hifi_EntityEncodeCache_h
@@ -189,7 +189,33 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         requestedProperties = entityTreeElementExtraEncodeData->entities.value(getEntityItemID());
     }
 
+    // On the server every send thread encodes the same bytes for an unchanged entity, so if another thread has already
+    // encoded this version of the entity with these properties we can splice its encoding in and skip all the work below.
+    EntityTreePointer tree = getTree();
+    EntityEncodeCache* encodeCache = (tree && tree->getIsServer()) ? &tree->getEncodeCache() : nullptr;
+    EntityEncodeCache::Key encodeCacheKey;
+    if (encodeCache) {
+        encodeCacheKey.requestedProperties = requestedProperties;
+        encodeCacheKey.lastEdited = getLastEdited();
+        encodeCacheKey.lastUpdated = getLastUpdated();
+        encodeCacheKey.lastSimulated = getLastSimulated();
+        encodeCacheKey.lastChangedOnServer = getLastChangedOnServer();
+
+        QByteArray cachedEntityData;
+        if (encodeCache->find(getEntityItemID(), encodeCacheKey, cachedEntityData)) {
+            LevelDetails cachedEntityLevel = packetData->startLevel();
+            if (packetData->appendRawData(cachedEntityData)) {
+                packetData->endLevel(cachedEntityLevel);
+                params.trackSend(getID(), getLastEdited());
+                return OctreeElement::COMPLETED;
+            }
+            // doesn't fit in what's left of this packet, let the normal encoding send what it can
+            packetData->discardLevel(cachedEntityLevel);
+        }
+    }
+
     LevelDetails entityLevel = packetData->startLevel();
+    int startOfEntity = packetData->getUncompressedByteOffset();
 
     quint64 lastEdited = getLastEdited();
 
@@ -324,6 +350,12 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         }
 
         packetData->endLevel(entityLevel);
+
+        if (encodeCache && appendState == OctreeElement::COMPLETED) {
+            int endOfEntity = packetData->getUncompressedByteOffset();
+            encodeCache->store(getEntityItemID(), encodeCacheKey,
+                QByteArray((const char*)packetData->getUncompressedData(startOfEntity), endOfEntity - startOfEntity));
+        }
     } else {
         packetData->discardLevel(entityLevel);
         appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
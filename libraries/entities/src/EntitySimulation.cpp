@@ -143,6 +143,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
     MovingEntitiesOperator moveOperator(_entityTree);
     AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
+    QVector<QPair<EntityItemPointer, EntityTreeElementPointer>> movingEntities;
     SetOfEntities::iterator itemItr = _entitiesToSort.begin();
     while (itemItr != _entitiesToSort.end()) {
         EntityItemPointer entity = *itemItr;
@@ -156,6 +157,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
             prepareEntityForDelete(entity);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            movingEntities.push_back({ entity, entity->getElement() });
             ++itemItr;
         }
     }
@@ -164,6 +166,15 @@ void EntitySimulation::sortEntitiesThatMoved() {
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
+    // the send threads only visit the elements of journaled entities, so tell them where these ended up
+    if (_entityTree->getIsServer()) {
+        for (auto& movingEntity : movingEntities) {
+            if (movingEntity.first->getElement() != movingEntity.second) {
+                _entityTree->getChangeJournal().record(EntityChange::Moved, movingEntity.first->getEntityItemID());
+            }
+        }
+    }
+
     _entitiesToSort.clear();
 }
 
@@ -11,6 +11,7 @@
 
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QJsonDocument>
 #include <QtScript/QScriptEngine>
 
 #include "EntityTree.h"
@@ -23,6 +24,7 @@
 #include "QVariantGLM.h"
 #include "EntitiesLogging.h"
 #include "RecurseOctreeToMapOperator.h"
+#include "RecurseOctreeToSnapshotOperator.h"
 #include "LogHandler.h"
 #include "EntityEditFilters.h"
 #include "EntityDynamicFactoryInterface.h"
@@ -32,28 +34,6 @@ static const quint64 DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER = USECS_PER_MSEC *
 const float EntityTree::DEFAULT_MAX_TMP_ENTITY_LIFETIME = 60 * 60; // 1 hour
 
 
-// combines the ray cast arguments into a single object
-class RayArgs {
-public:
-    // Inputs
-    glm::vec3 origin;
-    glm::vec3 direction;
-    const QVector<EntityItemID>& entityIdsToInclude;
-    const QVector<EntityItemID>& entityIdsToDiscard;
-    bool visibleOnly;
-    bool collidableOnly;
-    bool precisionPicking;
-
-    // Outputs
-    OctreeElementPointer& element;
-    float& distance;
-    BoxFace& face;
-    glm::vec3& surfaceNormal;
-    void** intersectedObject;
-    bool found;
-};
-
-
 EntityTree::EntityTree(bool shouldReaverage) :
     Octree(shouldReaverage),
     _fbxService(NULL),
@@ -95,6 +75,9 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         }
         _entityToElementMap.clear();
     }
+    _boundsIndex.clear();
+    _encodeCache.clear();
+    _changeJournal.reset();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -302,6 +285,9 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
 
             UpdateEntityOperator theChildOperator(getThisPointer(), containingElement, childEntity, queryCube);
             recurseTreeWithOperator(&theChildOperator);
+            if (getIsServer() && childEntity->getElement() != containingElement) {
+                _changeJournal.record(EntityChange::Moved, childEntity->getEntityItemID());
+            }
             foreach (SpatiallyNestablePointer childChild, childEntity->getChildren()) {
                 if (childChild && childChild->getNestableType() == NestableType::Entity) {
                     toProcess.enqueue(childChild);
@@ -538,6 +524,8 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
             _recentlyDeletedEntityItemIDs.insert(deletedAt, theEntity->getEntityItemID());
+            _encodeCache.remove(theEntity->getEntityItemID());
+            _changeJournal.record(EntityChange::Deleted, theEntity->getEntityItemID());
         } else {
             // on the client side, we also remember that we deleted this entity, we don't care about the time
             trackDeletedEntity(theEntity->getEntityItemID());
@@ -550,211 +538,90 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
 }
 
 
-class FindNearPointArgs {
-public:
-    glm::vec3 position;
-    float targetRadius;
-    bool found;
-    EntityItemPointer closestEntity;
-    float closestEntityDistance;
-};
-
-
-bool EntityTree::findNearPointOperation(OctreeElementPointer element, void* extraData) {
-    FindNearPointArgs* args = static_cast<FindNearPointArgs*>(extraData);
-    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-
-    glm::vec3 penetration;
-    bool sphereIntersection = entityTreeElement->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this entityTreeElement contains the point, then search it...
-    if (sphereIntersection) {
-        EntityItemPointer thisClosestEntity = entityTreeElement->getClosestEntity(args->position);
-
-        // we may have gotten NULL back, meaning no entity was available
-        if (thisClosestEntity) {
-            glm::vec3 entityPosition = thisClosestEntity->getPosition();
-            float distanceFromPointToEntity = glm::distance(entityPosition, args->position);
-
-            // If we're within our target radius
-            if (distanceFromPointToEntity <= args->targetRadius) {
-                // we are closer than anything else we've found
-                if (distanceFromPointToEntity < args->closestEntityDistance) {
-                    args->closestEntity = thisClosestEntity;
-                    args->closestEntityDistance = distanceFromPointToEntity;
-                    args->found = true;
-                }
-            }
-        }
-
-        // we should be able to optimize this...
-        return true; // keep searching in case children have closer entities
-    }
-
-    // if this element doesn't contain the point, then none of its children can contain the point, so stop searching
-    return false;
-}
-
-bool findRayIntersectionOp(OctreeElementPointer element, void* extraData) {
-    RayArgs* args = static_cast<RayArgs*>(extraData);
-    bool keepSearching = true;
-    EntityTreeElementPointer entityTreeElementPointer = std::dynamic_pointer_cast<EntityTreeElement>(element);
-    if (entityTreeElementPointer->findRayIntersection(args->origin, args->direction, keepSearching,
-        args->element, args->distance, args->face, args->surfaceNormal, args->entityIdsToInclude,
-        args->entityIdsToDiscard, args->visibleOnly, args->collidableOnly, args->intersectedObject, args->precisionPicking)) {
-        args->found = true;
-    }
-    return keepSearching;
-}
-
 bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
                                     QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
                                     bool visibleOnly, bool collidableOnly, bool precisionPicking, 
                                     OctreeElementPointer& element, float& distance,
                                     BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject,
                                     Octree::lockType lockType, bool* accurateResult) {
-    RayArgs args = { origin, direction, entityIdsToInclude, entityIdsToDiscard,
-            visibleOnly, collidableOnly, precisionPicking,
-            element, distance, face, surfaceNormal,  intersectedObject, false };
+    bool found = false;
     distance = FLT_MAX;
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperation(findRayIntersectionOp, &args);
+        _boundsIndex.findRayCandidates(origin, direction, distance, [&](const EntityItemPointer& entity) {
+            bool keepSearching = true;
+            if (EntityTreeElement::findEntityRayIntersection(entity, origin, direction, keepSearching, element,
+                    distance, face, surfaceNormal, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly,
+                    intersectedObject, precisionPicking)) {
+                found = true;
+            }
+        });
     }, requireLock);
 
     if (accurateResult) {
         *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
     }
 
-    return args.found;
+    return found;
 }
 
 
 EntityItemPointer EntityTree::findClosestEntity(glm::vec3 position, float targetRadius) {
-    FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
+    EntityItemPointer closestEntity;
     withReadLock([&] {
-        // NOTE: This should use recursion, since this is a spatial operation
-        recurseTreeWithOperation(findNearPointOperation, &args);
+        closestEntity = _boundsIndex.findClosestEntity(position, targetRadius);
     });
-    return args.closestEntity;
-}
-
-class FindAllNearPointArgs {
-public:
-    glm::vec3 position;
-    float targetRadius;
-    QVector<EntityItemPointer> entities;
-};
-
-
-bool EntityTree::findInSphereOperation(OctreeElementPointer element, void* extraData) {
-    FindAllNearPointArgs* args = static_cast<FindAllNearPointArgs*>(extraData);
-    glm::vec3 penetration;
-    bool sphereIntersection = element->getAACube().findSpherePenetration(args->position, args->targetRadius, penetration);
-
-    // If this element contains the point, then search it...
-    if (sphereIntersection) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->getEntities(args->position, args->targetRadius, args->entities);
-        return true; // keep searching in case children have closer entities
-    }
-
-    // if this element doesn't contain the point, then none of it's children can contain the point, so stop searching
-    return false;
+    return closestEntity;
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) {
-    FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInSphereOperation, &args);
+    QVector<EntityItemPointer> entities;
+    _boundsIndex.findEntities(center, radius, [&](const EntityItemPointer& entity) {
+        if (EntityTreeElement::entityTouchesSphere(entity, center, radius)) {
+            entities.push_back(entity);
+        }
+    });
 
     // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args.entities);
-}
-
-class FindEntitiesInCubeArgs {
-public:
-    FindEntitiesInCubeArgs(const AACube& cube)
-        : _cube(cube), _foundEntities() {
-    }
-
-    AACube _cube;
-    QVector<EntityItemPointer> _foundEntities;
-};
-
-bool EntityTree::findInCubeOperation(OctreeElementPointer element, void* extraData) {
-    FindEntitiesInCubeArgs* args = static_cast<FindEntitiesInCubeArgs*>(extraData);
-    if (element->getAACube().touches(args->_cube)) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->getEntities(args->_cube, args->_foundEntities);
-        return true;
-    }
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
-    FindEntitiesInCubeArgs args(cube);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInCubeOperation, &args);
+    QVector<EntityItemPointer> entities;
+    _boundsIndex.findEntities(AABox(cube), [&](const EntityItemPointer& entity) {
+        if (EntityTreeElement::entityTouchesCube(entity, cube)) {
+            entities.push_back(entity);
+        }
+    });
     // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args._foundEntities);
-}
-
-class FindEntitiesInBoxArgs {
-public:
-    FindEntitiesInBoxArgs(const AABox& box)
-    : _box(box), _foundEntities() {
-    }
-
-    AABox _box;
-    QVector<EntityItemPointer> _foundEntities;
-};
-
-bool EntityTree::findInBoxOperation(OctreeElementPointer element, void* extraData) {
-    FindEntitiesInBoxArgs* args = static_cast<FindEntitiesInBoxArgs*>(extraData);
-    if (element->getAACube().touches(args->_box)) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->getEntities(args->_box, args->_foundEntities);
-        return true;
-    }
-    return false;
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
-    FindEntitiesInBoxArgs args(box);
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInBoxOperation, &args);
-    // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args._foundEntities);
-}
-
-class FindInFrustumArgs {
-public:
-    ViewFrustum frustum;
     QVector<EntityItemPointer> entities;
-};
-
-bool EntityTree::findInFrustumOperation(OctreeElementPointer element, void* extraData) {
-    FindInFrustumArgs* args = static_cast<FindInFrustumArgs*>(extraData);
-    if (element->isInView(args->frustum)) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->getEntities(args->frustum, args->entities);
-        return true;
-    }
-    return false;
+    _boundsIndex.findEntities(box, [&](const EntityItemPointer& entity) {
+        if (EntityTreeElement::entityTouchesBox(entity, box)) {
+            entities.push_back(entity);
+        }
+    });
+    // swap the two lists of entity pointers instead of copy
+    foundEntities.swap(entities);
 }
 
 // NOTE: assumes caller has handled locking
 void EntityTree::findEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) {
-    FindInFrustumArgs args = { frustum, QVector<EntityItemPointer>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInFrustumOperation, &args);
+    QVector<EntityItemPointer> entities;
+    _boundsIndex.findEntities(frustum, [&](const EntityItemPointer& entity) {
+        if (EntityTreeElement::entityTouchesFrustum(entity, frustum)) {
+            entities.push_back(entity);
+        }
+    });
     // swap the two lists of entity pointers instead of copy
-    foundEntities.swap(args.entities);
+    foundEntities.swap(entities);
 }
 
 EntityItemPointer EntityTree::findEntityByID(const QUuid& id) {
@@ -935,13 +802,15 @@ void EntityTree::fixupTerseEditLogging(EntityItemProperties& properties, QList<Q
 }
 
 
-bool EntityTree::filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType) {
+bool EntityTree::filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType,
+                                  QList<EntityItemID>* filterZonesOut) {
     bool accepted = true;
     auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
     if (entityEditFilters) {
         auto position = existingEntity ? existingEntity->getPosition() : propertiesIn.getPosition();
         auto entityID = existingEntity ? existingEntity->getEntityItemID() : EntityItemID();
-        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID);
+        accepted = entityEditFilters->filter(position, propertiesIn, propertiesOut, wasChanged, filterType, entityID,
+                                             filterZonesOut);
     }
 
     return accepted;
@@ -957,211 +826,300 @@ void EntityTree::bumpTimestamp(EntityItemProperties& properties) { //fixme put c
     properties.setLastEdited(properties.getLastEdited() + LAST_EDITED_SERVERSIDE_BUMP);
 }
 
-int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
-                                     const SharedNodePointer& senderNode) {
+class EntityTree::PreparedEntityEdit : public Octree::PreparedEdit {
+public:
+    PacketType packetType;
+    const unsigned char* editData { nullptr };
+    int maxLength { 0 };
+    SharedNodePointer senderNode;
+
+    bool isAdd { false };
+    bool isPhysics { false };
+    bool isValid { false };
+    bool isAllowed { false };
+    bool suppressDisallowedScript { false };
+
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+    EntityItemPointer existingEntity;
+    bool wasFilteredAtPosition { false }; // the edit went through filters picked by existingEntity's position
+    glm::vec3 filteredPosition; // existingEntity->getPosition() when the filters were picked
+    QList<EntityItemID> filterZones; // the zones the filters were picked from
+
+    quint64 decodeTime { 0 };
+    quint64 lookupTime { 0 };
+    quint64 filterTime { 0 };
+};
 
-    if (!getIsServer()) {
-        qCDebug(entities) << "UNEXPECTED!!! processEditPacketData() should only be called on a server tree.";
+bool EntityTree::canPrepareEditPacketType(PacketType packetType) const {
+    return packetType == PacketType::EntityAdd || packetType == PacketType::EntityEdit ||
+        packetType == PacketType::EntityPhysics;
+}
+
+int EntityTree::prepareEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                      const SharedNodePointer& senderNode, PreparedEditPointer& preparedEdit) {
+    if (!getIsServer() || !canPrepareEditPacketType(message.getType())) {
         return 0;
     }
 
+    auto edit = std::unique_ptr<PreparedEntityEdit>(new PreparedEntityEdit());
+    int processedBytes = prepareEntityEdit(message.getType(), editData, maxLength, senderNode, *edit);
+    preparedEdit = std::move(edit);
+    return processedBytes;
+}
+
+void EntityTree::applyPreparedEdit(PreparedEdit& preparedEdit) {
+    auto& edit = static_cast<PreparedEntityEdit&>(preparedEdit);
+
+    if (!edit.isAdd) {
+        // an edit that was applied after this one was prepared may have added or deleted the entity, or moved it into
+        // other edit filter zones, in which case the lookup or filter results are stale and this edit has to be validated
+        // again against the tree as it is. Other changes to the entity, like the edits before this one, don't matter here.
+        EntityItemPointer entity = findEntityByEntityItemID(edit.entityItemID);
+        bool isStale = entity != edit.existingEntity;
+        if (!isStale && edit.wasFilteredAtPosition && entity->getPosition() != edit.filteredPosition) {
+            // a move only matters if it took the entity into or out of a zone with a filter
+            auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+            glm::vec3 position = entity->getPosition();
+            isStale = !entityEditFilters || entityEditFilters->getZonesByPosition(position) != edit.filterZones;
+        }
+        if (isStale) {
+            PreparedEntityEdit revalidatedEdit;
+            prepareEntityEdit(edit.packetType, edit.editData, edit.maxLength, edit.senderNode, revalidatedEdit);
+            applyEntityEdit(revalidatedEdit);
+            _totalRevalidatedEdits++;
+            return;
+        }
+    }
+
+    applyEntityEdit(edit);
+}
+
+int EntityTree::prepareEntityEdit(PacketType packetType, const unsigned char* editData, int maxLength,
+                                  const SharedNodePointer& senderNode, PreparedEntityEdit& edit) {
+    edit.packetType = packetType;
+    edit.editData = editData;
+    edit.maxLength = maxLength;
+    edit.senderNode = senderNode;
+    edit.isAdd = packetType == PacketType::EntityAdd;
+    edit.isPhysics = packetType == PacketType::EntityPhysics;
+
     int processedBytes = 0;
-    bool isAdd = false;
-    // we handle these types of "edit" packets
-    switch (message.getType()) {
-        case PacketType::EntityErase: {
-            QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
-            processedBytes = processEraseMessageDetails(dataByteArray, senderNode);
-            break;
+    quint64 startDecode = usecTimestampNow();
+    edit.isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                edit.entityItemID, edit.properties);
+    edit.decodeTime = usecTimestampNow() - startDecode;
+
+    if (!edit.isAdd) {
+        // search for the entity by EntityItemID
+        quint64 startLookup = usecTimestampNow();
+        edit.existingEntity = findEntityByEntityItemID(edit.entityItemID);
+        edit.lookupTime = usecTimestampNow() - startLookup;
+        if (!edit.existingEntity) {
+            // this is not an add-entity operation, and we don't know about the identified entity.
+            edit.isValid = false;
         }
+    }
 
-        case PacketType::EntityAdd:
-            isAdd = true;  // fall through to next case
-        case PacketType::EntityPhysics:
-        case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startFilter = 0, endFilter = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            bool suppressDisallowedScript = false;
-            bool isPhysics = message.getType() == PacketType::EntityPhysics;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            EntityItemPointer existingEntity;
-            if (!isAdd) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (!existingEntity) {
-                    // this is not an add-entity operation, and we don't know about the identified entity.
-                    validEditPacket = false;
-                }
+    if (edit.isValid && !_entityScriptSourceWhitelist.isEmpty() && !edit.properties.getScript().isEmpty()) {
+        bool passedWhiteList = false;
+
+        // grab a URL representation of the entity script so we can check the host for this script
+        auto entityScriptURL = QUrl::fromUserInput(edit.properties.getScript());
+
+        for (const auto& whiteListedPrefix : _entityScriptSourceWhitelist) {
+            auto whiteListURL = QUrl::fromUserInput(whiteListedPrefix);
+
+            // check if this script URL matches the whitelist domain and, optionally, is beneath the path
+            if (entityScriptURL.host().compare(whiteListURL.host(), Qt::CaseInsensitive) == 0 &&
+                entityScriptURL.path().startsWith(whiteListURL.path(), Qt::CaseInsensitive)) {
+                passedWhiteList = true;
+                break;
+            }
+        }
+        if (!passedWhiteList) {
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << edit.senderNode->getUUID() << "] attempting to set entity script not on whitelist, edit rejected";
             }
 
-            if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty() && !properties.getScript().isEmpty()) {
-                bool passedWhiteList = false;
+            // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
+            if (edit.isAdd) {
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), edit.entityItemID);
+                edit.isValid = passedWhiteList;
+            } else {
+                edit.suppressDisallowedScript = true;
+            }
+        }
+    }
 
-                // grab a URL representation of the entity script so we can check the host for this script
-                auto entityScriptURL = QUrl::fromUserInput(properties.getScript());
+    if ((edit.isAdd || edit.properties.lifetimeChanged()) &&
+        !edit.senderNode->getCanRez() && edit.senderNode->getCanRezTmp()) {
+        // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
+        if (edit.properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
+            edit.properties.getLifetime() > _maxTmpEntityLifetime) {
+            edit.properties.setLifetime(_maxTmpEntityLifetime);
+            bumpTimestamp(edit.properties);
+        }
+    }
 
-                for (const auto& whiteListedPrefix : _entityScriptSourceWhitelist) {
-                    auto whiteListURL = QUrl::fromUserInput(whiteListedPrefix);
+    if (edit.isValid) {
+        quint64 startFilter = usecTimestampNow();
+        bool wasChanged = false;
+        // Having (un)lock rights bypasses the filter, unless it's a physics result.
+        FilterType filterType = edit.isPhysics ? FilterType::Physics : (edit.isAdd ? FilterType::Add : FilterType::Edit);
+        bool bypassesFilter = !edit.isPhysics && edit.senderNode->isAllowedEditor();
 
-                    // check if this script URL matches the whitelist domain and, optionally, is beneath the path
-                    if (entityScriptURL.host().compare(whiteListURL.host(), Qt::CaseInsensitive) == 0 &&
-                        entityScriptURL.path().startsWith(whiteListURL.path(), Qt::CaseInsensitive)) {
-                        passedWhiteList = true;
-                        break;
-                    }
-                }
-                if (!passedWhiteList) {
-                    if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] attempting to set entity script not on whitelist, edit rejected";
-                    }
+        // the entity server always has an EntityEditFilters, but the filters only depend on where the entity is when
+        // some of them belong to zones
+        auto entityEditFilters = DependencyManager::get<EntityEditFilters>();
+        if (!bypassesFilter && edit.existingEntity && entityEditFilters && entityEditFilters->hasZoneFilters()) {
+            edit.wasFilteredAtPosition = true;
+            edit.filteredPosition = edit.existingEntity->getPosition();
+        }
+        edit.isAllowed = bypassesFilter ||
+            filterProperties(edit.existingEntity, edit.properties, edit.properties, wasChanged, filterType,
+                             edit.wasFilteredAtPosition ? &edit.filterZones : nullptr);
+        if (!edit.isAllowed) {
+            auto timestamp = edit.properties.getLastEdited();
+            edit.properties = EntityItemProperties();
+            edit.properties.setLastEdited(timestamp);
+        }
+        if (!edit.isAllowed || wasChanged) {
+            bumpTimestamp(edit.properties);
+            // For now, free ownership on any modification.
+            edit.properties.clearSimulationOwner();
+        }
+        edit.filterTime = usecTimestampNow() - startFilter;
+    }
 
-                    // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
-                    if (isAdd) {
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                        validEditPacket = passedWhiteList;
-                    } else {
-                        suppressDisallowedScript = true;
-                    }
-                }
-            }
+    return processedBytes;
+}
 
-            if ((isAdd || properties.lifetimeChanged()) &&
-                !senderNode->getCanRez() && senderNode->getCanRezTmp()) {
-                // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
-                if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
-                    properties.getLifetime() > _maxTmpEntityLifetime) {
-                    properties.setLifetime(_maxTmpEntityLifetime);
-                    bumpTimestamp(properties);
-                }
+void EntityTree::applyEntityEdit(PreparedEntityEdit& edit) {
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    _totalEditMessages++;
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (edit.isValid) {
+        if (edit.existingEntity && !edit.isAdd) {
+
+            if (edit.suppressDisallowedScript) {
+                bumpTimestamp(edit.properties);
+                edit.properties.setScript(edit.existingEntity->getScript());
             }
 
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                startFilter = usecTimestampNow();
-                bool wasChanged = false;
-                // Having (un)lock rights bypasses the filter, unless it's a physics result.
-                FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
-                if (!allowed) {
-                    auto timestamp = properties.getLastEdited();
-                    properties = EntityItemProperties();
-                    properties.setLastEdited(timestamp);
-                }
-                if (!allowed || wasChanged) {
-                    bumpTimestamp(properties);
-                    // For now, free ownership on any modification.
-                    properties.clearSimulationOwner();
-                }
-                endFilter = usecTimestampNow();
+            // if the EntityItem exists, then update it
+            startLogging = usecTimestampNow();
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << edit.senderNode->getUUID() << "] editing entity. ID:" << edit.entityItemID;
+                qCDebug(entities) << "   properties:" << edit.properties;
+            }
+            if (wantTerseEditLogging()) {
+                QList<QString> changedProperties = edit.properties.listChangedProperties();
+                fixupTerseEditLogging(edit.properties, changedProperties);
+                qCDebug(entities) << edit.senderNode->getUUID() << "edit" <<
+                    edit.existingEntity->getDebugName() << changedProperties;
+            }
+            endLogging = usecTimestampNow();
 
-                if (existingEntity && !isAdd) {
+            startUpdate = usecTimestampNow();
+            if (!edit.isPhysics) {
+                edit.properties.setLastEditedBy(edit.senderNode->getUUID());
+            }
+            updateEntity(edit.entityItemID, edit.properties, edit.senderNode);
+            edit.existingEntity->markAsChangedOnServer();
+            _changeJournal.record(EntityChange::Edited, edit.entityItemID, edit.properties.getChangedProperties());
+            endUpdate = usecTimestampNow();
+            _totalUpdates++;
+        } else if (edit.isAdd) {
+            bool failedAdd = !edit.isAllowed;
+            if (!edit.isAllowed) {
+                qCDebug(entities) << "Filtered entity add. ID:" << edit.entityItemID;
+            } else if (!edit.senderNode->getCanRez() && !edit.senderNode->getCanRezTmp()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'rez rights' [" << edit.senderNode->getUUID()
+                                  << "] attempted to add an entity ID:" << edit.entityItemID;
 
-                    if (suppressDisallowedScript) {
-                        bumpTimestamp(properties);
-                        properties.setScript(existingEntity->getScript());
-                    }
+            } else {
+                // this is a new entity... assign a new entityID
+                edit.properties.setCreated(edit.properties.getLastEdited());
+                edit.properties.setLastEditedBy(edit.senderNode->getUUID());
+                startCreate = usecTimestampNow();
+                EntityItemPointer newEntity = addEntity(edit.entityItemID, edit.properties);
+                endCreate = usecTimestampNow();
+                _totalCreates++;
+                if (newEntity) {
+                    newEntity->markAsChangedOnServer();
+                    _changeJournal.record(EntityChange::Added, edit.entityItemID, edit.properties.getChangedProperties());
+                    notifyNewlyCreatedEntity(*newEntity, edit.senderNode);
 
-                    // if the EntityItem exists, then update it
                     startLogging = usecTimestampNow();
                     if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
-                        qCDebug(entities) << "   properties:" << properties;
+                        qCDebug(entities) << "User [" << edit.senderNode->getUUID() << "] added entity. ID:"
+                                          << newEntity->getEntityItemID();
+                        qCDebug(entities) << "   properties:" << edit.properties;
                     }
                     if (wantTerseEditLogging()) {
-                        QList<QString> changedProperties = properties.listChangedProperties();
-                        fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
+                        QList<QString> changedProperties = edit.properties.listChangedProperties();
+                        fixupTerseEditLogging(edit.properties, changedProperties);
+                        qCDebug(entities) << edit.senderNode->getUUID() << "add" << edit.entityItemID << changedProperties;
                     }
                     endLogging = usecTimestampNow();
 
-                    startUpdate = usecTimestampNow();
-                    if (!isPhysics) {
-                        properties.setLastEditedBy(senderNode->getUUID());
-                    }
-                    updateEntity(entityItemID, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (isAdd) {
-                    bool failedAdd = !allowed;
-                    if (!allowed) {
-                        qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
-                    } else if (!senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
-                                          << "] attempted to add an entity ID:" << entityItemID;
-
-                    } else {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        properties.setLastEditedBy(senderNode->getUUID());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                  << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        } else {
-                            failedAdd = true;
-                            qCDebug(entities) << "Add entity failed ID:" << entityItemID;
-                        }
-                    }
-                    if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                    }
                 } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
+                    failedAdd = true;
+                    qCDebug(entities) << "Add entity failed ID:" << edit.entityItemID;
                 }
             }
+            if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), edit.entityItemID);
+            }
+        } else {
+            static QString repeatedMessage =
+                LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+            qCDebug(entities) << "Edit failed. [" << edit.packetType <<"] " <<
+                    "entity id:" << edit.entityItemID << 
+                    "existingEntity pointer:" << edit.existingEntity.get();
+        }
+    }
 
+    _totalDecodeTime += edit.decodeTime;
+    _totalLookupTime += edit.lookupTime;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+    _totalFilterTime += edit.filterTime;
+}
 
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-            _totalFilterTime += endFilter - startFilter;
+int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode) {
 
+    if (!getIsServer()) {
+        qCDebug(entities) << "UNEXPECTED!!! processEditPacketData() should only be called on a server tree.";
+        return 0;
+    }
+
+    int processedBytes = 0;
+    // we handle these types of "edit" packets
+    switch (message.getType()) {
+        case PacketType::EntityErase: {
+            QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
+            processedBytes = processEraseMessageDetails(dataByteArray, senderNode);
+            break;
+        }
+
+        case PacketType::EntityAdd:
+        case PacketType::EntityPhysics:
+        case PacketType::EntityEdit: {
+            PreparedEntityEdit edit;
+            processedBytes = prepareEntityEdit(message.getType(), editData, maxLength, senderNode, edit);
+            applyEntityEdit(edit);
             break;
         }
 
@@ -1728,6 +1686,113 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return success;
 }
 
+bool EntityTree::writeToSnapshot(QByteArray& snapshot, OctreeElementPointer element) {
+    // the record count is patched in once the tree has been walked
+    int recordCountOffset = snapshot.size();
+    quint32 recordCount = 0;
+    snapshot.append(reinterpret_cast<const char*>(&recordCount), sizeof(recordCount));
+
+    QScriptEngine scriptEngine;
+    RecurseOctreeToSnapshotOperator theOperator(snapshot, element, &scriptEngine);
+    recurseTreeWithOperator(&theOperator);
+
+    recordCount = theOperator.getRecordCount();
+    memcpy(snapshot.data() + recordCountOffset, &recordCount, sizeof(recordCount));
+
+    if (theOperator.getJSONRecordCount() > 0) {
+        qCDebug(entities) << "Binary snapshot stored" << theOperator.getJSONRecordCount() << "of" << recordCount
+            << "entities as JSON, they were too large for an edit packet";
+    }
+    return true;
+}
+
+bool EntityTree::readFromSnapshot(const unsigned char* data, qint64 size, PacketVersion dataVersion) {
+    // records are edit packet payloads, which only decode at the version they were encoded at
+    if (dataVersion != versionForPacketType(expectedDataPacketType())) {
+        qCDebug(entities) << "Binary snapshot has data version" << dataVersion << "- expected"
+            << versionForPacketType(expectedDataPacketType());
+        return false;
+    }
+
+    const unsigned char* dataAt = data;
+    const unsigned char* dataEnd = data + size;
+
+    quint32 recordCount;
+    if (size < (qint64)sizeof(recordCount)) {
+        return false;
+    }
+    memcpy(&recordCount, dataAt, sizeof(recordCount));
+    dataAt += sizeof(recordCount);
+
+    if (recordCount == 0) {
+        // Empty snapshot, same as an empty JSON persist file.
+        return false;
+    }
+
+    QScriptEngine scriptEngine;
+    bool success = true;
+    for (quint32 i = 0; i < recordCount; i++) {
+        quint32 length;
+        if (dataEnd - dataAt < (qint64)sizeof(length)) {
+            qCDebug(entities) << "Binary snapshot truncated after" << i << "of" << recordCount << "entities";
+            return false;
+        }
+        memcpy(&length, dataAt, sizeof(length));
+        dataAt += sizeof(length);
+        if (length < (quint32)ENTITY_SNAPSHOT_RECORD_HEADER_SIZE || dataEnd - dataAt < (qint64)length) {
+            qCDebug(entities) << "Binary snapshot truncated after" << i << "of" << recordCount << "entities";
+            return false;
+        }
+        const unsigned char* recordEnd = dataAt + length;
+
+        quint8 encoding = *dataAt;
+        dataAt += sizeof(encoding);
+        quint64 created;
+        memcpy(&created, dataAt, sizeof(created));
+        dataAt += sizeof(created);
+        QUuid lastEditedBy = QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(dataAt),
+                                                                        NUM_BYTES_RFC4122_UUID));
+        dataAt += NUM_BYTES_RFC4122_UUID;
+        int bodySize = (int)(recordEnd - dataAt);
+
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        bool decoded = false;
+        if (encoding == EditPacketRecord) {
+            int processedBytes = 0;
+            decoded = EntityItemProperties::decodeEntityEditPacket(dataAt, bodySize, processedBytes,
+                                                                   entityItemID, properties);
+        } else if (encoding == JSONRecord) {
+            QByteArray json = QByteArray::fromRawData(reinterpret_cast<const char*>(dataAt), bodySize);
+            QVariantMap entityMap = QJsonDocument::fromJson(json).toVariant().toMap();
+            if (entityMap.contains("id")) {
+                QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+                EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+                entityItemID = EntityItemID(QUuid(entityMap["id"].toString()));
+                decoded = true;
+            }
+        }
+        dataAt = recordEnd;
+
+        if (!decoded) {
+            qCDebug(entities) << "unable to decode binary snapshot entity record, encoding" << encoding
+                << "data version" << dataVersion;
+            success = false;
+            continue;
+        }
+
+        properties.setCreated(created);
+        properties.setLastEditedBy(lastEditedBy);
+
+        EntityItemPointer entity = addEntity(entityItemID, properties);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            success = false;
+        }
+    }
+    return success;
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
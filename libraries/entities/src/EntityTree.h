@@ -23,6 +23,9 @@ typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 
 #include "EntityTreeElement.h"
+#include "EntityBoundsIndex.h"
+#include "EntityChangeJournal.h"
+#include "EntityEncodeCache.h"
 #include "DeleteEntityOperator.h"
 
 class EntityEditFilters;
@@ -98,6 +101,10 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual bool canPrepareEditPacketType(PacketType packetType) const override;
+    virtual int prepareEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                      const SharedNodePointer& senderNode, PreparedEditPointer& preparedEdit) override;
+    virtual void applyPreparedEdit(PreparedEdit& preparedEdit) override;
 
     virtual bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
@@ -187,6 +194,16 @@ public:
 
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
+    /// encodings of unchanged entities shared by the send threads, only used in server trees
+    EntityEncodeCache& getEncodeCache() { return _encodeCache; }
+
+    /// adds, edits and deletes in the order they happened, only used in server trees
+    EntityChangeJournal& getChangeJournal() { return _changeJournal; }
+
+    /// bounds of every entity, kept up to date by EntityTreeElement, backs findEntities(), findRayIntersection() and
+    /// findClosestEntity()
+    EntityBoundsIndex& getBoundsIndex() { return _boundsIndex; }
+
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
 
@@ -227,6 +244,8 @@ public:
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) override;
     virtual bool readFromMap(QVariantMap& entityDescription) override;
+    virtual bool writeToSnapshot(QByteArray& snapshot, OctreeElementPointer element) override;
+    virtual bool readFromSnapshot(const unsigned char* data, qint64 size, PacketVersion dataVersion) override;
 
     glm::vec3 getContentsDimensions();
     float getContentsLargestDimension();
@@ -240,6 +259,7 @@ public:
         _totalUpdateTime = 0;
         _totalCreateTime = 0;
         _totalLoggingTime = 0;
+        _totalRevalidatedEdits = 0;
     }
 
     virtual quint64 getAverageDecodeTime() const override { return _totalEditMessages == 0 ? 0 : _totalDecodeTime / _totalEditMessages; }
@@ -248,6 +268,7 @@ public:
     virtual quint64 getAverageCreateTime() const override { return _totalCreates == 0 ? 0 : _totalCreateTime / _totalCreates; }
     virtual quint64 getAverageLoggingTime() const override { return _totalEditMessages == 0 ? 0 : _totalLoggingTime / _totalEditMessages; }
     virtual quint64 getAverageFilterTime() const override { return _totalEditMessages == 0 ? 0 : _totalFilterTime / _totalEditMessages; }
+    virtual quint64 getTotalRevalidatedEdits() const override { return _totalRevalidatedEdits; }
 
     void trackIncomingEntityLastEdited(quint64 lastEditedTime, int bytesRead);
     quint64 getAverageEditDeltas() const
@@ -293,12 +314,12 @@ protected:
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElementPointer containingElement,
                                  const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
-    static bool findNearPointOperation(OctreeElementPointer element, void* extraData);
-    static bool findInSphereOperation(OctreeElementPointer element, void* extraData);
-    static bool findInCubeOperation(OctreeElementPointer element, void* extraData);
-    static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
-    static bool findInFrustumOperation(OctreeElementPointer element, void* extraData);
     static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
+
+    class PreparedEntityEdit;
+    int prepareEntityEdit(PacketType packetType, const unsigned char* editData, int maxLength,
+                          const SharedNodePointer& senderNode, PreparedEntityEdit& edit);
+    void applyEntityEdit(PreparedEntityEdit& edit);
     static void bumpTimestamp(EntityItemProperties& properties);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
@@ -327,6 +348,10 @@ protected:
     mutable QReadWriteLock _entityToElementLock;
     QHash<EntityItemID, EntityTreeElementPointer> _entityToElementMap;
 
+    EntityEncodeCache _encodeCache;
+    EntityChangeJournal _changeJournal;
+    EntityBoundsIndex _boundsIndex;
+
     EntitySimulationPointer _simulation;
 
     bool _wantEditLogging = false;
@@ -343,6 +368,7 @@ protected:
     quint64 _totalCreateTime = 0;
     quint64 _totalLoggingTime = 0;
     quint64 _totalFilterTime = 0;
+    quint64 _totalRevalidatedEdits = 0; // prepared edits whose lookup or filter zones went stale before they were applied
 
     // these performance statistics are only used in the client
     void resetClientEditStats();
@@ -362,7 +388,8 @@ protected:
 
     float _maxTmpEntityLifetime { DEFAULT_MAX_TMP_ENTITY_LIFETIME };
 
-    bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType);
+    bool filterProperties(EntityItemPointer& existingEntity, EntityItemProperties& propertiesIn, EntityItemProperties& propertiesOut, bool& wasChanged, FilterType filterType,
+                          QList<EntityItemID>* filterZonesOut = nullptr);
     bool _hasEntityEditFilter{ false };
     QStringList _entityScriptSourceWhitelist;
 };
@@ -636,79 +636,90 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
                                     bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
-    int entityNumber = 0;
     bool somethingIntersected = false;
     forEachEntity([&](EntityItemPointer entity) {
-        if ( (visibleOnly && !entity->isVisible()) || (collidableOnly && (entity->getCollisionless() || entity->getShapeType() == SHAPE_TYPE_NONE))
-            || (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID()))
-            || (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
-            return;
+        if (findEntityRayIntersection(entity, origin, direction, keepSearching, element, distance, face, surfaceNormal,
+                                      entityIdsToInclude, entityIDsToDiscard, visibleOnly, collidableOnly,
+                                      intersectedObject, precisionPicking)) {
+            somethingIntersected = true;
         }
+    });
+    return somethingIntersected;
+}
 
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        if (!success) {
-            return;
-        }
+bool EntityTreeElement::findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                                    const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element,
+                                    float& distance, BoxFace& face, glm::vec3& surfaceNormal,
+                                    const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIDsToDiscard,
+                                    bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking) {
+    if ( (visibleOnly && !entity->isVisible()) || (collidableOnly && (entity->getCollisionless() || entity->getShapeType() == SHAPE_TYPE_NONE))
+        || (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID()))
+        || (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
+        return false;
+    }
 
-        float localDistance;
-        BoxFace localFace;
-        glm::vec3 localSurfaceNormal;
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    if (!success) {
+        return false;
+    }
 
-        // if the ray doesn't intersect with our cube, we can stop searching!
-        if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
-            return;
-        }
+    float localDistance;
+    BoxFace localFace;
+    glm::vec3 localSurfaceNormal;
 
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-        glm::mat4 translation = glm::translate(entity->getPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+    // if the ray doesn't intersect with our cube, we can stop searching!
+    if (!entityBox.findRayIntersection(origin, direction, localDistance, localFace, localSurfaceNormal)) {
+        return false;
+    }
 
-        glm::vec3 dimensions = entity->getDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
-
-        AABox entityFrameBox(corner, dimensions);
-
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
-
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
-                                                localFace, localSurfaceNormal)) {
-            if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
-                    if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
-                        localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
-
-                        if (localDistance < distance) {
-                            distance = localDistance;
-                            face = localFace;
-                            surfaceNormal = localSurfaceNormal;
-                            *intersectedObject = (void*)entity.get();
-                            somethingIntersected = true;
-                        }
-                    }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle entities
-                    if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+    // extents is the entity relative, scaled, centered extents of the entity
+    glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+    glm::mat4 translation = glm::translate(entity->getPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+
+    glm::vec3 dimensions = entity->getDimensions();
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
+
+    AABox entityFrameBox(corner, dimensions);
+
+    glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+    glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+    // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+    // and testing intersection there.
+    if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
+                                            localFace, localSurfaceNormal)) {
+        if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
+            // now ask the entity if we actually intersect
+            if (entity->supportsDetailedRayIntersection()) {
+                if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
+                    localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
+
+                    if (localDistance < distance) {
                         distance = localDistance;
                         face = localFace;
-                        surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 1.0f));
+                        surfaceNormal = localSurfaceNormal;
                         *intersectedObject = (void*)entity.get();
-                        somethingIntersected = true;
+                        return true;
                     }
                 }
+            } else {
+                // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                // Never intersect with particle entities
+                if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+                    distance = localDistance;
+                    face = localFace;
+                    surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 1.0f));
+                    *intersectedObject = (void*)entity.get();
+                    return true;
+                }
             }
         }
-        entityNumber++;
-    });
-    return somethingIntersected;
+    }
+    return false;
 }
 
 // TODO: change this to use better bounding shape for entity than sphere
@@ -751,81 +762,17 @@ EntityItemPointer EntityTreeElement::getClosestEntity(glm::vec3 position) const
     return closestEntity;
 }
 
-// TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<EntityItemPointer>& foundEntities) const {
     forEachEntity([&](EntityItemPointer entity) {
-
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (!success || entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
-
-            glm::vec3 dimensions = entity->getDimensions();
-
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably dull actuall hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
-                (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
-
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
-
-                bool success;
-                if (findSphereSpherePenetration(searchPosition, searchRadius,
-                        entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
-                        foundEntities.push_back(entity);
-                    }
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
-                glm::mat4 translation = glm::translate(entity->getPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
-
-                AABox entityFrameBox(corner, dimensions);
-
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
-                    foundEntities.push_back(entity);
-                }
-            }
+        if (entityTouchesSphere(entity, searchPosition, searchRadius)) {
+            foundEntities.push_back(entity);
         }
     });
 }
 
 void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
     forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
-        // FIXME - consider allowing the entity to determine penetration so that
-        //         entities could presumably dull actuall hull testing if they wanted to
-        // FIXME - is there an easy way to translate the search cube into something in the
-        //         entity frame that can be easily tested against?
-        //         simple algorithm is probably:
-        //             if target box is fully inside search box == yes
-        //             if search box is fully inside target box == yes
-        //             for each face of search box:
-        //                 translate the triangles of the face into the box frame
-        //                 test the triangles of the face against the box?
-        //                 if translated search face triangle intersect target box
-        //                     add to result
-        //
-
-        // If the entities AABox touches the search cube then consider it to be found
-        if (!success || entityBox.touches(cube)) {
+        if (entityTouchesCube(entity, cube)) {
             foundEntities.push_back(entity);
         }
     });
@@ -833,25 +780,7 @@ void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointe
 
 void EntityTreeElement::getEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
     forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
-        // FIXME - consider allowing the entity to determine penetration so that
-        //         entities could presumably dull actuall hull testing if they wanted to
-        // FIXME - is there an easy way to translate the search cube into something in the
-        //         entity frame that can be easily tested against?
-        //         simple algorithm is probably:
-        //             if target box is fully inside search box == yes
-        //             if search box is fully inside target box == yes
-        //             for each face of search box:
-        //                 translate the triangles of the face into the box frame
-        //                 test the triangles of the face against the box?
-        //                 if translated search face triangle intersect target box
-        //                     add to result
-        //
-
-        // If the entities AABox touches the search cube then consider it to be found
-        if (!success || entityBox.touches(box)) {
+        if (entityTouchesBox(entity, box)) {
             foundEntities.push_back(entity);
         }
     });
@@ -859,15 +788,100 @@ void EntityTreeElement::getEntities(const AABox& box, QVector<EntityItemPointer>
 
 void EntityTreeElement::getEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) {
     forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - See FIXMEs for similar methods above.
-        if (!success || frustum.boxIntersectsFrustum(entityBox) || frustum.boxIntersectsKeyhole(entityBox)) {
+        if (entityTouchesFrustum(entity, frustum)) {
             foundEntities.push_back(entity);
         }
     });
 }
 
+// TODO: change this to use better bounding shape for entity than sphere
+bool EntityTreeElement::entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& searchPosition, float searchRadius) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+
+    // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
+    glm::vec3 penetration;
+    if (!success || entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
+
+        glm::vec3 dimensions = entity->getDimensions();
+
+        // FIXME - consider allowing the entity to determine penetration so that
+        //         entities could presumably dull actuall hull testing if they wanted to
+        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
+        //         can we handle the ellipsoid case better? We only currently handle perfect spheres
+        //         with centered registration points
+        if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
+            (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
+
+            // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
+            //       maximum bounding sphere, which is actually larger than our actual radius
+            float entityTrueRadius = dimensions.x / 2.0f;
+
+            bool success;
+            if (findSphereSpherePenetration(searchPosition, searchRadius,
+                    entity->getCenterPosition(success), entityTrueRadius, penetration)) {
+                return success;
+            }
+        } else {
+            // determine the worldToEntityMatrix that doesn't include scale because
+            // we're going to use the registration aware aa box in the entity frame
+            glm::mat4 rotation = glm::mat4_cast(entity->getRotation());
+            glm::mat4 translation = glm::translate(entity->getPosition());
+            glm::mat4 entityToWorldMatrix = translation * rotation;
+            glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+
+            glm::vec3 registrationPoint = entity->getRegistrationPoint();
+            glm::vec3 corner = -(dimensions * registrationPoint);
+
+            AABox entityFrameBox(corner, dimensions);
+
+            glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
+            if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool EntityTreeElement::entityTouchesCube(const EntityItemPointer& entity, const AACube& cube) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
+    // FIXME - consider allowing the entity to determine penetration so that
+    //         entities could presumably dull actuall hull testing if they wanted to
+    // FIXME - is there an easy way to translate the search cube into something in the
+    //         entity frame that can be easily tested against?
+    //         simple algorithm is probably:
+    //             if target box is fully inside search box == yes
+    //             if search box is fully inside target box == yes
+    //             for each face of search box:
+    //                 translate the triangles of the face into the box frame
+    //                 test the triangles of the face against the box?
+    //                 if translated search face triangle intersect target box
+    //                     add to result
+    //
+
+    // If the entities AABox touches the search cube then consider it to be found
+    return !success || entityBox.touches(cube);
+}
+
+bool EntityTreeElement::entityTouchesBox(const EntityItemPointer& entity, const AABox& box) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    // FIXME - See FIXMEs in entityTouchesCube()
+
+    // If the entities AABox touches the search box then consider it to be found
+    return !success || entityBox.touches(box);
+}
+
+bool EntityTreeElement::entityTouchesFrustum(const EntityItemPointer& entity, const ViewFrustum& frustum) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    // FIXME - See FIXMEs in entityTouchesCube()
+    return !success || frustum.boxIntersectsFrustum(entityBox) || frustum.boxIntersectsKeyhole(entityBox);
+}
+
 EntityItemPointer EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id) const {
     EntityItemPointer foundEntity = NULL;
     withReadLock([&] {
@@ -889,6 +903,9 @@ void EntityTreeElement::cleanupEntities() {
             // we know that it will be deleted.
             //delete entity;
             entity->_element = NULL;
+            if (_myTree) {
+                _myTree->getBoundsIndex().remove(entity->getEntityItemID());
+            }
         }
         _entityItems.clear();
     });
@@ -903,6 +920,9 @@ bool EntityTreeElement::removeEntityWithEntityItemID(const EntityItemID& id) {
             if (entity->getEntityItemID() == id) {
                 foundEntity = true;
                 entity->_element = NULL;
+                if (_myTree) {
+                    _myTree->getBoundsIndex().remove(id);
+                }
                 _entityItems.removeAt(i);
                 break;
             }
@@ -919,6 +939,9 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity) {
     if (numEntries > 0) {
         assert(entity->_element.get() == this);
         entity->_element = NULL;
+        if (_myTree) {
+            _myTree->getBoundsIndex().remove(entity->getEntityItemID());
+        }
         return true;
     }
     return false;
@@ -1058,6 +1081,9 @@ void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
         _entityItems.push_back(entity);
     });
     entity->_element = getThisPointer();
+    if (_myTree) {
+        _myTree->getBoundsIndex().insert(entity, _cube);
+    }
 }
 
 // will average a "common reduced LOD view" from the the child elements...
@@ -199,6 +199,18 @@ public:
     /// \param entities[out] vector of non-const EntityItemPointer
     void getEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities);
 
+    // the per entity tests behind getEntities() and findDetailedRayIntersection(), EntityTree uses them directly with
+    // the candidates from its EntityBoundsIndex
+    static bool entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+    static bool entityTouchesCube(const EntityItemPointer& entity, const AACube& cube);
+    static bool entityTouchesBox(const EntityItemPointer& entity, const AABox& box);
+    static bool entityTouchesFrustum(const EntityItemPointer& entity, const ViewFrustum& frustum);
+    static bool findEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                         const glm::vec3& direction, bool& keepSearching, OctreeElementPointer& element, float& distance,
+                         BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
+                         const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly,
+                         void** intersectedObject, bool precisionPicking);
+
     EntityItemPointer getEntityWithID(uint32_t id) const;
     EntityItemPointer getEntityWithEntityItemID(const EntityItemID& id) const;
     void getEntitiesInside(const AACube& box, QVector<EntityItemPointer>& foundEntities);
@@ -0,0 +1,76 @@
+//
+//  RecurseOctreeToSnapshotOperator.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RecurseOctreeToSnapshotOperator.h"
+
+#include <QJsonDocument>
+
+#include "EntityItemProperties.h"
+
+RecurseOctreeToSnapshotOperator::RecurseOctreeToSnapshotOperator(QByteArray& snapshot, OctreeElementPointer top,
+                                                                 QScriptEngine* engine) :
+        RecurseOctreeOperator(),
+        _snapshot(snapshot),
+        _top(top),
+        _engine(engine)
+{
+    // if some element "top" was given, only save information for that element and its children.
+    _withinTop = !_top;
+}
+
+bool RecurseOctreeToSnapshotOperator::preRecursion(OctreeElementPointer element) {
+    if (element == _top) {
+        _withinTop = true;
+    }
+    return true;
+}
+
+bool RecurseOctreeToSnapshotOperator::postRecursion(OctreeElementPointer element) {
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+
+    entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
+        if (!entityItem->isParentIDValid()) {
+            return;  // we weren't able to resolve a parent from _parentID, so don't save this entity.
+        }
+
+        EntityItemProperties properties = entityItem->getProperties();
+        properties.markAllChanged();
+
+        // the edit packet is sized like an outbound one, so anything that fits here would also fit on the wire
+        _editBuffer.resize(MAX_OCTREE_PACKET_DATA_SIZE);
+        if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entityItem->getEntityItemID(),
+                                                         properties, _editBuffer)) {
+            appendRecord(EditPacketRecord, properties.getCreated(), properties.getLastEditedBy(), _editBuffer);
+        } else {
+            // too big for a single edit packet, store what the JSON persist file would have
+            QVariant asVariant = EntityItemPropertiesToScriptValue(_engine, properties).toVariant();
+            QByteArray json = QJsonDocument::fromVariant(asVariant).toJson(QJsonDocument::Compact);
+            appendRecord(JSONRecord, properties.getCreated(), properties.getLastEditedBy(), json);
+            _jsonRecordCount++;
+        }
+    });
+
+    if (element == _top) {
+        _withinTop = false;
+    }
+    return true;
+}
+
+void RecurseOctreeToSnapshotOperator::appendRecord(EntitySnapshotRecordEncoding encoding, quint64 created,
+                                                   const QUuid& lastEditedBy, const QByteArray& body) {
+    quint32 length = ENTITY_SNAPSHOT_RECORD_HEADER_SIZE + body.size();
+    quint8 encodingByte = encoding;
+    _snapshot.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    _snapshot.append(reinterpret_cast<const char*>(&encodingByte), sizeof(encodingByte));
+    _snapshot.append(reinterpret_cast<const char*>(&created), sizeof(created));
+    _snapshot.append(lastEditedBy.toRfc4122());
+    _snapshot.append(body);
+    _recordCount++;
+}
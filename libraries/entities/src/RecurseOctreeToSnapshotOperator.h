@@ -0,0 +1,53 @@
+//
+//  RecurseOctreeToSnapshotOperator.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_RecurseOctreeToSnapshotOperator_h
+#define hifi_RecurseOctreeToSnapshotOperator_h
+
+#include <UUID.h>
+
+#include "EntityTree.h"
+
+// Binary snapshot entity records, each of them laid out as:
+//     quint32 length of the rest of the record
+//     quint8 encoding, one of EntitySnapshotRecordEncoding
+//     quint64 created
+//     16 bytes lastEditedBy (rfc4122)
+//     body, an EntityAdd edit packet payload or the entity properties as compact JSON
+enum EntitySnapshotRecordEncoding : quint8 {
+    EditPacketRecord = 0,
+    JSONRecord
+};
+
+const int ENTITY_SNAPSHOT_RECORD_HEADER_SIZE = sizeof(quint8) + sizeof(quint64) + NUM_BYTES_RFC4122_UUID;
+
+class RecurseOctreeToSnapshotOperator : public RecurseOctreeOperator {
+public:
+    RecurseOctreeToSnapshotOperator(QByteArray& snapshot, OctreeElementPointer top, QScriptEngine* engine);
+    bool preRecursion(OctreeElementPointer element) override;
+    bool postRecursion(OctreeElementPointer element) override;
+
+    quint32 getRecordCount() const { return _recordCount; }
+    quint32 getJSONRecordCount() const { return _jsonRecordCount; }
+
+private:
+    void appendRecord(EntitySnapshotRecordEncoding encoding, quint64 created, const QUuid& lastEditedBy,
+                      const QByteArray& body);
+
+    QByteArray& _snapshot;
+    OctreeElementPointer _top;
+    QScriptEngine* _engine;
+    QByteArray _editBuffer;
+    bool _withinTop;
+    quint32 _recordCount { 0 };
+    quint32 _jsonRecordCount { 0 };
+};
+
+#endif // hifi_RecurseOctreeToSnapshotOperator_h
@@ -42,6 +42,8 @@ void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
             // remove ownership and dirty all the tree elements that contain the it
             entity->clearSimulationOwnership();
             entity->markAsChangedOnServer();
+            getEntityTree()->getChangeJournal().record(EntityChange::Edited, entity->getEntityItemID(),
+                                                       EntityPropertyFlags(PROP_SIMULATION_OWNER));
             DirtyOctreeElementOperator op(entity->getElement());
             getEntityTree()->recurseTreeWithOperator(&op);
         } else {
@@ -71,6 +73,12 @@ void SimpleEntitySimulation::updateEntitiesInternal(const quint64& now) {
 
                     // dirty all the tree elements that contain it
                     entity->markAsChangedOnServer();
+                    EntityPropertyFlags zeroedProperties;
+                    zeroedProperties += PROP_VELOCITY;
+                    zeroedProperties += PROP_ANGULAR_VELOCITY;
+                    zeroedProperties += PROP_ACCELERATION;
+                    getEntityTree()->getChangeJournal().record(EntityChange::Edited, entity->getEntityItemID(),
+                                                               zeroedProperties);
                     DirtyOctreeElementOperator op(entity->getElement());
                     getEntityTree()->recurseTreeWithOperator(&op);
                 }
@@ -353,13 +353,20 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
     connect(message.data(), &ReceivedMessage::progress, this, [this, weakNode, messageID, length](qint64 size) {
         handleProgressCallback(weakNode, messageID, size, length);
     });
-    connect(message.data(), &ReceivedMessage::completed, this, [this, weakNode, messageID]() {
-        handleCompleteCallback(weakNode, messageID);
+    connect(message.data(), &ReceivedMessage::completed, this, [this, weakNode, messageID, length]() {
+        handleCompleteCallback(weakNode, messageID, length);
     });
 
     if (message->isComplete()) {
         disconnect(message.data(), nullptr, this, nullptr);
-        callbacks.completeCallback(true, error, message->readAll());
+
+        auto data = message->readAll();
+        if (data.size() != length) {
+            qCWarning(asset_client) << "Asset reply ended after" << data.size() << "of" << length << "bytes";
+            callbacks.completeCallback(false, AssetServerError::NoError, QByteArray());
+        } else {
+            callbacks.completeCallback(true, error, data);
+        }
         messageCallbackMap.erase(requestIt);
     }
 }
@@ -391,7 +398,7 @@ void AssetClient::handleProgressCallback(const QWeakPointer<Node>& node, Message
     callbacks.progressCallback(size, length);
 }
 
-void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, MessageID messageID) {
+void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, MessageID messageID, DataOffset length) {
     auto senderNode = node.toStrongRef();
 
     if (!senderNode) {
@@ -428,7 +435,14 @@ void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, Message
     if (message->failed()) {
         callbacks.completeCallback(false, AssetServerError::NoError, QByteArray());
     } else {
-        callbacks.completeCallback(true, AssetServerError::NoError, message->readAll());
+        // the server ends a streamed reply early if it fails to read the asset
+        auto data = message->readAll();
+        if (data.size() != length) {
+            qCWarning(asset_client) << "Asset reply ended after" << data.size() << "of" << length << "bytes";
+            callbacks.completeCallback(false, AssetServerError::NoError, QByteArray());
+        } else {
+            callbacks.completeCallback(true, AssetServerError::NoError, data);
+        }
     }
 
     // We should never get to this point without the associated senderNode and messageID
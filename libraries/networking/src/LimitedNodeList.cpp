@@ -11,6 +11,7 @@
 
 #include "LimitedNodeList.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -70,6 +71,10 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
     }
 
     qRegisterMetaType<ConnectionStep>("ConnectionStep");
+
+    // start readers off with an empty node set
+    publishNodeSnapshot();
+
     auto port = (socketListenPort != INVALID_PORT) ? socketListenPort : LIMITED_NODELIST_LOCAL_PORT.get();
     _nodeSocket.bind(QHostAddress::AnyIPv4, port);
     qCDebug(networking) << "NodeList socket is listening on" << _nodeSocket.localPort();
@@ -270,11 +275,9 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verificationHashMatches(packet, matchingNode->getConnectionSecret(),
+                                                       matchingNode->getVerificationKey())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -315,8 +318,12 @@ void LimitedNodeList::collectPacketStats(const NLPacket& packet) {
 }
 
 void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret) {
+    fillPacketHeader(packet, getSessionUUID(), connectionSecret);
+}
+
+void LimitedNodeList::fillPacketHeader(const NLPacket& packet, const QUuid& sessionUUID, const QUuid& connectionSecret) {
     if (!NON_SOURCED_PACKETS.contains(packet.getType())) {
-        packet.writeSourceID(getSessionUUID());
+        packet.writeSourceID(sessionUUID);
     }
 
     if (!connectionSecret.isNull()
@@ -437,6 +444,17 @@ qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList,
 qint64 LimitedNodeList::sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode) {
     auto activeSocket = destinationNode.getActiveSocket();
     if (activeSocket) {
+        if (packetList->isStreamed()) {
+            // streamed packets are produced by the send queue, so their headers are filled in as they are produced
+            QUuid sessionUUID = getSessionUUID();
+            QUuid connectionSecret = destinationNode.getConnectionSecret();
+            packetList->_streamedPacketHeaderWriter = [sessionUUID, connectionSecret](udt::Packet& packet) {
+                fillPacketHeader(static_cast<NLPacket&>(packet), sessionUUID, connectionSecret);
+            };
+
+            return _nodeSocket.writePacketList(std::move(packetList), *activeSocket);
+        }
+
         // close the last packet in the list
         packetList->closeCurrentPacket();
 
@@ -491,11 +509,143 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+    return withNodeSnapshot([&](const NodeSnapshot& snapshot) {
+        auto it = snapshot.nodesByUUID.find(nodeUUID);
+        return it == snapshot.nodesByUUID.cend() ? SharedNodePointer() : it->second;
+    });
+}
+
+namespace {
+    const int MAX_NESTED_NODE_SNAPSHOTS = 8;
+
+    // the snapshots one thread is reading, one per nesting level of the each functions
+    struct NodeSnapshotHazards {
+        std::atomic<const void*> snapshots[MAX_NESTED_NODE_SNAPSHOTS];
+        int depth { 0 };
+    };
+
+    struct NodeSnapshotHazardRegistry {
+        std::mutex mutex;
+        std::vector<NodeSnapshotHazards*> threads;
+    };
+
+    NodeSnapshotHazardRegistry& nodeSnapshotHazardRegistry() {
+        // never destroyed, since threads can still exit after static destruction
+        static NodeSnapshotHazardRegistry* registry = new NodeSnapshotHazardRegistry();
+        return *registry;
+    }
+
+    struct ThreadNodeSnapshotHazards : NodeSnapshotHazards {
+        ThreadNodeSnapshotHazards() {
+            for (auto& snapshot : snapshots) {
+                snapshot = nullptr;
+            }
+
+            auto& registry = nodeSnapshotHazardRegistry();
+            std::lock_guard<std::mutex> lock { registry.mutex };
+            registry.threads.push_back(this);
+        }
+
+        ~ThreadNodeSnapshotHazards() {
+            auto& registry = nodeSnapshotHazardRegistry();
+            std::lock_guard<std::mutex> lock { registry.mutex };
+            registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), this), registry.threads.end());
+        }
+    };
+
+    NodeSnapshotHazards& threadNodeSnapshotHazards() {
+        thread_local ThreadNodeSnapshotHazards hazards;
+        return hazards;
+    }
+}
+
+const LimitedNodeList::NodeSnapshot* LimitedNodeList::acquireNodeSnapshot() const {
+    auto& hazards = threadNodeSnapshotHazards();
+
+    if (hazards.depth >= MAX_NESTED_NODE_SNAPSHOTS) {
+        // deeper than we track - keep reading the deepest snapshot this thread already protects
+        Q_ASSERT(false);
+        ++hazards.depth;
+        return static_cast<const NodeSnapshot*>(hazards.snapshots[MAX_NESTED_NODE_SNAPSHOTS - 1].load());
+    }
+
+    auto& hazard = hazards.snapshots[hazards.depth++];
+
+    // the snapshot is safe to read once it is still current after being marked as in use
+    const NodeSnapshot* snapshot = _nodeSnapshot.load();
+    while (true) {
+        hazard.store(snapshot);
+
+        const NodeSnapshot* currentSnapshot = _nodeSnapshot.load();
+        if (currentSnapshot == snapshot) {
+            return snapshot;
+        }
+        snapshot = currentSnapshot;
+    }
+}
 
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+void LimitedNodeList::releaseNodeSnapshot() const {
+    auto& hazards = threadNodeSnapshotHazards();
+
+    if (--hazards.depth < MAX_NESTED_NODE_SNAPSHOTS) {
+        hazards.snapshots[hazards.depth].store(nullptr);
+    }
+
+    // a snapshot replaced while we were reading it holds on to removed nodes until freed, which would
+    // otherwise only happen with the next add or remove - if some thread is publishing or freeing right now,
+    // it sees our hazard cleared or leaves the rest to the next reader
+    if (hazards.depth == 0 && _hasReplacedNodeSnapshots.load()) {
+        std::unique_lock<std::mutex> lock { _nodeSnapshotMutex, std::try_to_lock };
+        if (lock.owns_lock()) {
+            reclaimNodeSnapshots();
+        }
+    }
+}
+
+void LimitedNodeList::publishNodeSnapshot() {
+    std::lock_guard<std::mutex> publishLock { _nodeSnapshotMutex };
+
+    std::unique_ptr<NodeSnapshot> snapshot { new NodeSnapshot() };
+    {
+        QReadLocker readLock(&_nodeMutex);
+
+        snapshot->nodes.reserve(_nodeHash.size());
+        for (const auto& pair : _nodeHash) {
+            snapshot->nodes.push_back(pair.second);
+            snapshot->nodesByUUID.emplace(pair.first, pair.second);
+        }
+    }
+
+    _nodeSnapshot.store(snapshot.get());
+    _nodeSnapshots.push_back(std::move(snapshot));
+
+    reclaimNodeSnapshots();
+}
+
+void LimitedNodeList::reclaimNodeSnapshots() const {
+    // free the replaced snapshots that no thread is reading anymore
+    std::vector<const void*> snapshotsInUse;
+    {
+        auto& registry = nodeSnapshotHazardRegistry();
+        std::lock_guard<std::mutex> lock { registry.mutex };
+        for (auto thread : registry.threads) {
+            for (auto& hazard : thread->snapshots) {
+                if (auto snapshotInUse = hazard.load()) {
+                    snapshotsInUse.push_back(snapshotInUse);
+                }
+            }
+        }
+    }
+
+    const NodeSnapshot* currentSnapshot = _nodeSnapshot.load();
+    _nodeSnapshots.erase(std::remove_if(_nodeSnapshots.begin(), _nodeSnapshots.end(),
+        [&](const std::unique_ptr<NodeSnapshot>& oldSnapshot) {
+            return oldSnapshot.get() != currentSnapshot
+                && std::find(snapshotsInUse.begin(), snapshotsInUse.end(), oldSnapshot.get()) == snapshotsInUse.end();
+        }), _nodeSnapshots.end());
+
+    _hasReplacedNodeSnapshots.store(_nodeSnapshots.size() > 1);
+}
 
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
@@ -517,6 +667,10 @@ void LimitedNodeList::eraseAllNodes() {
         }
     }
 
+    if (!killedNodes.isEmpty()) {
+        publishNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -543,6 +697,8 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
             _nodeHash.unsafe_erase(it);
         }
 
+        publishNodeSnapshot();
+
         handleNodeKill(matchingNode);
         return true;
     }
@@ -610,10 +766,13 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                 auto oldSoloNode = previousSoloIt->second;
 
                 _nodeHash.unsafe_erase(previousSoloIt);
+                writeLocker.unlock();
+
+                // readers must not find the old node once it has been reported killed
+                publishNodeSnapshot();
                 handleNodeKill(oldSoloNode);
 
                 // convert the current lock back to a read lock for insertion of new node
-                writeLocker.unlock();
                 readLocker.relock();
             }
         }
@@ -622,6 +781,8 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
         readLocker.unlock();
 
+        publishNodeSnapshot();
+
         qCDebug(networking) << "Added" << *newNode;
 
         emit nodeAdded(newNodePointer);
@@ -753,6 +914,10 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
 
+    if (!killedNodes.isEmpty()) {
+        publishNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -1058,11 +1223,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
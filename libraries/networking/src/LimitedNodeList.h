@@ -13,11 +13,15 @@
 #define hifi_LimitedNodeList_h
 
 #include <assert.h>
+#include <atomic>
 #include <stdint.h>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifndef _WIN32
 #include <unistd.h> // not on windows, not needed for mac or windows
@@ -138,7 +142,7 @@ public:
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return withNodeSnapshot([](const NodeSnapshot& snapshot) { return snapshot.nodes.size(); }); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -178,82 +182,76 @@ public:
     using value_type = SharedNodePointer;
     using const_iterator = std::vector<value_type>::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // Cede control of iteration over a single snapshot of the node set (e.g. for use by thread pools)
+    // Use this for nested loops instead of nesting the each functions
+    //   This allows multiple threads (i.e. a thread pool) to share one view of the nodes
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor, 
                     int* lockWaitOut = nullptr, 
                     int* nodeTransformOut = nullptr, 
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
+        withNodeSnapshot([&](const NodeSnapshot& snapshot) {
             auto endLock = usecTimestampNow();
             if (lockWaitOut) {
                 *lockWaitOut = (endLock - start);
             }
 
-            std::vector<SharedNodePointer> nodes(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), nodes.begin(), [](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
+            // the snapshot already holds the nodes as a vector, there is nothing left to transform
             if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
+                *nodeTransformOut = 0;
             }
 
-            functor(nodes.cbegin(), nodes.cend());
+            functor(snapshot.nodes.cbegin(), snapshot.nodes.cend());
             auto endFunctor = usecTimestampNow();
             if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
+                *functorOut = (endFunctor - endLock);
             }
-        }
+        });
     }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        withNodeSnapshot([&](const NodeSnapshot& snapshot) {
+            for (const SharedNodePointer& node : snapshot.nodes) {
+                functor(node);
+            }
+        });
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        withNodeSnapshot([&](const NodeSnapshot& snapshot) {
+            for (const SharedNodePointer& node : snapshot.nodes) {
+                if (predicate(node)) {
+                    functor(node);
+                }
             }
-        }
+        });
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
-                break;
+        withNodeSnapshot([&](const NodeSnapshot& snapshot) {
+            for (const SharedNodePointer& node : snapshot.nodes) {
+                if (!functor(node)) {
+                    break;
+                }
             }
-        }
+        });
     }
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        return withNodeSnapshot([&](const NodeSnapshot& snapshot) {
+            for (const SharedNodePointer& node : snapshot.nodes) {
+                if (predicate(node)) {
+                    return node;
+                }
             }
-        }
 
-        return SharedNodePointer();
+            return SharedNodePointer();
+        });
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -321,6 +319,8 @@ protected slots:
     void clientConnectionToSockAddrReset(const HifiSockAddr& sockAddr);
 
 protected:
+    friend class LimitedNodeListTests;
+
     LimitedNodeList(int socketListenPort = INVALID_PORT, int dtlsListenPort = INVALID_PORT);
     LimitedNodeList(LimitedNodeList const&) = delete; // Don't implement, needed to avoid copies of singleton
     void operator=(LimitedNodeList const&) = delete; // Don't implement, needed to avoid copies of singleton
@@ -331,6 +331,7 @@ protected:
                        const QUuid& connectionSecret = QUuid());
     void collectPacketStats(const NLPacket& packet);
     void fillPacketHeader(const NLPacket& packet, const QUuid& connectionSecret = QUuid());
+    static void fillPacketHeader(const NLPacket& packet, const QUuid& sessionUUID, const QUuid& connectionSecret);
 
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
@@ -346,9 +347,41 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    // Immutable copy of the node set, republished after every add or remove. The each functions, nodeWithUUID and
+    // friends read it without touching _nodeMutex, which now only serializes changes to _nodeHash.
+    struct NodeSnapshot {
+        std::vector<SharedNodePointer> nodes;
+        std::unordered_map<QUuid, SharedNodePointer, UUIDHasher> nodesByUUID;
+    };
+
+    // readers publish the snapshot they use as a per-thread hazard pointer, so a snapshot replaced while it is
+    // being read is only freed once no thread marks it - by the next publish, or by the reader that finishes last
+    // (readers only take _nodeSnapshotMutex while replaced snapshots are waiting to be freed)
+    const NodeSnapshot* acquireNodeSnapshot() const;
+    void releaseNodeSnapshot() const;
+    void publishNodeSnapshot();
+    void reclaimNodeSnapshots() const; // with _nodeSnapshotMutex held
+
+    template<typename SnapshotLambda>
+    auto withNodeSnapshot(SnapshotLambda functor) const -> decltype(functor(std::declval<const NodeSnapshot&>())) {
+        struct SnapshotGuard {
+            const LimitedNodeList& nodeList;
+            const NodeSnapshot* snapshot;
+            SnapshotGuard(const LimitedNodeList& nodeList) :
+                nodeList(nodeList), snapshot(nodeList.acquireNodeSnapshot()) {}
+            ~SnapshotGuard() { nodeList.releaseNodeSnapshot(); }
+        } guard { *this };
+
+        return functor(*guard.snapshot);
+    }
+
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex;
+    mutable std::mutex _nodeSnapshotMutex; // serializes publishing and freeing snapshots
+    std::atomic<const NodeSnapshot*> _nodeSnapshot { nullptr };
+    mutable std::vector<std::unique_ptr<NodeSnapshot>> _nodeSnapshots; // the current snapshot and any still being read
+    mutable std::atomic<bool> _hasReplacedNodeSnapshots { false };
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
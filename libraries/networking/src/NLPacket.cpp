@@ -163,6 +163,47 @@ QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUu
     return hash.result();
 }
 
+SipHash NLPacket::verificationKeyForSecret(const QUuid& connectionSecret) {
+    // lay the secret out as its RFC 4122 bytes without going through a QByteArray
+    uint8_t key[SipHash::KEY_SIZE];
+    key[0] = (uint8_t)(connectionSecret.data1 >> 24);
+    key[1] = (uint8_t)(connectionSecret.data1 >> 16);
+    key[2] = (uint8_t)(connectionSecret.data1 >> 8);
+    key[3] = (uint8_t)connectionSecret.data1;
+    key[4] = (uint8_t)(connectionSecret.data2 >> 8);
+    key[5] = (uint8_t)connectionSecret.data2;
+    key[6] = (uint8_t)(connectionSecret.data3 >> 8);
+    key[7] = (uint8_t)connectionSecret.data3;
+    memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+    return SipHash(key);
+}
+
+void NLPacket::hashForPacketAndKey(const udt::Packet& packet, const SipHash& verificationKey, char hash[NUM_BYTES_MD5_HASH]) {
+    static_assert(NUM_BYTES_MD5_HASH == SipHash::DIGEST_SIZE_128, "SipHash digest must fill the verification hash field");
+
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
+
+    verificationKey.hash128(packet.getData() + offset, packet.getDataSize() - offset, reinterpret_cast<uint8_t*>(hash));
+}
+
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret,
+                                       const SipHash& verificationKey) {
+    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID;
+    const char* headerHash = packet.getData() + offset;
+
+    if (packetVerificationMethod() == PacketVerificationMethod::MD5) {
+        QByteArray expectedHash = hashForPacketAndSecret(packet, connectionSecret);
+        return memcmp(headerHash, expectedHash.constData(), NUM_BYTES_MD5_HASH) == 0;
+    }
+
+    char expectedHash[NUM_BYTES_MD5_HASH];
+    hashForPacketAndKey(packet, verificationKey, expectedHash);
+    return memcmp(headerHash, expectedHash, NUM_BYTES_MD5_HASH) == 0;
+}
+
 void NLPacket::writeTypeAndVersion() {
     auto headerOffset = Packet::totalHeaderSize(isPartOfMessage());
     
@@ -217,7 +258,11 @@ void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) c
     
     auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
                 + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+
+    if (packetVerificationMethod() == PacketVerificationMethod::MD5) {
+        QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
+        memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    } else {
+        hashForPacketAndKey(*this, verificationKeyForSecret(connectionSecret), _packet.get() + offset);
+    }
 }
@@ -14,6 +14,7 @@
 
 #include <QtCore/QSharedPointer>
 
+#include <SipHash.h>
 #include <UUID.h>
 
 #include "udt/Packet.h"
@@ -60,6 +61,13 @@ public:
     static QUuid sourceIDInHeader(const udt::Packet& packet);
     static QByteArray verificationHashInHeader(const udt::Packet& packet);
     static QByteArray hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret);
+
+    // keyed once per connection secret so receivers can cache it alongside the secret
+    static SipHash verificationKeyForSecret(const QUuid& connectionSecret);
+    static void hashForPacketAndKey(const udt::Packet& packet, const SipHash& verificationKey,
+                                    char hash[NUM_BYTES_MD5_HASH]);
+    static bool verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret,
+                                        const SipHash& verificationKey);
     
     PacketType getType() const { return _type; }
     void setType(PacketType type);
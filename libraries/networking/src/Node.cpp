@@ -17,6 +17,7 @@
 
 #include <UUID.h>
 
+#include "NLPacket.h"
 #include "NetworkLogging.h"
 #include "NodePermissions.h"
 #include "SharedUtil.h"
@@ -56,6 +57,7 @@ Node::Node(const QUuid& uuid, NodeType_t type, const HifiSockAddr& publicSocket,
     NetworkPeer(uuid, publicSocket, localSocket, parent),
     _type(type),
     _connectionSecret(connectionSecret),
+    _verificationKey(NLPacket::verificationKeyForSecret(connectionSecret)),
     _pingMs(-1),  // "Uninitialized"
     _clockSkewUsec(0),
     _mutex(),
@@ -67,6 +69,11 @@ Node::Node(const QUuid& uuid, NodeType_t type, const HifiSockAddr& publicSocket,
     _ignoreRadiusEnabled = false;
 }
 
+void Node::setConnectionSecret(const QUuid& connectionSecret) {
+    _connectionSecret = connectionSecret;
+    _verificationKey = NLPacket::verificationKeyForSecret(connectionSecret);
+}
+
 void Node::setType(char type) {
     _type = type;
     
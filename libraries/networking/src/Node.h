@@ -22,6 +22,7 @@
 #include <QtCore/QUuid>
 
 #include <QReadLocker>
+#include <SipHash.h>
 #include <UUIDHasher.h>
 
 #include <tbb/concurrent_unordered_set.h>
@@ -49,7 +50,8 @@ public:
     void setType(char type);
 
     const QUuid& getConnectionSecret() const { return _connectionSecret; }
-    void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
+    void setConnectionSecret(const QUuid& connectionSecret);
+    const SipHash& getVerificationKey() const { return _verificationKey; }
 
     NodeData* getLinkedData() const { return _linkedData.get(); }
     void setLinkedData(std::unique_ptr<NodeData> linkedData) { _linkedData = std::move(linkedData); }
@@ -88,6 +90,7 @@ private:
     NodeType_t _type;
 
     QUuid _connectionSecret;
+    SipHash _verificationKey;
     std::unique_ptr<NodeData> _linkedData;
     int _pingMs;
     qint64 _clockSkewUsec;
@@ -50,6 +50,11 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
         static_cast<NodeList*>(dependency)->deleteLater();
     });
 
+    if (newOwnerType != NodeType::Agent) {
+        // assignment clients move the most packets, have them read and write in batches where the platform allows
+        _nodeSocket.setBatchedIOEnabled(true);
+    }
+
     auto addressManager = DependencyManager::get<AddressManager>();
 
     // handle domain change signals from AddressManager
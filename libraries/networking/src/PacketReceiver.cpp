@@ -12,20 +12,66 @@
 
 #include "PacketReceiver.h"
 
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
 #include <QMutexLocker>
+#include <QtCore/QSet>
+
+#include <GenericQueueThread.h>
 
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "SharedUtil.h"
 
+class PacketReceiver::WorkerQueue : public GenericQueueThread<std::function<void()>> {
+public:
+    WorkerQueue(const QString& name) { setObjectName(name); }
+
+protected:
+    virtual bool processQueueItems(const Queue& items) override {
+        for (const auto& item : items) {
+            item();
+        }
+        return isStillRunning();
+    }
+
+    // wake the worker if it is waiting on an empty queue so terminate() doesn't sit out the full wait
+    virtual void terminating() override { _hasItems.wakeAll(); }
+};
+
+namespace {
+    // the listeners the current thread is in the middle of invoking, which unregisterListener can't wait for
+    thread_local std::vector<const void*> invokingListeners;
+}
+
 PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
     qRegisterMetaType<QSharedPointer<NLPacket>>();
     qRegisterMetaType<QSharedPointer<NLPacketList>>();
     qRegisterMetaType<QSharedPointer<ReceivedMessage>>();
+
+    for (size_t i = 0; i < NUM_PACKET_TYPES; ++i) {
+        _messageListeners[i].store(nullptr, std::memory_order_relaxed);
+        _hasWarnedMissingListener[i].store(false, std::memory_order_relaxed);
+        _workerQueues[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+PacketReceiver::~PacketReceiver() {
+    // stop the workers before the listeners they reference go away
+    for (auto& queue : _workerQueuesByName) {
+        queue.second->terminate();
+    }
 }
 
 bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot) {
+    return registerListenerForTypesInternal(std::move(types), listener, slot, false);
+}
+
+bool PacketReceiver::registerListenerForTypesInternal(PacketTypeList types, QObject* listener,
+                                                      const char* slot, bool isDirect) {
     Q_ASSERT_X(!types.empty(), "PacketReceiver::registerListenerForTypes", "No types to register");
     Q_ASSERT_X(listener, "PacketReceiver::registerListenerForTypes", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerListenerForTypes", "No slot to register");
@@ -54,13 +100,13 @@ bool PacketReceiver::registerListenerForTypes(PacketTypeList types, QObject* lis
     }
     
     // Register non sourced types
-    std::for_each(std::begin(types), middle, [this, &listener, &nonSourcedMethod](PacketType type) {
-        registerVerifiedListener(type, listener, nonSourcedMethod);
+    std::for_each(std::begin(types), middle, [this, &listener, &nonSourcedMethod, isDirect](PacketType type) {
+        registerVerifiedListener(type, listener, nonSourcedMethod, false, isDirect);
     });
     
     // Register sourced types
-    std::for_each(middle, std::end(types), [this, &listener, &sourcedMethod](PacketType type) {
-        registerVerifiedListener(type, listener, sourcedMethod);
+    std::for_each(middle, std::end(types), [this, &listener, &sourcedMethod, isDirect](PacketType type) {
+        registerVerifiedListener(type, listener, sourcedMethod, false, isDirect);
     });
     
     return true;
@@ -70,12 +116,10 @@ void PacketReceiver::registerDirectListener(PacketType type, QObject* listener,
     Q_ASSERT_X(listener, "PacketReceiver::registerDirectListener", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerDirectListener", "No slot to register");
     
-    bool success = registerListener(type, listener, slot);
-    if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
+    QMetaMethod matchingMethod = matchingMethodForListener(type, listener, slot);
+
+    if (matchingMethod.isValid()) {
+        registerVerifiedListener(type, listener, matchingMethod, false, true);
     }
 }
 
@@ -84,14 +128,7 @@ void PacketReceiver::registerDirectListenerForTypes(PacketTypeList types,
     Q_ASSERT_X(listener, "PacketReceiver::registerDirectListenerForTypes", "No object to register");
     Q_ASSERT_X(slot, "PacketReceiver::registerDirectListenerForTypes", "No slot to register");
     
-    // just call register listener for types to start
-    bool success = registerListenerForTypes(std::move(types), listener, slot);
-    if (success) {
-        QMutexLocker locker(&_directConnectSetMutex);
-        
-        // if we successfully registered, add this object to the set of objects that are directly connected
-        _directlyConnectedObjects.insert(listener);
-    }
+    registerListenerForTypesInternal(std::move(types), listener, slot, true);
 }
 
 bool PacketReceiver::registerListener(PacketType type, QObject* listener, const char* slot,
@@ -111,6 +148,23 @@ bool PacketReceiver::registerListener(PacketType type, QObject* listener, const
     }
 }
 
+void PacketReceiver::setWorkerQueueForTypes(PacketTypeList types, const QString& queueName) {
+    Q_ASSERT_X(!queueName.isEmpty(), "PacketReceiver::setWorkerQueueForTypes", "No queue name");
+
+    QMutexLocker locker(&_packetListenerLock);
+
+    auto& queue = _workerQueuesByName[queueName];
+    if (!queue) {
+        queue.reset(new WorkerQueue("PacketReceiver " + queueName));
+        queue->initialize();
+    }
+
+    for (auto type : types) {
+        qCDebug(networking) << "Delivering packet type" << type << "on worker queue" << queueName;
+        _workerQueues[static_cast<uint8_t>(type)].store(queue.get(), std::memory_order_release);
+    }
+}
+
 QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject* object, const char* slot) const {
     Q_ASSERT_X(object, "PacketReceiver::matchingMethodForListener", "No object to call");
     Q_ASSERT_X(slot, "PacketReceiver::matchingMethodForListener", "No slot to call");
@@ -165,39 +219,81 @@ QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject*
     }
 }
 
-void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot, bool deliverPending) {
+void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object, const QMetaMethod& slot,
+                                              bool deliverPending, bool isDirect) {
     Q_ASSERT_X(object, "PacketReceiver::registerVerifiedListener", "No object to register");
+
+    // resolve the node parameter now so that dispatch doesn't have to inspect the slot for every message
+    static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+    static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+
+    NodeParameter nodeParameter = NodeParameter::None;
+    auto parameterTypes = slot.parameterTypes();
+    if (parameterTypes.contains(SHARED_NODE_NORMALIZED)) {
+        nodeParameter = NodeParameter::SharedNodePointer;
+    } else if (parameterTypes.contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+        nodeParameter = NodeParameter::QSharedPointerNode;
+    }
+
     QMutexLocker locker(&_packetListenerLock);
 
-    if (_messageListenerMap.contains(type)) {
+    auto index = static_cast<uint8_t>(type);
+
+    if (_messageListeners[index].load(std::memory_order_relaxed)) {
         qCWarning(networking) << "Registering a packet listener for packet type" << type
             << "that will remove a previously registered listener";
+        _hasRetiredListeners = true;
     }
+
+    _listeners.emplace_back(new Listener(object, slot, nodeParameter, deliverPending, isDirect));
     
     // add the mapping
-    _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
+    _messageListeners[index].store(_listeners.back().get(), std::memory_order_release);
+    _hasWarnedMissingListener[index].store(false, std::memory_order_relaxed);
 }
 
 void PacketReceiver::unregisterListener(QObject* listener) {
     Q_ASSERT_X(listener, "PacketReceiver::unregisterListener", "No listener to unregister");
     
+    std::vector<Listener*> unregistered;
+
     {
         QMutexLocker packetListenerLocker(&_packetListenerLock);
-        
-        // clear any registrations for this listener in _messageListenerMap
-        auto it = _messageListenerMap.begin();
-        
-        while (it != _messageListenerMap.end()) {
-            if (it.value().object == listener) {
-                it = _messageListenerMap.erase(it);
-            } else {
-                ++it;
+
+        // clear any registrations for this listener in _messageListeners
+        for (auto& entry : _messageListeners) {
+            auto registered = entry.load(std::memory_order_relaxed);
+            if (registered && registered->object == listener) {
+                entry.store(nullptr, std::memory_order_release);
+            }
+        }
+
+        // messages already on their way to it are dropped too
+        for (auto& registered : _listeners) {
+            if (registered->object == listener) {
+                registered->isUnregistered = true;
+                unregistered.push_back(registered.get());
             }
         }
+
+        if (unregistered.empty()) {
+            return;
+        }
+
+        _hasRetiredListeners = true;
+        ++_numUnregistering;
     }
-    
-    QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
-    _directlyConnectedObjects.remove(listener);
+
+    // wait for the slots running on other threads, so that the listener can be destroyed once we return
+    {
+        std::unique_lock<std::mutex> lock(_unregisterMutex);
+        for (auto registered : unregistered) {
+            int numInvokingHere = (int)std::count(invokingListeners.begin(), invokingListeners.end(), registered);
+            _unregisterCondition.wait(lock, [&] { return registered->numInvoking <= numInvokingHere; });
+        }
+    }
+
+    --_numUnregistering;
 }
 
 void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
@@ -257,107 +353,126 @@ void PacketReceiver::handleMessageFailure(HifiSockAddr from, udt::Packet::Messag
 }
 
 void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> receivedMessage, bool justReceived) {
-    auto nodeList = DependencyManager::get<LimitedNodeList>();
-    
-    SharedNodePointer matchingNode;
-    
-    if (!receivedMessage->getSourceID().isNull()) {
-        matchingNode = nodeList->nodeWithUUID(receivedMessage->getSourceID());
+    if (_hasRetiredListeners) {
+        freeRetiredListeners();
     }
-    
-    QMutexLocker packetListenerLocker(&_packetListenerLock);
-    
-    bool listenerIsDead = false;
-    
-    auto it = _messageListenerMap.find(receivedMessage->getType());
-            
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
-         
-        auto listener = it.value();
 
-        if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
-            return;
+    auto index = static_cast<uint8_t>(receivedMessage->getType());
+
+    Listener* listener = _messageListeners[index].load(std::memory_order_acquire);
+
+    if (!listener) {
+        // only warn the first time we see a type nobody is listening for
+        if (!_hasWarnedMissingListener[index].exchange(true, std::memory_order_relaxed)) {
+            qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
         }
-    
-        if (listener.object) {
-            
-            bool success = false;
-
-            Qt::ConnectionType connectionType;
-            // check if this is a directly connected listener
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
- 
-                connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
-            }
-            
-            PacketType packetType = receivedMessage->getType();
-            
-            if (matchingNode) {
-                matchingNode->recordBytesReceived(receivedMessage->getSize());
-
-                QMetaMethod metaMethod = listener.method;
-                
-                static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-                static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
-                
-                // one final check on the QPointer before we go to invoke
-                if (listener.object) {
-                    if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(SharedNodePointer, matchingNode));
-                        
-                    } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
-                                                    Q_ARG(QSharedPointer<Node>, matchingNode));
-                        
-                    } else {
-                        success = metaMethod.invoke(listener.object,
-                                                    connectionType,
-                                                    Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-                    }
-                } else {
-                    listenerIsDead = true;
-                }
-            } else {
-                // one final check on the QPointer before we invoke
-                if (listener.object) {
-                    success = listener.method.invoke(listener.object,
-                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
-                } else {
-                    listenerIsDead = true;
-                }
-                
-            }
-            
-            if (!success) {
-                qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to listener "
-                    << listener.object << "::" << qPrintable(listener.method.methodSignature());
-            }
-            
+        return;
+    }
+
+    if ((listener->deliverPending && !justReceived) || (!listener->deliverPending && !receivedMessage->isComplete())) {
+        return;
+    }
+
+    if (!listener->object) {
+        qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
+            << " has been destroyed. Removing from listener map.";
+
+        // only clear the entry if it wasn't replaced by a new registration in the meantime
+        if (_messageListeners[index].compare_exchange_strong(listener, nullptr, std::memory_order_acq_rel)) {
+            _hasRetiredListeners = true;
+        }
+        return;
+    }
+
+    WorkerQueue* workerQueue = _workerQueues[index].load(std::memory_order_acquire);
+
+    if (workerQueue) {
+        ++listener->numQueued;
+        workerQueue->queueItem([this, listener, receivedMessage] {
+            invokeListener(*listener, receivedMessage, Qt::DirectConnection);
+            --listener->numQueued;
+        });
+    } else {
+        invokeListener(*listener, receivedMessage, listener->isDirect ? Qt::DirectConnection : Qt::AutoConnection);
+    }
+}
+
+void PacketReceiver::invokeListener(Listener& listener, const QSharedPointer<ReceivedMessage>& receivedMessage,
+                                    Qt::ConnectionType connectionType) {
+    // count ourselves in before checking, so that unregisterListener either waits for us or we see it
+    ++listener.numInvoking;
+    invokingListeners.push_back(&listener);
+
+    // one final check on the QPointer before we go to invoke
+    QObject* object = listener.isUnregistered ? nullptr : listener.object.data();
+
+    if (object) {
+        SharedNodePointer matchingNode;
+
+        if (!receivedMessage->getSourceID().isNull()) {
+            matchingNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(receivedMessage->getSourceID());
+        }
+
+        bool success = false;
+
+        if (matchingNode) {
+            matchingNode->recordBytesReceived(receivedMessage->getSize());
+        }
+
+        if (matchingNode && listener.nodeParameter == NodeParameter::SharedNodePointer) {
+            success = listener.method.invoke(object, connectionType,
+                                             Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                             Q_ARG(SharedNodePointer, matchingNode));
+        } else if (matchingNode && listener.nodeParameter == NodeParameter::QSharedPointerNode) {
+            success = listener.method.invoke(object, connectionType,
+                                             Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
+                                             Q_ARG(QSharedPointer<Node>, matchingNode));
         } else {
-            listenerIsDead = true;
+            success = listener.method.invoke(object, connectionType,
+                                             Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
         }
-        
-        if (listenerIsDead) {
-            qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
-                << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
-            
-            // if it exists, remove the listener from _directlyConnectedObjects
-            {
-                QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
-            }
+
+        if (!success) {
+            qCDebug(networking).nospace() << "Error delivering packet " << receivedMessage->getType() << " to listener "
+                << object << "::" << qPrintable(listener.method.methodSignature());
         }
-    } else if (it == _messageListenerMap.end()) {
-        qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
-        
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
     }
+
+    invokingListeners.pop_back();
+    --listener.numInvoking;
+
+    if (listener.isUnregistered) {
+        std::lock_guard<std::mutex> lock(_unregisterMutex);
+        _unregisterCondition.notify_all();
+    }
+}
+
+void PacketReceiver::freeRetiredListeners() {
+    // registration is rare, so rather than wait on it we try again with the next message
+    if (!_packetListenerLock.tryLock()) {
+        return;
+    }
+
+    std::unordered_set<const Listener*> mappedListeners;
+    for (auto& entry : _messageListeners) {
+        if (auto listener = entry.load(std::memory_order_relaxed)) {
+            mappedListeners.insert(listener);
+        }
+    }
+
+    bool hasRetiredListeners = false;
+    _listeners.erase(std::remove_if(_listeners.begin(), _listeners.end(), [&](const std::unique_ptr<Listener>& listener) {
+        if (mappedListeners.count(listener.get())) {
+            return false;
+        }
+        if (listener->numQueued > 0 || _numUnregistering > 0) {
+            hasRetiredListeners = true;
+            return false;
+        }
+        return true;
+    }), _listeners.end());
+
+    _hasRetiredListeners = hasRetiredListeners;
+
+    _packetListenerLock.unlock();
 }
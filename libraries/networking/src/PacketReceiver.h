@@ -13,6 +13,14 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
@@ -21,7 +29,6 @@
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
-#include <QtCore/QSet>
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
@@ -47,6 +54,7 @@ public:
     
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
+    ~PacketReceiver();
 
     PacketReceiver& operator=(const PacketReceiver&) = delete;
     
@@ -63,40 +71,87 @@ public:
     bool registerListener(PacketType type, QObject* listener, const char* slot, bool deliverPending = false);
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
     void unregisterListener(QObject* listener);
+
+    // Messages of the given types will be delivered on a dedicated worker thread (one per queue name) instead of
+    // being handed to the listener's thread. Slots are invoked directly on the worker, so listeners for these types
+    // must be safe to call off of their own thread. Types that share a queue name are delivered in order.
+    // unregisterListener waits for a slot running on a worker, and messages still queued for it are dropped.
+    void setWorkerQueueForTypes(PacketTypeList types, const QString& queueName);
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
     void handleVerifiedMessagePacket(std::unique_ptr<udt::Packet> message);
     void handleMessageFailure(HifiSockAddr from, udt::Packet::MessageNumber messageNumber);
     
 private:
+    enum class NodeParameter {
+        None,
+        SharedNodePointer,
+        QSharedPointerNode
+    };
+
     struct Listener {
+        Listener(QObject* object, const QMetaMethod& method, NodeParameter nodeParameter, bool deliverPending, bool isDirect) :
+            object(object), method(method), nodeParameter(nodeParameter), deliverPending(deliverPending), isDirect(isDirect) {}
+
         QPointer<QObject> object;
         QMetaMethod method;
+        NodeParameter nodeParameter;
         bool deliverPending;
+        bool isDirect;
+
+        std::atomic<bool> isUnregistered { false }; // no longer invoked, even for messages already on a worker queue
+        std::atomic<int> numInvoking { 0 }; // invocations in progress, that unregisterListener waits for
+        std::atomic<int> numQueued { 0 }; // messages on a worker queue for it, which keep it from being freed
     };
 
+    class WorkerQueue;
+
+    static const size_t NUM_PACKET_TYPES = std::numeric_limits<std::underlying_type<PacketType>::type>::max() + 1;
+
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
+    void invokeListener(Listener& listener, const QSharedPointer<ReceivedMessage>& message,
+                        Qt::ConnectionType connectionType);
+    void freeRetiredListeners();
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
     // should be changed to have a true event loop and be able to handle our QMetaMethod::invoke
     void registerDirectListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
     void registerDirectListener(PacketType type, QObject* listener, const char* slot);
 
+    bool registerListenerForTypesInternal(PacketTypeList types, QObject* listener, const char* slot, bool isDirect);
+
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
-    void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
+    void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot,
+                                  bool deliverPending = false, bool isDirect = false);
 
+    // writers (registration, unregistration, worker queue setup) take _packetListenerLock
+    // handleVerifiedMessage only ever reads the per-type tables, so dispatch never waits on a lock
     QMutex _packetListenerLock;
-    QHash<PacketType, Listener> _messageListenerMap;
+
+    // a Listener replaced or unregistered (retired) is freed by the thread that handles verified packets - the only
+    // one that reads _messageListeners outside of the lock - once no message is queued for it on a worker
+    std::vector<std::unique_ptr<Listener>> _listeners;
+    std::atomic<bool> _hasRetiredListeners { false };
+
+    // signaled when an invocation of an unregistered listener is done, no listener is freed while one is waited for
+    std::atomic<int> _numUnregistering { 0 };
+    std::mutex _unregisterMutex;
+    std::condition_variable _unregisterCondition;
+    std::array<std::atomic<Listener*>, NUM_PACKET_TYPES> _messageListeners;
+    std::array<std::atomic<bool>, NUM_PACKET_TYPES> _hasWarnedMissingListener;
+
+    std::map<QString, std::unique_ptr<WorkerQueue>> _workerQueuesByName;
+    std::array<std::atomic<WorkerQueue*>, NUM_PACKET_TYPES> _workerQueues;
+
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
-    QMutex _directConnectSetMutex;
-    QSet<QObject*> _directlyConnectedObjects;
 
     std::unordered_map<std::pair<HifiSockAddr, udt::Packet::MessageNumber>, QSharedPointer<ReceivedMessage>> _pendingMessages;
     
     friend class EntityEditPacketSender;
     friend class OctreePacketProcessor;
+    friend class PacketReceiverTests;
 };
 
 #endif // hifi_PacketReceiver_h
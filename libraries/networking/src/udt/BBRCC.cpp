@@ -0,0 +1,339 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2) - the smallest gain that lets startup double the delivery rate each round trip
+static const double HIGH_GAIN = 2.885;
+static const double PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN = 2.0;
+static const double PROBE_BANDWIDTH_PACING_GAINS[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PROBE_BANDWIDTH_CYCLE_LENGTH = sizeof(PROBE_BANDWIDTH_PACING_GAINS) / sizeof(double);
+
+static const int BANDWIDTH_FILTER_ROUNDS = 10;
+static const auto MIN_RTT_FILTER_WINDOW = seconds(10);
+static const auto PROBE_RTT_DURATION = milliseconds(200);
+
+// startup is over once three round trips in a row don't grow the bandwidth estimate by a quarter
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+static const int INITIAL_CONGESTION_WINDOW_PACKETS = 16;
+
+BBRCC::BBRCC() :
+    _pacingGain(HIGH_GAIN),
+    _congestionWindowGain(HIGH_GAIN)
+{
+    _mss = udt::MAX_PACKET_SIZE_WITH_UDP_HEADER;
+
+    // the first window goes out unpaced, pacing starts with the first delivery rate sample
+    _packetSendPeriod = 0.0;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW_PACKETS;
+
+    setAckInterval(1); // every ACK is a delivery rate sample
+
+    // we can't do this as a member initializer until our VS has support for constexpr
+    _minRTT = std::numeric_limits<int>::max();
+
+    auto now = p_high_resolution_clock::now();
+    _deliveredTime = now;
+    _minRTTTimestamp = now;
+    _cycleTimestamp = now;
+}
+
+void BBRCC::setInitialSendSequenceNumber(SequenceNumber seqNum) {
+    _lastACK = seqNum - 1;
+    _lastSentSequenceNumber = seqNum - 1;
+}
+
+int BBRCC::packetsInFlight() const {
+    return std::max(seqoff(_lastACK, _lastSentSequenceNumber), 0);
+}
+
+double BBRCC::bottleneckBandwidth() const {
+    if (_bandwidthSamples.empty()) {
+        return 0.0;
+    }
+
+    double bandwidth = _bandwidthSamples.front().second;
+
+    // the receiver's packet pair estimate (from the PacketTimeWindow, sent with sync ACKs) is an upper bound on
+    // what the link can carry - use it to keep compressed ACKs from inflating the estimate
+    if (_bandwidth > 0) {
+        bandwidth = std::min(bandwidth, (double)_bandwidth);
+    }
+
+    return bandwidth;
+}
+
+int BBRCC::bandwidthDelayProduct(double gain) const {
+    auto bandwidth = bottleneckBandwidth();
+    if (bandwidth <= 0.0 || _minRTT == std::numeric_limits<int>::max()) {
+        return INITIAL_CONGESTION_WINDOW_PACKETS;
+    }
+
+    return (int)(gain * bandwidth * _minRTT / USECS_PER_SECOND + 0.5);
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (seqNum <= _lastACK || _sentPackets.find(seqNum) != _sentPackets.end()) {
+        // this is a re-send, the original send time is the one RTT and delivery rate are measured against
+        return;
+    }
+
+    // if the queue sat idle for more than a couple of send periods with room left in the window then the sender
+    // is the bottleneck, not the network - samples taken until this flight is delivered would underestimate it
+    int inFlight = packetsInFlight();
+    auto sinceLastSend = duration_cast<microseconds>(timePoint - _lastSendTime).count();
+    if (inFlight < _congestionWindowSize && sinceLastSend > 2 * std::max(_packetSendPeriod, 1.0) + synInterval()) {
+        _appLimitedUntil = _delivered + std::max(inFlight, 1);
+    }
+
+    if (inFlight == 0) {
+        // restarting from idle, measure the next interval from now
+        _deliveredTime = timePoint;
+    }
+
+    _sentPackets[seqNum] = { timePoint, _deliveredTime, _delivered, _appLimitedUntil > _delivered };
+
+    if (seqNum > _lastSentSequenceNumber) {
+        _lastSentSequenceNumber = seqNum;
+    }
+    _lastSendTime = timePoint;
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    int newlyDelivered = seqoff(_lastACK, ack);
+    if (newlyDelivered <= 0) {
+        return false;
+    }
+
+    _lastACK = ack;
+    _delivered += newlyDelivered;
+    _deliveredTime = receiveTime;
+    _isRoundStart = false;
+
+    auto it = _sentPackets.find(ack);
+    if (it != _sentPackets.end()) {
+        const auto& state = it->second;
+
+        int rtt = (int)duration_cast<microseconds>(receiveTime - state.sendTime).count();
+
+        // cap the sample to avoid overflows in the window calculations, and never allow a zero RTT
+        const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+        rtt = std::min(std::max(rtt, 1), MAX_RTT_SAMPLE_MICROSECONDS);
+        updateRoundTripTime(rtt, receiveTime);
+
+        // the delivery rate is the packets delivered since this one was sent over the time it took them to arrive
+        auto interval = duration_cast<microseconds>(receiveTime - state.deliveredTime).count();
+        if (interval > 0) {
+            double deliveryRate = (double)(_delivered - state.delivered) * USECS_PER_SECOND / interval;
+
+            // app limited samples can only raise the estimate
+            if (!state.isAppLimited || deliveryRate >= bottleneckBandwidth()) {
+                updateBandwidth(deliveryRate);
+            }
+        }
+
+        if (state.delivered >= _nextRoundDelivered) {
+            _nextRoundDelivered = _delivered;
+            ++_roundCount;
+            _isRoundStart = true;
+
+            // age out samples that are older than the bandwidth filter window
+            while (!_bandwidthSamples.empty()
+                   && _bandwidthSamples.front().first + BANDWIDTH_FILTER_ROUNDS <= _roundCount) {
+                _bandwidthSamples.pop_front();
+            }
+        }
+    }
+
+    // drop the state for every packet this ACK covers
+    _sentPackets.erase(_sentPackets.begin(), _sentPackets.upper_bound(ack));
+
+    checkFullPipe();
+    updateMode(receiveTime);
+    updateControlParameters(newlyDelivered);
+
+    // losses are re-sent from NAKs, we never need a fast re-transmit
+    return false;
+}
+
+void BBRCC::onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) {
+    // loss is not a congestion signal here, it only ends a bandwidth probe early
+    _hasLossInCycle = true;
+}
+
+void BBRCC::onTimeout() {
+    // nothing has been heard for a full timeout - fall back to a minimal window until the next ACK comes in
+    if (!_isRecoveringFromTimeout) {
+        _priorCongestionWindowSize = std::max(_priorCongestionWindowSize, _congestionWindowSize);
+        _isRecoveringFromTimeout = true;
+    }
+    _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+}
+
+void BBRCC::updateBandwidth(double deliveryRate) {
+    // windowed max filter - keep the samples in decreasing order so the max is always at the front
+    while (!_bandwidthSamples.empty() && _bandwidthSamples.back().second <= deliveryRate) {
+        _bandwidthSamples.pop_back();
+    }
+    _bandwidthSamples.emplace_back(_roundCount, deliveryRate);
+}
+
+void BBRCC::updateRoundTripTime(int rtt, p_high_resolution_clock::time_point now) {
+    _minRTTExpired = now > _minRTTTimestamp + MIN_RTT_FILTER_WINDOW;
+
+    if (rtt <= _minRTT || _minRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTimestamp = now;
+    }
+}
+
+void BBRCC::checkFullPipe() {
+    if (_isFullPipe || !_isRoundStart) {
+        return;
+    }
+
+    auto bandwidth = bottleneckBandwidth();
+    if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+        // still growing - wait for the next round trip
+        _fullBandwidth = bandwidth;
+        _fullBandwidthRounds = 0;
+    } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+        _isFullPipe = true;
+    }
+}
+
+void BBRCC::enterProbeBandwidth(p_high_resolution_clock::time_point now) {
+    static std::random_device randomDevice;
+    static std::mt19937 generator(randomDevice());
+
+    _mode = Mode::ProbeBandwidth;
+    _congestionWindowGain = PROBE_BANDWIDTH_CONGESTION_WINDOW_GAIN;
+
+    // start anywhere in the cycle except the drain phase, so that connections sharing a link don't probe in lockstep
+    int index = generator() % (PROBE_BANDWIDTH_CYCLE_LENGTH - 1);
+    _cycleIndex = index >= 1 ? index + 1 : index;
+    _pacingGain = PROBE_BANDWIDTH_PACING_GAINS[_cycleIndex];
+    _cycleTimestamp = now;
+    _hasLossInCycle = false;
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point now) {
+    if (_mode == Mode::Startup && _isFullPipe) {
+        _mode = Mode::Drain;
+        _pacingGain = 1.0 / HIGH_GAIN;
+        _congestionWindowGain = HIGH_GAIN;
+    }
+
+    if (_mode == Mode::Drain && packetsInFlight() <= bandwidthDelayProduct(1.0)) {
+        enterProbeBandwidth(now);
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        bool hasFullCycleElapsed = duration_cast<microseconds>(now - _cycleTimestamp).count() > _minRTT;
+        bool shouldAdvance = hasFullCycleElapsed;
+
+        if (_pacingGain > 1.0) {
+            // keep probing until we've actually put the extra packets in flight, unless that is causing loss
+            shouldAdvance = hasFullCycleElapsed
+                && (_hasLossInCycle || packetsInFlight() >= bandwidthDelayProduct(_pacingGain));
+        } else if (_pacingGain < 1.0) {
+            // stop draining as soon as the queue we built while probing is gone
+            shouldAdvance = hasFullCycleElapsed || packetsInFlight() <= bandwidthDelayProduct(1.0);
+        }
+
+        if (shouldAdvance) {
+            _cycleIndex = (_cycleIndex + 1) % PROBE_BANDWIDTH_CYCLE_LENGTH;
+            _pacingGain = PROBE_BANDWIDTH_PACING_GAINS[_cycleIndex];
+            _cycleTimestamp = now;
+            _hasLossInCycle = false;
+        }
+    }
+
+    if (_mode != Mode::ProbeRTT && _minRTTExpired) {
+        // the min RTT hasn't been refreshed in a while, drain the pipe so we can measure it again
+        _mode = Mode::ProbeRTT;
+        _pacingGain = 1.0;
+        _congestionWindowGain = 1.0;
+        _priorCongestionWindowSize = std::max(_priorCongestionWindowSize, _congestionWindowSize);
+        _hasProbeRTTDoneTimestamp = false;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (!_hasProbeRTTDoneTimestamp && packetsInFlight() <= MIN_CONGESTION_WINDOW_PACKETS) {
+            // hold the minimal window for a while and at least one round trip
+            _probeRTTDoneTimestamp = now + PROBE_RTT_DURATION;
+            _hasProbeRTTDoneTimestamp = true;
+            _probeRTTRoundDone = _roundCount + 1;
+        } else if (_hasProbeRTTDoneTimestamp && _roundCount >= _probeRTTRoundDone && now > _probeRTTDoneTimestamp) {
+            _minRTTTimestamp = now;
+            _minRTTExpired = false;
+            _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+            _priorCongestionWindowSize = 0;
+
+            if (_isFullPipe) {
+                enterProbeBandwidth(now);
+            } else {
+                _mode = Mode::Startup;
+                _pacingGain = HIGH_GAIN;
+                _congestionWindowGain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+void BBRCC::updateControlParameters(int newlyDelivered) {
+    // pace at the bandwidth estimate times the current gain
+    double pacingRate = _pacingGain * bottleneckBandwidth();
+    if (pacingRate > 0.0) {
+        double sendPeriod = USECS_PER_SECOND / pacingRate;
+
+        // until startup is done the rate only ever goes up
+        if (_isFullPipe || _packetSendPeriod <= 0.0 || sendPeriod < _packetSendPeriod) {
+            setPacketSendPeriod(sendPeriod);
+        }
+    }
+
+    if (_isRecoveringFromTimeout) {
+        // we're hearing back again, go back to where we were
+        _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+        _priorCongestionWindowSize = 0;
+        _isRecoveringFromTimeout = false;
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+        return;
+    }
+
+    int targetWindowSize = std::max(bandwidthDelayProduct(_congestionWindowGain), MIN_CONGESTION_WINDOW_PACKETS);
+
+    if (_isFullPipe) {
+        _congestionWindowSize = std::min(_congestionWindowSize + newlyDelivered, targetWindowSize);
+    } else if (_congestionWindowSize < targetWindowSize || _delivered < INITIAL_CONGESTION_WINDOW_PACKETS) {
+        _congestionWindowSize += newlyDelivered;
+    }
+
+    _congestionWindowSize = std::min(std::max(_congestionWindowSize, MIN_CONGESTION_WINDOW_PACKETS),
+                                     udt::MAX_PACKETS_IN_FLIGHT);
+}
@@ -0,0 +1,114 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <deque>
+#include <map>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Model based congestion control in the style of BBR (https://queue.acm.org/detail.cfm?id=3022184).
+// Rather than treating loss or rising delay as a congestion signal, the sender keeps running estimates of the
+// bottleneck bandwidth (windowed max of delivery rate samples) and of the round trip propagation time (windowed min
+// RTT), paces packets out at that bandwidth and caps the packets in flight at a small multiple of their product.
+// Random loss on a wireless hop therefore gets re-sent from NAKs without collapsing the sending rate.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onLoss(SequenceNumber rangeStart, SequenceNumber rangeEnd) override;
+    virtual void onTimeout() override;
+
+    virtual bool shouldNAK() override { return true; }
+    virtual bool shouldACK2() override { return false; }
+    virtual bool shouldProbe() override { return false; }
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override;
+
+private:
+    enum class Mode {
+        Startup, // grow the sending rate exponentially until the bandwidth estimate stops growing
+        Drain, // drain the queue built up during startup
+        ProbeBandwidth, // cycle the pacing gain around the bandwidth estimate to pick up any new bandwidth
+        ProbeRTT // briefly empty the pipe to re-measure the propagation delay
+    };
+
+    struct SentPacketState {
+        p_high_resolution_clock::time_point sendTime;
+        p_high_resolution_clock::time_point deliveredTime; // time of the latest delivery when this packet was sent
+        int64_t delivered; // number of packets delivered when this packet was sent
+        bool isAppLimited; // whether the sender had nothing to send when this packet went out
+    };
+
+    int packetsInFlight() const;
+    double bottleneckBandwidth() const; // packets per second
+    int bandwidthDelayProduct(double gain) const; // in packets
+
+    void updateBandwidth(double deliveryRate);
+    void updateRoundTripTime(int rtt, p_high_resolution_clock::time_point now);
+    void checkFullPipe();
+    void updateMode(p_high_resolution_clock::time_point now);
+    void enterProbeBandwidth(p_high_resolution_clock::time_point now);
+    void updateControlParameters(int newlyDelivered);
+
+    using SentPacketStates = std::map<SequenceNumber, SentPacketState>;
+    SentPacketStates _sentPackets; // send state for each packet waiting on an ACK
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+    SequenceNumber _lastSentSequenceNumber; // Highest sequence number sent so far
+    p_high_resolution_clock::time_point _lastSendTime;
+
+    int64_t _delivered { 0 }; // Total packets delivered (cumulatively ACKed)
+    p_high_resolution_clock::time_point _deliveredTime; // Time of the last delivery
+    int64_t _appLimitedUntil { 0 }; // Delivery count until which samples are marked app limited
+
+    int64_t _roundCount { 0 }; // Number of round trips so far
+    int64_t _nextRoundDelivered { 0 }; // Delivery count that ends the current round trip
+    bool _isRoundStart { false };
+
+    std::deque<std::pair<int64_t, double>> _bandwidthSamples; // (round, rate) - decreasing rates, max at the front
+
+    int _minRTT; // Lowest RTT in the current window, in microseconds
+    p_high_resolution_clock::time_point _minRTTTimestamp;
+    bool _minRTTExpired { false };
+
+    bool _isFullPipe { false }; // Startup has found the bottleneck bandwidth
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthRounds { 0 };
+
+    int _cycleIndex { 0 }; // Index in the ProbeBandwidth pacing gain cycle
+    p_high_resolution_clock::time_point _cycleTimestamp;
+    bool _hasLossInCycle { false };
+
+    p_high_resolution_clock::time_point _probeRTTDoneTimestamp;
+    bool _hasProbeRTTDoneTimestamp { false };
+    int64_t _probeRTTRoundDone { 0 };
+    int _priorCongestionWindowSize { 0 }; // Window to restore after ProbeRTT or a timeout
+    bool _isRecoveringFromTimeout { false };
+};
+
+}
+
+#endif // hifi_BBRCC_h
@@ -13,7 +13,11 @@
 
 #include <random>
 
+#include <QtCore/QDebug>
+
+#include "BBRCC.h"
 #include "Packet.h"
+#include "TCPVegasCC.h"
 
 using namespace udt;
 using namespace std::chrono;
@@ -21,6 +25,42 @@ using namespace std::chrono;
 static const double USECS_PER_SECOND = 1000000.0;
 static const int BITS_PER_BYTE = 8;
 
+std::unique_ptr<CongestionControlVirtualFactory> udt::congestionControlFactoryForName(const QString& name) {
+    auto lowerName = name.toLower();
+
+    if (lowerName == "default") {
+        return std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<DefaultCC>());
+    } else if (lowerName == "vegas") {
+        return std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<TCPVegasCC>());
+    } else if (lowerName == "bbr") {
+        return std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<BBRCC>());
+    }
+
+    return nullptr;
+}
+
+std::unique_ptr<CongestionControlVirtualFactory> udt::defaultCongestionControlFactory() {
+    static const QString requestedName = [] {
+        static const char* CONGESTION_CONTROL_ENV_VARIABLE = "HIFI_UDT_CONGESTION_CONTROL";
+        return QString::fromLocal8Bit(qgetenv(CONGESTION_CONTROL_ENV_VARIABLE));
+    }();
+
+    if (!requestedName.isEmpty()) {
+        auto factory = congestionControlFactoryForName(requestedName);
+        if (factory) {
+            return factory;
+        }
+
+        static bool hasWarned = false;
+        if (!hasWarned) {
+            qWarning() << "Unknown congestion control" << requestedName << "- falling back to TCP Vegas";
+            hasWarned = true;
+        }
+    }
+
+    return std::unique_ptr<CongestionControlVirtualFactory>(new CongestionControlFactory<TCPVegasCC>());
+}
+
 void CongestionControl::setMaxBandwidth(int maxBandwidth) {
     _maxBandwidth = maxBandwidth;
     setPacketSendPeriod(_packetSendPeriod);
@@ -16,6 +16,8 @@
 #include <memory>
 #include <vector>
 
+#include <QtCore/QString>
+
 #include <PortableHighResolutionClock.h>
 
 #include "LossList.h"
@@ -106,6 +108,12 @@ public:
     virtual std::unique_ptr<CongestionControl> create() override { return std::unique_ptr<T>(new T()); }
 };
 
+// returns a factory for the named congestion control ("default", "vegas" or "bbr"), or nullptr for an unknown name
+std::unique_ptr<CongestionControlVirtualFactory> congestionControlFactoryForName(const QString& name);
+
+// the factory new sockets start with - TCP Vegas, unless HIFI_UDT_CONGESTION_CONTROL names another one
+std::unique_ptr<CongestionControlVirtualFactory> defaultCongestionControlFactory();
+
 class DefaultCC: public CongestionControl {
 public:
     DefaultCC();
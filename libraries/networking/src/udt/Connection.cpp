@@ -11,7 +11,6 @@
 
 #include "Connection.h"
 
-#include <QtCore/QThread>
 
 #include <NumericalConstants.h>
 
@@ -72,21 +71,15 @@ Connection::~Connection() {
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
-        // tell the send queue to stop and be deleted
-        
-        sendQueue->stop();
-        sendQueue->deleteLater();
+    if (_sendQueue) {
+        // tell the send queue to stop
+        _sendQueue->stop();
         
         // since we're stopping the send queue we should consider our handshake ACK not receieved
         _hasReceivedHandshakeACK = false;
         
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
+        // deleting the send queue waits for the scheduler to be done with it
+        _sendQueue.reset();
     }
 }
 
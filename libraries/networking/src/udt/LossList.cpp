@@ -11,159 +11,155 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
 void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
+    Q_ASSERT_X(_lossList.empty() || (_lossList.rbegin()->second < seq), "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
     
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
+    if (getLength() > 0 && _lossList.rbegin()->second + 1 == seq) {
+        ++_lossList.rbegin()->second;
     } else {
-        _lossList.push_back(make_pair(seq, seq));
+        _lossList.emplace_hint(_lossList.end(), seq, seq);
     }
     _length += 1;
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(_lossList.empty() || (_lossList.rbegin()->second < start),
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
     Q_ASSERT_X(start <= end,
                "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
+    if (getLength() > 0 && _lossList.rbegin()->second + 1 == start) {
+        _lossList.rbegin()->second = end;
     } else {
-        _lossList.push_back(make_pair(start, end));
+        _lossList.emplace_hint(_lossList.end(), start, end);
     }
     _length += seqlen(start, end);
 }
 
+LossList::Ranges::iterator LossList::firstRangeFrom(SequenceNumber seq, bool touchAdjacent) {
+    auto it = _lossList.upper_bound(seq);
+    
+    if (it != _lossList.begin()) {
+        auto previous = std::prev(it);
+        if (seq <= previous->second || (touchAdjacent && previous->second + 1 == seq)) {
+            return previous;
+        }
+    }
+    
+    return it;
+}
+
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
+    auto it = firstRangeFrom(start, true);
     
-    if (it == _lossList.end() || end < it->first) {
+    if (it == _lossList.end() || end + 1 < it->first) {
         // No overlap, simply insert
         _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
-    } else {
-        // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
-        }
-        
-        // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
-        }
-        
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
-            // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
-            }
-            
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
-        }
+        _lossList.emplace_hint(it, start, end);
+        return;
+    }
+    
+    // absorb every range touching the new one, then put back the merged range
+    auto mergedStart = std::min(start, it->first);
+    auto mergedEnd = end;
+    
+    while (it != _lossList.end() && it->first <= mergedEnd + 1) {
+        mergedEnd = std::max(mergedEnd, it->second);
+        _length -= seqlen(it->first, it->second);
+        it = _lossList.erase(it);
     }
+    
+    _length += seqlen(mergedStart, mergedEnd);
+    _lossList.emplace_hint(it, mergedStart, mergedEnd);
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
-    
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
-        } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
-        }
-        _length -= 1;
-        
-        // this sequence number was found in the loss list, return true
-        return true;
-    } else {
+    auto it = firstRangeFrom(seq, false);
+    
+    if (it == _lossList.end() || seq < it->first) {
         // this sequence number was not found in the loss list, return false
         return false;
     }
+    
+    auto first = it->first;
+    auto last = it->second;
+    
+    if (first == last) {
+        _lossList.erase(it);
+    } else if (seq == last) {
+        --it->second;
+    } else if (seq == first) {
+        // the key changes, so the rest of the range needs to be re-inserted
+        auto hint = _lossList.erase(it);
+        _lossList.emplace_hint(hint, seq + 1, last);
+    } else {
+        // cut the range in two around seq
+        it->second = seq - 1;
+        _lossList.emplace_hint(std::next(it), seq + 1, last);
+    }
+    _length -= 1;
+    
+    // this sequence number was found in the loss list, return true
+    return true;
 }
 
 void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
+    
     // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
+    auto it = firstRangeFrom(start, false);
     
-    // If we found one
-    if (it != _lossList.end()) {
+    while (it != _lossList.end() && it->first <= end) {
+        auto first = it->first;
+        auto last = it->second;
+        
+        _length -= seqlen(first, last);
+        it = _lossList.erase(it);
         
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
+        // keep whatever part of the segment falls outside of the removed range
+        if (first < start) {
+            _length += seqlen(first, start - 1);
+            _lossList.emplace_hint(it, first, start - 1);
         }
         
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
+        if (end < last) {
+            _length += seqlen(end + 1, last);
+            _lossList.emplace_hint(it, end + 1, last);
         }
     }
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+    return _lossList.begin()->first;
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
-    auto front = getFirstSequenceNumber();
-    remove(front);
+    Q_ASSERT_X(getLength() > 0, "LossList::popFirstSequenceNumber()", "Trying to pop first element of an empty list");
+    
+    auto it = _lossList.begin();
+    auto front = it->first;
+    auto last = it->second;
+    
+    it = _lossList.erase(it);
+    if (front != last) {
+        _lossList.emplace_hint(it, front + 1, last);
+    }
+    _length -= 1;
+    
     return front;
 }
 
@@ -12,7 +12,7 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <map>
 
 #include "SequenceNumber.h"
 
@@ -30,7 +30,7 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere, merging with any overlapping or adjacent ranges
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
@@ -44,7 +44,16 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    // disjoint, non-adjacent ranges keyed by their first sequence number - lookups, inserts and removals are
+    // O(log n) in the number of ranges instead of a linear scan. All of the sequence numbers in the list are
+    // within SequenceNumber::THRESHOLD of each other, which keeps the wrapping comparison a strict ordering.
+    using Ranges = std::map<SequenceNumber, SequenceNumber>;
+
+    // returns the range containing seq, or the one immediately before it if touchAdjacent is true and that range
+    // ends right before seq, otherwise the first range after seq
+    Ranges::iterator firstRangeFrom(SequenceNumber seq, bool touchAdjacent);
+
+    Ranges _lossList;
     int _length { 0 };
 };
     
@@ -0,0 +1,174 @@
+//
+//  MultiDatagramIO.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MultiDatagramIO.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include "Constants.h"
+
+using namespace udt;
+
+// datagrams that don't fit are truncated and dropped, nothing valid is larger than this
+static const int RECEIVE_BUFFER_SIZE = MAX_PACKET_SIZE_WITH_UDP_HEADER;
+
+// sends are built on the stack of the calling thread, in chunks of this many datagrams
+static const int MAX_SEND_BATCH_SIZE = 64;
+
+#ifdef Q_OS_LINUX
+
+struct MultiDatagramIO::Headers {
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iovecs;
+    std::vector<sockaddr_in> addresses;
+};
+
+bool MultiDatagramIO::isSupported() {
+    return true;
+}
+
+MultiDatagramIO::MultiDatagramIO(int batchSize) :
+    _batchSize(batchSize),
+    _buffers(batchSize * RECEIVE_BUFFER_SIZE),
+    _sizes(batchSize, 0),
+    _headers(new Headers)
+{
+    _headers->messages.resize(batchSize);
+    _headers->iovecs.resize(batchSize);
+    _headers->addresses.resize(batchSize);
+}
+
+MultiDatagramIO::~MultiDatagramIO() {
+    delete _headers;
+}
+
+int MultiDatagramIO::receive(qintptr socketDescriptor) {
+    auto& messages = _headers->messages;
+
+    // recvmmsg overwrites the lengths, so the headers are reset for every batch
+    for (int i = 0; i < _batchSize; ++i) {
+        auto& iov = _headers->iovecs[i];
+        iov.iov_base = &_buffers[i * RECEIVE_BUFFER_SIZE];
+        iov.iov_len = RECEIVE_BUFFER_SIZE;
+
+        memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &iov;
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &_headers->addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    int numReceived = recvmmsg((int)socketDescriptor, messages.data(), _batchSize, MSG_DONTWAIT, nullptr);
+    if (numReceived < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    for (int i = 0; i < numReceived; ++i) {
+        // a truncated datagram can't be a valid packet, mark it as empty so it gets skipped
+        _sizes[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : (int)messages[i].msg_len;
+    }
+
+    return numReceived;
+}
+
+HifiSockAddr MultiDatagramIO::getSenderSockAddr(int index) const {
+    return HifiSockAddr(reinterpret_cast<const sockaddr*>(&_headers->addresses[index]));
+}
+
+int MultiDatagramIO::send(qintptr socketDescriptor, const std::vector<Datagram>& datagrams,
+                          const HifiSockAddr& destination) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(destination.getAddress().toIPv4Address());
+    address.sin_port = htons(destination.getPort());
+
+    mmsghdr messages[MAX_SEND_BATCH_SIZE];
+    iovec iovecs[MAX_SEND_BATCH_SIZE];
+
+    int numSent = 0;
+    int numDatagrams = (int)datagrams.size();
+
+    while (numSent < numDatagrams) {
+        int batchSize = std::min(MAX_SEND_BATCH_SIZE, numDatagrams - numSent);
+
+        for (int i = 0; i < batchSize; ++i) {
+            const auto& datagram = datagrams[numSent + i];
+            iovecs[i].iov_base = const_cast<char*>(datagram.data);
+            iovecs[i].iov_len = datagram.size;
+
+            memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &address;
+            messages[i].msg_hdr.msg_namelen = sizeof(address);
+        }
+
+        int batchSent = sendmmsg((int)socketDescriptor, messages, batchSize, 0);
+        if (batchSent <= 0) {
+            break;
+        }
+
+        numSent += batchSent;
+
+        if (batchSent < batchSize) {
+            // the socket couldn't take the whole batch, let the caller deal with the rest
+            break;
+        }
+    }
+
+    return numSent > 0 ? numSent : -1;
+}
+
+#else
+
+struct MultiDatagramIO::Headers {};
+
+bool MultiDatagramIO::isSupported() {
+    return false;
+}
+
+MultiDatagramIO::MultiDatagramIO(int batchSize) :
+    _batchSize(batchSize)
+{
+}
+
+MultiDatagramIO::~MultiDatagramIO() {
+}
+
+int MultiDatagramIO::receive(qintptr socketDescriptor) {
+    return -1;
+}
+
+HifiSockAddr MultiDatagramIO::getSenderSockAddr(int index) const {
+    return HifiSockAddr();
+}
+
+int MultiDatagramIO::send(qintptr socketDescriptor, const std::vector<Datagram>& datagrams,
+                          const HifiSockAddr& destination) {
+    return -1;
+}
+
+#endif
+
+const char* MultiDatagramIO::getData(int index) const {
+    return &_buffers[index * RECEIVE_BUFFER_SIZE];
+}
+
+int MultiDatagramIO::getSize(int index) const {
+    return _sizes[index];
+}
@@ -0,0 +1,66 @@
+//
+//  MultiDatagramIO.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_MultiDatagramIO_h
+#define hifi_MultiDatagramIO_h
+
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// Reads and writes batches of datagrams with one system call per batch (recvmmsg/sendmmsg).
+// This is only available on Linux - elsewhere isSupported() is false and receive()/send() return -1,
+// so the caller keeps reading and writing one datagram at a time.
+class MultiDatagramIO {
+public:
+    struct Datagram {
+        const char* data;
+        qint64 size;
+    };
+
+    static const int DEFAULT_BATCH_SIZE = 64;
+
+    static bool isSupported();
+
+    MultiDatagramIO(int batchSize = DEFAULT_BATCH_SIZE);
+    ~MultiDatagramIO();
+
+    // reads the datagrams waiting on the socket, up to the batch size, without blocking
+    // returns the number of datagrams read (0 if there were none) or -1 on error
+    // the buffers are re-used, so the datagrams are only valid until the next call
+    int receive(qintptr socketDescriptor);
+
+    const char* getData(int index) const;
+    int getSize(int index) const;
+    HifiSockAddr getSenderSockAddr(int index) const;
+
+    // sends datagrams to a single destination, this is safe to call from any thread
+    // returns the number of datagrams that were sent, or -1 if none could be
+    static int send(qintptr socketDescriptor, const std::vector<Datagram>& datagrams, const HifiSockAddr& destination);
+
+private:
+    int _batchSize;
+    std::vector<char> _buffers;
+    std::vector<int> _sizes;
+
+    // platform specific headers (mmsghdr, iovec and sockaddr) re-used between calls to receive
+    struct Headers;
+    Headers* _headers { nullptr };
+};
+
+}
+
+#endif // hifi_MultiDatagramIO_h
@@ -56,7 +56,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
         case PacketType::KillAvatar:
-            return static_cast<PacketVersion>(AvatarMixerPacketVersion::AvatarIdentitySequenceId);
+            return static_cast<PacketVersion>(AvatarMixerPacketVersion::QuantizedJointData);
         case PacketType::MessagesData:
             return static_cast<PacketVersion>(MessageDataVersion::TextOrBinaryData);
         case PacketType::ICEServerHeartbeat:
@@ -105,6 +105,15 @@ QDebug operator<<(QDebug debug, const PacketType& type) {
     return debug.space();
 }
 
+PacketVerificationMethod packetVerificationMethod() {
+    static const PacketVerificationMethod method = [] {
+        static const char* VERIFICATION_ENV_VARIABLE = "HIFI_PACKET_VERIFICATION";
+        QByteArray requestedMethod = qgetenv(VERIFICATION_ENV_VARIABLE).toLower();
+        return requestedMethod == "md5" ? PacketVerificationMethod::MD5 : PacketVerificationMethod::SipHash;
+    }();
+    return method;
+}
+
 #if (PR_BUILD || DEV_BUILD)
 static bool sendWrongProtocolVersion = false;
 void sendWrongProtocolVersionsSignature(bool sendWrongVersion) {
@@ -125,6 +134,10 @@ static void ensureProtocolVersionsSignature() {
             uint8_t packetTypeVersion = static_cast<uint8_t>(versionForPacketType(static_cast<PacketType>(packetType)));
             stream << packetTypeVersion;
         }
+        // the legacy method adds nothing so that it still matches builds that predate the choice
+        if (packetVerificationMethod() != PacketVerificationMethod::MD5) {
+            stream << static_cast<uint8_t>(packetVerificationMethod());
+        }
         QCryptographicHash hash(QCryptographicHash::Md5);
         hash.addData(buffer);
         protocolVersionSignature = hash.result();
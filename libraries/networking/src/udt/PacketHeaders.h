@@ -122,12 +122,20 @@ using PacketType = PacketTypeEnum::Value;
 
 const int NUM_BYTES_MD5_HASH = 16;
 
+// How sourced packets are authenticated with the connection secret. Both fill the NUM_BYTES_MD5_HASH field in the
+// NLPacket header. The method is folded into the protocol signature, so nodes that disagree are denied on connect.
+enum class PacketVerificationMethod : uint8_t {
+    MD5 = 0, // legacy MD5 over payload + secret, keeps the signature of older builds
+    SipHash // SipHash-2-4-128 over the payload, keyed with the secret
+};
+
 typedef char PacketVersion;
 
 extern const QSet<PacketType> NON_VERIFIED_PACKETS;
 extern const QSet<PacketType> NON_SOURCED_PACKETS;
 
 PacketVersion versionForPacketType(PacketType packetType);
+PacketVerificationMethod packetVerificationMethod(); /// HIFI_PACKET_VERIFICATION=md5 selects the legacy method
 QByteArray protocolVersionsSignature(); /// returns a unqiue signature for all the current protocols
 QString protocolVersionsSignatureBase64();
 
@@ -236,7 +244,8 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     AvatarAsChildFixes,
     StickAndBallDefaultAvatar,
     IdentityPacketsIncludeUpdateTime,
-    AvatarIdentitySequenceId
+    AvatarIdentitySequenceId,
+    QuantizedJointData
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
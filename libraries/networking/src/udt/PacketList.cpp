@@ -158,6 +158,45 @@ void PacketList::preparePackets(MessageNumber messageNumber) {
     }
 }
 
+void PacketList::setStreamSource(StreamSource streamSource) {
+    Q_ASSERT_X(_isReliable && _isOrdered, "PacketList::setStreamSource", "Only reliable ordered PacketLists can be streamed");
+    _streamSource = streamSource;
+    _isStreamed = true;
+}
+
+bool PacketList::takeStreamedPackets(std::list<PacketPointer>& packets) {
+    // enough packets per pull to keep the flow window fed without holding much of the message in memory
+    static const size_t PACKETS_PER_STREAM_PULL = 32;
+
+    // while the source still has data one complete packet is held back, so that the last packet can be marked as such
+    while (_streamSource && _packets.size() <= PACKETS_PER_STREAM_PULL) {
+        if (!_streamSource(*this)) {
+            _streamSource = nullptr;
+            closeCurrentPacket(_nextStreamedPartNumber == 0);
+        }
+    }
+
+    bool isFinished = !_streamSource;
+    auto end = isFinished ? _packets.end() : std::prev(_packets.end());
+
+    for (auto it = _packets.begin(); it != end; ++it) {
+        bool isFirst = _nextStreamedPartNumber == 0;
+        bool isLast = isFinished && std::next(it) == end;
+
+        Packet::PacketPosition position = isFirst ? (isLast ? Packet::PacketPosition::ONLY : Packet::PacketPosition::FIRST)
+                                                  : (isLast ? Packet::PacketPosition::LAST : Packet::PacketPosition::MIDDLE);
+        (*it)->writeMessageNumber(_messageNumber, position, _nextStreamedPartNumber++);
+
+        if (_streamedPacketHeaderWriter) {
+            _streamedPacketHeaderWriter(**it);
+        }
+    }
+
+    packets.splice(packets.end(), _packets, _packets.begin(), end);
+
+    return !isFinished;
+}
+
 const qint64 PACKET_LIST_WRITE_ERROR = -1;
 
 qint64 PacketList::writeString(const QString& string) {
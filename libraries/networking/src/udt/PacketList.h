@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include <QtCore/QIODevice>
@@ -53,6 +54,14 @@ public:
     
     void closeCurrentPacket(bool shouldSendEmpty = false);
 
+    // A streamed list does not hold its whole message. Whatever was written before sending goes first, then the
+    // source is called from the send queue as it drains the list, to write the next part of the message.
+    // The source returns false once the message is complete, or to end it early when it can't produce the rest
+    // (the receiver then sees a message shorter than it expected). Only reliable ordered lists can be streamed.
+    using StreamSource = std::function<bool(PacketList& packetList)>;
+    void setStreamSource(StreamSource streamSource);
+    bool isStreamed() const { return _isStreamed; }
+
     // QIODevice virtual functions
     virtual bool isSequential() const override { return false; }
     virtual qint64 size() const override { return getDataSize(); }
@@ -87,6 +96,10 @@ private:
     // Takes the first packet of the list and returns it.
     template<typename T> std::unique_ptr<T> takeFront();
     
+    // Moves the next packets of a streamed message to the end of packets, pulling from the source as needed.
+    // Returns false once the last packet of the message has been moved.
+    bool takeStreamedPackets(std::list<PacketPointer>& packets);
+
     // Creates a new packet, can be overriden to change return underlying type
     virtual std::unique_ptr<Packet> createPacket();
     std::unique_ptr<Packet> createPacketWithExtendedHeader();
@@ -98,6 +111,11 @@ private:
     std::unique_ptr<Packet> _currentPacket;
     
     int _segmentStartIndex = -1;
+
+    StreamSource _streamSource;
+    std::function<void(Packet&)> _streamedPacketHeaderWriter; // lets the layer above finish headers as packets are pulled
+    Packet::MessagePartNumber _nextStreamedPartNumber { 0 };
+    bool _isStreamed { false };
     
     QByteArray _extendedHeader;
 };
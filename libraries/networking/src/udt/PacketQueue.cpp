@@ -16,7 +16,7 @@
 using namespace udt;
 
 PacketQueue::PacketQueue() {
-    _channels.emplace_back(new std::list<PacketPointer>());
+    _channels.emplace_back(new Channel());
 }
 
 MessageNumber PacketQueue::getNextMessageNumber() {
@@ -28,29 +28,49 @@ MessageNumber PacketQueue::getNextMessageNumber() {
 bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
     // Only the main channel and it is empty
-    return (_channels.size() == 1) && _channels.front()->empty();
+    return (_channels.size() == 1) && isChannelEmpty(*_channels.front());
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
-    LockGuard locker(_packetsLock);
+    std::unique_lock<Mutex> locker(_packetsLock);
     if (isEmpty()) {
         return PacketPointer();
     }
 
     // Find next non empty channel
-    if (_channels[nextIndex()]->empty()) {
+    if (isChannelEmpty(*_channels[nextIndex()])) {
         nextIndex();
     }
-    auto& channel = _channels[_currentIndex];
-    Q_ASSERT(!channel->empty());
+    auto& channel = *_channels[_currentIndex];
+    Q_ASSERT(!isChannelEmpty(channel));
+
+    // Streamed lists only produce their next packets once the previous ones have been taken.
+    // Producing them can read from disk, so it's done without holding up the threads queueing packets
+    // (the channel stays put meanwhile, only takePacket takes from or removes channels)
+    if (channel.packets.empty()) {
+        std::list<PacketPointer> streamedPackets;
+        auto stream = channel.stream.get();
+
+        locker.unlock();
+        bool hasMorePackets = stream->takeStreamedPackets(streamedPackets);
+        locker.lock();
+
+        channel.packets.splice(channel.packets.end(), streamedPackets);
+        if (!hasMorePackets) {
+            channel.stream.reset();
+        }
+    }
 
-    // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+    PacketPointer packet;
+    if (!channel.packets.empty()) {
+        // Take front packet
+        packet = std::move(channel.packets.front());
+        channel.packets.pop_front();
+    }
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentIndex != 0) {
-        channel->swap(*_channels.back());
+    if (isChannelEmpty(channel) && _currentIndex != 0) {
+        std::swap(_channels[_currentIndex], _channels.back());
         _channels.pop_back();
         --_currentIndex;
     }
@@ -65,15 +85,24 @@ unsigned int PacketQueue::nextIndex() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _channels.front()->packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
+    if (packetList->isStreamed()) {
+        // the list keeps its packets and hands them out as the channel drains, see takePacket
+        LockGuard locker(_packetsLock);
+        packetList->_messageNumber = getNextMessageNumber();
+        _channels.emplace_back(new Channel());
+        _channels.back()->stream = std::move(packetList);
+        return;
+    }
+
     if (packetList->isOrdered()) {
         packetList->preparePackets(getNextMessageNumber());
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _channels.emplace_back(new Channel());
+    _channels.back()->packets.swap(packetList->_packets);
 }
@@ -30,8 +30,12 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using Channel = std::unique_ptr<std::list<PacketPointer>>;
-    using Channels = std::vector<Channel>;
+    struct Channel {
+        std::list<PacketPointer> packets;
+        PacketListPointer stream; // set while a streamed packet list still has packets to produce
+    };
+    using ChannelPointer = std::unique_ptr<Channel>;
+    using Channels = std::vector<ChannelPointer>;
     
 public:
     PacketQueue();
@@ -46,6 +50,7 @@ public:
 private:
     MessageNumber getNextMessageNumber();
     unsigned int nextIndex();
+    static bool isChannelEmpty(const Channel& channel) { return channel.packets.empty() && !channel.stream; }
     
     MessageNumber _currentMessageNumber { 0 };
     
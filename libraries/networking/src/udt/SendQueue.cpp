@@ -13,12 +13,10 @@
 
 #include <algorithm>
 #include <random>
-#include <thread>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
-#include <QtCore/QThread>
 
 #include <LogHandler.h>
 #include <NumericalConstants.h>
@@ -67,25 +65,15 @@ std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destin
     
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination));
 
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // queues share the scheduler's threads rather than each having their own
+    queue->_scheduler.add(queue.get());
     
     return queue;
 }
     
 SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
     _socket(socket),
+    _scheduler(socket->getSendQueueScheduler()),
     _destination(dest)
 {
     // setup psuedo-random number generation for all instances of SendQueue
@@ -106,37 +94,37 @@ SendQueue::SendQueue(Socket* socket, HifiSockAddr dest) :
 }
 
 SendQueue::~SendQueue() {
+    // make sure no scheduler thread is still running us
+    _scheduler.remove(this);
+}
+
+void SendQueue::wake() {
+    // once woken, the queue is run again before any other wake has to go through the scheduler
+    if (!_wasWoken.exchange(true)) {
+        _scheduler.wake(this);
+    }
 }
 
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
     _packets.queuePacket(std::move(packet));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
     _packets.queuePacketList(std::move(packetList));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!this->thread()->isRunning() && _state == State::NotStarted) {
-        this->thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wake();
 }
 
 void SendQueue::stop() {
     
     _state = State::Stopped;
     
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
+    // wake the queue so the scheduler drops it
+    wake();
 }
     
 int SendQueue::sendPacket(const Packet& packet) {
@@ -154,9 +142,7 @@ void SendQueue::ack(SequenceNumber ack) {
     {
         // remove any ACKed packets from the map of sent packets
         QWriteLocker locker(&_sentLock);
-        for (auto seq = SequenceNumber { (uint32_t) _lastACKSequenceNumber }; seq <= ack; ++seq) {
-            _sentPackets.erase(seq);
-        }
+        _sentPackets.acknowledge(ack);
     }
     
     {   // remove any sequence numbers equal to or lower than this ACK in the loss list
@@ -169,8 +155,8 @@ void SendQueue::ack(SequenceNumber ack) {
     
     _lastACKSequenceNumber = (uint32_t) ack;
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping with a full congestion window
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting with a full congestion window
+    wake();
 }
 
 void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
@@ -182,8 +168,8 @@ void SendQueue::nak(SequenceNumber start, SequenceNumber end) {
         _naks.insert(start, end);
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
@@ -192,8 +178,8 @@ void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
         _naks.insert(ack, ack);
     }
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
@@ -217,12 +203,11 @@ void SendQueue::overrideNAKListFromPacket(ControlPacket& packet) {
         }
     }
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wake();
 }
 
 void SendQueue::sendHandshake() {
-    std::unique_lock<std::mutex> handshakeLock { _handshakeMutex };
     if (!_hasReceivedHandshakeACK) {
         // we haven't received a handshake ACK from the client, send another now
         auto handshakePacket = ControlPacket::create(ControlPacket::Handshake, sizeof(SequenceNumber));
@@ -231,18 +216,16 @@ void SendQueue::sendHandshake() {
         
         // we wait for the ACK or the re-send interval to expire
         static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
+        _nextHandshakeTimestamp = p_high_resolution_clock::now() + HANDSHAKE_RESEND_INTERVAL;
     }
 }
 
 void SendQueue::handshakeACK(SequenceNumber initialSequenceNumber) {
     if (initialSequenceNumber == _initialSequenceNumber) {
-        {
-            std::lock_guard<std::mutex> locker { _handshakeMutex };
-            _hasReceivedHandshakeACK = true;
-        }
-        // Notify on the handshake ACK condition
-        _handshakeACKCondition.notify_one();
+        _hasReceivedHandshakeACK = true;
+
+        // wake the queue so it starts sending right away
+        wake();
     }
 }
 
@@ -266,11 +249,8 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     {
         // Insert the packet we have just sent in the sent list
         QWriteLocker locker(&_sentLock);
-        auto& entry = _sentPackets[newPacket->getSequenceNumber()];
-        entry.first = 0; // No resend
-        entry.second.swap(newPacket);
+        _sentPackets.push(sequenceNumber, std::move(newPacket));
     }
-    Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
 
     if (bytesWritten < 0) {
         // this is a short-circuit loss - we failed to put this packet on the wire
@@ -289,113 +269,120 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     }
 }
 
-void SendQueue::run() {
-    if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run after being told to stop. Will not run.";
-#endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+p_high_resolution_clock::time_point SendQueue::run() {
+    // only a queue that hasn't started yet starts running, stop() can come in at any time
+    State state = State::NotStarted;
+    if (!_state.compare_exchange_strong(state, State::Running) && state == State::Stopped) {
+        // we've been asked to stop, the scheduler will drop us
+        return p_high_resolution_clock::now();
     }
-    
-    _state = State::Running;
+
+    // any work that comes in from here on wakes us again
+    bool wasWoken = _wasWoken.exchange(false);
+
+    auto now = p_high_resolution_clock::now();
     
     // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
+    if (!_hasReceivedHandshakeACK) {
+        if (now >= _nextHandshakeTimestamp) {
+            sendHandshake();
+        }
 
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
+        // we'll be woken if the handshake ACK comes in, otherwise it's time to re-send a handshake.
+        // Either way no packets will be sent until a handshake ACK has been received.
+        return _nextHandshakeTimestamp;
     }
 
-    // Keep an HRC to know when the next packet should have been
-    auto nextPacketTimestamp = p_high_resolution_clock::now();
+    if (!_hasStartedSending) {
+        _hasStartedSending = true;
 
-    while (_state == State::Running) {
-        bool attemptedToSendPacket = maybeResendPacket();
-        
-        // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
-        // (this is according to the current flow window size) then we send out a new packet
-        auto newPacketCount = 0;
-        if (!attemptedToSendPacket) {
-            newPacketCount = maybeSendNewPacket();
-            attemptedToSendPacket = (newPacketCount > 0);
-        }
-        
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(attemptedToSendPacket)) {
-            return;
-        }
+        // Keep an HRC to know when the next packet should have been
+        _nextPacketTimestamp = now;
+    }
 
-        if (_packetSendPeriod > 0) {
-            // push the next packet timestamp forwards by the current packet send period
-            auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
-            nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
+    if (wasWoken) {
+        // new work came in, anything we were waiting for starts over
+        _waitReason = WaitReason::None;
+    }
 
-            // sleep as long as we need for next packet send, if we can
-            auto now = p_high_resolution_clock::now();
+    if (_nextPacketTimestamp > now) {
+        // we were woken up before it was time for the next packet
+        return _nextPacketTimestamp;
+    }
+
+    bool attemptedToSendPacket = maybeResendPacket();
+    
+    // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
+    // (this is according to the current flow window size) then we send out a new packet
+    auto newPacketCount = 0;
+    if (!attemptedToSendPacket) {
+        newPacketCount = maybeSendNewPacket();
+        attemptedToSendPacket = (newPacketCount > 0);
+    }
+    
+    // check now if we were just told to stop, or if the send queue has been inactive
+    if (_state != State::Running || isInactive(attemptedToSendPacket)) {
+        return p_high_resolution_clock::now();
+    }
 
-            auto timeToSleep = duration_cast<microseconds>(nextPacketTimestamp - now);
+    if (_waitReason != WaitReason::None) {
+        // nothing to send, wait for new work or for the wait to expire
+        return _waitExpiry;
+    }
 
-            // we use nextPacketTimestamp so that we don't fall behind, not to force long sleeps
-            // we'll never allow nextPacketTimestamp to force us to sleep for more than nextPacketDelta
-            // so cap it to that value
-            if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
-                // reset the nextPacketTimestamp so that it is correct next time we come around
-                nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+    now = p_high_resolution_clock::now();
 
-                timeToSleep = std::chrono::microseconds(nextPacketDelta);
-            }
+    if (_packetSendPeriod > 0) {
+        // push the next packet timestamp forwards by the current packet send period
+        auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
+        _nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
 
-            // we're seeing SendQueues sleep for a long period of time here,
-            // which can lock the NodeList if it's attempting to clear connections
-            // for now we guard this by capping the time this thread and sleep for
-
-            const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
-            if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
-                qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
-                qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
-                qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
-                << "NPT:" << nextPacketTimestamp.time_since_epoch().count()
-                << "NOW:" << now.time_since_epoch().count();
-
-                // alright, we're in a weird state
-                // we want to know why this is happening so we can implement a better fix than this guard
-                // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
-                static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
-
-                // setup a json object with the details we want
-                QJsonObject longSleepObject;
-                longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
-                longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
-                longSleepObject["nextPacketDelta"] = nextPacketDelta;
-                longSleepObject["nextPacketTimestamp"] = qint64(nextPacketTimestamp.time_since_epoch().count());
-                longSleepObject["then"] = qint64(now.time_since_epoch().count());
-
-                // hopefully send this event using the user activity logger
-                UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
-                
-                timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
-            }
+        auto timeToSleep = duration_cast<microseconds>(_nextPacketTimestamp - now);
+
+        // we use nextPacketTimestamp so that we don't fall behind, not to force long sleeps
+        // we'll never allow nextPacketTimestamp to force us to sleep for more than nextPacketDelta
+        // so cap it to that value
+        if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
+            // reset the nextPacketTimestamp so that it is correct next time we come around
+            _nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+
+            timeToSleep = std::chrono::microseconds(nextPacketDelta);
+        }
+
+        // we've seen SendQueues want to sleep for a long period of time here,
+        // for now we guard this by capping the time until the next packet
+
+        const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
+        if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
+            qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
+            qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
+            qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
+            << "NPT:" << _nextPacketTimestamp.time_since_epoch().count()
+            << "NOW:" << now.time_since_epoch().count();
+
+            // alright, we're in a weird state
+            // we want to know why this is happening so we can implement a better fix than this guard
+            // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
+            static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
+
+            // setup a json object with the details we want
+            QJsonObject longSleepObject;
+            longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
+            longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
+            longSleepObject["nextPacketDelta"] = nextPacketDelta;
+            longSleepObject["nextPacketTimestamp"] = qint64(_nextPacketTimestamp.time_since_epoch().count());
+            longSleepObject["then"] = qint64(now.time_since_epoch().count());
+
+            // hopefully send this event using the user activity logger
+            UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
             
-            std::this_thread::sleep_for(timeToSleep);
+            _nextPacketTimestamp = now + MAX_SEND_QUEUE_SLEEP_USECS;
         }
+
+        return _nextPacketTimestamp;
     }
+
+    return now;
 }
 
 void SendQueue::setProbePacketEnabled(bool enabled) {
@@ -467,19 +454,18 @@ bool SendQueue::maybeResendPacket() {
             QReadLocker sentLocker(&_sentLock);
             
             // see if we can find the packet to re-send
-            auto it = _sentPackets.find(resendNumber);
+            auto entry = _sentPackets.find(resendNumber);
 
-            if (it != _sentPackets.end()) {
+            if (entry && entry->packet) {
 
-                auto& entry = it->second;
                 // we found the packet - grab it
-                auto& resendPacket = *(entry.second);
-                ++entry.first; // Add 1 resend
+                auto& resendPacket = *(entry->packet);
+                ++entry->resendCount; // Add 1 resend
 
-                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry.first < 2 ? 0 : (entry.first - 2) % 4);
+                Packet::ObfuscationLevel level = (Packet::ObfuscationLevel)(entry->resendCount < 2 ? 0 : (entry->resendCount - 2) % 4);
 
                 auto wireSize = resendPacket.getWireSize();
-                auto sequenceNumber = it->first;
+                auto sequenceNumber = resendNumber;
 
                 if (level != Packet::NoObfuscation) {
 #ifdef UDT_CONNECTION_DEBUG
@@ -562,7 +548,7 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
     if (!attemptedToSendPacket) {
         // During our processing above we didn't send any packets
         
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
+        // If that is still the case we should wait until we have data to handle.
         // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
         using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
         DoubleLock doubleLock(_packets.getLock(), _naksLock);
@@ -570,16 +556,17 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
         
         if (locker.owns_lock() && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
             // The packets queue and loss list mutexes are now both locked and they're both empty
+            auto now = p_high_resolution_clock::now();
             
             if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
                 // we've sent the client as much data as we have (and they've ACKed it)
                 // either wait for new data to send or 5 seconds before cleaning up the queue
                 static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
                 
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+                if (_waitReason != WaitReason::Empty) {
+                    _waitReason = WaitReason::Empty;
+                    _waitExpiry = now + EMPTY_QUEUES_INACTIVE_TIMEOUT;
+                } else if (now >= _waitExpiry) {
 #ifdef UDT_CONNECTION_DEBUG
                     qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
                         << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
@@ -587,7 +574,7 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
                         << "The queue is now inactive and will be stopped.";
 #endif
 
-                    // we have the lock again - Make sure to unlock it
+                    // we still have the lock - Make sure to unlock it
                     locker.unlock();
                     
                     // Deactivate queue
@@ -599,27 +586,33 @@ bool SendQueue::isInactive(bool attemptedToSendPacket) {
                 // We think the client is still waiting for data (based on the sequence number gap)
                 // Let's wait either for a response from the client or until the estimated timeout
                 // (plus the sync interval to allow the client to respond) has elapsed
-                auto waitDuration = std::chrono::microseconds(_estimatedTimeout + _syncInterval);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, waitDuration);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()
-                    && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                    // after a timeout if we still have sent packets that the client hasn't ACKed we
-                    // add them to the loss list
-                    
-                    // Note that thanks to the DoubleLock we have the _naksLock right now
-                    _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+                if (_waitReason != WaitReason::Unacknowledged) {
+                    _waitReason = WaitReason::Unacknowledged;
+                    _waitExpiry = now + std::chrono::microseconds(_estimatedTimeout + _syncInterval);
+                } else if (now >= _waitExpiry) {
+                    _waitReason = WaitReason::None;
 
-                    // we have the lock again - time to unlock it
-                    locker.unlock();
-                    
-                    emit timeout();
+                    if (SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+                        // after a timeout if we still have sent packets that the client hasn't ACKed we
+                        // add them to the loss list
+
+                        // Note that thanks to the DoubleLock we have the _naksLock right now
+                        _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+
+                        // time to unlock
+                        locker.unlock();
+
+                        emit timeout();
+                    }
                 }
             }
+
+            return false;
         }
     }
+
+    // there is something to send, stop waiting
+    _waitReason = WaitReason::None;
     
     return false;
 }
@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -31,6 +30,8 @@
 #include "PacketQueue.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
+#include "SentPacketBuffer.h"
+#include "SendQueueScheduler.h"
 
 namespace udt {
     
@@ -40,7 +41,7 @@ class Packet;
 class PacketList;
 class Socket;
     
-class SendQueue : public QObject {
+class SendQueue : public QObject, public SendQueueScheduler::Task {
     Q_OBJECT
     
 public:
@@ -52,7 +53,10 @@ public:
     
     static std::unique_ptr<SendQueue> create(Socket* socket, HifiSockAddr destination);
 
+    // blocks until the socket's SendQueueScheduler is done running this queue
     virtual ~SendQueue();
+
+    State getState() const { return _state; }
     
     void queuePacket(std::unique_ptr<Packet> packet);
     void queuePacketList(std::unique_ptr<PacketList> packetList);
@@ -87,14 +91,19 @@ signals:
     void shortCircuitLoss(quint32 sequenceNumber);
     void timeout();
     
-private slots:
-    void run();
-    
 private:
     SendQueue(Socket* socket, HifiSockAddr dest);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
+    // sends whatever can be sent right now, called by the SendQueueScheduler
+    // returns the time this should be called again at, unless the queue is woken before that
+    virtual p_high_resolution_clock::time_point run() override;
+    virtual bool isStopped() const override { return _state == State::Stopped; }
+
+    // has the SendQueueScheduler run this queue as soon as possible
+    void wake();
+
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
@@ -103,7 +112,7 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    bool isInactive(bool attemptedToSendPacket); // also starts or expires the wait for new work
     void deactivate(); // makes the queue inactive and cleans it up
 
     bool isFlowWindowFull() const;
@@ -114,6 +123,7 @@ private:
     PacketQueue _packets;
     
     Socket* _socket { nullptr }; // Socket to send packet on
+    SendQueueScheduler& _scheduler; // the socket's scheduler, which runs this queue
     HifiSockAddr _destination; // Destination addr
 
     SequenceNumber _initialSequenceNumber; // Randomized on SendQueue creation, identifies connection during re-connect requests
@@ -136,14 +146,24 @@ private:
     LossList _naks; // Sequence numbers of packets to resend
     
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
-    using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
-    std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
+    SentPacketBuffer _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
+
+    // the following are only used from run(), which is never called concurrently
+    bool _hasStartedSending { false }; // set once the handshake ACK is in and packets can go out
+    p_high_resolution_clock::time_point _nextHandshakeTimestamp; // time to re-send the handshake at
+    p_high_resolution_clock::time_point _nextPacketTimestamp; // time the next packet should be sent at
+
+    // when the queue has nothing to send it waits for new work, or until the wait expires
+    enum class WaitReason {
+        None,
+        Empty, // all sent packets are ACKed, the queue goes inactive once the wait expires
+        Unacknowledged // sent packets aren't ACKed yet, they are considered lost once the wait expires
+    };
+    WaitReason _waitReason { WaitReason::None };
+    p_high_resolution_clock::time_point _waitExpiry;
+    std::atomic<bool> _wasWoken { false }; // new work came in since the last run, restarts any wait
 
 
     std::atomic<bool> _shouldSendProbes { true };
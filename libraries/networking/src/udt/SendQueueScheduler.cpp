@@ -0,0 +1,176 @@
+//
+//  SendQueueScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueScheduler.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+// sending is mostly time spent sleeping between paced packets, so a few threads go a long way
+static const unsigned int MAX_SCHEDULER_THREADS = 4;
+
+// how long a thread keeps running a queue that is pacing packets before putting it back in the heap
+static const std::chrono::microseconds MAX_KEEP_TIME { 2000 };
+
+SendQueueScheduler::SendQueueScheduler(unsigned int numThreads) {
+    if (numThreads == DEFAULT_NUM_THREADS) {
+        // hardware_concurrency returns 0 if cores cannot be detected
+        numThreads = std::max(1u, std::min(MAX_SCHEDULER_THREADS, std::thread::hardware_concurrency() / 2));
+    }
+    _numThreads = numThreads;
+}
+
+SendQueueScheduler::~SendQueueScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _scheduleCondition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void SendQueueScheduler::add(Task* task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // sockets that never send reliable packets don't need the threads
+    if (_threads.empty()) {
+        for (unsigned int i = 0; i < _numThreads; ++i) {
+            _threads.emplace_back(&SendQueueScheduler::runThread, this);
+        }
+    }
+
+    schedule(task, _slots[task], p_high_resolution_clock::now());
+}
+
+void SendQueueScheduler::wake(Task* task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _slots.find(task);
+    if (it == _slots.end() || it->second.isRemoved) {
+        // the task has stopped
+        return;
+    }
+
+    auto& slot = it->second;
+    if (slot.isRunning) {
+        // the thread running it will re-schedule it right away
+        slot.isWoken = true;
+    } else {
+        auto now = p_high_resolution_clock::now();
+        if (slot.runTime > now) {
+            schedule(task, slot, now);
+        }
+    }
+}
+
+void SendQueueScheduler::remove(Task* task) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _slots.find(task);
+    if (it == _slots.end()) {
+        return;
+    }
+
+    // a task that is always due would otherwise be picked up again before we get the lock back,
+    // and any entry left in the heap for it is skipped once its slot is gone
+    it->second.isRemoved = true;
+    _runCondition.wait(lock, [&] {
+        auto it = _slots.find(task);
+        return it == _slots.end() || !it->second.isRunning;
+    });
+    _slots.erase(task);
+}
+
+void SendQueueScheduler::schedule(Task* task, Slot& slot, TimePoint runTime) {
+    slot.runTime = runTime;
+    slot.generation = ++_nextGeneration;
+
+    bool isEarliest = _heap.empty() || runTime < _heap.front().runTime;
+
+    _heap.push_back({ runTime, task, slot.generation });
+    std::push_heap(_heap.begin(), _heap.end(), runsLater);
+
+    if (isEarliest) {
+        _earliestRunTime = runTime.time_since_epoch().count();
+        _scheduleCondition.notify_one();
+    }
+}
+
+void SendQueueScheduler::popHeap() {
+    std::pop_heap(_heap.begin(), _heap.end(), runsLater);
+    _heap.pop_back();
+    _earliestRunTime = _heap.empty() ? TimePoint::max().time_since_epoch().count() :
+        _heap.front().runTime.time_since_epoch().count();
+}
+
+void SendQueueScheduler::runThread() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_isStopping) {
+        if (_heap.empty()) {
+            _scheduleCondition.wait(lock);
+            continue;
+        }
+
+        Entry next = _heap.front();
+
+        auto it = _slots.find(next.task);
+        if (it == _slots.end() || it->second.isRemoved || it->second.generation != next.generation) {
+            // stale entry, the task was removed or re-scheduled
+            popHeap();
+            continue;
+        }
+
+        if (next.runTime > p_high_resolution_clock::now()) {
+            _scheduleCondition.wait_until(lock, next.runTime);
+            continue;
+        }
+
+        popHeap();
+
+        it->second.isRunning = true;
+        it->second.isWoken = false;
+
+        lock.unlock();
+
+        auto runTime = next.task->run();
+        bool isStopped = next.task->isStopped();
+
+        // keep running a task that is due again shortly, as long as no other task is due before it
+        // (a task woken meanwhile is run at its next time anyway, which is no later than what keeping it allows)
+        auto keepUntil = p_high_resolution_clock::now() + MAX_KEEP_TIME;
+        while (!isStopped && !_isStopping && runTime <= keepUntil &&
+               runTime.time_since_epoch().count() <= _earliestRunTime) {
+            std::this_thread::sleep_until(runTime);
+            runTime = next.task->run();
+            isStopped = next.task->isStopped();
+        }
+
+        lock.lock();
+
+        // the slot may have been re-hashed while we were running the task, look it up again
+        auto& slot = _slots[next.task];
+        slot.isRunning = false;
+
+        if (slot.isRemoved) {
+            // remove() erases it
+        } else if (isStopped) {
+            _slots.erase(next.task);
+        } else {
+            schedule(next.task, slot, slot.isWoken ? p_high_resolution_clock::now() : runTime);
+        }
+
+        _runCondition.notify_all();
+    }
+}
@@ -0,0 +1,105 @@
+//
+//  SendQueueScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueScheduler_h
+#define hifi_SendQueueScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+// Runs the SendQueues of a Socket on a small fixed pool of threads, started with the first queue.
+// Each queue is kept in a heap ordered by the time it next wants to run (its next paced packet send,
+// handshake re-send or idle timeout), and is woken early whenever it gets new work (packets, ACKs, NAKs).
+// A queue is only ever run by one thread at a time. A thread keeps a queue that is pacing packets for a
+// short while, as long as no other queue is due first, so that pacing doesn't go through the heap for every packet.
+class SendQueueScheduler {
+public:
+    using TimePoint = p_high_resolution_clock::time_point;
+
+    // what the scheduler runs, a SendQueue
+    class Task {
+    public:
+        virtual ~Task() {}
+
+        // does the work that is due, returns the time to be run again at unless woken before then
+        virtual TimePoint run() = 0;
+
+        // a stopped task is dropped by the scheduler once it returns from run()
+        virtual bool isStopped() const = 0;
+    };
+
+    static const unsigned int DEFAULT_NUM_THREADS = 0; // half the cores, at most four
+
+    SendQueueScheduler(unsigned int numThreads = DEFAULT_NUM_THREADS);
+    ~SendQueueScheduler();
+
+    int getNumThreads() const { return (int)_threads.size(); }
+
+    // starts running the task right away
+    void add(Task* task);
+
+    // runs the task as soon as a thread is free, instead of at the time it last asked for
+    void wake(Task* task);
+
+    // stops running the task, blocks until no thread is running it so that it can be deleted
+    void remove(Task* task);
+
+private:
+    SendQueueScheduler(const SendQueueScheduler&) = delete;
+    SendQueueScheduler& operator=(const SendQueueScheduler&) = delete;
+
+    struct Slot {
+        TimePoint runTime;
+        uint64_t generation { 0 };
+        bool isRunning { false };
+        bool isWoken { false };
+        bool isRemoved { false }; // not run again, kept until the run in progress is done
+    };
+
+    // heap entries are invalidated by bumping the generation of their slot, rather than being removed
+    struct Entry {
+        TimePoint runTime;
+        Task* task;
+        uint64_t generation;
+    };
+    static bool runsLater(const Entry& lhs, const Entry& rhs) { return lhs.runTime > rhs.runTime; }
+
+    void schedule(Task* task, Slot& slot, TimePoint runTime);
+    void popHeap();
+    void runThread();
+
+    unsigned int _numThreads;
+
+    std::mutex _mutex;
+    std::condition_variable _scheduleCondition; // signaled when the heap gets an earlier entry
+    std::condition_variable _runCondition; // signaled when a thread is done running a task
+    std::unordered_map<Task*, Slot> _slots;
+    std::vector<Entry> _heap;
+    uint64_t _nextGeneration { 0 };
+    std::atomic<bool> _isStopping { false };
+
+    // the run time at the top of the heap, read without the lock by threads keeping a task
+    std::atomic<TimePoint::rep> _earliestRunTime { TimePoint::max().time_since_epoch().count() };
+
+    std::vector<std::thread> _threads;
+};
+
+}
+
+#endif // hifi_SendQueueScheduler_h
@@ -0,0 +1,95 @@
+//
+//  SentPacketBuffer.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketBuffer.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+static const int MIN_SENT_PACKET_BUFFER_CAPACITY = 64;
+
+void SentPacketBuffer::push(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet) {
+    Q_ASSERT_X(isEmpty() || sequenceNumber == _firstSequenceNumber + _count, "SentPacketBuffer::push",
+               "SequenceNumber pushed does not follow the last SequenceNumber in the buffer");
+
+    if (isEmpty()) {
+        _firstSequenceNumber = sequenceNumber;
+        _head = 0;
+    }
+
+    if (_count == capacity()) {
+        grow();
+    }
+
+    auto& entry = _entries[(_head + _count) & (capacity() - 1)];
+    entry.resendCount = 0;
+    entry.packet = std::move(packet);
+    ++_count;
+}
+
+SentPacketBuffer::Entry* SentPacketBuffer::find(SequenceNumber sequenceNumber) {
+    if (isEmpty()) {
+        return nullptr;
+    }
+
+    auto offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0 || offset >= _count) {
+        return nullptr;
+    }
+
+    return &_entries[(_head + offset) & (capacity() - 1)];
+}
+
+void SentPacketBuffer::acknowledge(SequenceNumber sequenceNumber) {
+    if (isEmpty()) {
+        return;
+    }
+
+    auto offset = seqoff(_firstSequenceNumber, sequenceNumber);
+    if (offset < 0) {
+        // this was already acknowledged
+        return;
+    }
+
+    auto numAcknowledged = std::min(offset + 1, _count);
+    auto mask = capacity() - 1;
+
+    for (int i = 0; i < numAcknowledged; ++i) {
+        _entries[(_head + i) & mask].packet.reset();
+    }
+
+    _head = (_head + numAcknowledged) & mask;
+    _firstSequenceNumber += numAcknowledged;
+    _count -= numAcknowledged;
+}
+
+void SentPacketBuffer::clear() {
+    for (auto& entry : _entries) {
+        entry.packet.reset();
+    }
+    _head = 0;
+    _count = 0;
+}
+
+void SentPacketBuffer::grow() {
+    auto newCapacity = std::max(MIN_SENT_PACKET_BUFFER_CAPACITY, capacity() * 2);
+    Q_ASSERT_X(newCapacity <= SequenceNumber::MAX, "SentPacketBuffer::grow", "Too many packets waiting for an ACK");
+
+    // move the entries over in sequence order so the oldest one ends up at the front
+    std::vector<Entry> entries(newCapacity);
+    auto mask = capacity() - 1;
+    for (int i = 0; i < _count; ++i) {
+        entries[i] = std::move(_entries[(_head + i) & mask]);
+    }
+
+    _entries.swap(entries);
+    _head = 0;
+}
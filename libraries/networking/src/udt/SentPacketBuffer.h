@@ -0,0 +1,58 @@
+//
+//  SentPacketBuffer.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketBuffer_h
+#define hifi_SentPacketBuffer_h
+
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// Holds the packets a SendQueue has sent and is waiting on an ACK for.
+// Packets are sent with consecutive sequence numbers, so they are kept in a contiguous ring
+// indexed by their offset from the oldest unacknowledged sequence number instead of in a hash map.
+class SentPacketBuffer {
+public:
+    struct Entry {
+        uint8_t resendCount { 0 };
+        std::unique_ptr<Packet> packet;
+    };
+
+    // the sequence number must follow the last one added (any sequence number is accepted when empty)
+    void push(SequenceNumber sequenceNumber, std::unique_ptr<Packet> packet);
+
+    // returns nullptr if the packet has already been acknowledged or was never sent
+    Entry* find(SequenceNumber sequenceNumber);
+
+    // drops every packet up to and including the given sequence number
+    void acknowledge(SequenceNumber sequenceNumber);
+
+    void clear();
+
+    int size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+    int capacity() const { return (int)_entries.size(); }
+
+private:
+    void grow();
+
+    std::vector<Entry> _entries; // size is always zero or a power of two
+    SequenceNumber _firstSequenceNumber; // sequence number of the entry at _head
+    int _head { 0 };
+    int _count { 0 };
+};
+
+}
+
+#endif // hifi_SentPacketBuffer_h
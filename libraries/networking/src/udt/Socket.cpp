@@ -11,6 +11,9 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+#include <cstring>
+
 #ifdef Q_OS_ANDROID
 #include <sys/socket.h>
 #endif
@@ -116,6 +119,19 @@ void Socket::setSystemBufferSizes() {
     }
 }
 
+bool Socket::setBatchedIOEnabled(bool enabled) {
+    if (enabled && !MultiDatagramIO::isSupported()) {
+        return false;
+    }
+
+    if (enabled != isBatchedIOEnabled()) {
+        _multiDatagramIO.reset(enabled ? new MultiDatagramIO() : nullptr);
+        qCDebug(networking) << "Batched datagram I/O is" << (enabled ? "enabled" : "disabled");
+    }
+
+    return true;
+}
+
 qint64 Socket::writeBasePacket(const udt::BasePacket& packet, const HifiSockAddr &sockAddr) {
     // Since this is a base packet we have no way to know if this is reliable or not - we just fire it off
 
@@ -166,7 +182,7 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
         // hand this packetList off to writeReliablePacketList
         // because Qt can't invoke with the unique_ptr we have to release it here and re-construct in writeReliablePacketList
 
-        if (packetList->getNumPackets() == 0) {
+        if (packetList->getNumPackets() == 0 && !packetList->isStreamed()) {
             qCWarning(networking) << "Trying to send packet list with 0 packets, bailing.";
             return 0;
         }
@@ -186,6 +202,33 @@ qint64 Socket::writePacketList(std::unique_ptr<PacketList> packetList, const Hif
 
     // Unerliable and Unordered
     qint64 totalBytesSent = 0;
+
+    if (_multiDatagramIO && packetList->_packets.size() > 1) {
+        // hand all of the packets to the socket at once
+        std::vector<MultiDatagramIO::Datagram> datagrams;
+        datagrams.reserve(packetList->_packets.size());
+        {
+            Lock lock(_unreliableSequenceNumbersMutex);
+            auto& sequenceNumber = _unreliableSequenceNumbers[sockAddr];
+            for (auto& packet : packetList->_packets) {
+                packet->writeSequenceNumber(++sequenceNumber);
+                datagrams.push_back({ packet->getData(), packet->getDataSize() });
+            }
+        }
+
+        int numSent = MultiDatagramIO::send(_udpSocket.socketDescriptor(), datagrams, sockAddr);
+        for (int i = 0; i < numSent; ++i) {
+            totalBytesSent += datagrams[i].size;
+        }
+
+        // write whatever didn't make it one at a time, so that errors are handled as usual
+        for (int i = std::max(numSent, 0); i < (int)datagrams.size(); ++i) {
+            totalBytesSent += std::max(writeDatagram(datagrams[i].data, datagrams[i].size, sockAddr), (qint64)0);
+        }
+
+        return totalBytesSent;
+    }
+
     while (!packetList->_packets.empty()) {
         totalBytesSent += writePacket(packetList->takeFront<Packet>(), sockAddr);
     }
@@ -345,6 +388,7 @@ void Socket::readPendingDatagrams() {
         auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
 
         // pull the datagram
+        // with batched I/O the first datagram is still read through the QUdpSocket, that is what re-arms its readyRead
         auto sizeRead = _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
                                                 senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
 
@@ -352,71 +396,99 @@ void Socket::readPendingDatagrams() {
         _lastPacketSizeRead = sizeRead;
         _lastPacketSockAddr = senderSockAddr;
 
-        if (sizeRead <= 0) {
-            // we either didn't pull anything for this packet or there was an error reading (this seems to trigger
-            // on windows even if there's not a packet available)
-            continue;
+        if (sizeRead > 0) {
+            processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr, receiveTime);
         }
+        // otherwise we either didn't pull anything for this packet or there was an error reading (this seems to trigger
+        // on windows even if there's not a packet available)
+
+        if (_multiDatagramIO) {
+            // pull the rest of what is waiting in batches
+            int numReceived = 0;
+            do {
+                numReceived = _multiDatagramIO->receive(_udpSocket.socketDescriptor());
+                receiveTime = p_high_resolution_clock::now();
+
+                for (int i = 0; i < numReceived; ++i) {
+                    int size = _multiDatagramIO->getSize(i);
+                    if (size <= 0) {
+                        continue;
+                    }
 
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+                    _lastPacketSizeRead = size;
+                    _lastPacketSockAddr = _multiDatagramIO->getSenderSockAddr(i);
 
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                basePacket->setReceiveTime(receiveTime);
-                it->second(std::move(basePacket));
-            }
+                    // packets own their data, so each datagram is copied out of the re-used batch buffers
+                    auto datagramBuffer = std::unique_ptr<char[]>(new char[size]);
+                    memcpy(datagramBuffer.get(), _multiDatagramIO->getData(i), size);
 
-            continue;
+                    processDatagram(std::move(datagramBuffer), size, _lastPacketSockAddr, receiveTime);
+                }
+            } while (numReceived == MultiDatagramIO::DEFAULT_BATCH_SIZE);
         }
+    }
+}
 
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+void Socket::processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr,
+                             p_high_resolution_clock::time_point receiveTime) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
 
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            controlPacket->setReceiveTime(receiveTime);
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            basePacket->setReceiveTime(receiveTime);
+            it->second(std::move(basePacket));
+        }
 
-            // move this control packet to the matching connection, if there is one
-            auto connection = findOrCreateConnection(senderSockAddr);
+        return;
+    }
 
-            if (connection) {
-                connection->processControl(move(controlPacket));
-            }
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-            packet->setReceiveTime(receiveTime);
-
-            // save the sequence number in case this is the packet that sticks readyRead
-            _lastReceivedSequenceNumber = packet->getSequenceNumber();
-
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto connection = findOrCreateConnection(senderSockAddr);
-
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
-                        continue;
-                    }
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        controlPacket->setReceiveTime(receiveTime);
+
+        // move this control packet to the matching connection, if there is one
+        auto connection = findOrCreateConnection(senderSockAddr);
+
+        if (connection) {
+            connection->processControl(move(controlPacket));
+        }
+
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        packet->setReceiveTime(receiveTime);
+
+        // save the sequence number in case this is the packet that sticks readyRead
+        _lastReceivedSequenceNumber = packet->getSequenceNumber();
+
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto connection = findOrCreateConnection(senderSockAddr);
+
+                if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                              packet->getDataSize(),
+                                                                              packet->getPayloadSize())) {
+                    // the connection could not be created or indicated that we should not continue processing this packet
+                    return;
                 }
+            }
 
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+            if (packet->isPartOfMessage()) {
+                auto connection = findOrCreateConnection(senderSockAddr);
+                if (connection) {
+                    connection->queueReceivedMessagePacket(std::move(packet));
                 }
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
             }
         }
     }
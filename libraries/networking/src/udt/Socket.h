@@ -23,8 +23,10 @@
 #include <QtNetwork/QUdpSocket>
 
 #include "../HifiSockAddr.h"
-#include "TCPVegasCC.h"
+#include "CongestionControl.h"
 #include "Connection.h"
+#include "MultiDatagramIO.h"
+#include "SendQueueScheduler.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -80,7 +82,16 @@ public:
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
         { _unfilteredHandlers[senderSockAddr] = handler; }
     
+    // reads and writes datagrams in batches where the platform supports it (Linux), should be set before the socket is used
+    // returns false if batched I/O is not supported
+    bool setBatchedIOEnabled(bool enabled);
+    bool isBatchedIOEnabled() const { return (bool)_multiDatagramIO; }
+
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
+
+    // runs the send queues of this socket's connections
+    SendQueueScheduler& getSendQueueScheduler() { return _sendQueueScheduler; }
+
     void setConnectionMaxBandwidth(int maxBandwidth);
 
     void messageReceived(std::unique_ptr<Packet> packet);
@@ -109,6 +120,8 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    void processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -132,6 +145,9 @@ private:
 
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
+
+    // declared before the connections, so that their send queues are gone before it is
+    SendQueueScheduler _sendQueueScheduler;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
     
     int _synInterval { 10 }; // 10ms
@@ -141,10 +157,12 @@ private:
 
     int _maxBandwidth { -1 };
 
-    std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
+    std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { defaultCongestionControlFactory() };
 
     bool _shouldChangeSocketOptions { true };
 
+    std::unique_ptr<MultiDatagramIO> _multiDatagramIO;
+
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
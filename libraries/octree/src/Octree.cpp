@@ -51,7 +51,16 @@
 #include "OctreeUtils.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"json", "json.gz", "bin"};
+
+// binary snapshots start with this magic, followed by the snapshot format version and the data packet version
+const char BINARY_SNAPSHOT_MAGIC[] = { 'H', 'F', 'O', 'S' };
+const quint32 BINARY_SNAPSHOT_FORMAT_VERSION = 1;
+const int BINARY_SNAPSHOT_HEADER_SIZE = sizeof(BINARY_SNAPSHOT_MAGIC) + sizeof(quint32) + sizeof(quint32);
+
+// gzipped JSON of the same content as a binary snapshot, saved next to it when the persist thread asks for it
+// (on shutdown, so it is current for an upgrade), and read instead of a snapshot written at another version
+const QString BINARY_SNAPSHOT_FALLBACK_EXTENSION = ".json.gz";
 
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
@@ -1625,6 +1634,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        return readFromBinaryFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1667,6 +1680,80 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
     return readJSONFromStream(-1, jsonStream);
 }
 
+bool Octree::readFromBinaryFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open binary snapshot file for reading: " << qFileName;
+        return false;
+    }
+
+    // map the snapshot rather than copying it, fall back to reading it if the file can't be mapped
+    qint64 fileSize = file.size();
+    QByteArray fileData;
+    const unsigned char* data = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (!data) {
+        fileData = file.readAll();
+        data = reinterpret_cast<const unsigned char*>(fileData.constData());
+        fileSize = fileData.size();
+    }
+
+    if (fileSize < BINARY_SNAPSHOT_HEADER_SIZE ||
+        memcmp(data, BINARY_SNAPSHOT_MAGIC, sizeof(BINARY_SNAPSHOT_MAGIC)) != 0) {
+        // not a snapshot, this can be content that was uploaded as a replacement for a binary persist file
+        QByteArray contents = fileData.isEmpty() ? QByteArray(reinterpret_cast<const char*>(data), fileSize) : fileData;
+        file.close();
+
+        const unsigned char GZIP_MAGIC[] = { 0x1f, 0x8b };
+        if (contents.size() >= 2 && (unsigned char)contents[0] == GZIP_MAGIC[0] &&
+            (unsigned char)contents[1] == GZIP_MAGIC[1]) {
+            return readJSONFromGzippedFile(qFileName);
+        }
+
+        QDataStream inputStream(contents);
+        return readFromStream(contents.size(), inputStream);
+    }
+
+    const unsigned char* dataAt = data + sizeof(BINARY_SNAPSHOT_MAGIC);
+    quint32 formatVersion;
+    memcpy(&formatVersion, dataAt, sizeof(formatVersion));
+    dataAt += sizeof(formatVersion);
+    quint32 dataVersion;
+    memcpy(&dataVersion, dataAt, sizeof(dataVersion));
+    dataAt += sizeof(dataVersion);
+
+    PacketVersion expectedVersion = versionForPacketType(expectedDataPacketType());
+    if (formatVersion != BINARY_SNAPSHOT_FORMAT_VERSION || dataVersion != expectedVersion) {
+        // the property encoding of another version can't be trusted to decode the same, so use the JSON instead
+        qWarning() << "Binary snapshot" << qFileName << "was written at format" << formatVersion << "data version"
+            << dataVersion << "- expected" << BINARY_SNAPSHOT_FORMAT_VERSION << expectedVersion;
+        file.close();
+        return readBinaryFileFallback(qFileName);
+    }
+
+    qCDebug(octree) << "Loading binary snapshot" << qFileName << "...";
+
+    emit importSize(1.0f, 1.0f, 1.0f);
+    emit importProgress(0);
+
+    bool success = readFromSnapshot(dataAt, fileSize - BINARY_SNAPSHOT_HEADER_SIZE, (PacketVersion)dataVersion);
+
+    emit importProgress(100);
+    file.close();
+
+    return success;
+}
+
+bool Octree::readBinaryFileFallback(QString qFileName) {
+    QString fallbackFileName = qFileName + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+    if (!QFile::exists(fallbackFileName)) {
+        qCritical() << "No JSON fallback for binary snapshot" << qFileName;
+        return false;
+    }
+
+    qCDebug(octree) << "Loading JSON fallback" << fallbackFileName << "...";
+    return readJSONFromGzippedFile(fallbackFileName);
+}
+
 bool Octree::readFromURL(const QString& urlString) {
     auto request = std::unique_ptr<ResourceRequest>(ResourceManager::createResourceRequest(this, urlString));
 
@@ -1866,7 +1953,8 @@ bool Octree::readJSONFromStream(unsigned long streamLength, QDataStream& inputSt
     return success;
 }
 
-bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QString persistAsFileType) {
+bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QString persistAsFileType,
+                         bool withBinaryFallback) {
     // make the sure file extension makes sense
     QString qFileName = fileNameWithoutExtension(QString(fileName), PERSIST_EXTENSIONS) + "." + persistAsFileType;
     QByteArray byteArray = qFileName.toUtf8();
@@ -1877,6 +1965,8 @@ bool Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         success = writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         success = writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin") {
+        success = writeToBinaryFile(cFileName, element, withBinaryFallback);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -1931,6 +2021,48 @@ bool Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     return success;
 }
 
+bool Octree::writeToBinaryFile(const char* fileName, OctreeElementPointer element, bool withFallback) {
+    qCDebug(octree, "Saving binary snapshot to file %s...", fileName);
+
+    OctreeElementPointer top;
+    if (element) {
+        top = element;
+    } else {
+        top = _rootElement;
+    }
+
+    QByteArray snapshot;
+    quint32 formatVersion = BINARY_SNAPSHOT_FORMAT_VERSION;
+    quint32 dataVersion = versionForPacketType(expectedDataPacketType());
+    snapshot.append(BINARY_SNAPSHOT_MAGIC, sizeof(BINARY_SNAPSHOT_MAGIC));
+    snapshot.append(reinterpret_cast<const char*>(&formatVersion), sizeof(formatVersion));
+    snapshot.append(reinterpret_cast<const char*>(&dataVersion), sizeof(dataVersion));
+
+    if (!writeToSnapshot(snapshot, top)) {
+        qCritical("Failed to write binary snapshot.");
+        return false;
+    }
+
+    // the fallback is written first, so that it is never older than the snapshot it stands in for
+    if (withFallback) {
+        QByteArray fallbackFileName = (QString(fileName) + BINARY_SNAPSHOT_FALLBACK_EXTENSION).toUtf8();
+        if (!writeToJSONFile(fallbackFileName.constData(), top, true)) {
+            qCritical("Failed to write binary snapshot JSON fallback.");
+            return false;
+        }
+    }
+
+    QFile persistFile(fileName);
+    bool success = false;
+    if (persistFile.open(QIODevice::WriteOnly)) {
+        success = persistFile.write(snapshot) != -1;
+    } else {
+        qCritical("Could not write binary snapshot.");
+    }
+
+    return success;
+}
+
 unsigned long Octree::getOctreeElementsCount() {
     unsigned long nodeCount = 0;
     recurseTreeWithOperation(countOctreeElementsOperation, &nodeCount);
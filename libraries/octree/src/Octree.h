@@ -37,6 +37,7 @@ class Shape;
 using OctreePointer = std::shared_ptr<Octree>;
 
 extern QVector<QString> PERSIST_EXTENSIONS;
+extern const QString BINARY_SNAPSHOT_FALLBACK_EXTENSION;
 
 /// derive from this class to use the Octree::recurseTreeWithOperator() method
 class RecurseOctreeOperator {
@@ -212,6 +213,22 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    /// An edit decoded and validated by prepareEditPacketData(), waiting to be applied by applyPreparedEdit()
+    class PreparedEdit {
+    public:
+        virtual ~PreparedEdit() { }
+    };
+    using PreparedEditPointer = std::unique_ptr<PreparedEdit>;
+
+    // Optionally, your tree can split processEditPacketData() in two so that the OctreeServer can decode and validate
+    // edits on several threads without the tree lock. prepareEditPacketData() may be called from any thread and returns
+    // the bytes read like processEditPacketData(), the edit data must stay valid until the edit is applied.
+    // applyPreparedEdit() is called with the tree write locked, in the order the edits arrived.
+    virtual bool canPrepareEditPacketType(PacketType packetType) const { return false; }
+    virtual int prepareEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                      const SharedNodePointer& sourceNode, PreparedEditPointer& preparedEdit) { return 0; }
+    virtual void applyPreparedEdit(PreparedEdit& preparedEdit) { }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -293,11 +310,17 @@ public:
     void loadOctreeFile(const char* fileName);
 
     // Octree exporters
-    bool writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "json.gz");
+    bool writeToFile(const char* filename, OctreeElementPointer element = NULL, QString persistAsFileType = "json.gz",
+                     bool withBinaryFallback = false);
     bool writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
+    // withFallback also writes the gzipped JSON that is read in place of the snapshot by another version
+    bool writeToBinaryFile(const char* filename, OctreeElementPointer element = NULL, bool withFallback = false);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
                             bool skipThoseWithBadParents) = 0;
 
+    // appends the contents of the tree to a binary snapshot, after the header written by writeToBinaryFile()
+    virtual bool writeToSnapshot(QByteArray& snapshot, OctreeElementPointer element) { return false; }
+
     // Octree importers
     bool readFromFile(const char* filename);
     bool readFromURL(const QString& url); // will support file urls as well...
@@ -305,8 +328,14 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readFromBinaryFile(QString qFileName);
+    bool readBinaryFileFallback(QString qFileName); // reads the JSON saved along with a binary snapshot
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    // reads the contents written by writeToSnapshot(), dataVersion is the data packet version the snapshot was written at,
+    // which has to be the current one
+    virtual bool readFromSnapshot(const unsigned char* data, qint64 size, PacketVersion dataVersion) { return false; }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -343,6 +372,7 @@ public:
     virtual quint64 getAverageCreateTime() const { return 0;  }
     virtual quint64 getAverageLoggingTime() const { return 0;  }
     virtual quint64 getAverageFilterTime() const { return 0; }
+    virtual quint64 getTotalRevalidatedEdits() const { return 0; }
 
 signals:
     void importSize(float x, float y, float z);
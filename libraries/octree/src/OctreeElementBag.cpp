@@ -10,10 +10,18 @@
 //
 
 #include "OctreeElementBag.h"
+
+#include <algorithm>
+
 #include <OctalCode.h>
 
+// orders the heap by priority, ties are broken by element so that copies of an element are extracted back to back
+bool OctreeElementBag::lowerPriority(const Entry& a, const Entry& b) {
+    return a.priority < b.priority || (a.priority == b.priority && a.key < b.key);
+}
+
 void OctreeElementBag::deleteAll() {
-    _bagElements = Bag();
+    _bagElements.clear();
 }
 
 /// does the bag contain elements?
@@ -24,17 +32,56 @@ bool OctreeElementBag::isEmpty() {
 }
 
 void OctreeElementBag::insert(OctreeElementPointer element) {
-    _bagElements[element.get()] = element;
+    _bagElements.push_back({ calculatePriority(*element), element.get(), element });
+    std::push_heap(_bagElements.begin(), _bagElements.end(), lowerPriority);
 }
 
 OctreeElementPointer OctreeElementBag::extract() {
     OctreeElementPointer result;
 
-    // Find the first element still alive
-    Bag::iterator it = _bagElements.begin();
-    while (it != _bagElements.end() && !result) {
-        result = it->second.lock();
-        it = _bagElements.erase(it);
+    // Find the highest priority element still alive
+    while (!_bagElements.empty() && !result) {
+        std::pop_heap(_bagElements.begin(), _bagElements.end(), lowerPriority);
+        Entry entry = std::move(_bagElements.back());
+        _bagElements.pop_back();
+
+        // an element inserted more than once has the same priority each time, so its copies are next
+        while (!_bagElements.empty() && _bagElements.front().key == entry.key) {
+            std::pop_heap(_bagElements.begin(), _bagElements.end(), lowerPriority);
+            _bagElements.pop_back();
+        }
+
+        result = entry.element.lock();
     }
     return result;
 }
+
+void OctreeElementBag::setViewFrustum(const ViewFrustum& viewFrustum) {
+    if (_hasViewPosition && _viewPosition == viewFrustum.getPosition()) {
+        return;
+    }
+    _hasViewPosition = true;
+    _viewPosition = viewFrustum.getPosition();
+
+    // elements that have expired keep their old priority, extract() skips them anyway
+    for (auto& entry : _bagElements) {
+        if (auto element = entry.element.lock()) {
+            entry.priority = calculatePriority(*element);
+        }
+    }
+    std::make_heap(_bagElements.begin(), _bagElements.end(), lowerPriority);
+}
+
+float OctreeElementBag::calculatePriority(const OctreeElement& element) const {
+    const AACube& cube = element.getAACube();
+    if (!_hasViewPosition) {
+        return cube.getScale();
+    }
+
+    // the angular size of the element's bounding sphere, elements around the view position come first
+    const float HALF_SQRT_THREE = 0.8660254f;
+    const float MIN_DISTANCE = 0.001f;
+    float radius = cube.getScale() * HALF_SQRT_THREE;
+    float distance = glm::distance(_viewPosition, cube.calcCenter());
+    return radius / std::max(distance, MIN_DISTANCE);
+}
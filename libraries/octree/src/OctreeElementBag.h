@@ -6,7 +6,8 @@
 //  Copyright 2013 High Fidelity, Inc.
 //
 //  This class is used by the Octree:encodeTreeBitstream() functions to store elements and element data that need to be sent.
-//  It's a generic bag style storage mechanism. But It has the property that you can't put the same element into the bag
+//  It's a priority queue: elements come out largest on screen first, as seen from the view frustum set on the bag, or
+//  largest first if no view frustum has been set. It has the property that you can't put the same element into the bag
 //  more than once (in other words, it de-dupes automatically).
 //
 //  Distributed under the Apache License, Version 2.0.
@@ -16,17 +17,23 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
-#include <unordered_map>
+#include <vector>
 
 #include "OctreeElement.h"
 
 class OctreeElementBag {
-    using Bag = std::unordered_map<OctreeElement*, OctreeElementWeakPointer>;
-    
+    struct Entry {
+        float priority;
+        const OctreeElement* key;
+        OctreeElementWeakPointer element;
+    };
+    // a binary heap, its storage is kept between scenes so that filling the bag doesn't allocate
+    using Bag = std::vector<Entry>;
+
 public:
     void insert(OctreeElementPointer element); // put a element into the bag
 
-    OctreeElementPointer extract(); /// pull a element out of the bag (could come in any order) and if all of the
+    OctreeElementPointer extract(); /// pull the highest priority element out of the bag and if all of the
                                     /// elements have expired, a single null pointer will be returned
 
     bool isEmpty(); /// does the bag contain elements, 
@@ -36,8 +43,16 @@ public:
     void deleteAll();
     size_t size() const { return _bagElements.size(); }
 
+    /// prioritize elements by their angular size from this view frustum's position, including those already in the bag
+    void setViewFrustum(const ViewFrustum& viewFrustum);
+
 private:
+    static bool lowerPriority(const Entry& a, const Entry& b);
+    float calculatePriority(const OctreeElement& element) const;
+
     Bag _bagElements;
+    bool _hasViewPosition { false };
+    glm::vec3 _viewPosition;
 };
 
 class OctreeElementExtraEncodeDataBase {
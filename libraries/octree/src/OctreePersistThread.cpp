@@ -62,6 +62,8 @@ QString OctreePersistThread::getPersistFileMimeType() const {
         return "application/json";
     } if (_persistAsFileType == "json.gz") {
         return "application/zip";
+    } if (_persistAsFileType == "bin") {
+        return "application/octet-stream";
     }
     return "";
 }
@@ -275,7 +277,8 @@ bool OctreePersistThread::process() {
 
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
-    persist();
+    const bool isFinalPersist = true;
+    persist(isFinalPersist);
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
@@ -289,8 +292,13 @@ QByteArray OctreePersistThread::getPersistFileContents() const {
     return fileContents;
 }
 
-void OctreePersistThread::persist() {
-    if (_tree->isDirty() && _initialLoadComplete) {
+void OctreePersistThread::persist(bool isFinalPersist) {
+    // the JSON fallback of a binary snapshot costs more to write than the snapshot, so it is only brought up to date
+    // on shutdown, which is when the server can be upgraded to a version that reads it instead of the snapshot
+    bool withBinaryFallback = hasBinaryFallback() &&
+        (isFinalPersist ? _isBinaryFallbackStale : !QFile::exists(_filename + BINARY_SNAPSHOT_FALLBACK_EXTENSION));
+
+    if ((_tree->isDirty() || withBinaryFallback) && _initialLoadComplete) {
 
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -309,7 +317,9 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
-            _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            if (_tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType, withBinaryFallback)) {
+                _isBinaryFallbackStale = !withBinaryFallback;
+            }
             time(&_lastPersistTime);
             _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
@@ -345,6 +355,17 @@ void OctreePersistThread::restoreFromMostRecentBackup() {
             qCDebug(octree) << "ERROR while restoring backup file " << mostRecentBackupFileName << "to" << _filename << "...";
             perror("ERROR while restoring backup file");
         }
+
+        if (hasBinaryFallback()) {
+            // the fallback of the restored snapshot, if it was backed up with one
+            QString fallbackFileName = _filename + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+            QString backupFallbackFileName = mostRecentBackupFileName + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+            QFile::remove(fallbackFileName);
+            if (QFile::exists(backupFallbackFileName) && !QFile::copy(backupFallbackFileName, fallbackFileName)) {
+                qCDebug(octree) << "ERROR while restoring backup file " << backupFallbackFileName << "to"
+                    << fallbackFileName << "...";
+            }
+        }
     } else {
         qCDebug(octree) << "NO BEST backup file found.";
     }
@@ -384,6 +405,12 @@ bool OctreePersistThread::getMostRecentBackup(const QString& format,
     while(dirIterator.hasNext()) {
 
         dirIterator.next();
+
+        // the JSON fallbacks of binary snapshot backups are restored along with their snapshots
+        if (hasBinaryFallback() && dirIterator.fileName().endsWith(BINARY_SNAPSHOT_FALLBACK_EXTENSION)) {
+            continue;
+        }
+
         QDateTime lastModified = dirIterator.fileInfo().lastModified();
 
         // Based on last modified date, track the most recently modified file as the best backup
@@ -421,6 +448,9 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
                     qCDebug(octree) << "ERROR deleting old backup file " << backupMaxFilenameN;
                 }
             }
+            if (hasBinaryFallback()) {
+                QFile::remove(backupMaxFilenameN + BINARY_SNAPSHOT_FALLBACK_EXTENSION);
+            }
 
             for(int n = rule.maxBackupVersions - 1; n > 0; n--) {
                 QString backupExtensionN = rule.extensionFormat;
@@ -443,6 +473,16 @@ void OctreePersistThread::rollOldBackupVersions(const BackupRule& rule) {
                         perror("ERROR in rolling backup file");
                     }
                 }
+
+                QString backupFallbackFilenameN = backupFilenameN + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+                if (hasBinaryFallback() && QFile::exists(backupFallbackFilenameN)) {
+                    QString backupFallbackFilenameNplusOne = backupFilenameNplusOne + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+                    if (rename(qPrintable(backupFallbackFilenameN), qPrintable(backupFallbackFilenameNplusOne)) != 0) {
+                        qCDebug(octree) << "ERROR in rolling backup file " << backupFallbackFilenameN << "to"
+                            << backupFallbackFilenameNplusOne << "...";
+                        perror("ERROR in rolling backup file");
+                    }
+                }
             }
             qCDebug(octree) << "Done rolling old backup versions...";
         } else {
@@ -497,6 +537,12 @@ void OctreePersistThread::backup() {
                         if (result) {
                             qCDebug(octree) << "DONE backing up persist file...";
                             rule.lastBackup = now; // only record successful backup in this case.
+
+                            QString fallbackFileName = _filename + BINARY_SNAPSHOT_FALLBACK_EXTENSION;
+                            if (hasBinaryFallback() && QFile::exists(fallbackFileName) &&
+                                !QFile::copy(fallbackFileName, backupFileName + BINARY_SNAPSHOT_FALLBACK_EXTENSION)) {
+                                qCDebug(octree) << "ERROR in backing up persist file fallback" << fallbackFileName;
+                            }
                         } else {
                             qCDebug(octree) << "ERROR in backing up persist file...";
                             perror("ERROR in backing up persist file");
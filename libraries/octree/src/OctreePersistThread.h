@@ -54,7 +54,7 @@ protected:
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
-    void persist();
+    void persist(bool isFinalPersist = false);
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
@@ -81,6 +81,10 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    // a binary persist file has a JSON fallback, which is written when it is missing and on the final persist
+    bool hasBinaryFallback() const { return _persistAsFileType == "bin"; }
+    bool _isBinaryFallbackStale { true };
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -0,0 +1,142 @@
+//
+//  BitPacking.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BitPacking.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float SMALLEST_THREE_MAGNITUDE = 1.0f / sqrtf(2.0f);
+
+void BitWriter::write(uint32_t value, int numBits) {
+    for (int i = 0; i < numBits; i++, _numBits++) {
+        int byteIndex = (int)(_numBits / 8);
+        if (byteIndex >= _size) {
+            _isOverflowed = true;
+            return;
+        }
+        int bitIndex = (int)(_numBits % 8);
+        if (bitIndex == 0) {
+            _buffer[byteIndex] = 0;
+        }
+        if (value & (1U << i)) {
+            _buffer[byteIndex] |= (1 << bitIndex);
+        }
+    }
+}
+
+uint32_t BitReader::read(int numBits) {
+    uint32_t value = 0;
+    for (int i = 0; i < numBits; i++, _numBits++) {
+        int byteIndex = (int)(_numBits / 8);
+        if (byteIndex >= _size) {
+            _isOverflowed = true;
+            return 0;
+        }
+        if (_buffer[byteIndex] & (1 << (_numBits % 8))) {
+            value |= (1U << i);
+        }
+    }
+    return value;
+}
+
+int32_t BitReader::readSigned(int numBits) {
+    uint32_t value = read(numBits);
+
+    // sign extend
+    if (numBits < 32 && (value & (1U << (numBits - 1)))) {
+        value |= ~((1U << numBits) - 1);
+    }
+    return (int32_t)value;
+}
+
+// quantize value in [-range, range] to [0, 2^numBits - 1]
+static uint32_t quantize(float value, float range, int numBits) {
+    const uint32_t maxValue = (1U << numBits) - 1;
+    float normalized = glm::clamp((value + range) / (2.0f * range), 0.0f, 1.0f);
+    return (uint32_t)(normalized * maxValue + 0.5f);
+}
+
+static float dequantize(uint32_t value, float range, int numBits) {
+    const uint32_t maxValue = (1U << numBits) - 1;
+    return ((float)value / (float)maxValue) * (2.0f * range) - range;
+}
+
+glm::quat packOrientationQuatSmallestThree(BitWriter& writer, const glm::quat& quatInput, int numBits) {
+    // find largest component
+    int largestComponent = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(quatInput[i]) > fabsf(quatInput[largestComponent])) {
+            largestComponent = i;
+        }
+    }
+
+    // ensure that the sign of the dropped component is always positive
+    glm::quat q = quatInput[largestComponent] < 0.0f ? -quatInput : quatInput;
+
+    writer.write((uint32_t)largestComponent, 2);
+    glm::quat result;
+    float sumSquares = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestComponent) {
+            uint32_t value = quantize(q[i], SMALLEST_THREE_MAGNITUDE, numBits);
+            writer.write(value, numBits);
+            result[i] = dequantize(value, SMALLEST_THREE_MAGNITUDE, numBits);
+            sumSquares += result[i] * result[i];
+        }
+    }
+    result[largestComponent] = sqrtf(std::max(1.0f - sumSquares, 0.0f));
+    return glm::normalize(result);
+}
+
+glm::quat unpackOrientationQuatSmallestThree(BitReader& reader, int numBits) {
+    int largestComponent = (int)reader.read(2);
+
+    glm::quat result;
+    float sumSquares = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestComponent) {
+            result[i] = dequantize(reader.read(numBits), SMALLEST_THREE_MAGNITUDE, numBits);
+            sumSquares += result[i] * result[i];
+        }
+    }
+    result[largestComponent] = sqrtf(std::max(1.0f - sumSquares, 0.0f));
+    return glm::normalize(result);
+}
+
+float smallRotationRange(int numBits, int fullNumBits) {
+    return SMALLEST_THREE_MAGNITUDE * (float)((1U << numBits) - 1) / (float)((1U << fullNumBits) - 1);
+}
+
+bool isSmallRotation(const glm::quat& rotation, float range) {
+    return fabsf(rotation.x) <= range && fabsf(rotation.y) <= range && fabsf(rotation.z) <= range;
+}
+
+glm::quat packSmallRotation(BitWriter& writer, const glm::quat& rotation, int numBits, float range) {
+    glm::quat q = rotation.w < 0.0f ? -rotation : rotation;
+
+    uint32_t x = quantize(q.x, range, numBits);
+    uint32_t y = quantize(q.y, range, numBits);
+    uint32_t z = quantize(q.z, range, numBits);
+    writer.write(x, numBits);
+    writer.write(y, numBits);
+    writer.write(z, numBits);
+
+    glm::vec3 xyz(dequantize(x, range, numBits), dequantize(y, range, numBits), dequantize(z, range, numBits));
+    return glm::normalize(glm::quat(sqrtf(std::max(1.0f - glm::dot(xyz, xyz), 0.0f)), xyz.x, xyz.y, xyz.z));
+}
+
+glm::quat unpackSmallRotation(BitReader& reader, int numBits, float range) {
+    glm::vec3 xyz;
+    xyz.x = dequantize(reader.read(numBits), range, numBits);
+    xyz.y = dequantize(reader.read(numBits), range, numBits);
+    xyz.z = dequantize(reader.read(numBits), range, numBits);
+    return glm::normalize(glm::quat(sqrtf(std::max(1.0f - glm::dot(xyz, xyz), 0.0f)), xyz.x, xyz.y, xyz.z));
+}
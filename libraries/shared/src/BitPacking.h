@@ -0,0 +1,75 @@
+//
+//  BitPacking.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BitPacking_h
+#define hifi_BitPacking_h
+
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Writes values of any width up to 32 bits into a byte buffer, least significant bit first
+//   Writing past the end of the buffer is dropped, and flags the writer as overflowed.
+class BitWriter {
+public:
+    BitWriter(unsigned char* buffer, int size) : _buffer(buffer), _size(size) {}
+
+    void write(uint32_t value, int numBits);
+    void writeSigned(int32_t value, int numBits) { write((uint32_t)value, numBits); }
+
+    // number of bytes touched so far, including a partially written last byte
+    int getNumBytes() const { return (int)((_numBits + 7) / 8); }
+    bool isOverflowed() const { return _isOverflowed; }
+
+private:
+    unsigned char* _buffer;
+    int _size;
+    uint64_t _numBits { 0 };
+    bool _isOverflowed { false };
+};
+
+// Reads values written by a BitWriter
+//   Reading past the end of the buffer returns zeros, and flags the reader as overflowed.
+class BitReader {
+public:
+    BitReader(const unsigned char* buffer, int size) : _buffer(buffer), _size(size) {}
+
+    uint32_t read(int numBits);
+    int32_t readSigned(int numBits);
+
+    int getNumBytes() const { return (int)((_numBits + 7) / 8); }
+    bool isOverflowed() const { return _isOverflowed; }
+
+private:
+    const unsigned char* _buffer;
+    int _size;
+    uint64_t _numBits { 0 };
+    bool _isOverflowed { false };
+};
+
+// writes the index of the largest component in 2 bits, then the other three in numBits each
+// returns the quaternion the reader will decode
+glm::quat packOrientationQuatSmallestThree(BitWriter& writer, const glm::quat& quatInput, int numBits);
+glm::quat unpackOrientationQuatSmallestThree(BitReader& reader, int numBits);
+
+// the range a small rotation packed with numBits per component covers, at the same step as
+// packOrientationQuatSmallestThree with fullNumBits per component
+float smallRotationRange(int numBits, int fullNumBits);
+
+// true if the x, y and z of rotation (or of its negation, if w is negative) are all within +/- range
+bool isSmallRotation(const glm::quat& rotation, float range);
+
+// writes the x, y and z of a small rotation (see isSmallRotation) in numBits each, w is implied positive
+// returns the quaternion the reader will decode
+glm::quat packSmallRotation(BitWriter& writer, const glm::quat& rotation, int numBits, float range);
+glm::quat unpackSmallRotation(BitReader& reader, int numBits, float range);
+
+#endif // hifi_BitPacking_h
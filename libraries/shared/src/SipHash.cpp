@@ -0,0 +1,126 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+#include <string.h>
+
+namespace {
+
+    const uint64_t INITIAL_V0 = 0x736f6d6570736575ULL; // "somepseu"
+    const uint64_t INITIAL_V1 = 0x646f72616e646f6dULL; // "dorandom"
+    const uint64_t INITIAL_V2 = 0x6c7967656e657261ULL; // "lygenera"
+    const uint64_t INITIAL_V3 = 0x7465646279746573ULL; // "tedbytes"
+
+    const int COMPRESSION_ROUNDS = 2;
+    const int FINALIZATION_ROUNDS = 4;
+
+    inline uint64_t rotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t readLittleEndian64(const uint8_t* bytes) {
+        return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8) | ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
+            ((uint64_t)bytes[4] << 32) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[6] << 48) | ((uint64_t)bytes[7] << 56);
+    }
+
+    inline void writeLittleEndian64(uint64_t value, uint8_t* bytes) {
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = (uint8_t)(value >> (8 * i));
+        }
+    }
+
+    inline void sipRound(uint64_t v[4]) {
+        v[0] += v[1];
+        v[1] = rotateLeft(v[1], 13);
+        v[1] ^= v[0];
+        v[0] = rotateLeft(v[0], 32);
+        v[2] += v[3];
+        v[3] = rotateLeft(v[3], 16);
+        v[3] ^= v[2];
+        v[0] += v[3];
+        v[3] = rotateLeft(v[3], 21);
+        v[3] ^= v[0];
+        v[2] += v[1];
+        v[1] = rotateLeft(v[1], 17);
+        v[1] ^= v[2];
+        v[2] = rotateLeft(v[2], 32);
+    }
+
+    inline void finalizationRounds(uint64_t v[4]) {
+        for (int i = 0; i < FINALIZATION_ROUNDS; ++i) {
+            sipRound(v);
+        }
+    }
+}
+
+SipHash::SipHash(const uint8_t key[KEY_SIZE]) :
+    SipHash(readLittleEndian64(key), readLittleEndian64(key + 8))
+{
+}
+
+SipHash::SipHash(uint64_t k0, uint64_t k1) :
+    _v0(k0 ^ INITIAL_V0),
+    _v1(k1 ^ INITIAL_V1),
+    _v2(k0 ^ INITIAL_V2),
+    _v3(k1 ^ INITIAL_V3)
+{
+}
+
+void SipHash::compress(uint64_t v[4], const uint8_t* data, size_t length) const {
+    const uint8_t* end = data + (length - (length % 8));
+
+    for (; data != end; data += 8) {
+        uint64_t m = readLittleEndian64(data);
+        v[3] ^= m;
+        for (int i = 0; i < COMPRESSION_ROUNDS; ++i) {
+            sipRound(v);
+        }
+        v[0] ^= m;
+    }
+
+    // the last block holds the remaining bytes, with the message length in its top byte
+    uint8_t lastBlock[8] = { 0 };
+    memcpy(lastBlock, data, length % 8);
+    lastBlock[7] = (uint8_t)length;
+
+    uint64_t m = readLittleEndian64(lastBlock);
+    v[3] ^= m;
+    for (int i = 0; i < COMPRESSION_ROUNDS; ++i) {
+        sipRound(v);
+    }
+    v[0] ^= m;
+}
+
+uint64_t SipHash::hash64(const void* data, size_t length) const {
+    uint64_t v[4] = { _v0, _v1, _v2, _v3 };
+
+    compress(v, static_cast<const uint8_t*>(data), length);
+
+    v[2] ^= 0xff;
+    finalizationRounds(v);
+
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+void SipHash::hash128(const void* data, size_t length, uint8_t digest[DIGEST_SIZE_128]) const {
+    // the 128-bit variant tweaks v1 up front and runs a second finalization for the high half
+    uint64_t v[4] = { _v0, _v1 ^ 0xee, _v2, _v3 };
+
+    compress(v, static_cast<const uint8_t*>(data), length);
+
+    v[2] ^= 0xee;
+    finalizationRounds(v);
+    writeLittleEndian64(v[0] ^ v[1] ^ v[2] ^ v[3], digest);
+
+    v[1] ^= 0xdd;
+    finalizationRounds(v);
+    writeLittleEndian64(v[0] ^ v[1] ^ v[2] ^ v[3], digest + 8);
+}
@@ -0,0 +1,42 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SipHash-2-4 keyed hash (Aumasson & Bernstein). It is a short-input PRF, fast enough to authenticate
+// every packet, and needs no heap allocation. The key schedule is done once at construction so a
+// SipHash can be cached per connection and shared between threads for hashing.
+class SipHash {
+public:
+    static const size_t KEY_SIZE = 16;
+    static const size_t DIGEST_SIZE_64 = 8;
+    static const size_t DIGEST_SIZE_128 = 16;
+
+    SipHash() {}
+    explicit SipHash(const uint8_t key[KEY_SIZE]);
+    SipHash(uint64_t k0, uint64_t k1);
+
+    uint64_t hash64(const void* data, size_t length) const;
+    void hash128(const void* data, size_t length, uint8_t digest[DIGEST_SIZE_128]) const;
+
+private:
+    void compress(uint64_t state[4], const uint8_t* data, size_t length) const;
+
+    uint64_t _v0 { 0 };
+    uint64_t _v1 { 0 };
+    uint64_t _v2 { 0 };
+    uint64_t _v3 { 0 };
+};
+
+#endif // hifi_SipHash_h
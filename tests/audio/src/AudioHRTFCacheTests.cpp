@@ -0,0 +1,180 @@
+//
+//  AudioHRTFCacheTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioHRTFCacheTests.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include <AudioHRTFCache.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioHRTFCacheTests)
+
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+static const int HRTF_INDEX = 1;
+static const float AZIMUTH_STEP = TWO_PI / HRTF_AZIMUTHS;
+
+// a 100Hz tone, continuous across blocks
+static void fillTone(int16_t* block, unsigned int frame) {
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float t = (float)(frame * NUM_FRAMES + i) / AudioConstants::SAMPLE_RATE;
+        block[i] = (int16_t)(8000.0f * sinf(TWO_PI * 100.0f * t));
+    }
+}
+
+// the largest change between consecutive samples of either channel
+static float maxStep(const std::vector<float>& samples) {
+    float step = 0.0f;
+    for (size_t i = 2; i < samples.size(); i++) {
+        step = std::max(step, std::abs(samples[i] - samples[i - 2]));
+    }
+    return step;
+}
+
+void AudioHRTFCacheTests::bucketEdgeIsContinuous() {
+    AudioHRTFCache cache;
+    cache.setEnabled(true);
+    cache.setMinListeners(1);
+
+    AudioHRTFCache::ListenerSource listenerSource;
+    AudioHRTF reference;
+    QUuid nodeID = QUuid::createUuid();
+
+    std::vector<float> cached, direct;
+    std::set<uint32_t> buckets;
+
+    // sweep across several azimuth and distance buckets
+    const unsigned int NUM_SWEEP_FRAMES = 100;
+    for (unsigned int frame = 1; frame <= NUM_SWEEP_FRAMES; frame++) {
+        float azimuth = 3.0f * AZIMUTH_STEP * frame / NUM_SWEEP_FRAMES;
+        float distance = 2.0f * std::exp2((float)frame / NUM_SWEEP_FRAMES);
+
+        int16_t input[NUM_FRAMES];
+        fillTone(input, frame);
+
+        float cachedOutput[NUM_SAMPLES] = {};
+        bool useBucket = cache.touch(nodeID, QUuid());
+        cache.render(listenerSource, useBucket, nodeID, QUuid(), input, cachedOutput, HRTF_INDEX,
+                     azimuth, distance, 0.5f, frame);
+        if (listenerSource.bucket != AudioHRTFCache::OWN_HRTF) {
+            buckets.insert(listenerSource.bucket);
+        }
+
+        float directOutput[NUM_SAMPLES] = {};
+        reference.render(input, directOutput, HRTF_INDEX, azimuth, distance, 0.5f, NUM_FRAMES);
+
+        cached.insert(cached.end(), cachedOutput, cachedOutput + NUM_SAMPLES);
+        direct.insert(direct.end(), directOutput, directOutput + NUM_SAMPLES);
+
+        cache.nextFrame(frame);
+    }
+
+    QVERIFY(buckets.size() >= 3);
+    QVERIFY(maxStep(cached) <= 2.0f * maxStep(direct));
+}
+
+void AudioHRTFCacheTests::fallbackIsContinuous() {
+    AudioHRTFCache cache;
+    cache.setEnabled(true);
+    cache.setMinListeners(1);
+
+    AudioHRTFCache::ListenerSource listenerSource;
+    AudioHRTF reference;
+    QUuid nodeID = QUuid::createUuid();
+
+    std::vector<float> cached, direct;
+
+    // alternate between the listener's own HRTF and the shared bucket
+    for (unsigned int frame = 1; frame <= 60; frame++) {
+        int16_t input[NUM_FRAMES];
+        fillTone(input, frame);
+
+        float cachedOutput[NUM_SAMPLES] = {};
+        bool useBucket = (frame / 15) % 2 == 1;
+        cache.render(listenerSource, useBucket, nodeID, QUuid(), input, cachedOutput, HRTF_INDEX, 1.0f, 3.0f, 0.5f, frame);
+        QCOMPARE(listenerSource.bucket == AudioHRTFCache::OWN_HRTF, !useBucket);
+
+        float directOutput[NUM_SAMPLES] = {};
+        reference.render(input, directOutput, HRTF_INDEX, 1.0f, 3.0f, 0.5f, NUM_FRAMES);
+
+        cached.insert(cached.end(), cachedOutput, cachedOutput + NUM_SAMPLES);
+        direct.insert(direct.end(), directOutput, directOutput + NUM_SAMPLES);
+
+        cache.nextFrame(frame);
+    }
+
+    QVERIFY(maxStep(cached) <= 2.0f * maxStep(direct));
+}
+
+void AudioHRTFCacheTests::staleBucketStartsOver() {
+    AudioHRTFCache cache;
+    AudioHRTFCache freshCache;
+    QUuid nodeID = QUuid::createUuid();
+    int16_t input[NUM_FRAMES];
+
+    // one listener hears the source through a bucket, then stops
+    AudioHRTFCache::ListenerSource first;
+    for (unsigned int frame = 1; frame <= 5; frame++) {
+        fillTone(input, frame);
+        float output[NUM_SAMPLES] = {};
+        cache.render(first, true, nodeID, QUuid(), input, output, HRTF_INDEX, 1.0f, 3.0f, 0.5f, frame);
+        cache.nextFrame(frame);
+    }
+
+    // another listener in the same bucket much later hears what it would from a new bucket
+    const unsigned int LATER_FRAME = 20;
+    fillTone(input, LATER_FRAME);
+
+    AudioHRTFCache::ListenerSource second;
+    float staleOutput[NUM_SAMPLES] = {};
+    cache.render(second, true, nodeID, QUuid(), input, staleOutput, HRTF_INDEX, 1.0f, 3.0f, 0.5f, LATER_FRAME);
+
+    AudioHRTFCache::ListenerSource fresh;
+    float freshOutput[NUM_SAMPLES] = {};
+    freshCache.render(fresh, true, nodeID, QUuid(), input, freshOutput, HRTF_INDEX, 1.0f, 3.0f, 0.5f, LATER_FRAME);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(staleOutput[i], freshOutput[i]);
+    }
+
+    // and it fades in from silence
+    QVERIFY(std::abs(staleOutput[0]) < 100.0f && std::abs(staleOutput[1]) < 100.0f);
+}
+
+void AudioHRTFCacheTests::sharedBucketIsHit() {
+    AudioHRTFCache cache;
+    QUuid nodeID = QUuid::createUuid();
+
+    AudioHRTFCache::ListenerSource first, second;
+    for (unsigned int frame = 1; frame <= 3; frame++) {
+        int16_t input[NUM_FRAMES];
+        fillTone(input, frame);
+
+        // both listeners fall in the same bucket
+        float firstOutput[NUM_SAMPLES] = {};
+        float secondOutput[NUM_SAMPLES] = {};
+        bool isFirstHit = cache.render(first, true, nodeID, QUuid(), input, firstOutput, HRTF_INDEX,
+                                       2.0f * AZIMUTH_STEP, 4.0f, 0.5f, frame);
+        bool isSecondHit = cache.render(second, true, nodeID, QUuid(), input, secondOutput, HRTF_INDEX,
+                                        2.2f * AZIMUTH_STEP, 4.2f, 0.51f, frame);
+
+        QVERIFY(!isFirstHit);
+        QVERIFY(isSecondHit);
+        QCOMPARE(first.bucket, second.bucket);
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            QCOMPARE(firstOutput[i], secondOutput[i]);
+        }
+
+        cache.nextFrame(frame);
+    }
+}
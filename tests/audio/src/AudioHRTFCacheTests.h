@@ -0,0 +1,25 @@
+//
+//  AudioHRTFCacheTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioHRTFCacheTests_h
+#define hifi_AudioHRTFCacheTests_h
+
+#include <QtTest/QtTest>
+
+class AudioHRTFCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void bucketEdgeIsContinuous();
+    void fallbackIsContinuous();
+    void staleBucketStartsOver();
+    void sharedBucketIsHit();
+};
+
+#endif // hifi_AudioHRTFCacheTests_h
@@ -0,0 +1,196 @@
+//
+//  AudioMixKernelsBenchmark.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsBenchmark.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioMixKernels.h>
+#include <CPUDetect.h>
+
+QTEST_MAIN(AudioMixKernelsBenchmark)
+
+static const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_ITERATIONS = 200000;
+
+static float floatInput[NUM_SAMPLES];
+static int16_t int16Input[NUM_SAMPLES];
+static float floatOutput[NUM_SAMPLES];
+static int16_t int16Output[NUM_SAMPLES];
+
+void AudioMixKernelsBenchmark::initTestCase() {
+    qDebug() << "AVX2 Support:" << (cpuSupportsAVX2() ? "enabled" : "disabled");
+
+    qsrand(0);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        int16Input[i] = (int16_t)((qrand() % 65536) - 32768);
+        floatInput[i] = (float)((qrand() % 80000) - 40000) + 0.25f;
+    }
+}
+
+void AudioMixKernelsBenchmark::report(const char* name, int samplesPerCall, std::function<void()> kernel) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        kernel();
+    }
+    qint64 nsecs = std::max(timer.nsecsElapsed(), (qint64)1);
+
+    double samplesPerSecond = (double)samplesPerCall * NUM_ITERATIONS / (nsecs * 1e-9);
+    qDebug("%s: %.1f Msamples/sec", name, samplesPerSecond * 1e-6);
+}
+
+void AudioMixKernelsBenchmark::accumulate() {
+    memset(floatOutput, 0, sizeof(floatOutput));
+    mixAccumulate(floatInput, floatOutput, NUM_SAMPLES);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(floatOutput[i], floatInput[i]);
+    }
+
+    report("mixAccumulate", NUM_SAMPLES, [] {
+        mixAccumulate(floatInput, floatOutput, NUM_SAMPLES);
+    });
+}
+
+void AudioMixKernelsBenchmark::accumulateInt16() {
+    const float GAIN = 0.5f;
+
+    memset(floatOutput, 0, sizeof(floatOutput));
+    mixAccumulateInt16(int16Input, floatOutput, GAIN, NUM_SAMPLES);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(floatOutput[i], (float)int16Input[i] * (GAIN / AudioConstants::MAX_SAMPLE_VALUE));
+    }
+
+    report("mixAccumulateInt16", NUM_SAMPLES, [&] {
+        mixAccumulateInt16(int16Input, floatOutput, GAIN, NUM_SAMPLES);
+    });
+}
+
+void AudioMixKernelsBenchmark::accumulateInt16MonoToStereo() {
+    const float GAIN = 0.5f;
+
+    memset(floatOutput, 0, sizeof(floatOutput));
+    mixAccumulateInt16MonoToStereo(int16Input, floatOutput, GAIN, NUM_FRAMES);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float expected = (float)int16Input[i] * (GAIN / AudioConstants::MAX_SAMPLE_VALUE);
+        QCOMPARE(floatOutput[2*i+0], expected);
+        QCOMPARE(floatOutput[2*i+1], expected);
+    }
+
+    report("mixAccumulateInt16MonoToStereo", NUM_SAMPLES, [&] {
+        mixAccumulateInt16MonoToStereo(int16Input, floatOutput, GAIN, NUM_FRAMES);
+    });
+}
+
+void AudioMixKernelsBenchmark::isSilent() {
+    memset(floatOutput, 0, sizeof(floatOutput));
+    QVERIFY(mixIsSilent(floatOutput, NUM_SAMPLES));
+    floatOutput[NUM_SAMPLES - 1] = 1e-30f;
+    QVERIFY(!mixIsSilent(floatOutput, NUM_SAMPLES));
+    floatOutput[NUM_SAMPLES - 1] = 0.0f;
+
+    // worst case: the whole buffer is scanned
+    volatile bool isSilent = false;
+    report("mixIsSilent", NUM_SAMPLES, [&] {
+        isSilent = mixIsSilent(floatOutput, NUM_SAMPLES);
+    });
+    QVERIFY(isSilent);
+}
+
+void AudioMixKernelsBenchmark::convertToInt16() {
+    mixConvertToInt16(floatInput, int16Output, NUM_SAMPLES);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        float x = std::min(std::max(floatInput[i], -32768.0f), 32767.0f);
+        QCOMPARE(int16Output[i], (int16_t)lrintf(x));
+    }
+
+    report("mixConvertToInt16", NUM_SAMPLES, [] {
+        mixConvertToInt16(floatInput, int16Output, NUM_SAMPLES);
+    });
+}
+
+void AudioMixKernelsBenchmark::oddLengths() {
+    // lengths that leave a scalar tail after every vector width, from a misaligned start
+    const int LENGTHS[] = { 1, 3, 5, 7, 9, 15, 17, 23, 31, 33, NUM_FRAMES - 1 };
+    const float GAIN = 0.5f;
+    const float GUARD = 7.0f;
+
+    const float* input = &floatInput[1];
+    const int16_t* input16 = &int16Input[1];
+
+    for (int length : LENGTHS) {
+        // one guard sample past the end, which must be left alone
+        std::vector<float> output(2 * length + 1, 0.0f);
+
+        output[length] = GUARD;
+        mixAccumulate(input, output.data(), length);
+        for (int i = 0; i < length; i++) {
+            QCOMPARE(output[i], input[i]);
+        }
+        QCOMPARE(output[length], GUARD);
+
+        std::fill(output.begin(), output.end(), 0.0f);
+        output[length] = GUARD;
+        mixAccumulateInt16(input16, output.data(), GAIN, length);
+        for (int i = 0; i < length; i++) {
+            QCOMPARE(output[i], (float)input16[i] * (GAIN / AudioConstants::MAX_SAMPLE_VALUE));
+        }
+        QCOMPARE(output[length], GUARD);
+
+        std::fill(output.begin(), output.end(), 0.0f);
+        output[2 * length] = GUARD;
+        mixAccumulateInt16MonoToStereo(input16, output.data(), GAIN, length);
+        for (int i = 0; i < length; i++) {
+            float expected = (float)input16[i] * (GAIN / AudioConstants::MAX_SAMPLE_VALUE);
+            QCOMPARE(output[2*i+0], expected);
+            QCOMPARE(output[2*i+1], expected);
+        }
+        QCOMPARE(output[2 * length], GUARD);
+
+        std::fill(output.begin(), output.end(), 0.0f);
+        output[length] = GUARD;
+        QVERIFY(mixIsSilent(output.data(), length));
+        output[length - 1] = 1e-30f;
+        QVERIFY(!mixIsSilent(output.data(), length));
+
+        std::vector<int16_t> output16(length + 1, 0);
+        output16[length] = 12345;
+        mixConvertToInt16(input, output16.data(), length);
+        for (int i = 0; i < length; i++) {
+            float x = std::min(std::max(input[i], -32768.0f), 32767.0f);
+            QCOMPARE(output16[i], (int16_t)lrintf(x));
+        }
+        QCOMPARE(output16[length], (int16_t)12345);
+    }
+}
+
+void AudioMixKernelsBenchmark::convertOutOfRange() {
+    // past the int32_t range, where an unclamped conversion gives 0x80000000
+    const float INF = std::numeric_limits<float>::infinity();
+    const float VALUES[] = { 1e10f, -1e10f, INF, -INF, 3e9f, -3e9f, 32767.6f, -32768.6f };
+    const int NUM_VALUES = sizeof(VALUES) / sizeof(VALUES[0]);
+
+    float input[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        input[i] = VALUES[i % NUM_VALUES];
+    }
+
+    // the whole buffer through the vector path, and an odd length through the tail
+    for (int length : { NUM_SAMPLES, 37 }) {
+        mixConvertToInt16(input, int16Output, length);
+        for (int i = 0; i < length; i++) {
+            QCOMPARE(int16Output[i], (int16_t)(input[i] > 0.0f ? 32767 : -32768));
+        }
+    }
+}
@@ -0,0 +1,37 @@
+//
+//  AudioMixKernelsBenchmark.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsBenchmark_h
+#define hifi_AudioMixKernelsBenchmark_h
+
+#include <functional>
+
+#include <QtTest/QtTest>
+
+class AudioMixKernelsBenchmark : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void accumulate();
+    void accumulateInt16();
+    void accumulateInt16MonoToStereo();
+    void isSilent();
+    void convertToInt16();
+
+    void oddLengths();
+    void convertOutOfRange();
+
+private:
+    // runs kernel over the benchmark buffers, and logs its throughput
+    void report(const char* name, int samplesPerCall, std::function<void()> kernel);
+};
+
+#endif // hifi_AudioMixKernelsBenchmark_h
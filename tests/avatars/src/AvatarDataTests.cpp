@@ -0,0 +1,180 @@
+//
+//  AvatarDataTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataTests.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+#include <BitPacking.h>
+#include <HeadData.h>
+#include <NumericalConstants.h>
+
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(AvatarDataTests)
+
+// the layout of the quantized joint stream, see AvatarDataPacket::QuantizedJointData
+enum JointMode { Unchanged = 0, Absolute, Delta, SmallDelta };
+static const int MODE_BITS = 2;
+
+// the receiver decodes exactly what the sender recorded as sent, allowing only for float noise
+static const float EXACT = 1.0e-5f;
+
+// a joint can be off from what was set by about one step of the coarsest encoding
+static const float MAX_ROTATION_ERROR = 1.0e-3f;
+static const float MAX_TRANSLATION_ERROR = 1.0e-3f;
+
+static const int NUM_JOINTS = 4;
+static const int BUFFER_SIZE = 1024;
+
+class TestAvatarData : public AvatarData {
+public:
+    TestAvatarData() { _headData = new HeadData(this); }
+};
+
+// the rotation and translation modes of each joint in a packed quantized joint section
+static std::vector<std::pair<int, int>> readJointModes(const unsigned char* section) {
+    int numJoints = section[0];
+    int rotationBits = section[1];
+    uint16_t numStreamBytes;
+    memcpy(&numStreamBytes, section + 2, sizeof(numStreamBytes));
+
+    BitReader reader(section + AvatarDataPacket::QUANTIZED_JOINT_DATA_HEADER_SIZE, numStreamBytes);
+    const int rotationPayloadBits[] = { 0, 2 + 3 * rotationBits, 3 * (rotationBits - 3), 3 * (rotationBits - 6) };
+    const int translationPayloadBits[] = { 0, 3 * 16, 3 * 8, 3 * 4 };
+
+    std::vector<std::pair<int, int>> modes;
+    for (int i = 0; i < numJoints; i++) {
+        int rotationMode = (int)reader.read(MODE_BITS);
+        for (int bits = rotationPayloadBits[rotationMode]; bits > 0; bits -= 16) {
+            reader.read(std::min(bits, 16));
+        }
+        int translationMode = (int)reader.read(MODE_BITS);
+        for (int bits = translationPayloadBits[translationMode]; bits > 0; bits -= 16) {
+            reader.read(std::min(bits, 16));
+        }
+        modes.push_back({ rotationMode, translationMode });
+    }
+    return modes;
+}
+
+static void compareJoints(const QVector<JointData>& joints, const QVector<JointData>& expected, float maxRotationError,
+                          float maxTranslationError) {
+    QCOMPARE(joints.size(), expected.size());
+    for (int i = 0; i < joints.size(); i++) {
+        QCOMPARE(joints[i].rotationSet, expected[i].rotationSet);
+        QCOMPARE(joints[i].translationSet, expected[i].translationSet);
+        QVERIFY(1.0f - fabsf(glm::dot(joints[i].rotation, expected[i].rotation)) <= maxRotationError);
+        QCOMPARE_WITH_ABS_ERROR(joints[i].translation.x, expected[i].translation.x, maxTranslationError);
+        QCOMPARE_WITH_ABS_ERROR(joints[i].translation.y, expected[i].translation.y, maxTranslationError);
+        QCOMPARE_WITH_ABS_ERROR(joints[i].translation.z, expected[i].translation.z, maxTranslationError);
+    }
+}
+
+static QVector<JointData> makeJoints() {
+    QVector<JointData> joints(NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        joints[i].rotation = glm::angleAxis(0.3f * (i + 1), glm::normalize(glm::vec3(1.0f, 2.0f, (float)i)));
+        joints[i].rotationSet = true;
+        joints[i].translation = glm::vec3(0.25f, 0.5f * i, -0.125f);
+        joints[i].translationSet = true;
+    }
+    return joints;
+}
+
+static QByteArray pack(const AvatarData& avatar, AvatarData::AvatarDataDetail dataDetail,
+                       const QVector<JointData>& lastSentJointData, QVector<JointData>* sentJointDataOut) {
+    AvatarDataPacket::HasFlags hasFlags;
+    return avatar.toByteArray(dataDetail, 0, lastSentJointData, hasFlags, false, false, glm::vec3(0.0f),
+                              sentJointDataOut, nullptr, true);
+}
+
+void AvatarDataTests::testQuantizedJointRoundTrip() {
+    TestAvatarData sender;
+    TestAvatarData receiver;
+    QVector<JointData> joints = makeJoints();
+    sender.setRawJointData(joints);
+
+    // a full update sends every joint absolute
+    QVector<JointData> sent;
+    unsigned char section[BUFFER_SIZE];
+    sender.packJointData(section, BUFFER_SIZE, true, false, sent, false, glm::vec3(0.0f), nullptr, true);
+    for (auto& modes : readJointModes(section)) {
+        QCOMPARE(modes.first, (int)Absolute);
+        QCOMPARE(modes.second, (int)Absolute);
+    }
+
+    receiver.parseDataFromBuffer(pack(sender, AvatarData::SendAllData, sent, &sent));
+    compareJoints(receiver.getRawJointData(), sent, EXACT, EXACT);
+    compareJoints(receiver.getRawJointData(), joints, MAX_ROTATION_ERROR, MAX_TRANSLATION_ERROR);
+
+    // then a large, a medium and a small change, and a joint left as it was sent
+    joints[0].rotation = joints[0].rotation * glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f));
+    joints[0].translation += glm::vec3(1.0f, 0.0f, 0.0f);
+    joints[1].rotation = joints[1].rotation * glm::angleAxis(glm::radians(5.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    joints[1].translation += glm::vec3(0.0f, 0.01f, 0.0f);
+    joints[2].rotation = joints[2].rotation * glm::angleAxis(glm::radians(0.5f), glm::vec3(0.0f, 0.0f, 1.0f));
+    joints[2].translation += glm::vec3(0.0f, 0.0f, 0.001f);
+    joints[3] = sent[3];
+    sender.setRawJointData(joints);
+
+    sender.packJointData(section, BUFFER_SIZE, false, false, sent, false, glm::vec3(0.0f), nullptr, true);
+    auto modes = readJointModes(section);
+    QCOMPARE((int)modes.size(), NUM_JOINTS);
+    QCOMPARE(modes[0].first, (int)Absolute);
+    QCOMPARE(modes[0].second, (int)Absolute);
+    QCOMPARE(modes[1].first, (int)Delta);
+    QCOMPARE(modes[1].second, (int)Delta);
+    QCOMPARE(modes[2].first, (int)SmallDelta);
+    QCOMPARE(modes[2].second, (int)SmallDelta);
+    QCOMPARE(modes[3].first, (int)Unchanged);
+    QCOMPARE(modes[3].second, (int)Unchanged);
+
+    receiver.parseDataFromBuffer(pack(sender, AvatarData::IncludeSmallData, sent, &sent));
+    compareJoints(receiver.getRawJointData(), sent, EXACT, EXACT);
+    compareJoints(receiver.getRawJointData(), joints, MAX_ROTATION_ERROR, MAX_TRANSLATION_ERROR);
+}
+
+void AvatarDataTests::testQuantizedJointOverflow() {
+    TestAvatarData sender;
+    QVector<JointData> joints = makeJoints();
+    sender.setRawJointData(joints);
+
+    QVector<JointData> lastSent;
+    pack(sender, AvatarData::SendAllData, lastSent, &lastSent);
+
+    for (auto& joint : joints) {
+        joint.rotation = joint.rotation * glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f));
+        joint.translation += glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+    sender.setRawJointData(joints);
+
+    // room for the header, the faux joints and the joint modes, but not for the changes
+    const int FAUX_JOINTS_SIZE = 24;
+    const int maxSize = (int)AvatarDataPacket::QUANTIZED_JOINT_DATA_HEADER_SIZE + FAUX_JOINTS_SIZE +
+        NUM_JOINTS * 2 * MODE_BITS / 8;
+
+    unsigned char section[BUFFER_SIZE];
+    QVector<JointData> sent = lastSent;
+    int size = sender.packJointData(section, maxSize, false, false, lastSent, false, glm::vec3(0.0f), &sent, true);
+    QVERIFY(size <= maxSize);
+
+    // every joint goes out unchanged, and the sent joints still predict from what the receiver has
+    for (auto& modes : readJointModes(section)) {
+        QCOMPARE(modes.first, (int)Unchanged);
+        QCOMPARE(modes.second, (int)Unchanged);
+    }
+    compareJoints(sent, lastSent, EXACT, EXACT);
+}
@@ -0,0 +1,23 @@
+//
+//  AvatarDataTests.h
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataTests_h
+#define hifi_AvatarDataTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarDataTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testQuantizedJointRoundTrip();
+    void testQuantizedJointOverflow();
+};
+
+#endif // hifi_AvatarDataTests_h
@@ -0,0 +1,146 @@
+//
+//  LimitedNodeListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LimitedNodeListTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <NodeList.h>
+
+QTEST_MAIN(LimitedNodeListTests)
+
+static SharedNodePointer addNode(LimitedNodeList& nodeList) {
+    return nodeList.addOrUpdateNode(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr());
+}
+
+size_t LimitedNodeListTests::numNodeSnapshots(LimitedNodeList& nodeList) {
+    std::lock_guard<std::mutex> lock { nodeList._nodeSnapshotMutex };
+    return nodeList._nodeSnapshots.size();
+}
+
+void LimitedNodeListTests::initTestCase() {
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityLimitedNodeListTests)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned, INVALID_PORT);
+}
+
+void LimitedNodeListTests::concurrentReadTest() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->eraseAllNodes();
+
+    // a few nodes are always there, the others come and go
+    const int NUM_STABLE_NODES = 4;
+    std::vector<SharedNodePointer> stableNodes;
+    for (int i = 0; i < NUM_STABLE_NODES; ++i) {
+        stableNodes.push_back(addNode(*nodeList));
+    }
+
+    std::atomic<bool> isDone { false };
+    std::atomic<int> numErrors { 0 };
+    std::atomic<int> numReads { 0 };
+
+    const int NUM_READERS = 4;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; ++i) {
+        readers.emplace_back([&] {
+            while (!isDone) {
+                int numNodes = 0;
+                int numStableNodesSeen = 0;
+                nodeList->eachNode([&](const SharedNodePointer& node) {
+                    ++numNodes;
+                    if (!node) {
+                        ++numErrors;
+                        return;
+                    }
+                    if (std::find(stableNodes.begin(), stableNodes.end(), node) != stableNodes.end()) {
+                        ++numStableNodesSeen;
+                    }
+
+                    // nested reads go through their own snapshot
+                    auto sameNode = nodeList->nodeWithUUID(node->getUUID());
+                    if (sameNode && sameNode != node) {
+                        ++numErrors;
+                    }
+                });
+
+                if (numStableNodesSeen != NUM_STABLE_NODES || numNodes < NUM_STABLE_NODES) {
+                    ++numErrors;
+                }
+                ++numReads;
+            }
+        });
+    }
+
+    const int NUM_CHANGES = 2000;
+    std::vector<SharedNodePointer> transientNodes;
+    for (int i = 0; i < NUM_CHANGES; ++i) {
+        if (transientNodes.size() < 8 && (i % 3 != 0 || transientNodes.empty())) {
+            transientNodes.push_back(addNode(*nodeList));
+        } else {
+            nodeList->killNodeWithUUID(transientNodes.back()->getUUID());
+            transientNodes.pop_back();
+        }
+    }
+
+    isDone = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(numErrors.load(), 0);
+    QVERIFY(numReads.load() > 0);
+    QCOMPARE((int)nodeList->size(), NUM_STABLE_NODES + (int)transientNodes.size());
+
+    // with every reader gone only the current snapshot is left
+    nodeList->size();
+    QCOMPARE((int)numNodeSnapshots(*nodeList), 1);
+
+    nodeList->eraseAllNodes();
+}
+
+void LimitedNodeListTests::readerFreesReplacedSnapshotTest() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->eraseAllNodes();
+
+    auto node = addNode(*nodeList);
+    QUuid nodeID = node->getUUID();
+    node.reset();
+    QCOMPARE((int)numNodeSnapshots(*nodeList), 1);
+
+    std::promise<void> readerEntered;
+    std::promise<void> nodeKilled;
+    auto nodeKilledFuture = nodeKilled.get_future().share();
+
+    std::thread reader([&] {
+        nodeList->eachNode([&](const SharedNodePointer&) {
+            readerEntered.set_value();
+            nodeKilledFuture.wait();
+        });
+    });
+
+    readerEntered.get_future().wait();
+    QVERIFY(nodeList->killNodeWithUUID(nodeID));
+
+    // the reader still has the snapshot with the killed node
+    QCOMPARE((int)numNodeSnapshots(*nodeList), 2);
+    QVERIFY(!nodeList->nodeWithUUID(nodeID));
+
+    nodeKilled.set_value();
+    reader.join();
+
+    // and freed it on its way out, with no add or remove since
+    QCOMPARE((int)numNodeSnapshots(*nodeList), 1);
+}
@@ -0,0 +1,33 @@
+//
+//  LimitedNodeListTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LimitedNodeListTests_h
+#define hifi_LimitedNodeListTests_h
+
+#include <QtTest/QtTest>
+
+class LimitedNodeList;
+
+class LimitedNodeListTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that readers on other threads always see a consistent node set while nodes are added and killed
+    void concurrentReadTest();
+
+    // Test that a snapshot replaced while it is being read is freed when the reader is done, without another publish
+    void readerFreesReplacedSnapshotTest();
+
+private:
+    size_t numNodeSnapshots(LimitedNodeList& nodeList);
+};
+
+#endif // hifi_LimitedNodeListTests_h
@@ -0,0 +1,203 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include <udt/LossList.h>
+#include <udt/SentPacketBuffer.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+// enough packets to cover a large entity download at full rate
+static const int NUM_BENCHMARK_PACKETS = 100000;
+static const int LOSS_PERCENT = 5;
+
+static SequenceNumber sequenceNumberAt(SequenceNumber::Type base, int offset) {
+    return SequenceNumber(base) + offset;
+}
+
+static bool lossListMatches(LossList& lossList, const std::set<int>& expected, SequenceNumber::Type base) {
+    if (lossList.getLength() != (int)expected.size()) {
+        return false;
+    }
+
+    // pop everything off a copy to compare the contents in order
+    LossList copy = lossList;
+    for (auto offset : expected) {
+        if (copy.popFirstSequenceNumber() != sequenceNumberAt(base, offset)) {
+            return false;
+        }
+    }
+    return copy.isEmpty();
+}
+
+void LossListTests::insertRemoveTest() {
+    std::mt19937 generator(1);
+
+    // run once in the middle of the sequence space and once straddling the wrap back to 0
+    for (auto base : { SequenceNumber::Type(1000), SequenceNumber::Type(SequenceNumber::MAX - 500) }) {
+        LossList lossList;
+        std::set<int> expected;
+
+        for (int i = 0; i < 2000; ++i) {
+            int start = generator() % 1000;
+            int end = start + generator() % 20;
+
+            switch (generator() % 4) {
+                case 0:
+                    lossList.insert(sequenceNumberAt(base, start), sequenceNumberAt(base, end));
+                    for (int offset = start; offset <= end; ++offset) {
+                        expected.insert(offset);
+                    }
+                    break;
+                case 1:
+                    QCOMPARE(lossList.remove(sequenceNumberAt(base, start)), expected.erase(start) > 0);
+                    break;
+                case 2:
+                    lossList.remove(sequenceNumberAt(base, start), sequenceNumberAt(base, end));
+                    for (int offset = start; offset <= end; ++offset) {
+                        expected.erase(offset);
+                    }
+                    break;
+                default:
+                    if (!expected.empty()) {
+                        QCOMPARE(lossList.popFirstSequenceNumber(), sequenceNumberAt(base, *expected.begin()));
+                        expected.erase(expected.begin());
+                    }
+                    break;
+            }
+
+            QCOMPARE(lossList.getLength(), (int)expected.size());
+        }
+
+        QVERIFY(lossListMatches(lossList, expected, base));
+    }
+}
+
+void LossListTests::sentPacketBufferTest() {
+    auto base = SequenceNumber::Type(SequenceNumber::MAX - 100);
+    SentPacketBuffer buffer;
+
+    for (int i = 0; i < 300; ++i) {
+        buffer.push(sequenceNumberAt(base, i), Packet::create());
+    }
+    QCOMPARE(buffer.size(), 300);
+
+    auto entry = buffer.find(sequenceNumberAt(base, 150));
+    QVERIFY(entry && entry->packet);
+    QCOMPARE(entry->resendCount, (uint8_t)0);
+
+    // ACK past the wrap point
+    buffer.acknowledge(sequenceNumberAt(base, 149));
+    QCOMPARE(buffer.size(), 150);
+    QVERIFY(!buffer.find(sequenceNumberAt(base, 149)));
+    QVERIFY(buffer.find(sequenceNumberAt(base, 150)));
+    QVERIFY(buffer.find(sequenceNumberAt(base, 299)));
+    QVERIFY(!buffer.find(sequenceNumberAt(base, 300)));
+
+    // a stale ACK changes nothing
+    buffer.acknowledge(sequenceNumberAt(base, 10));
+    QCOMPARE(buffer.size(), 150);
+
+    buffer.acknowledge(sequenceNumberAt(base, 299));
+    QVERIFY(buffer.isEmpty());
+}
+
+void LossListTests::randomLossBenchmark() {
+    std::mt19937 generator(2);
+    std::vector<int> lost;
+    for (int i = 0; i < NUM_BENCHMARK_PACKETS; ++i) {
+        if ((int)(generator() % 100) < LOSS_PERCENT) {
+            lost.push_back(i);
+        }
+    }
+
+    // recover the losses in a different order than they were detected
+    auto recovered = lost;
+    std::shuffle(recovered.begin(), recovered.end(), generator);
+
+    auto base = SequenceNumber::Type(SequenceNumber::MAX - NUM_BENCHMARK_PACKETS / 2);
+
+    QBENCHMARK {
+        LossList lossList;
+        for (auto offset : lost) {
+            lossList.append(sequenceNumberAt(base, offset));
+        }
+        for (auto offset : recovered) {
+            lossList.remove(sequenceNumberAt(base, offset));
+        }
+        QVERIFY(lossList.isEmpty());
+    }
+}
+
+void LossListTests::burstLossBenchmark() {
+    static const int MAX_BURST_LENGTH = 64;
+
+    std::mt19937 generator(3);
+    std::vector<std::pair<int, int>> bursts;
+    for (int i = 0; i < NUM_BENCHMARK_PACKETS; ) {
+        if ((int)(generator() % 100) < LOSS_PERCENT) {
+            int length = 1 + generator() % MAX_BURST_LENGTH;
+            bursts.emplace_back(i, i + length - 1);
+            i += length + 1;
+        } else {
+            i += 1 + generator() % MAX_BURST_LENGTH;
+        }
+    }
+
+    // NAKs for the bursts arrive out of order on the sender, which then re-sends from the front
+    std::shuffle(bursts.begin(), bursts.end(), generator);
+
+    auto base = SequenceNumber::Type(SequenceNumber::MAX - NUM_BENCHMARK_PACKETS / 2);
+
+    QBENCHMARK {
+        LossList lossList;
+        for (const auto& burst : bursts) {
+            lossList.insert(sequenceNumberAt(base, burst.first), sequenceNumberAt(base, burst.second));
+        }
+        while (!lossList.isEmpty()) {
+            lossList.popFirstSequenceNumber();
+        }
+    }
+}
+
+void LossListTests::sentPacketBufferBenchmark() {
+    static const int FLOW_WINDOW_SIZE = 4096;
+
+    std::mt19937 generator(4);
+
+    auto base = SequenceNumber::Type(SequenceNumber::MAX - NUM_BENCHMARK_PACKETS / 2);
+
+    QBENCHMARK {
+        SentPacketBuffer buffer;
+        int lastACK = -1;
+        for (int i = 0; i < NUM_BENCHMARK_PACKETS; ++i) {
+            buffer.push(sequenceNumberAt(base, i), Packet::create());
+
+            if ((int)(generator() % 100) < LOSS_PERCENT) {
+                auto entry = buffer.find(sequenceNumberAt(base, lastACK + 1 + generator() % (i - lastACK)));
+                QVERIFY(entry);
+                ++entry->resendCount;
+            }
+
+            // ACK once the window fills up
+            if (i - lastACK >= FLOW_WINDOW_SIZE) {
+                lastACK = i - FLOW_WINDOW_SIZE / 2;
+                buffer.acknowledge(sequenceNumberAt(base, lastACK));
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that inserts and removals match a plain set of sequence numbers, including across the wrap point
+    void insertRemoveTest();
+
+    // Test that the sent packet buffer finds and drops packets like the map it replaces
+    void sentPacketBufferTest();
+
+    // Benchmark receiving 5% uniformly random loss on a long transfer and clearing it as packets are recovered
+    void randomLossBenchmark();
+
+    // Benchmark bursty loss where whole runs of packets go missing and are NAKed out of order
+    void burstLossBenchmark();
+
+    // Benchmark sending through the sent packet buffer with 5% of packets re-sent before their ACK
+    void sentPacketBufferBenchmark();
+};
+
+#endif // hifi_LossListTests_h
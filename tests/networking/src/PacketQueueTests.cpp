@@ -0,0 +1,174 @@
+//
+//  PacketQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketQueueTests.h"
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <udt/PacketList.h>
+#include <udt/PacketQueue.h>
+
+QTEST_MAIN(PacketQueueTests)
+
+using namespace udt;
+
+static const int CHUNK_SIZE = 4000;
+
+static QByteArray chunkData(int index) {
+    return QByteArray(CHUNK_SIZE, (char)('a' + index % 26));
+}
+
+static std::unique_ptr<PacketList> createStreamedList(int numChunks, int numChunksRead) {
+    auto packetList = PacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    packetList->write("head");
+
+    auto nextChunk = std::make_shared<int>(0);
+    packetList->setStreamSource([=](PacketList& packetList) {
+        if (*nextChunk == numChunksRead) {
+            // the read failed, end the message here
+            return false;
+        }
+        packetList.write(chunkData((*nextChunk)++));
+        return *nextChunk < numChunks;
+    });
+
+    return packetList;
+}
+
+struct TakenMessage {
+    std::vector<std::unique_ptr<Packet>> packets;
+    QByteArray data;
+};
+
+using TakenMessages = std::map<Packet::MessageNumber, TakenMessage>;
+
+// takes every packet from the queue, sorted by message, checking the part numbers as it goes
+// (order gets the message number of each packet taken, or -1 for one from the main channel)
+static void takeAll(PacketQueue& queue, TakenMessages& messages, std::vector<int>& order) {
+    while (!queue.isEmpty()) {
+        auto packet = queue.takePacket();
+        if (!packet) {
+            break;
+        }
+
+        if (!packet->isPartOfMessage()) {
+            order.push_back(-1);
+            continue;
+        }
+
+        auto& message = messages[packet->getMessageNumber()];
+        order.push_back(packet->getMessageNumber());
+        QCOMPARE((int)packet->getMessagePartNumber(), (int)message.packets.size());
+        message.data.append(packet->getPayload(), packet->getPayloadSize());
+        message.packets.push_back(std::move(packet));
+    }
+}
+
+static void verifyPositions(const TakenMessage& message) {
+    QVERIFY(message.packets.size() > 2);
+    QCOMPARE((int)message.packets.front()->getPacketPosition(), (int)Packet::PacketPosition::FIRST);
+    for (size_t i = 1; i < message.packets.size() - 1; ++i) {
+        QCOMPARE((int)message.packets[i]->getPacketPosition(), (int)Packet::PacketPosition::MIDDLE);
+    }
+    QCOMPARE((int)message.packets.back()->getPacketPosition(), (int)Packet::PacketPosition::LAST);
+}
+
+void PacketQueueTests::streamedOrderTest() {
+    const int NUM_CHUNKS = 100;
+
+    PacketQueue queue;
+    queue.queuePacketList(createStreamedList(NUM_CHUNKS, NUM_CHUNKS));
+
+    const int NUM_UNRELIABLE = 20;
+    for (int i = 0; i < NUM_UNRELIABLE; ++i) {
+        queue.queuePacket(Packet::create());
+    }
+
+    TakenMessages messages;
+    std::vector<int> order;
+    takeAll(queue, messages, order);
+    QCOMPARE((int)messages.size(), 1);
+
+    auto& message = messages.begin()->second;
+    verifyPositions(message);
+
+    QByteArray expected = "head";
+    for (int i = 0; i < NUM_CHUNKS; ++i) {
+        expected.append(chunkData(i));
+    }
+    QCOMPARE(message.data, expected);
+
+    // the main channel isn't held up until the stream is done
+    QCOMPARE((int)std::count(order.begin(), order.end(), -1), NUM_UNRELIABLE);
+    QVERIFY(order.back() != -1);
+}
+
+void PacketQueueTests::streamedReadFailureTest() {
+    const int NUM_CHUNKS = 100;
+    const int NUM_CHUNKS_READ = 60;
+
+    PacketQueue queue;
+    queue.queuePacketList(createStreamedList(NUM_CHUNKS, NUM_CHUNKS_READ));
+
+    TakenMessages messages;
+    std::vector<int> order;
+    takeAll(queue, messages, order);
+    QCOMPARE((int)messages.size(), 1);
+    QVERIFY(queue.isEmpty());
+
+    auto& message = messages.begin()->second;
+    verifyPositions(message);
+
+    // what was read and no padding in place of the rest
+    QByteArray expected = "head";
+    for (int i = 0; i < NUM_CHUNKS_READ; ++i) {
+        expected.append(chunkData(i));
+    }
+    QCOMPARE(message.data, expected);
+}
+
+void PacketQueueTests::queueWhileStreamingTest() {
+    PacketQueue queue;
+
+    std::promise<void> sourceEntered;
+    std::promise<void> packetQueued;
+    auto packetQueuedFuture = packetQueued.get_future().share();
+
+    auto packetList = PacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    packetList->setStreamSource([&](PacketList& packetList) {
+        sourceEntered.set_value();
+
+        // a slow read, which must not keep other threads from queueing packets
+        bool wasQueued = packetQueuedFuture.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        packetList.write(wasQueued ? "queued" : "blocked");
+        return false;
+    });
+    queue.queuePacketList(std::move(packetList));
+
+    std::thread queueingThread([&] {
+        sourceEntered.get_future().wait();
+        queue.queuePacket(Packet::create());
+        packetQueued.set_value();
+    });
+
+    TakenMessages messages;
+    std::vector<int> order;
+    takeAll(queue, messages, order);
+    queueingThread.join();
+
+    QCOMPARE((int)messages.size(), 1);
+    QCOMPARE(messages.begin()->second.data, QByteArray("queued"));
+    QCOMPARE((int)messages.begin()->second.packets.front()->getPacketPosition(), (int)Packet::PacketPosition::ONLY);
+}
@@ -0,0 +1,29 @@
+//
+//  PacketQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketQueueTests_h
+#define hifi_PacketQueueTests_h
+
+#include <QtTest/QtTest>
+
+class PacketQueueTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a streamed list comes out whole and in order, interleaved with the main channel
+    void streamedOrderTest();
+
+    // Test that a source ending early closes the message with what it wrote, and nothing more
+    void streamedReadFailureTest();
+
+    // Test that packets can be queued while a streamed list is being pulled from its source
+    void queueWhileStreamingTest();
+};
+
+#endif // hifi_PacketQueueTests_h
@@ -0,0 +1,153 @@
+//
+//  PacketReceiverTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketReceiverTests.h"
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <NLPacket.h>
+#include <NodeList.h>
+#include <PacketReceiver.h>
+
+QTEST_MAIN(PacketReceiverTests)
+
+// a non-sourced type, so that delivery doesn't depend on the sending node
+static const PacketType TEST_PACKET_TYPE = PacketType::ICEPing;
+
+class TestListener : public QObject {
+    Q_OBJECT
+public:
+    std::mutex mutex;
+    std::vector<int> received;
+    std::vector<QThread*> threads;
+
+    // when set, the slot waits for it before returning
+    std::shared_future<void> release;
+    std::promise<void> entered;
+    bool hasEntered { false };
+
+public slots:
+    void handleMessage(QSharedPointer<ReceivedMessage> message) {
+        int sequence;
+        message->readPrimitive(&sequence);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            received.push_back(sequence);
+            threads.push_back(QThread::currentThread());
+        }
+
+        if (release.valid()) {
+            if (!hasEntered) {
+                hasEntered = true;
+                entered.set_value();
+            }
+            release.wait();
+        }
+    }
+};
+
+static void receive(PacketReceiver& receiver, int sequence) {
+    auto packet = NLPacket::create(TEST_PACKET_TYPE);
+    packet->writePrimitive(sequence);
+
+    // go through the bytes, like a packet off of the socket
+    auto size = packet->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), packet->getData(), size);
+    receiver.handleVerifiedPacket(udt::Packet::fromReceivedPacket(std::move(data), size, HifiSockAddr()));
+}
+
+static int numReceived(TestListener& listener) {
+    std::lock_guard<std::mutex> lock(listener.mutex);
+    return (int)listener.received.size();
+}
+
+void PacketReceiverTests::initTestCase() {
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityPacketReceiverTests)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned, INVALID_PORT);
+}
+
+void PacketReceiverTests::workerQueueTest() {
+    PacketReceiver receiver;
+    TestListener listener;
+    QVERIFY(receiver.registerListener(TEST_PACKET_TYPE, &listener, "handleMessage"));
+    receiver.setWorkerQueueForTypes({ TEST_PACKET_TYPE }, "Test");
+
+    const int NUM_MESSAGES = 100;
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        receive(receiver, i);
+    }
+
+    QTRY_COMPARE(numReceived(listener), NUM_MESSAGES);
+
+    std::lock_guard<std::mutex> lock(listener.mutex);
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        QCOMPARE(listener.received[i], i);
+        QVERIFY(listener.threads[i] != QThread::currentThread());
+        QCOMPARE(listener.threads[i], listener.threads.front());
+    }
+}
+
+void PacketReceiverTests::unregisterWaitsTest() {
+    PacketReceiver receiver;
+    TestListener listener;
+    QVERIFY(receiver.registerListener(TEST_PACKET_TYPE, &listener, "handleMessage"));
+    receiver.setWorkerQueueForTypes({ TEST_PACKET_TYPE }, "Test");
+
+    std::promise<void> release;
+    listener.release = release.get_future().share();
+    auto entered = listener.entered.get_future();
+
+    // the first message blocks the worker, the others queue up behind it
+    const int NUM_MESSAGES = 5;
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        receive(receiver, i);
+    }
+    entered.wait();
+
+    auto unregistered = std::async(std::launch::async, [&] {
+        receiver.unregisterListener(&listener);
+    });
+    QVERIFY(unregistered.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+
+    release.set_value();
+    QVERIFY(unregistered.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+    // nothing is delivered once unregisterListener returned
+    receive(receiver, NUM_MESSAGES);
+    QTest::qWait(100);
+    QCOMPARE(numReceived(listener), 1);
+}
+
+void PacketReceiverTests::replacedListenerFreedTest() {
+    PacketReceiver receiver;
+    TestListener first;
+    TestListener second;
+
+    QVERIFY(receiver.registerListener(TEST_PACKET_TYPE, &first, "handleMessage"));
+    QVERIFY(receiver.registerListener(TEST_PACKET_TYPE, &second, "handleMessage"));
+    QCOMPARE((int)receiver._listeners.size(), 2);
+
+    // the next message frees the replaced one
+    receive(receiver, 0);
+    QCOMPARE((int)receiver._listeners.size(), 1);
+
+    QTRY_COMPARE(numReceived(second), 1);
+    QCOMPARE(numReceived(first), 0);
+}
+
+#include "PacketReceiverTests.moc"
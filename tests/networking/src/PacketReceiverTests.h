@@ -0,0 +1,31 @@
+//
+//  PacketReceiverTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketReceiverTests_h
+#define hifi_PacketReceiverTests_h
+
+#include <QtTest/QtTest>
+
+class PacketReceiverTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test that messages of a type with a worker queue are delivered in order on one other thread
+    void workerQueueTest();
+
+    // Test that unregisterListener waits for a slot running on a worker, and that queued messages are dropped
+    void unregisterWaitsTest();
+
+    // Test that a replaced listener is freed once nothing is queued for it
+    void replacedListenerFreedTest();
+};
+
+#endif // hifi_PacketReceiverTests_h
@@ -180,3 +180,24 @@ void PacketTests::primitiveTest() {
     QCOMPARE(recvPacket->peekPrimitive(&noValue), 0);
     QCOMPARE(recvPacket->readPrimitive(&noValue), 0);
 }
+
+void PacketTests::verificationHashTest() {
+    auto packet = NLPacket::create(PacketType::AvatarData);
+    QByteArray payload("avatar data payload");
+    packet->write(payload);
+
+    QUuid connectionSecret = QUuid::createUuid();
+    packet->writeSourceID(QUuid::createUuid());
+    packet->writeVerificationHashGivenSecret(connectionSecret);
+
+    auto verificationKey = NLPacket::verificationKeyForSecret(connectionSecret);
+    QVERIFY(NLPacket::verificationHashMatches(*packet, connectionSecret, verificationKey));
+
+    QUuid otherSecret = QUuid::createUuid();
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, otherSecret, NLPacket::verificationKeyForSecret(otherSecret)));
+
+    // flip a payload byte after hashing
+    auto readPacket = copyToReadPacket(packet);
+    readPacket->getData()[readPacket->getDataSize() - 1] ^= 0x1;
+    QVERIFY(!NLPacket::verificationHashMatches(*readPacket, connectionSecret, verificationKey));
+}
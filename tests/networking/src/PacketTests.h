@@ -36,6 +36,9 @@ private slots:
 
     // Test set/get packet type
     void packetTypeTest();
+
+    // Test that verification hashes match for the writing secret and catch tampering
+    void verificationHashTest();
 };
 
 #endif // hifi_PacketTests_h
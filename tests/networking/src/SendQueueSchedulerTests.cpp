@@ -0,0 +1,165 @@
+//
+//  SendQueueSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendQueueSchedulerTests.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <udt/SendQueue.h>
+#include <udt/SendQueueScheduler.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(SendQueueSchedulerTests)
+
+using namespace udt;
+using Clock = p_high_resolution_clock;
+
+static const int NUM_THREADS = 2;
+
+// a task that asks to be run again after a fixed period, or much later if the period is zero
+class TestTask : public SendQueueScheduler::Task {
+public:
+    TestTask(std::chrono::microseconds period, std::chrono::microseconds runDuration = std::chrono::microseconds(0)) :
+        _period(period), _runDuration(runDuration) {}
+
+    virtual Clock::time_point run() override {
+        if (++_numRunning > 1) {
+            _wasRunConcurrently = true;
+        }
+
+        auto now = Clock::now();
+        if (now < _nextRunTime) {
+            _wasRunEarly = true;
+        }
+        if (_runDuration.count() > 0) {
+            std::this_thread::sleep_for(_runDuration);
+        }
+        _nextRunTime = _period.count() > 0 ? now + _period : now + std::chrono::seconds(10);
+        ++_numRuns;
+
+        --_numRunning;
+        return _nextRunTime;
+    }
+
+    virtual bool isStopped() const override { return _isStopped; }
+
+    std::atomic<int> _numRuns { 0 };
+    std::atomic<int> _numRunning { 0 };
+    std::atomic<bool> _isStopped { false };
+    std::atomic<bool> _wasRunEarly { false };
+    std::atomic<bool> _wasRunConcurrently { false };
+
+private:
+    std::chrono::microseconds _period;
+    std::chrono::microseconds _runDuration;
+    Clock::time_point _nextRunTime;
+};
+
+void SendQueueSchedulerTests::pacingTest() {
+    SendQueueScheduler scheduler(NUM_THREADS);
+    TestTask task(std::chrono::microseconds(500));
+    scheduler.add(&task);
+
+    const int TEST_MSECS = 200;
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_MSECS));
+    scheduler.remove(&task);
+
+    // allow for a loaded machine, but pacing has to be in the right ballpark
+    int expectedRuns = TEST_MSECS * 2;
+    QVERIFY(!task._wasRunEarly);
+    QVERIFY(task._numRuns > expectedRuns / 4);
+    QVERIFY(task._numRuns <= expectedRuns + 1);
+}
+
+void SendQueueSchedulerTests::wakeTest() {
+    SendQueueScheduler scheduler(NUM_THREADS);
+    TestTask task(std::chrono::microseconds(0));
+    scheduler.add(&task);
+
+    // the first run is right away, the next one would be much later
+    QTRY_COMPARE(task._numRuns.load(), 1);
+
+    scheduler.wake(&task);
+    QTRY_COMPARE_WITH_TIMEOUT(task._numRuns.load(), 2, 1000);
+
+    scheduler.remove(&task);
+}
+
+void SendQueueSchedulerTests::exclusiveRunTest() {
+    SendQueueScheduler scheduler(NUM_THREADS);
+
+    const int NUM_TASKS = 8 * NUM_THREADS;
+    std::vector<std::unique_ptr<TestTask>> tasks;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        tasks.emplace_back(new TestTask(std::chrono::microseconds(100 * (i + 1)), std::chrono::microseconds(50)));
+        scheduler.add(tasks.back().get());
+    }
+
+    // wakes race with the runs
+    for (int i = 0; i < 1000; ++i) {
+        scheduler.wake(tasks[i % NUM_TASKS].get());
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    for (auto& task : tasks) {
+        scheduler.remove(task.get());
+        QVERIFY(task->_numRuns > 0);
+        QVERIFY(!task->_wasRunConcurrently);
+    }
+}
+
+void SendQueueSchedulerTests::removeTest() {
+    SendQueueScheduler scheduler(NUM_THREADS);
+    TestTask task(std::chrono::microseconds(100), std::chrono::milliseconds(20));
+    scheduler.add(&task);
+
+    QTRY_VERIFY(task._numRunning > 0);
+    scheduler.remove(&task);
+    QCOMPARE(task._numRunning.load(), 0);
+
+    int numRuns = task._numRuns;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    QCOMPARE(task._numRuns.load(), numRuns);
+}
+
+void SendQueueSchedulerTests::stoppedTest() {
+    SendQueueScheduler scheduler(NUM_THREADS);
+    TestTask task(std::chrono::microseconds(100));
+    scheduler.add(&task);
+
+    QTRY_VERIFY(task._numRuns > 0);
+    task._isStopped = true;
+    scheduler.wake(&task);
+
+    // one more run sees the stop at most
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int numRuns = task._numRuns;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    QCOMPARE(task._numRuns.load(), numRuns);
+
+    scheduler.remove(&task);
+}
+
+void SendQueueSchedulerTests::sendQueueStopTest() {
+    Socket socket;
+    HifiSockAddr destination(QHostAddress::LocalHost, 1);
+
+    for (int i = 0; i < 100; ++i) {
+        auto queue = SendQueue::create(&socket, destination);
+        queue->stop();
+
+        // whether or not the scheduler got to it before the stop, it stays stopped
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        QCOMPARE(queue->getState(), SendQueue::State::Stopped);
+    }
+}
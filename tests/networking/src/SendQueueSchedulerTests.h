@@ -0,0 +1,38 @@
+//
+//  SendQueueSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendQueueSchedulerTests_h
+#define hifi_SendQueueSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class SendQueueSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a paced task is never run before the time it asked for, and keeps up with its pace
+    void pacingTest();
+
+    // Test that waking a task runs it right away instead of at the time it asked for
+    void wakeTest();
+
+    // Test that a task is never run by two threads at once, with more tasks than threads
+    void exclusiveRunTest();
+
+    // Test that remove() waits for a running task, and that it isn't run after
+    void removeTest();
+
+    // Test that a stopped task is dropped
+    void stoppedTest();
+
+    // Test that a SendQueue stopped before its first run never goes to running
+    void sendQueueStopTest();
+};
+
+#endif // hifi_SendQueueSchedulerTests_h
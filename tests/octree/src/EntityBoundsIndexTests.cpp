@@ -0,0 +1,317 @@
+//
+//  EntityBoundsIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityBoundsIndexTests.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <EntityBoundsIndex.h>
+#include <EntityItem.h>
+#include <EntityItemProperties.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(EntityBoundsIndexTests)
+
+static const int NUM_ROUNDS = 40;
+static const int NUM_CHANGES_PER_ROUND = 50;
+static const int NUM_QUERIES_PER_ROUND = 10;
+static const int WORLD_HALF_SCALE = 100;
+static const float MAX_RAY_DISTANCE = 300.0f;
+
+// rays that graze an edge may be reported either way
+static const float RAY_TOLERANCE = 0.001f;
+
+// the entities the index should hold, with their bounds
+class Reference {
+public:
+    QHash<EntityItemID, EntityItemPointer> entities;
+    QHash<EntityItemID, AACube> bounds;
+    QVector<EntityItemID> liveIDs;
+    QVector<EntityItemPointer> removed;
+};
+
+// integer corners and power of two scales, so the index and the scan compute exactly the same bounds
+static AACube randomCube(std::mt19937& random) {
+    std::uniform_int_distribution<int> corner(-WORLD_HALF_SCALE, WORLD_HALF_SCALE);
+    float scale = (float)(1 << std::uniform_int_distribution<int>(0, 5)(random));
+    return AACube(glm::vec3(corner(random), corner(random), corner(random)), scale);
+}
+
+static glm::vec3 randomPoint(std::mt19937& random) {
+    std::uniform_real_distribution<float> coordinate(-WORLD_HALF_SCALE, WORLD_HALF_SCALE);
+    return glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+}
+
+static glm::vec3 randomDirection(std::mt19937& random) {
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+
+    // some rays in a plane or along an axis, to cover the zero components
+    int shape = std::uniform_int_distribution<int>(0, 3)(random);
+    glm::vec3 direction;
+    do {
+        direction = glm::vec3(component(random), component(random), component(random));
+        if (shape == 1) {
+            direction.x = 0.0f;
+        } else if (shape == 2) {
+            direction = glm::vec3(direction.x < 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f);
+        }
+    } while (glm::length2(direction) < 0.01f);
+    return glm::normalize(direction);
+}
+
+static EntityItemPointer makeEntity(const AACube& bounds) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(bounds.calcCenter());
+    properties.setDimensions(glm::vec3(bounds.getScale() * 0.5f));
+    return EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+}
+
+static void place(EntityBoundsIndex& index, Reference& reference, const EntityItemPointer& entity, const AACube& bounds) {
+    entity->setPosition(bounds.calcCenter());
+    index.insert(entity, bounds);
+    EntityItemID entityID = entity->getEntityItemID();
+    if (!reference.entities.contains(entityID)) {
+        reference.entities.insert(entityID, entity);
+        reference.liveIDs.push_back(entityID);
+    }
+    reference.bounds[entityID] = bounds;
+}
+
+static void applyRandomChange(EntityBoundsIndex& index, Reference& reference, std::mt19937& random) {
+    int change = std::uniform_int_distribution<int>(0, 99)(random);
+    if (reference.liveIDs.isEmpty() || change < 40) {
+        AACube bounds = randomCube(random);
+        place(index, reference, makeEntity(bounds), bounds);
+
+    } else if (change < 70) {
+        // moves to another element
+        EntityItemID entityID = reference.liveIDs[std::uniform_int_distribution<int>(0, reference.liveIDs.size() - 1)(random)];
+        place(index, reference, reference.entities[entityID], randomCube(random));
+
+    } else if (change < 85 || reference.removed.isEmpty()) {
+        int i = std::uniform_int_distribution<int>(0, reference.liveIDs.size() - 1)(random);
+        EntityItemID entityID = reference.liveIDs[i];
+        index.remove(entityID);
+        reference.removed.push_back(reference.entities.take(entityID));
+        reference.bounds.remove(entityID);
+        reference.liveIDs[i] = reference.liveIDs.back();
+        reference.liveIDs.pop_back();
+
+    } else {
+        // removed from one element and added to another, as the octree does when an entity changes elements
+        int i = std::uniform_int_distribution<int>(0, reference.removed.size() - 1)(random);
+        EntityItemPointer entity = reference.removed[i];
+        reference.removed[i] = reference.removed.back();
+        reference.removed.pop_back();
+        place(index, reference, entity, randomCube(random));
+    }
+}
+
+static QVector<EntityItemID> sortedIDs(const QVector<EntityItemPointer>& entities) {
+    QVector<EntityItemID> entityIDs;
+    for (auto& entity : entities) {
+        entityIDs.push_back(entity->getEntityItemID());
+    }
+    std::sort(entityIDs.begin(), entityIDs.end());
+    return entityIDs;
+}
+
+template <typename BoundsTest>
+static QVector<EntityItemID> scan(const Reference& reference, BoundsTest boundsTest) {
+    QVector<EntityItemID> entityIDs;
+    for (auto it = reference.bounds.constBegin(); it != reference.bounds.constEnd(); ++it) {
+        if (boundsTest(it.value())) {
+            entityIDs.push_back(it.key());
+        }
+    }
+    std::sort(entityIDs.begin(), entityIDs.end());
+    return entityIDs;
+}
+
+static float distanceSquaredToCube(const glm::vec3& point, const AACube& cube) {
+    return glm::distance2(point, glm::clamp(point, cube.getMinimumPoint(), cube.getMaximumPoint()));
+}
+
+// distance along the ray to where it enters the bounds grown by margin, 0 if it starts inside them
+static bool rayHitsCube(const glm::vec3& origin, const glm::vec3& direction, const AACube& cube, float margin,
+                        float& distance) {
+    glm::vec3 minimum = cube.getMinimumPoint() - glm::vec3(margin);
+    glm::vec3 maximum = cube.getMaximumPoint() + glm::vec3(margin);
+    float nearDistance = 0.0f;
+    float farDistance = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        if (direction[axis] == 0.0f) {
+            if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float first = (minimum[axis] - origin[axis]) / direction[axis];
+        float second = (maximum[axis] - origin[axis]) / direction[axis];
+        nearDistance = std::max(nearDistance, std::min(first, second));
+        farDistance = std::min(farDistance, std::max(first, second));
+    }
+    distance = nearDistance;
+    return nearDistance <= farDistance;
+}
+
+static void compareQueries(EntityBoundsIndex& index, const Reference& reference, std::mt19937& random) {
+    QCOMPARE(index.size(), reference.entities.size());
+
+    for (int query = 0; query < NUM_QUERIES_PER_ROUND; query++) {
+        QVector<EntityItemPointer> found;
+        auto collect = [&](const EntityItemPointer& entity) { found.push_back(entity); };
+
+        // box
+        glm::vec3 boxCorner = randomPoint(random);
+        glm::vec3 boxDimensions = glm::vec3(std::uniform_real_distribution<float>(1.0f, 50.0f)(random));
+        AABox box(boxCorner, boxDimensions);
+        index.findEntities(box, collect);
+        QCOMPARE(sortedIDs(found), scan(reference, [&](const AACube& cube) {
+            glm::vec3 minimum = cube.getMinimumPoint();
+            glm::vec3 maximum = cube.getMaximumPoint();
+            return glm::all(glm::lessThanEqual(minimum, box.getMaximumPoint())) &&
+                glm::all(glm::greaterThanEqual(maximum, box.getMinimumPoint()));
+        }));
+
+        // sphere
+        found.clear();
+        glm::vec3 center = randomPoint(random);
+        float radius = std::uniform_real_distribution<float>(0.0f, 40.0f)(random);
+        index.findEntities(center, radius, collect);
+        QCOMPARE(sortedIDs(found), scan(reference, [&](const AACube& cube) {
+            return distanceSquaredToCube(center, cube) <= radius * radius;
+        }));
+
+        // frustum
+        found.clear();
+        ViewFrustum frustum;
+        frustum.setProjection(glm::perspective(PI / 3.0f, 1.5f, 0.1f, 80.0f));
+        frustum.setPosition(randomPoint(random));
+        frustum.setOrientation(rotationBetween(Vectors::FRONT, randomDirection(random)));
+        frustum.setCenterRadius(5.0f);
+        frustum.calculate();
+        index.findEntities(frustum, collect);
+        QCOMPARE(sortedIDs(found), scan(reference, [&](const AACube& cube) {
+            AABox bounds(cube);
+            return frustum.boxIntersectsFrustum(bounds) || frustum.boxIntersectsKeyhole(bounds);
+        }));
+
+        // ray, everything it clearly hits within the distance and nothing it clearly misses
+        found.clear();
+        glm::vec3 origin = randomPoint(random);
+        glm::vec3 direction = randomDirection(random);
+        float maxDistance = std::uniform_real_distribution<float>(10.0f, MAX_RAY_DISTANCE)(random);
+        index.findRayCandidates(origin, direction, maxDistance, collect);
+        QVector<EntityItemID> candidates = sortedIDs(found);
+        QVERIFY(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+        QVector<EntityItemID> hit = scan(reference, [&](const AACube& cube) {
+            float distance;
+            return rayHitsCube(origin, direction, cube, -RAY_TOLERANCE, distance) && distance < maxDistance - RAY_TOLERANCE;
+        });
+        QVERIFY(std::includes(candidates.begin(), candidates.end(), hit.begin(), hit.end()));
+        for (auto& entityID : candidates) {
+            QVERIFY(reference.bounds.contains(entityID));
+            float distance;
+            QVERIFY(rayHitsCube(origin, direction, reference.bounds[entityID], RAY_TOLERANCE, distance));
+            QVERIFY(distance < maxDistance + RAY_TOLERANCE);
+        }
+
+        // a ray search that shortens its distance with each hit still reaches the nearest clear hit
+        float nearestDistance = maxDistance;
+        for (auto& entityID : hit) {
+            float distance;
+            rayHitsCube(origin, direction, reference.bounds[entityID], 0.0f, distance);
+            nearestDistance = std::min(nearestDistance, distance);
+        }
+        float searchDistance = maxDistance;
+        index.findRayCandidates(origin, direction, searchDistance, [&](const EntityItemPointer& entity) {
+            float distance;
+            if (rayHitsCube(origin, direction, reference.bounds.value(entity->getEntityItemID()), 0.0f, distance) &&
+                    distance < searchDistance) {
+                searchDistance = distance;
+            }
+        });
+        QVERIFY(searchDistance <= nearestDistance + RAY_TOLERANCE);
+
+        // closest
+        glm::vec3 position = randomPoint(random);
+        float closestRadius = std::uniform_real_distribution<float>(0.0f, 40.0f)(random);
+        EntityItemPointer closest = index.findClosestEntity(position, closestRadius);
+        float expectedDistanceSquared = FLT_MAX;
+        for (auto it = reference.bounds.constBegin(); it != reference.bounds.constEnd(); ++it) {
+            float distanceSquared = glm::distance2(position, reference.entities[it.key()]->getPosition());
+            if (distanceSquaredToCube(position, it.value()) <= closestRadius * closestRadius &&
+                    distanceSquared <= closestRadius * closestRadius) {
+                expectedDistanceSquared = std::min(expectedDistanceSquared, distanceSquared);
+            }
+        }
+        if (expectedDistanceSquared == FLT_MAX) {
+            QVERIFY(!closest);
+        } else {
+            QVERIFY(closest);
+            QVERIFY(reference.entities.contains(closest->getEntityItemID()));
+            QCOMPARE(glm::distance2(position, closest->getPosition()), expectedDistanceSquared);
+        }
+    }
+}
+
+void EntityBoundsIndexTests::emptyTest() {
+    EntityBoundsIndex index;
+    int numFound = 0;
+    auto count = [&](const EntityItemPointer&) { numFound++; };
+
+    index.findEntities(AABox(glm::vec3(-10.0f), 20.0f), count);
+    index.findEntities(glm::vec3(0.0f), 10.0f, count);
+    index.findRayCandidates(glm::vec3(0.0f), Vectors::UNIT_X, 100.0f, count);
+    QCOMPARE(numFound, 0);
+    QVERIFY(!index.findClosestEntity(glm::vec3(0.0f), 10.0f));
+
+    // an index that was cleared is empty again
+    AACube bounds(glm::vec3(1.0f), 2.0f);
+    index.insert(makeEntity(bounds), bounds);
+    QCOMPARE(index.size(), 1);
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    index.findEntities(AABox(glm::vec3(-10.0f), 20.0f), count);
+    QCOMPARE(numFound, 0);
+}
+
+void EntityBoundsIndexTests::queriesMatchScanTest() {
+    EntityBoundsIndex index;
+    Reference reference;
+    std::mt19937 random(1234);
+
+    // enough changes between queries that the hierarchy is rebuilt many times, with moves, removes and pending entries
+    // left over in between
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        for (int change = 0; change < NUM_CHANGES_PER_ROUND; change++) {
+            applyRandomChange(index, reference, random);
+        }
+        compareQueries(index, reference, random);
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+
+    // a large batch of new entities at once
+    for (int change = 0; change < 1000; change++) {
+        AACube bounds = randomCube(random);
+        place(index, reference, makeEntity(bounds), bounds);
+    }
+    compareQueries(index, reference, random);
+}
@@ -0,0 +1,23 @@
+//
+//  EntityBoundsIndexTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityBoundsIndexTests_h
+#define hifi_EntityBoundsIndexTests_h
+
+#include <QtTest/QtTest>
+
+class EntityBoundsIndexTests : public QObject {
+    Q_OBJECT
+private slots:
+    void emptyTest();
+    void queriesMatchScanTest();
+};
+
+#endif // hifi_EntityBoundsIndexTests_h
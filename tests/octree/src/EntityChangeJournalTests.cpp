@@ -0,0 +1,169 @@
+//
+//  EntityChangeJournalTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityChangeJournalTests.h"
+
+#include <vector>
+
+#include <EntityChangeJournal.h>
+
+QTEST_MAIN(EntityChangeJournalTests)
+
+static std::vector<quint64> sequencesSince(const EntityChangeJournal& journal, quint64 sinceSequence, bool& isAvailable) {
+    std::vector<quint64> sequences;
+    isAvailable = journal.forEachChangeSince(sinceSequence, [&](const EntityChange& change) {
+        sequences.push_back(change.sequence);
+    });
+    return sequences;
+}
+
+void EntityChangeJournalTests::recordTest() {
+    EntityChangeJournal journal;
+    QCOMPARE(journal.getLastSequence(), (quint64)0);
+
+    EntityItemID first = QUuid::createUuid();
+    EntityItemID second = QUuid::createUuid();
+
+    journal.record(EntityChange::Added, first, EntityPropertyFlags(PROP_POSITION));
+    journal.record(EntityChange::Added, second);
+    journal.record(EntityChange::Edited, first, EntityPropertyFlags(PROP_COLOR));
+    journal.record(EntityChange::Deleted, second);
+    QCOMPARE(journal.getLastSequence(), (quint64)4);
+
+    std::vector<EntityChange> changes;
+    QVERIFY(journal.forEachChangeSince(0, [&](const EntityChange& change) {
+        changes.push_back(change);
+    }));
+    QCOMPARE((int)changes.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(changes[i].sequence, (quint64)i + 1);
+    }
+    QCOMPARE(changes[0].entityID, first);
+    QCOMPARE((int)changes[0].type, (int)EntityChange::Added);
+    QVERIFY(changes[0].changedProperties.getHasProperty(PROP_POSITION));
+    QCOMPARE(changes[2].entityID, first);
+    QCOMPARE((int)changes[2].type, (int)EntityChange::Edited);
+    QVERIFY(changes[2].changedProperties.getHasProperty(PROP_COLOR));
+    QCOMPARE((int)changes[3].type, (int)EntityChange::Deleted);
+
+    bool isAvailable;
+    auto sequences = sequencesSince(journal, 2, isAvailable);
+    QVERIFY(isAvailable);
+    QCOMPARE(sequences, (std::vector<quint64> { 3, 4 }));
+
+    // nothing new for a sender that is up to date
+    sequences = sequencesSince(journal, 4, isAvailable);
+    QVERIFY(isAvailable);
+    QVERIFY(sequences.empty());
+}
+
+void EntityChangeJournalTests::coalesceTest() {
+    EntityChangeJournal journal;
+
+    EntityItemID added = QUuid::createUuid();
+    EntityItemID edited = QUuid::createUuid();
+    EntityItemID moved = QUuid::createUuid();
+    EntityItemID deleted = QUuid::createUuid();
+
+    journal.record(EntityChange::Edited, edited, EntityPropertyFlags(PROP_POSITION));
+    journal.record(EntityChange::Added, added, EntityPropertyFlags(PROP_POSITION));
+    journal.record(EntityChange::Moved, moved);
+    journal.record(EntityChange::Moved, edited);
+    journal.record(EntityChange::Edited, added, EntityPropertyFlags(PROP_COLOR));
+    journal.record(EntityChange::Edited, deleted, EntityPropertyFlags(PROP_COLOR));
+    journal.record(EntityChange::Moved, moved);
+    journal.record(EntityChange::Edited, edited, EntityPropertyFlags(PROP_PARENT_ID));
+    journal.record(EntityChange::Deleted, deleted);
+
+    QHash<EntityItemID, EntityChange> changesByEntity;
+    QVERIFY(journal.getChangesByEntitySince(0, changesByEntity));
+    QCOMPARE(changesByEntity.size(), 4);
+
+    // added and then edited is still an add, with everything that was set
+    auto& addedChange = changesByEntity[added];
+    QCOMPARE((int)addedChange.type, (int)EntityChange::Added);
+    QCOMPARE(addedChange.sequence, (quint64)5);
+    QVERIFY(addedChange.changedProperties.getHasProperty(PROP_POSITION));
+    QVERIFY(addedChange.changedProperties.getHasProperty(PROP_COLOR));
+
+    // a move doesn't hide an edit
+    auto& editedChange = changesByEntity[edited];
+    QCOMPARE((int)editedChange.type, (int)EntityChange::Edited);
+    QCOMPARE(editedChange.sequence, (quint64)8);
+    QVERIFY(editedChange.changedProperties.getHasProperty(PROP_POSITION));
+    QVERIFY(editedChange.changedProperties.getHasProperty(PROP_PARENT_ID));
+
+    auto& movedChange = changesByEntity[moved];
+    QCOMPARE((int)movedChange.type, (int)EntityChange::Moved);
+    QCOMPARE(movedChange.sequence, (quint64)7);
+
+    QCOMPARE((int)changesByEntity[deleted].type, (int)EntityChange::Deleted);
+
+    // only the changes after the given sequence count
+    changesByEntity.clear();
+    QVERIFY(journal.getChangesByEntitySince(5, changesByEntity));
+    QCOMPARE(changesByEntity.size(), 3);
+    QVERIFY(!changesByEntity.contains(added));
+    QVERIFY(!changesByEntity[edited].changedProperties.getHasProperty(PROP_POSITION));
+}
+
+void EntityChangeJournalTests::truncationTest() {
+    const int MAX_CHANGES = 10;
+    EntityChangeJournal journal(MAX_CHANGES);
+
+    EntityItemID entityID = QUuid::createUuid();
+    const int NUM_CHANGES = 25;
+    for (int i = 0; i < NUM_CHANGES; ++i) {
+        journal.record(EntityChange::Edited, entityID);
+    }
+    QCOMPARE(journal.getLastSequence(), (quint64)NUM_CHANGES);
+
+    // the oldest change still kept is NUM_CHANGES - MAX_CHANGES + 1
+    bool isAvailable;
+    auto sequences = sequencesSince(journal, NUM_CHANGES - MAX_CHANGES, isAvailable);
+    QVERIFY(isAvailable);
+    QCOMPARE((int)sequences.size(), MAX_CHANGES);
+    QCOMPARE(sequences.front(), (quint64)(NUM_CHANGES - MAX_CHANGES + 1));
+
+    // a sender that is further behind has to walk the tree, and isn't handed any changes
+    sequences = sequencesSince(journal, NUM_CHANGES - MAX_CHANGES - 1, isAvailable);
+    QVERIFY(!isAvailable);
+    QVERIFY(sequences.empty());
+
+    QHash<EntityItemID, EntityChange> changesByEntity;
+    QVERIFY(!journal.getChangesByEntitySince(0, changesByEntity));
+}
+
+void EntityChangeJournalTests::resetTest() {
+    EntityChangeJournal journal;
+
+    EntityItemID entityID = QUuid::createUuid();
+    journal.record(EntityChange::Added, entityID);
+    journal.record(EntityChange::Edited, entityID);
+    quint64 upToDate = journal.getLastSequence();
+
+    journal.reset();
+
+    // even a sender that had seen every change has to walk the tree
+    bool isAvailable;
+    sequencesSince(journal, upToDate, isAvailable);
+    QVERIFY(!isAvailable);
+    sequencesSince(journal, 0, isAvailable);
+    QVERIFY(!isAvailable);
+
+    // while one that starts now is told about what comes next
+    quint64 afterReset = journal.getLastSequence();
+    QVERIFY(afterReset > upToDate);
+    journal.record(EntityChange::Added, entityID);
+
+    auto sequences = sequencesSince(journal, afterReset, isAvailable);
+    QVERIFY(isAvailable);
+    QCOMPARE(sequences, (std::vector<quint64> { afterReset + 1 }));
+}
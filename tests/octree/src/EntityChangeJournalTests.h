@@ -0,0 +1,32 @@
+//
+//  EntityChangeJournalTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityChangeJournalTests_h
+#define hifi_EntityChangeJournalTests_h
+
+#include <QtTest/QtTest>
+
+class EntityChangeJournalTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that changes get consecutive sequences and are listed oldest first from any point
+    void recordTest();
+
+    // Test that the changes of each entity are merged into one
+    void coalesceTest();
+
+    // Test that a journal only answers for the changes it still has
+    void truncationTest();
+
+    // Test that a reset sends everyone back to walking the tree
+    void resetTest();
+};
+
+#endif // hifi_EntityChangeJournalTests_h
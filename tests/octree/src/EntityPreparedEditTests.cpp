@@ -0,0 +1,216 @@
+//
+//  EntityPreparedEditTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPreparedEditTests.h"
+
+#include <memory>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityEditFilters.h>
+#include <EntityTree.h>
+#include <NLPacket.h>
+#include <NodeList.h>
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(EntityPreparedEditTests)
+
+// an edit packet as the server receives it, and the edit prepared from it
+class EditMessage {
+public:
+    EditMessage(PacketType type, const EntityItemID& entityID, const EntityItemProperties& properties) {
+        QByteArray buffer(NLPacket::maxPayloadSize(type), 0);
+        EntityItemProperties::encodeEntityEditPacket(type, entityID, properties, buffer);
+        auto packet = NLPacket::create(type);
+        packet->write(buffer);
+        packet->seek(0);
+        message.reset(new ReceivedMessage(*packet));
+    }
+
+    // decodes and validates the edit without the tree lock, as the edit pipeline's workers do
+    int prepare(EntityTreePointer tree, const SharedNodePointer& sender) {
+        const unsigned char* editData = reinterpret_cast<const unsigned char*>(message->getRawMessage());
+        return tree->prepareEditPacketData(*message, editData, (int)message->getSize(), sender, edit);
+    }
+
+    void apply(EntityTreePointer tree) {
+        tree->withWriteLock([&] {
+            tree->applyPreparedEdit(*edit);
+        });
+    }
+
+    std::unique_ptr<ReceivedMessage> message;
+    Octree::PreparedEditPointer edit;
+};
+
+static EntityTreePointer makeTree() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+// a sender that can rez entities but doesn't have lock rights, so its edits go through the edit filters
+static SharedNodePointer makeSender() {
+    NodePermissions permissions;
+    permissions.set(NodePermissions::Permission::canRezPermanentEntities);
+    return SharedNodePointer(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), permissions));
+}
+
+static EntityItemProperties boxProperties(const QString& name) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName(name);
+    properties.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    properties.setDimensions(glm::vec3(0.5f));
+    return properties;
+}
+
+static EntityItemProperties nameProperties(const QString& name) {
+    EntityItemProperties properties;
+    properties.setName(name);
+    return properties;
+}
+
+static EntityItemPointer addBox(EntityTreePointer tree, const EntityItemID& entityID, const QString& name) {
+    EntityItemPointer entity;
+    tree->withWriteLock([&] {
+        entity = tree->addEntity(entityID, boxProperties(name));
+    });
+    return entity;
+}
+
+void EntityPreparedEditTests::initTestCase() {
+    // adding entities to a tree needs a NodeList
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityEntityPreparedEditTests)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned, INVALID_PORT);
+}
+
+void EntityPreparedEditTests::editsAppliedInOrderTest() {
+    auto tree = makeTree();
+    auto sender = makeSender();
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemPointer entity = addBox(tree, entityID, "box");
+    QVERIFY(entity);
+
+    // several edits of one entity, all prepared before any of them is applied
+    const int NUM_EDITS = 4;
+    std::vector<std::unique_ptr<EditMessage>> edits;
+    for (int i = 0; i < NUM_EDITS; i++) {
+        edits.emplace_back(new EditMessage(PacketType::EntityEdit, entityID, nameProperties(QString("edit %1").arg(i))));
+        QVERIFY(edits.back()->prepare(tree, sender) > 0);
+    }
+
+    for (int i = 0; i < NUM_EDITS; i++) {
+        edits[i]->apply(tree);
+        QCOMPARE(entity->getName(), QString("edit %1").arg(i));
+    }
+
+    // the edits before each one changed the entity, but not its lookup, so none of them had to be prepared again
+    QCOMPARE(tree->getTotalRevalidatedEdits(), (quint64)0);
+    QCOMPARE(tree->findEntityByEntityItemID(entityID), entity);
+}
+
+void EntityPreparedEditTests::movesWithoutZoneFiltersTest() {
+    auto tree = makeTree();
+    auto sender = makeSender();
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemPointer entity = addBox(tree, entityID, "box");
+    QVERIFY(entity);
+
+    // the entity server always has edit filters, even when none are configured
+    DependencyManager::set<EntityEditFilters>(tree);
+
+    // a moving entity, each edit prepared before the move ahead of it is applied
+    const int NUM_EDITS = 4;
+    std::vector<std::unique_ptr<EditMessage>> edits;
+    for (int i = 0; i < NUM_EDITS; i++) {
+        EntityItemProperties properties;
+        properties.setPosition(glm::vec3(1.0f + i, 2.0f, 3.0f));
+        edits.emplace_back(new EditMessage(PacketType::EntityEdit, entityID, properties));
+        QVERIFY(edits.back()->prepare(tree, sender) > 0);
+    }
+
+    for (int i = 0; i < NUM_EDITS; i++) {
+        edits[i]->apply(tree);
+        QCOMPARE(entity->getPosition(), glm::vec3(1.0f + i, 2.0f, 3.0f));
+    }
+
+    // no zone has a filter, so where the entity is doesn't change how its edits are filtered
+    QCOMPARE(tree->getTotalRevalidatedEdits(), (quint64)0);
+
+    DependencyManager::destroy<EntityEditFilters>();
+}
+
+void EntityPreparedEditTests::addPreparedWithEditTest() {
+    auto tree = makeTree();
+    auto sender = makeSender();
+    EntityItemID entityID(QUuid::createUuid());
+
+    // the edit is prepared before the add that comes ahead of it is applied, so it can't find the entity yet
+    EditMessage add(PacketType::EntityAdd, entityID, boxProperties("added"));
+    EditMessage edit(PacketType::EntityEdit, entityID, nameProperties("edited"));
+    QVERIFY(add.prepare(tree, sender) > 0);
+    QVERIFY(edit.prepare(tree, sender) > 0);
+
+    add.apply(tree);
+    EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+    QVERIFY(entity);
+    QCOMPARE(entity->getName(), QString("added"));
+
+    edit.apply(tree);
+    QCOMPARE(entity->getName(), QString("edited"));
+    QCOMPARE(tree->getTotalRevalidatedEdits(), (quint64)1);
+}
+
+void EntityPreparedEditTests::deletedEntityTest() {
+    auto tree = makeTree();
+    auto sender = makeSender();
+    EntityItemID entityID(QUuid::createUuid());
+    QVERIFY(addBox(tree, entityID, "box"));
+
+    EditMessage edit(PacketType::EntityEdit, entityID, nameProperties("edited"));
+    QVERIFY(edit.prepare(tree, sender) > 0);
+
+    tree->withWriteLock([&] {
+        tree->deleteEntity(entityID, true);
+    });
+
+    // the stale edit is validated again and dropped, rather than applied to the deleted entity
+    edit.apply(tree);
+    QCOMPARE(tree->getTotalRevalidatedEdits(), (quint64)1);
+    QVERIFY(!tree->findEntityByEntityItemID(entityID));
+}
+
+void EntityPreparedEditTests::replacedEntityTest() {
+    auto tree = makeTree();
+    auto sender = makeSender();
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemPointer original = addBox(tree, entityID, "original");
+    QVERIFY(original);
+
+    EditMessage edit(PacketType::EntityEdit, entityID, nameProperties("edited"));
+    QVERIFY(edit.prepare(tree, sender) > 0);
+
+    // deleted and added again with the same ID after the edit was prepared
+    tree->withWriteLock([&] {
+        tree->deleteEntity(entityID, true);
+    });
+    EntityItemPointer replacement = addBox(tree, entityID, "replacement");
+    QVERIFY(replacement);
+    QVERIFY(replacement != original);
+
+    // the edit goes to the entity that is in the tree now
+    edit.apply(tree);
+    QCOMPARE(tree->getTotalRevalidatedEdits(), (quint64)1);
+    QCOMPARE(replacement->getName(), QString("edited"));
+    QCOMPARE(original->getName(), QString("original"));
+}
@@ -0,0 +1,27 @@
+//
+//  EntityPreparedEditTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPreparedEditTests_h
+#define hifi_EntityPreparedEditTests_h
+
+#include <QtTest/QtTest>
+
+class EntityPreparedEditTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void editsAppliedInOrderTest();
+    void movesWithoutZoneFiltersTest();
+    void addPreparedWithEditTest();
+    void deletedEntityTest();
+    void replacedEntityTest();
+};
+
+#endif // hifi_EntityPreparedEditTests_h
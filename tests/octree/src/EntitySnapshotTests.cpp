@@ -0,0 +1,142 @@
+//
+//  EntitySnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySnapshotTests.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(EntitySnapshotTests)
+
+static const int NUM_ENTITIES = 10;
+
+// where the data packet version is in a binary snapshot header, after the magic and the format version
+static const qint64 DATA_VERSION_OFFSET = 8;
+
+static EntityTreePointer makeTree() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    return tree;
+}
+
+static QVector<EntityItemID> addEntities(EntityTreePointer tree) {
+    QVector<EntityItemID> entityIDs;
+    tree->withWriteLock([&] {
+        for (int i = 0; i < NUM_ENTITIES; i++) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setName(QString("box %1").arg(i));
+            properties.setPosition(glm::vec3(i, 2.0f * i, -3.0f * i));
+            properties.setDimensions(glm::vec3(0.5f + i));
+
+            EntityItemID entityID(QUuid::createUuid());
+            QVERIFY(tree->addEntity(entityID, properties));
+            entityIDs.push_back(entityID);
+        }
+    });
+    return entityIDs;
+}
+
+static void compareEntities(EntityTreePointer tree, EntityTreePointer original, const QVector<EntityItemID>& entityIDs) {
+    for (auto& entityID : entityIDs) {
+        EntityItemPointer entity = tree->findEntityByEntityItemID(entityID);
+        EntityItemPointer expected = original->findEntityByEntityItemID(entityID);
+        QVERIFY(entity);
+        QCOMPARE(entity->getType(), expected->getType());
+        QCOMPARE(entity->getName(), expected->getName());
+        QCOMPARE(entity->getCreated(), expected->getCreated());
+        QCOMPARE_WITH_ABS_ERROR(entity->getPosition().x, expected->getPosition().x, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(entity->getPosition().y, expected->getPosition().y, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(entity->getPosition().z, expected->getPosition().z, EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(entity->getDimensions().x, expected->getDimensions().x, EPSILON);
+    }
+}
+
+static bool readSnapshot(EntityTreePointer tree, const QString& fileName) {
+    bool success = false;
+    tree->withWriteLock([&] {
+        success = tree->readFromBinaryFile(fileName);
+    });
+    return success;
+}
+
+static void setDataVersion(const QString& fileName, quint32 dataVersion) {
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(DATA_VERSION_OFFSET));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(&dataVersion), sizeof(dataVersion)), (qint64)sizeof(dataVersion));
+}
+
+void EntitySnapshotTests::initTestCase() {
+    // adding entities to a tree needs a NodeList
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityEntitySnapshotTests)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned, INVALID_PORT);
+}
+
+void EntitySnapshotTests::testRoundTrip() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.bin");
+
+    auto original = makeTree();
+    auto entityIDs = addEntities(original);
+    bool written = false;
+    original->withReadLock([&] {
+        written = original->writeToBinaryFile(qPrintable(fileName));
+    });
+    QVERIFY(written);
+
+    // the JSON fallback is only saved when asked for
+    QVERIFY(!QFile::exists(fileName + ".json.gz"));
+
+    auto tree = makeTree();
+    QVERIFY(readSnapshot(tree, fileName));
+    compareEntities(tree, original, entityIDs);
+}
+
+void EntitySnapshotTests::testMismatchedVersion() {
+    QTemporaryDir dir;
+    QString fileName = dir.filePath("models.bin");
+
+    auto original = makeTree();
+    auto entityIDs = addEntities(original);
+    bool written = false;
+    original->withReadLock([&] {
+        const bool withFallback = true;
+        written = original->writeToBinaryFile(qPrintable(fileName), NULL, withFallback);
+    });
+    QVERIFY(written);
+    QVERIFY(QFile::exists(fileName + ".json.gz"));
+
+    // a snapshot from an older or a newer version is read from its JSON instead
+    quint32 currentVersion = versionForPacketType(PacketType::EntityData);
+    for (quint32 dataVersion : { currentVersion - 1, currentVersion + 1 }) {
+        setDataVersion(fileName, dataVersion);
+        auto tree = makeTree();
+        QVERIFY(readSnapshot(tree, fileName));
+        compareEntities(tree, original, entityIDs);
+    }
+
+    // and isn't read at all without it
+    QVERIFY(QFile::remove(fileName + ".json.gz"));
+    auto tree = makeTree();
+    QVERIFY(!readSnapshot(tree, fileName));
+    for (auto& entityID : entityIDs) {
+        QVERIFY(!tree->findEntityByEntityItemID(entityID));
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  EntitySnapshotTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySnapshotTests_h
+#define hifi_EntitySnapshotTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySnapshotTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testRoundTrip();
+    void testMismatchedVersion();
+};
+
+#endif // hifi_EntitySnapshotTests_h
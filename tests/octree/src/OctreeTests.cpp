@@ -19,6 +19,7 @@
 #include <EntityTree.h>
 #include <EntityTreeElement.h>
 #include <Octree.h>
+#include <OctreeElementBag.h>
 #include <OctreeConstants.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
@@ -827,3 +828,48 @@ void OctreeTests::elementAddChildTests() {
         }
     }
 }
+
+void OctreeTests::elementBagTests() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    auto root = tree->createNewElement();
+    auto nearChild = root->addChildAtIndex(0);
+    auto farChild = root->addChildAtIndex(7);
+    auto grandChild = nearChild->addChildAtIndex(7);
+
+    // without a view frustum, larger elements come first
+    OctreeElementBag bag;
+    bag.insert(grandChild);
+    bag.insert(nearChild);
+    bag.insert(root);
+    QCOMPARE(bag.extract(), root);
+    QCOMPARE(bag.extract(), nearChild);
+    QCOMPARE(bag.extract(), grandChild);
+    QCOMPARE(bag.isEmpty(), true);
+
+    // elements are only extracted once, no matter how often they were inserted
+    bag.insert(farChild);
+    bag.insert(nearChild);
+    bag.insert(farChild);
+    QCOMPARE(bag.size(), (size_t)3);
+    bag.extract();
+    bag.extract();
+    QCOMPARE(bag.isEmpty(), true);
+
+    // with a view frustum, elements are ordered by their size on screen, so a close small element can come first
+    bag.insert(farChild);
+    bag.insert(grandChild);
+    ViewFrustum viewFrustum;
+    viewFrustum.setPosition(grandChild->getAACube().calcCenter());
+    bag.setViewFrustum(viewFrustum);
+    QCOMPARE(bag.extract(), grandChild);
+    QCOMPARE(bag.extract(), farChild);
+
+    // expired elements are skipped
+    {
+        auto expired = tree->createNewElement();
+        bag.insert(expired);
+    }
+    QCOMPARE(bag.isEmpty(), false);
+    QCOMPARE((bool)bag.extract(), false);
+    QCOMPARE(bag.isEmpty(), true);
+}
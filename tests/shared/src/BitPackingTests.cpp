@@ -0,0 +1,164 @@
+//
+//  BitPackingTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BitPackingTests.h"
+
+#include <BitPacking.h>
+#include <NumericalConstants.h>
+
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(BitPackingTests)
+
+// the writer reports exactly what the reader decodes, allowing only for float noise
+static const float EXACT = 1.0e-6f;
+
+void BitPackingTests::testReadWrite() {
+    unsigned char buffer[16];
+    BitWriter writer(buffer, sizeof(buffer));
+    writer.write(1, 1);
+    writer.write(5, 3);
+    writer.write(0xabc, 12);
+    writer.write(0xdeadbeef, 32);
+    writer.write(3, 2);
+    QCOMPARE(writer.getNumBytes(), 7);
+    QVERIFY(!writer.isOverflowed());
+
+    BitReader reader(buffer, writer.getNumBytes());
+    QCOMPARE(reader.read(1), 1U);
+    QCOMPARE(reader.read(3), 5U);
+    QCOMPARE(reader.read(12), 0xabcU);
+    QCOMPARE(reader.read(32), 0xdeadbeefU);
+    QCOMPARE(reader.read(2), 3U);
+    QVERIFY(!reader.isOverflowed());
+}
+
+void BitPackingTests::testSignedReadWrite() {
+    unsigned char buffer[16];
+    BitWriter writer(buffer, sizeof(buffer));
+    writer.writeSigned(-1, 4);
+    writer.writeSigned(7, 4);
+    writer.writeSigned(-8, 4);
+    writer.writeSigned(-128, 8);
+    writer.writeSigned(-32768, 16);
+    writer.writeSigned(32767, 16);
+
+    BitReader reader(buffer, writer.getNumBytes());
+    QCOMPARE(reader.readSigned(4), -1);
+    QCOMPARE(reader.readSigned(4), 7);
+    QCOMPARE(reader.readSigned(4), -8);
+    QCOMPARE(reader.readSigned(8), -128);
+    QCOMPARE(reader.readSigned(16), -32768);
+    QCOMPARE(reader.readSigned(16), 32767);
+}
+
+void BitPackingTests::testOverflow() {
+    unsigned char buffer[2];
+    BitWriter writer(buffer, sizeof(buffer));
+    writer.write(0xffff, 16);
+    QVERIFY(!writer.isOverflowed());
+    writer.write(1, 1);
+    QVERIFY(writer.isOverflowed());
+
+    BitReader reader(buffer, sizeof(buffer));
+    QCOMPARE(reader.read(16), 0xffffU);
+    QCOMPARE(reader.read(1), 0U);
+    QVERIFY(reader.isOverflowed());
+}
+
+static void testSmallestThree(const glm::quat& testQuat, int numBits, float maxComponentError) {
+    unsigned char buffer[16];
+    BitWriter writer(buffer, sizeof(buffer));
+    glm::quat written = packOrientationQuatSmallestThree(writer, testQuat, numBits);
+    QCOMPARE(writer.getNumBytes(), (2 + 3 * numBits + 7) / 8);
+
+    BitReader reader(buffer, writer.getNumBytes());
+    glm::quat q = unpackOrientationQuatSmallestThree(reader, numBits);
+
+    QCOMPARE_WITH_ABS_ERROR(q.x, written.x, EXACT);
+    QCOMPARE_WITH_ABS_ERROR(q.y, written.y, EXACT);
+    QCOMPARE_WITH_ABS_ERROR(q.z, written.z, EXACT);
+    QCOMPARE_WITH_ABS_ERROR(q.w, written.w, EXACT);
+
+    if (glm::dot(q, testQuat) < 0.0f) {
+        q = -q;
+    }
+    QCOMPARE_WITH_ABS_ERROR(q.x, testQuat.x, maxComponentError);
+    QCOMPARE_WITH_ABS_ERROR(q.y, testQuat.y, maxComponentError);
+    QCOMPARE_WITH_ABS_ERROR(q.z, testQuat.z, maxComponentError);
+    QCOMPARE_WITH_ABS_ERROR(q.w, testQuat.w, maxComponentError);
+}
+
+void BitPackingTests::testSmallestThreeCompression() {
+    const glm::quat ROT_X_90 = glm::angleAxis(PI / 2.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::quat ROT_Y_180 = glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::quat ROT_Z_30 = glm::angleAxis(PI / 6.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+
+    std::vector<glm::quat> quatVec = {
+        glm::quat(),
+        ROT_X_90,
+        ROT_Y_180,
+        ROT_Z_30,
+        ROT_X_90 * ROT_Y_180 * ROT_Z_30,
+        ROT_Y_180 * ROT_Z_30 * ROT_X_90,
+        ROT_Z_30 * ROT_X_90 * ROT_Y_180,
+        glm::normalize(glm::quat(0.5f, 0.5f, 0.5f, 0.5f)),
+        glm::normalize(glm::quat(0.1f, -0.7f, 0.7f, 0.1f))
+    };
+
+    const float MAX_COMPONENT_ERROR_12_BITS = 1.0e-3f;
+    const float MAX_COMPONENT_ERROR_9_BITS = 8.0e-3f;
+    for (auto& q : quatVec) {
+        testSmallestThree(q, 12, MAX_COMPONENT_ERROR_12_BITS);
+        testSmallestThree(-q, 12, MAX_COMPONENT_ERROR_12_BITS);
+        testSmallestThree(q, 9, MAX_COMPONENT_ERROR_9_BITS);
+    }
+}
+
+void BitPackingTests::testSmallRotationCompression() {
+    const int FULL_BITS = 12;
+    const int DELTA_BITS = 6;
+    float range = smallRotationRange(DELTA_BITS, FULL_BITS);
+
+    // the delta covers the same step as the full encoding, over a smaller range
+    QCOMPARE_WITH_ABS_ERROR(range, smallRotationRange(FULL_BITS, FULL_BITS) * 63.0f / 4095.0f, 1.0e-6f);
+
+    const float MAX_COMPONENT_ERROR = 1.0e-3f;
+    std::vector<glm::quat> quatVec = {
+        glm::quat(),
+        glm::angleAxis(0.01f, glm::vec3(1.0f, 0.0f, 0.0f)),
+        glm::angleAxis(-0.01f, glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f))),
+        -glm::angleAxis(0.015f, glm::normalize(glm::vec3(0.0f, 1.0f, 1.0f)))
+    };
+
+    for (auto& testQuat : quatVec) {
+        QVERIFY(isSmallRotation(testQuat, range));
+
+        unsigned char buffer[16];
+        BitWriter writer(buffer, sizeof(buffer));
+        glm::quat written = packSmallRotation(writer, testQuat, DELTA_BITS, range);
+        QCOMPARE(writer.getNumBytes(), (3 * DELTA_BITS + 7) / 8);
+
+        BitReader reader(buffer, writer.getNumBytes());
+        glm::quat q = unpackSmallRotation(reader, DELTA_BITS, range);
+        QCOMPARE_WITH_ABS_ERROR(q.x, written.x, EXACT);
+        QCOMPARE_WITH_ABS_ERROR(q.y, written.y, EXACT);
+        QCOMPARE_WITH_ABS_ERROR(q.z, written.z, EXACT);
+        QCOMPARE_WITH_ABS_ERROR(q.w, written.w, EXACT);
+
+        glm::quat expected = testQuat.w < 0.0f ? -testQuat : testQuat;
+        QCOMPARE_WITH_ABS_ERROR(q.x, expected.x, MAX_COMPONENT_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(q.y, expected.y, MAX_COMPONENT_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(q.z, expected.z, MAX_COMPONENT_ERROR);
+        QCOMPARE_WITH_ABS_ERROR(q.w, expected.w, MAX_COMPONENT_ERROR);
+    }
+
+    QVERIFY(!isSmallRotation(glm::angleAxis(PI / 4.0f, glm::vec3(0.0f, 1.0f, 0.0f)), range));
+}
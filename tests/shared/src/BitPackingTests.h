@@ -0,0 +1,26 @@
+//
+//  BitPackingTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BitPackingTests_h
+#define hifi_BitPackingTests_h
+
+#include <QtTest/QtTest>
+
+class BitPackingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testReadWrite();
+    void testSignedReadWrite();
+    void testOverflow();
+    void testSmallestThreeCompression();
+    void testSmallRotationCompression();
+};
+
+#endif // hifi_BitPackingTests_h
@@ -0,0 +1,70 @@
+//
+//  SipHashTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHashTests.h"
+
+#include <SipHash.h>
+
+QTEST_MAIN(SipHashTests)
+
+namespace {
+    // the reference key and messages from the SipHash paper: key = 00 01 .. 0f, message = 00 01 .. (n - 1)
+    SipHash referenceHasher() {
+        uint8_t key[SipHash::KEY_SIZE];
+        for (size_t i = 0; i < SipHash::KEY_SIZE; ++i) {
+            key[i] = (uint8_t)i;
+        }
+        return SipHash(key);
+    }
+
+    QByteArray referenceMessage(int length) {
+        QByteArray message(length, 0);
+        for (int i = 0; i < length; ++i) {
+            message[i] = (char)i;
+        }
+        return message;
+    }
+}
+
+void SipHashTests::testReferenceVectors64() {
+    auto hasher = referenceHasher();
+
+    QCOMPARE(hasher.hash64(referenceMessage(0).constData(), 0), (uint64_t)0x726fdb47dd0e0e31ULL);
+    QCOMPARE(hasher.hash64(referenceMessage(1).constData(), 1), (uint64_t)0x74f839c593dc67fdULL);
+    QCOMPARE(hasher.hash64(referenceMessage(8).constData(), 8), (uint64_t)0x93f5f5799a932462ULL);
+    QCOMPARE(hasher.hash64(referenceMessage(15).constData(), 15), (uint64_t)0xa129ca6149be45e5ULL);
+    QCOMPARE(hasher.hash64(referenceMessage(63).constData(), 63), (uint64_t)0x958a324ceb064572ULL);
+}
+
+void SipHashTests::testReferenceVectors128() {
+    auto hasher = referenceHasher();
+
+    auto digest = [&](int length) {
+        QByteArray result(SipHash::DIGEST_SIZE_128, 0);
+        hasher.hash128(referenceMessage(length).constData(), length, reinterpret_cast<uint8_t*>(result.data()));
+        return result.toHex();
+    };
+
+    QCOMPARE(digest(0), QByteArray("a3817f04ba25a8e66df67214c7550293"));
+    QCOMPARE(digest(1), QByteArray("da87c1d86b99af44347659119b22fc45"));
+    QCOMPARE(digest(8), QByteArray("3b62a9ba6258f5610f83e264f31497b4"));
+    QCOMPARE(digest(63), QByteArray("5150d1772f50834a503e069a973fbd7c"));
+}
+
+void SipHashTests::testKeySensitivity() {
+    auto message = referenceMessage(32);
+
+    SipHash first(0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL);
+    SipHash second(0x0706050403020100ULL, 0x0f0e0d0c0b0a0909ULL);
+
+    // the integer constructor must match the byte constructor for the same little-endian key
+    QCOMPARE(first.hash64(message.constData(), message.size()), referenceHasher().hash64(message.constData(), message.size()));
+    QVERIFY(first.hash64(message.constData(), message.size()) != second.hash64(message.constData(), message.size()));
+}
@@ -0,0 +1,306 @@
+//
+//  AudioMixerLoadApp.cpp
+//  tools/audio-mixer-load/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QLoggingCategory>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <DomainHandler.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+
+#include "SyntheticAudioAgent.h"
+
+#include "AudioMixerLoadApp.h"
+
+static const int STATS_POLL_MSECS = 1000;
+
+// audio-mixer stats (see AudioMixer::sendStatsPacket) written to each CSV row
+static const QStringList CSV_STATS_KEYS {
+    "threads", "throttling_ratio", "trailing_mix_ratio", "avg_listeners_per_frame", "avg_streams_per_frame"
+};
+static const QString TIMING_STATS_KEY = "avg_timing_stats";
+static const QStringList CSV_TIMING_NAMES { "tic", "sleep", "frame", "prepare", "mix", "events", "packets" };
+
+AudioMixerLoadApp::AudioMixerLoadApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity audio-mixer load generator");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "address", "127.0.0.1:40103");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption numAgentsOption("n", "number of synthetic agents", "count", "10");
+    parser.addOption(numAgentsOption);
+
+    const QCommandLineOption rampOption("ramp", "milliseconds between agent starts", "msecs", "100");
+    parser.addOption(rampOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run, once all agents are started (0 runs forever)", "seconds", "60");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption codecOption("codec", "codec to offer the audio-mixer (pcm, zlib, hifiAC, ...)", "codec", "pcm");
+    parser.addOption(codecOption);
+
+    const QCommandLineOption motionOption("motion", "agent motion: static, circle or random", "motion", "static");
+    parser.addOption(motionOption);
+
+    const QCommandLineOption loudnessOption("loudness", "agent loudness: silent, constant or speech", "loudness", "speech");
+    parser.addOption(loudnessOption);
+
+    const QCommandLineOption radiusOption("radius", "meters from the origin the agents are spread across", "meters", "20");
+    parser.addOption(radiusOption);
+
+    const QCommandLineOption statsOption("stats", "domain-server http address to read audio-mixer stats from",
+                                         "address", QString("127.0.0.1:%1").arg(DOMAIN_SERVER_HTTP_PORT));
+    parser.addOption(statsOption);
+
+    const QCommandLineOption csvOption("csv", "file to write audio-mixer timings to", "path", "audio-mixer-load.csv");
+    parser.addOption(csvOption);
+
+    const QCommandLineOption agentOption("agent", "run as the synthetic agent with this index (used internally)", "index");
+    parser.addOption(agentOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _verbose = parser.isSet(verboseOutput);
+    if (!_verbose) {
+        QLoggingCategory::setFilterRules("qt.network.ssl.warning=false");
+
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    QString domainServerAddress = parser.value(domainAddressOption);
+    int duration = parser.value(durationOption).toInt();
+
+    SyntheticAudioAgent::Config config;
+    config.codec = parser.value(codecOption);
+    config.motion = SyntheticAudioAgent::motionFromString(parser.value(motionOption));
+    config.loudness = SyntheticAudioAgent::loudnessFromString(parser.value(loudnessOption));
+    config.radius = parser.value(radiusOption).toFloat();
+
+    if (parser.isSet(agentOption)) {
+        // agent mode: this process is a single synthetic agent
+        config.index = parser.value(agentOption).toInt();
+        _agent.reset(new SyntheticAudioAgent(config, domainServerAddress, this));
+        if (duration > 0) {
+            QTimer::singleShot(duration * (int)MSECS_PER_SECOND, this, [this] { finish(0); });
+        }
+        return;
+    }
+
+    // driver mode: spawn the agents, and record the audio-mixer stats
+    _numAgents = std::max(parser.value(numAgentsOption).toInt(), 0);
+    _rampMsecs = std::max(parser.value(rampOption).toInt(), 0);
+    _statsHost = parser.value(statsOption);
+
+    _agentArguments << "-d" << domainServerAddress
+        << "--codec" << parser.value(codecOption)
+        << "--motion" << parser.value(motionOption)
+        << "--loudness" << parser.value(loudnessOption)
+        << "--radius" << parser.value(radiusOption)
+        << "--duration" << "0";
+    if (_verbose) {
+        _agentArguments << "-v";
+    }
+
+    _csvFile.setFileName(parser.value(csvOption));
+    if (!_csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qCritical() << "Could not open" << _csvFile.fileName() << "for writing";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+    _csv.setDevice(&_csvFile);
+
+    // write the CSV header
+    _csv << "elapsed_s,agents";
+    for (auto& key : CSV_STATS_KEYS) {
+        _csv << "," << key;
+    }
+    for (auto& name : CSV_TIMING_NAMES) {
+        _csv << ",us_per_" << name << ",us_per_" << name << "_trailing";
+    }
+    _csv << endl;
+
+    qDebug() << "Spawning" << _numAgents << "agents against" << domainServerAddress
+        << "- writing audio-mixer timings to" << _csvFile.fileName();
+
+    _networkAccessManager = new QNetworkAccessManager(this);
+    _runTimer.start();
+
+    connect(&_spawnTimer, &QTimer::timeout, this, &AudioMixerLoadApp::spawnNextAgent);
+    _spawnTimer.start(_rampMsecs);
+
+    connect(&_statsTimer, &QTimer::timeout, this, &AudioMixerLoadApp::requestNodes);
+    _statsTimer.start(STATS_POLL_MSECS);
+
+    if (duration > 0) {
+        int totalMsecs = _numAgents * _rampMsecs + duration * (int)MSECS_PER_SECOND;
+        QTimer::singleShot(totalMsecs, this, [this] { finish(0); });
+    }
+}
+
+AudioMixerLoadApp::~AudioMixerLoadApp() {
+}
+
+void AudioMixerLoadApp::spawnNextAgent() {
+    int index = (int)_agentProcesses.size();
+    if (index >= _numAgents) {
+        _spawnTimer.stop();
+        qDebug() << "All" << _numAgents << "agents started";
+        return;
+    }
+
+    QProcess* process = new QProcess(this);
+    process->setProcessChannelMode(_verbose ? QProcess::ForwardedChannels : QProcess::MergedChannels);
+    connect(process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, &AudioMixerLoadApp::agentFinished);
+
+    QStringList arguments = _agentArguments;
+    arguments << "--agent" << QString::number(index);
+    process->start(QCoreApplication::applicationFilePath(), arguments);
+
+    _agentProcesses.push_back(process);
+}
+
+void AudioMixerLoadApp::agentFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    qWarning() << "An agent exited early with code" << exitCode << (exitStatus == QProcess::CrashExit ? "(crashed)" : "");
+}
+
+void AudioMixerLoadApp::requestNodes() {
+    if (!_audioMixerUUID.isEmpty()) {
+        // we already know the audio-mixer, go straight to its stats
+        QUrl statsURL(QString("http://%1/nodes/%2.json").arg(_statsHost, _audioMixerUUID));
+        QNetworkReply* reply = _networkAccessManager->get(QNetworkRequest(statsURL));
+        connect(reply, &QNetworkReply::finished, this, &AudioMixerLoadApp::handleStatsReply);
+        return;
+    }
+
+    QUrl nodesURL(QString("http://%1/nodes.json").arg(_statsHost));
+    QNetworkReply* reply = _networkAccessManager->get(QNetworkRequest(nodesURL));
+    connect(reply, &QNetworkReply::finished, this, &AudioMixerLoadApp::handleNodesReply);
+}
+
+void AudioMixerLoadApp::handleNodesReply() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        qWarning() << "Could not list domain-server nodes:" << reply->errorString();
+        return;
+    }
+
+    auto nodes = QJsonDocument::fromJson(reply->readAll()).object()["nodes"].toArray();
+    for (const auto& node : nodes) {
+        auto nodeObject = node.toObject();
+        if (nodeObject["type"].toString() == "audio-mixer") {
+            _audioMixerUUID = nodeObject["uuid"].toString();
+            qDebug() << "Found audio-mixer" << _audioMixerUUID;
+            requestNodes();
+            return;
+        }
+    }
+
+    if (_verbose) {
+        qDebug() << "No audio-mixer in the domain yet";
+    }
+}
+
+void AudioMixerLoadApp::handleStatsReply() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        // the audio-mixer may have restarted, look it up again
+        qWarning() << "Could not read audio-mixer stats:" << reply->errorString();
+        _audioMixerUUID.clear();
+        return;
+    }
+
+    // the domain-server serves the last stats it received, so skip repeats
+    QByteArray stats = reply->readAll();
+    if (stats == _lastStats) {
+        return;
+    }
+    _lastStats = stats;
+
+    writeStatsRow(QJsonDocument::fromJson(stats).object());
+}
+
+void AudioMixerLoadApp::writeStatsRow(const QJsonObject& stats) {
+    _csv << QString::number(_runTimer.elapsed() / (float)MSECS_PER_SECOND, 'f', 3) << "," << _agentProcesses.size();
+
+    for (auto& key : CSV_STATS_KEYS) {
+        _csv << "," << stats[key].toVariant().toString();
+    }
+
+    auto timingStats = stats[TIMING_STATS_KEY].toObject();
+    for (auto& name : CSV_TIMING_NAMES) {
+        _csv << "," << timingStats["us_per_" + name].toVariant().toString();
+        _csv << "," << timingStats["us_per_" + name + "_trailing"].toVariant().toString();
+    }
+
+    _csv << endl;
+}
+
+void AudioMixerLoadApp::finish(int exitCode) {
+    if (_agent) {
+        _agent->stop();
+        _agent.reset();
+    }
+
+    _spawnTimer.stop();
+    _statsTimer.stop();
+
+    // stop the agents
+    for (auto process : _agentProcesses) {
+        disconnect(process, nullptr, this, nullptr);
+        process->terminate();
+    }
+    for (auto process : _agentProcesses) {
+        static const int AGENT_EXIT_WAIT_MSECS = 2000;
+        if (!process->waitForFinished(AGENT_EXIT_WAIT_MSECS)) {
+            process->kill();
+        }
+    }
+
+    if (_csvFile.isOpen()) {
+        _csv.flush();
+        _csvFile.close();
+    }
+
+    QCoreApplication::exit(exitCode);
+}
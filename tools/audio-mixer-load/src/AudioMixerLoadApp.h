@@ -0,0 +1,73 @@
+//
+//  AudioMixerLoadApp.h
+//  tools/audio-mixer-load/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerLoadApp_h
+#define hifi_AudioMixerLoadApp_h
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <QtNetwork/QNetworkAccessManager>
+
+#include <memory>
+#include <vector>
+
+class SyntheticAudioAgent;
+
+// Load generator for the audio-mixer
+//   Run without --agent, it spawns one child process per synthetic agent (each process has its own NodeList)
+//   and polls the domain-server for the stats the audio-mixer reports, writing its timings to a CSV file.
+//   Run with --agent, it is one of those synthetic agents.
+class AudioMixerLoadApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    AudioMixerLoadApp(int argc, char* argv[]);
+    ~AudioMixerLoadApp();
+
+private slots:
+    void spawnNextAgent();
+    void requestNodes();
+    void handleNodesReply();
+    void handleStatsReply();
+    void agentFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    void writeStatsRow(const QJsonObject& stats);
+    void finish(int exitCode);
+
+    bool _verbose { false };
+
+    // agent mode
+    std::unique_ptr<SyntheticAudioAgent> _agent;
+
+    // driver mode
+    QStringList _agentArguments;
+    int _numAgents { 0 };
+    int _rampMsecs { 0 };
+    std::vector<QProcess*> _agentProcesses;
+    QTimer _spawnTimer;
+
+    QNetworkAccessManager* _networkAccessManager { nullptr };
+    QString _statsHost;
+    QString _audioMixerUUID;
+    QTimer _statsTimer;
+    QByteArray _lastStats;
+    QElapsedTimer _runTimer;
+
+    QFile _csvFile;
+    QTextStream _csv;
+};
+
+#endif // hifi_AudioMixerLoadApp_h
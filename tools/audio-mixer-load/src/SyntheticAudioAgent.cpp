@@ -0,0 +1,333 @@
+//
+//  SyntheticAudioAgent.cpp
+//  tools/audio-mixer-load/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QThread>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <AudioConstants.h>
+#include <DependencyManager.h>
+#include <GLMHelpers.h>
+#include <NLPacket.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SettingHandle.h>
+#include <SharedUtil.h>
+#include <plugins/PluginManager.h>
+
+#include "SyntheticAudioAgent.h"
+
+static const float TONE_FREQUENCY = 220.0f;         // Hz
+static const float TONE_AMPLITUDE = 0.25f * AudioConstants::MAX_SAMPLE_VALUE;
+static const float SPEECH_SYLLABLE_SECS = 0.25f;    // on/off gating of the speech pattern
+static const float SPEECH_PAUSE_RATIO = 0.4f;       // fraction of syllables that are silent
+static const float GOLDEN_RATIO = 0.618034f;         // spreads the syllable gating evenly
+static const float CIRCLE_SPEED = 1.5f;             // m/s
+static const float RANDOM_WALK_SPEED = 1.5f;        // m/s
+static const float ARRIVAL_DISTANCE = 0.5f;
+static const quint64 MAX_CATCH_UP_FRAMES = 4;       // frames sent at once after a stall, the rest are dropped
+
+SyntheticAudioAgent::Motion SyntheticAudioAgent::motionFromString(const QString& motion) {
+    if (motion == "circle") {
+        return Motion::Circle;
+    } else if (motion == "random") {
+        return Motion::Random;
+    }
+    return Motion::Static;
+}
+
+SyntheticAudioAgent::Loudness SyntheticAudioAgent::loudnessFromString(const QString& loudness) {
+    if (loudness == "silent") {
+        return Loudness::Silent;
+    } else if (loudness == "constant") {
+        return Loudness::Constant;
+    }
+    return Loudness::Speech;
+}
+
+SyntheticAudioAgent::SyntheticAudioAgent(const Config& config, const QString& domainServerAddress, QObject* parent) :
+    QObject(parent),
+    _config(config)
+{
+    // seed per agent, so the agents do not move and speak in lockstep
+    srand((unsigned int)usecTimestampNow() + config.index);
+    _phase = randFloat();
+
+    // spread the agents evenly across a disc around the origin
+    float angle = TWO_PI * randFloat();
+    float distance = _config.radius * sqrtf(randFloat());
+    _position = glm::vec3(distance * cosf(angle), 0.0f, distance * sinf(angle));
+    _target = _position;
+    _orientation = glm::angleAxis(TWO_PI * randFloat(), Vectors::UNIT_Y);
+
+    Setting::init();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityAudioMixerLoad)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent, INVALID_PORT);
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // start the nodeThread so its event loop is running
+    QThread* nodeThread = new QThread(this);
+    nodeThread->setObjectName("NodeList Thread");
+    nodeThread->start();
+
+    // make sure the node thread is given highest priority
+    nodeThread->setPriority(QThread::TimeCriticalPriority);
+
+    // setup a timer for domain-server check ins
+    QTimer* domainCheckInTimer = new QTimer(nodeList.data());
+    connect(domainCheckInTimer, &QTimer::timeout, nodeList.data(), &NodeList::sendDomainServerCheckIn);
+    domainCheckInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    // put the NodeList and datagram processing on the node thread
+    nodeList->moveToThread(nodeThread);
+
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &SyntheticAudioAgent::nodeActivated);
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
+    packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
+
+    // the mixer streams audio back to every agent - accept it and drop it
+    packetReceiver.registerListenerForTypes({ PacketType::MixedAudio, PacketType::SilentAudioFrame,
+                                              PacketType::AudioEnvironment, PacketType::AudioStreamStats },
+                                            this, "handleIgnoredPacket");
+
+    nodeList->addSetOfNodeTypesToNodeInterestSet(NodeSet() << NodeType::AudioMixer);
+
+    DependencyManager::get<AddressManager>()->handleLookupString(domainServerAddress, false);
+
+    _frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_frameTimer, &QTimer::timeout, this, &SyntheticAudioAgent::sendFrames);
+}
+
+SyntheticAudioAgent::~SyntheticAudioAgent() {
+    stop();
+}
+
+void SyntheticAudioAgent::stop() {
+    if (_stopped) {
+        return;
+    }
+    _stopped = true;
+    _frameTimer.stop();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // send the domain a disconnect packet, force stoppage of domain-server check-ins
+    nodeList->getDomainHandler().disconnect();
+    nodeList->setIsShuttingDown(true);
+
+    // tell the packet receiver we're shutting down, so it can drop packets
+    nodeList->getPacketReceiver().setShouldDropPackets(true);
+
+    QThread* nodeThread = nodeList->thread();
+    nodeList.reset();
+    // remove the NodeList from the DependencyManager
+    DependencyManager::destroy<NodeList>();
+    // ask the node thread to quit and wait until it is done
+    nodeThread->quit();
+    nodeThread->wait();
+
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+        _encoder = nullptr;
+        _codec = nullptr;
+    }
+}
+
+void SyntheticAudioAgent::nodeActivated(SharedNodePointer node) {
+    if (node->getType() == NodeType::AudioMixer) {
+        negotiateAudioFormat();
+
+        // (re)start streaming - a new mixer starts a new sequence
+        _sequence = 0;
+        _numSentFrames = 0;
+        _clock.start();
+        _frameTimer.start((int)AudioConstants::NETWORK_FRAME_MSECS);
+    }
+}
+
+void SyntheticAudioAgent::negotiateAudioFormat() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+
+    // offer only the requested codec, so the mixer cannot prefer another one
+    std::vector<QString> codecNames;
+    for (auto& plugin : PluginManager::getInstance()->getCodecPlugins()) {
+        if (_config.codec.isEmpty() || plugin->getName() == _config.codec) {
+            codecNames.push_back(plugin->getName());
+        }
+    }
+    if (codecNames.empty()) {
+        qWarning() << "Codec" << _config.codec << "is not available, sending raw PCM";
+    }
+
+    negotiateFormatPacket->writePrimitive((quint8)codecNames.size());
+    for (auto& codecName : codecNames) {
+        negotiateFormatPacket->writeString(codecName);
+    }
+
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    if (audioMixer) {
+        nodeList->sendPacket(std::move(negotiateFormatPacket), *audioMixer);
+    }
+}
+
+void SyntheticAudioAgent::handleSelectedAudioFormat(QSharedPointer<ReceivedMessage> message) {
+    QString selectedCodecName = message->readString();
+    if (_selectedCodecName == selectedCodecName) {
+        return;
+    }
+    _selectedCodecName = selectedCodecName;
+
+    qDebug() << "Agent" << _config.index << "selected codec:" << _selectedCodecName;
+
+    // release any old codec encoder first...
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+        _encoder = nullptr;
+        _codec = nullptr;
+    }
+
+    for (auto& plugin : PluginManager::getInstance()->getCodecPlugins()) {
+        if (_selectedCodecName == plugin->getName()) {
+            _codec = plugin;
+            _encoder = plugin->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+            break;
+        }
+    }
+}
+
+void SyntheticAudioAgent::sendFrames() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    quint64 elapsedUsecs = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    quint64 dueFrames = elapsedUsecs / AudioConstants::NETWORK_FRAME_USECS;
+
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    if (!audioMixer || !audioMixer->getActiveSocket()) {
+        // the frames due while there is no mixer are dropped, rather than sent in a burst once it is back
+        _numSentFrames = dueFrames;
+        return;
+    }
+
+    // send every frame that is due, so timer jitter does not change the send rate, but after a stall
+    // (a busy event loop, for one) only catch up on the last few frames
+    if (dueFrames > _numSentFrames + MAX_CATCH_UP_FRAMES) {
+        _numSentFrames = dueFrames - MAX_CATCH_UP_FRAMES;
+    }
+    while (_numSentFrames < dueFrames) {
+        sendFrame(audioMixer);
+        ++_numSentFrames;
+    }
+}
+
+void SyntheticAudioAgent::sendFrame(const SharedNodePointer& audioMixer) {
+    float time = _numSentFrames * AudioConstants::NETWORK_FRAME_SECS;
+    updatePose(time);
+
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    bool isSilent = !renderFrame(time, samples);
+
+    auto audioPacket = NLPacket::create(isSilent ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho);
+
+    audioPacket->writePrimitive(_sequence++);
+    audioPacket->writeString(_selectedCodecName);
+
+    if (isSilent) {
+        // write the number of silent samples so the audio-mixer can uphold timing
+        audioPacket->writePrimitive((quint16)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        // mono
+        audioPacket->writePrimitive((quint8)0);
+    }
+
+    // pose, as written by AbstractAudioInterface::emitAudioPacket
+    audioPacket->writePrimitive(_position);
+    audioPacket->writePrimitive(_orientation);
+    audioPacket->writePrimitive(_position);
+    audioPacket->writePrimitive(glm::vec3(0.0f));
+
+    if (!isSilent) {
+        QByteArray decodedBuffer(reinterpret_cast<const char*>(samples), sizeof(samples));
+        if (_encoder) {
+            QByteArray encodedBuffer;
+            _encoder->encode(decodedBuffer, encodedBuffer);
+            audioPacket->write(encodedBuffer);
+        } else {
+            audioPacket->write(decodedBuffer);
+        }
+    }
+
+    DependencyManager::get<NodeList>()->sendUnreliablePacket(*audioPacket, *audioMixer);
+}
+
+void SyntheticAudioAgent::updatePose(float time) {
+    switch (_config.motion) {
+        case Motion::Static:
+            break;
+
+        case Motion::Circle: {
+            // orbit the origin at the starting distance
+            glm::vec2 start(_target.x, _target.z);
+            float radius = std::max(glm::length(start), ARRIVAL_DISTANCE);
+            float angle = atan2f(start.y, start.x) + time * CIRCLE_SPEED / radius;
+            _position = glm::vec3(radius * cosf(angle), 0.0f, radius * sinf(angle));
+            _orientation = glm::angleAxis(-angle, Vectors::UNIT_Y);
+            break;
+        }
+
+        case Motion::Random: {
+            // walk towards a random point on the disc, picking a new one on arrival
+            glm::vec3 toTarget = _target - _position;
+            float distance = glm::length(toTarget);
+            if (distance < ARRIVAL_DISTANCE) {
+                float angle = TWO_PI * randFloat();
+                float targetDistance = _config.radius * sqrtf(randFloat());
+                _target = glm::vec3(targetDistance * cosf(angle), 0.0f, targetDistance * sinf(angle));
+            } else {
+                glm::vec3 direction = toTarget / distance;
+                _position += direction * std::min(distance, RANDOM_WALK_SPEED * AudioConstants::NETWORK_FRAME_SECS);
+                _orientation = glm::rotation(Vectors::UNIT_NEG_Z, direction);
+            }
+            break;
+        }
+    }
+}
+
+bool SyntheticAudioAgent::renderFrame(float time, int16_t* samples) {
+    switch (_config.loudness) {
+        case Loudness::Silent:
+            return false;
+
+        case Loudness::Speech: {
+            // gate the tone on and off in syllable-sized chunks, with a per-agent phase
+            float syllable = floorf(time / SPEECH_SYLLABLE_SECS);
+            float gate = fmodf(syllable * GOLDEN_RATIO + _phase, 1.0f);
+            if (gate < SPEECH_PAUSE_RATIO) {
+                return false;
+            }
+            break;
+        }
+
+        case Loudness::Constant:
+            break;
+    }
+
+    const float frequency = TONE_FREQUENCY * (1.0f + _phase);
+    const float step = TWO_PI * frequency / AudioConstants::SAMPLE_RATE;
+    float phase = fmodf(time * frequency, 1.0f) * TWO_PI;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        samples[i] = (int16_t)(TONE_AMPLITUDE * sinf(phase + i * step));
+    }
+    return true;
+}
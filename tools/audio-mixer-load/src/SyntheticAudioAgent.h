@@ -0,0 +1,79 @@
+//
+//  SyntheticAudioAgent.h
+//  tools/audio-mixer-load/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SyntheticAudioAgent_h
+#define hifi_SyntheticAudioAgent_h
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <Node.h>
+#include <ReceivedMessage.h>
+#include <plugins/CodecPlugin.h>
+
+// A headless agent that streams synthetic microphone audio to the audio-mixer,
+// in the same format (and at the same rate) as an interface client
+class SyntheticAudioAgent : public QObject {
+    Q_OBJECT
+public:
+    enum class Motion { Static, Circle, Random };
+    enum class Loudness { Silent, Constant, Speech };
+
+    struct Config {
+        int index { 0 };
+        QString codec;
+        Motion motion { Motion::Static };
+        Loudness loudness { Loudness::Speech };
+        float radius { 20.0f };
+    };
+
+    static Motion motionFromString(const QString& motion);
+    static Loudness loudnessFromString(const QString& loudness);
+
+    SyntheticAudioAgent(const Config& config, const QString& domainServerAddress, QObject* parent = nullptr);
+    ~SyntheticAudioAgent();
+
+    void stop();
+
+private slots:
+    void nodeActivated(SharedNodePointer node);
+    void handleSelectedAudioFormat(QSharedPointer<ReceivedMessage> message);
+    void handleIgnoredPacket(QSharedPointer<ReceivedMessage> message) {}
+    void sendFrames();
+
+private:
+    void negotiateAudioFormat();
+    void sendFrame(const SharedNodePointer& audioMixer);
+    void updatePose(float time);
+    bool renderFrame(float time, int16_t* samples);
+
+    Config _config;
+
+    glm::vec3 _position;
+    glm::quat _orientation;
+    glm::vec3 _target;
+    float _phase { 0.0f };
+
+    QString _selectedCodecName;
+    CodecPluginPointer _codec;
+    Encoder* _encoder { nullptr };
+
+    QTimer _frameTimer;
+    QElapsedTimer _clock;
+    quint64 _numSentFrames { 0 };
+    quint16 _sequence { 0 };
+    bool _stopped { false };
+};
+
+#endif // hifi_SyntheticAudioAgent_h
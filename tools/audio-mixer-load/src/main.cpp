@@ -0,0 +1,24 @@
+//
+//  main.cpp
+//  tools/audio-mixer-load/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <BuildInfo.h>
+
+#include "AudioMixerLoadApp.h"
+
+int main(int argc, char * argv[]) {
+    QCoreApplication::setApplicationName("audio-mixer-load");
+    QCoreApplication::setOrganizationName(BuildInfo::MODIFIED_ORGANIZATION);
+    QCoreApplication::setOrganizationDomain(BuildInfo::ORGANIZATION_DOMAIN);
+    QCoreApplication::setApplicationVersion(BuildInfo::VERSION);
+
+    AudioMixerLoadApp app(argc, argv);
+
+    return app.exec();
+}
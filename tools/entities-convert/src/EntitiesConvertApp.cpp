@@ -0,0 +1,125 @@
+//
+//  EntitiesConvertApp.cpp
+//  tools/entities-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "EntitiesConvertApp.h"
+
+EntitiesConvertApp::EntitiesConvertApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity entities persist file converter");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption inputFilenameOption("i", "input file", "models.json.gz");
+    parser.addOption(inputFilenameOption);
+
+    const QCommandLineOption outputFilenameOption("o", "output file", "models.bin");
+    parser.addOption(outputFilenameOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    if (!parser.isSet(inputFilenameOption) || !parser.isSet(outputFilenameOption)) {
+        qCritical() << "both an input and an output file are required" << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    QString inputFilename = parser.value(inputFilenameOption);
+    QString outputFilename = parser.value(outputFilenameOption);
+    QString inputType = persistFileType(inputFilename);
+    QString outputType = persistFileType(outputFilename);
+    if (inputType.isEmpty() || outputType.isEmpty()) {
+        qCritical() << "persist files must end in one of" << PERSIST_EXTENSIONS.toList();
+        _returnCode = 1;
+        return;
+    }
+
+    // adding entities to a tree needs a NodeList
+    DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityEntitiesConvert)"); });
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Unassigned, INVALID_PORT);
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    quint64 startTime = usecTimestampNow();
+    bool success = false;
+    tree->withWriteLock([&] {
+        // read the named file itself, Octree::readFromFile would pick whichever sibling file is most recent
+        if (inputType == "json.gz") {
+            success = tree->readJSONFromGzippedFile(inputFilename);
+        } else if (inputType == "bin") {
+            success = tree->readFromBinaryFile(inputFilename);
+        } else {
+            QFile file(inputFilename);
+            if (file.open(QIODevice::ReadOnly)) {
+                QDataStream inputStream(&file);
+                success = tree->readFromStream(file.size(), inputStream);
+            }
+        }
+    });
+    quint64 readTime = usecTimestampNow();
+
+    if (!success) {
+        qCritical() << "Failed to read entities from" << inputFilename;
+        _returnCode = 2;
+        return;
+    }
+
+    tree->withReadLock([&] {
+        success = tree->writeToFile(qPrintable(outputFilename), NULL, outputType);
+    });
+    quint64 writeTime = usecTimestampNow();
+
+    if (!success) {
+        qCritical() << "Failed to write entities to" << outputFilename;
+        _returnCode = 3;
+        return;
+    }
+
+    qDebug() << "Converted" << inputFilename << "to" << outputFilename << "- read in"
+        << (readTime - startTime) / USECS_PER_MSEC << "ms, wrote in" << (writeTime - readTime) / USECS_PER_MSEC << "ms";
+}
+
+EntitiesConvertApp::~EntitiesConvertApp() {
+}
+
+QString EntitiesConvertApp::persistFileType(const QString& filename) const {
+    // check the longest extensions first, so that json.gz isn't taken for json
+    QString matched;
+    foreach (const QString& extension, PERSIST_EXTENSIONS) {
+        if (filename.endsWith("." + extension, Qt::CaseInsensitive) && extension.size() > matched.size()) {
+            matched = extension;
+        }
+    }
+    return matched;
+}
@@ -0,0 +1,32 @@
+//
+//  EntitiesConvertApp.h
+//  tools/entities-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitiesConvertApp_h
+#define hifi_EntitiesConvertApp_h
+
+#include <QtCore/QCoreApplication>
+
+// Converts entity server persist files between the formats the entity server can store them in
+// (json, json.gz and bin), the format of each file is taken from its extension.
+class EntitiesConvertApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    EntitiesConvertApp(int argc, char* argv[]);
+    ~EntitiesConvertApp();
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    QString persistFileType(const QString& filename) const;
+
+    int _returnCode { 0 };
+};
+
+#endif // hifi_EntitiesConvertApp_h
@@ -0,0 +1,16 @@
+//
+//  main.cpp
+//  tools/entities-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitiesConvertApp.h"
+
+int main(int argc, char * argv[]) {
+    EntitiesConvertApp app(argc, argv);
+    return app.getReturnCode();
+}
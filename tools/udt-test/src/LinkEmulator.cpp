@@ -0,0 +1,109 @@
+//
+//  LinkEmulator.cpp
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LinkEmulator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QDebug>
+
+static const double BITS_PER_BYTE = 8.0;
+static const double USECS_PER_MSEC = 1000.0;
+
+LinkEmulator::LinkEmulator(const HifiSockAddr& destination, const Parameters& parameters, QObject* parent) :
+    QObject(parent),
+    _destination(destination),
+    _parameters(parameters)
+{
+    _socket.bind(QHostAddress::LocalHost);
+    connect(&_socket, &QUdpSocket::readyRead, this, &LinkEmulator::readPendingDatagrams);
+
+    _releaseTimer.setSingleShot(true);
+    _releaseTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_releaseTimer, &QTimer::timeout, this, &LinkEmulator::releaseDueDatagrams);
+
+    _clock.start();
+
+    qDebug() << "Emulating a" << _parameters.bottleneckMbps << "Mb/s link with" << _parameters.roundTripMsecs
+        << "ms RTT," << _parameters.lossPercent << "% loss and a" << _parameters.queueMsecs << "ms queue on port"
+        << localPort();
+}
+
+void LinkEmulator::readPendingDatagrams() {
+    auto oneWayDelayUsecs = (qint64)(_parameters.roundTripMsecs * USECS_PER_MSEC / 2);
+    auto queueLimitUsecs = (qint64)(_parameters.queueMsecs * USECS_PER_MSEC);
+    double usecsPerByte = BITS_PER_BYTE / std::max(_parameters.bottleneckMbps, 0.001);
+
+    while (_socket.hasPendingDatagrams()) {
+        QByteArray datagram(_socket.pendingDatagramSize(), 0);
+        HifiSockAddr sender;
+        _socket.readDatagram(datagram.data(), datagram.size(), sender.getAddressPointer(), sender.getPortPointer());
+
+        if (_source.isNull() && sender != _destination) {
+            _source = sender;
+        }
+
+        if (_lossDistribution(_generator) < _parameters.lossPercent) {
+            ++_randomLossCount;
+            continue;
+        }
+
+        auto now = nowUsecs();
+
+        if (sender == _destination) {
+            // replies only see the propagation delay
+            _toSource.push_back({ datagram, _source, now + oneWayDelayUsecs });
+        } else {
+            // datagrams to the destination wait their turn at the bottleneck, or are dropped if the queue is full
+            auto departureUsecs = std::max(now, _bottleneckFreeUsecs) + (qint64)(datagram.size() * usecsPerByte);
+            if (departureUsecs - now > queueLimitUsecs) {
+                ++_queueDropCount;
+                continue;
+            }
+
+            _bottleneckFreeUsecs = departureUsecs;
+            _toDestination.push_back({ datagram, _destination, departureUsecs + oneWayDelayUsecs });
+        }
+    }
+
+    scheduleRelease();
+}
+
+void LinkEmulator::releaseDueDatagrams() {
+    auto now = nowUsecs();
+
+    for (auto queue : { &_toDestination, &_toSource }) {
+        while (!queue->empty() && queue->front().dueUsecs <= now) {
+            const auto& pending = queue->front();
+            _socket.writeDatagram(pending.data, pending.destination.getAddress(), pending.destination.getPort());
+            queue->pop_front();
+        }
+    }
+
+    scheduleRelease();
+}
+
+void LinkEmulator::scheduleRelease() {
+    qint64 nextDueUsecs = std::numeric_limits<qint64>::max();
+    if (!_toDestination.empty()) {
+        nextDueUsecs = _toDestination.front().dueUsecs;
+    }
+    if (!_toSource.empty()) {
+        nextDueUsecs = std::min(nextDueUsecs, _toSource.front().dueUsecs);
+    }
+
+    if (nextDueUsecs == std::numeric_limits<qint64>::max()) {
+        return;
+    }
+
+    auto waitMsecs = std::max((qint64)0, (nextDueUsecs - nowUsecs()) / (qint64)USECS_PER_MSEC);
+    _releaseTimer.start((int)waitMsecs);
+}
@@ -0,0 +1,81 @@
+//
+//  LinkEmulator.h
+//  tools/udt-test/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LinkEmulator_h
+#define hifi_LinkEmulator_h
+
+#include <deque>
+#include <random>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtNetwork/QUdpSocket>
+
+#include <HifiSockAddr.h>
+
+// A local UDP relay that emulates a lossy, high latency link with a bandwidth bottleneck.
+// Datagrams from the first address to send to it are forwarded to the destination through the bottleneck and
+// replies from the destination are sent back, both after the one way delay. Either direction can lose datagrams.
+class LinkEmulator : public QObject {
+    Q_OBJECT
+public:
+    struct Parameters {
+        double lossPercent { 0.0 }; // random loss applied in both directions
+        int roundTripMsecs { 0 }; // propagation delay, split evenly between both directions
+        double bottleneckMbps { 100.0 }; // rate datagrams to the destination are drained at
+        int queueMsecs { 50 }; // bottleneck queue size - datagrams that would wait longer are dropped
+    };
+
+    LinkEmulator(const HifiSockAddr& destination, const Parameters& parameters, QObject* parent = nullptr);
+
+    quint16 localPort() const { return _socket.localPort(); }
+
+    quint64 getRandomLossCount() const { return _randomLossCount; }
+    quint64 getQueueDropCount() const { return _queueDropCount; }
+
+private slots:
+    void readPendingDatagrams();
+    void releaseDueDatagrams();
+
+private:
+    struct PendingDatagram {
+        QByteArray data;
+        HifiSockAddr destination;
+        qint64 dueUsecs;
+    };
+    using PendingDatagrams = std::deque<PendingDatagram>;
+
+    qint64 nowUsecs() const { return _clock.nsecsElapsed() / 1000; }
+    void scheduleRelease();
+
+    QUdpSocket _socket;
+    HifiSockAddr _destination;
+    HifiSockAddr _source;
+    Parameters _parameters;
+
+    QElapsedTimer _clock;
+    QTimer _releaseTimer;
+
+    // each direction releases in the order it received, so both queues stay sorted by due time
+    PendingDatagrams _toDestination;
+    PendingDatagrams _toSource;
+    qint64 _bottleneckFreeUsecs { 0 }; // when the bottleneck is done with the last queued datagram
+
+    std::mt19937 _generator { 742272 };
+    std::uniform_real_distribution<double> _lossDistribution { 0.0, 100.0 };
+
+    quint64 _randomLossCount { 0 };
+    quint64 _queueDropCount { 0 };
+};
+
+#endif // hifi_LinkEmulator_h
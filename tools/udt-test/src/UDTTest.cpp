@@ -11,6 +11,8 @@
 
 #include "UDTTest.h"
 
+#include <ctime>
+
 #include <QtCore/QDebug>
 
 #include <udt/Constants.h>
@@ -18,6 +20,7 @@
 #include <udt/PacketList.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +58,33 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption BATCHED_IO {
+    "batched-io", "read and write datagrams in batches (Linux only)"
+};
+const QCommandLineOption LOOPBACK_BENCHMARK {
+    "loopback", "send full size unreliable packets to a second local socket as fast as possible"
+        " and report throughput once a second", "seconds"
+};
+
+const QCommandLineOption CONGESTION_CONTROL {
+    "congestion-control", "congestion control for the connection: default, vegas or bbr (default is vegas)", "name"
+};
+const QCommandLineOption EMULATED_LINK {
+    "emulate-link", "send reliable packets to a second local socket through an emulated link"
+        " and report goodput once a second", "seconds"
+};
+const QCommandLineOption LINK_LOSS {
+    "link-loss", "random loss on the emulated link in both directions (default is 0)", "percent"
+};
+const QCommandLineOption LINK_RTT {
+    "link-rtt", "round trip propagation delay of the emulated link (default is 0)", "milliseconds"
+};
+const QCommandLineOption LINK_BANDWIDTH {
+    "link-bandwidth", "bottleneck bandwidth of the emulated link (default is 100)", "Mb/s"
+};
+const QCommandLineOption LINK_QUEUE {
+    "link-queue", "bottleneck queue size of the emulated link (default is 50)", "milliseconds"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -78,8 +108,32 @@ UDTTest::UDTTest(int& argc, char** argv) :
     // randomize the seed for packet size randomization
     srand(time(NULL));
 
+    if (_argumentParser.isSet(BATCHED_IO) && !_socket.setBatchedIOEnabled(true)) {
+        qWarning() << "Batched datagram I/O is not supported on this platform - it will be ignored";
+    }
+
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        auto factory = udt::congestionControlFactoryForName(_argumentParser.value(CONGESTION_CONTROL));
+        if (factory) {
+            _socket.setCongestionControlFactory(std::move(factory));
+        } else {
+            qCritical() << "Unknown congestion control" << _argumentParser.value(CONGESTION_CONTROL);
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        }
+    }
+
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
+
+    if (_argumentParser.isSet(LOOPBACK_BENCHMARK)) {
+        startLoopbackBenchmark(_argumentParser.value(LOOPBACK_BENCHMARK).toInt());
+        return;
+    }
+
+    if (_argumentParser.isSet(EMULATED_LINK)) {
+        startEmulatedLinkTransfer(_argumentParser.value(EMULATED_LINK).toInt());
+        return;
+    }
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
@@ -228,7 +282,8 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, BATCHED_IO, LOOPBACK_BENCHMARK,
+        CONGESTION_CONTROL, EMULATED_LINK, LINK_LOSS, LINK_RTT, LINK_BANDWIDTH, LINK_QUEUE
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -243,6 +298,144 @@ void UDTTest::parseArguments() {
     }
 }
 
+void UDTTest::startLoopbackBenchmark(int seconds) {
+    _loopbackSocket.reset(new udt::Socket());
+    _loopbackSocket->setBatchedIOEnabled(_socket.isBatchedIOEnabled());
+    _loopbackSocket->bind(QHostAddress::LocalHost);
+    _loopbackSocket->setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        ++_loopbackReceivedPackets;
+    });
+
+    _target = HifiSockAddr(QHostAddress::LocalHost, _loopbackSocket->localPort());
+    _loopbackSecondsLeft = std::max(seconds, 1);
+
+    qDebug() << "Running a" << _loopbackSecondsLeft << "second loopback benchmark to port" << _target.getPort()
+        << (_socket.isBatchedIOEnabled() ? "with" : "without") << "batched datagram I/O";
+    qDebug() << "Sent (P/s) | Received (P/s) | Lost (%) | CPU (us/P)";
+
+    // a zero interval timer sends a burst every time the event loop comes around, between reads of the loopback socket
+    connect(&_loopbackSendTimer, &QTimer::timeout, this, &UDTTest::sendLoopbackBurst);
+    _loopbackSendTimer.start(0);
+
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &UDTTest::sampleLoopbackStats);
+    statsTimer->start((int)MSECS_PER_SECOND);
+
+    _loopbackLastCPUTime = std::clock();
+}
+
+void UDTTest::sendLoopbackBurst() {
+    static const int LOOPBACK_BURST_PACKETS = 32;
+    static const QByteArray payload(udt::Packet::maxPayloadSize(false), 0);
+
+    auto packetList = udt::PacketList::create(PacketType::BulkAvatarData);
+    for (int i = 0; i < LOOPBACK_BURST_PACKETS; ++i) {
+        packetList->write(payload);
+    }
+    packetList->closeCurrentPacket();
+
+    _loopbackSentPackets += packetList->getNumPackets();
+    _socket.writePacketList(std::move(packetList), _target);
+}
+
+void UDTTest::sampleLoopbackStats() {
+    auto cpuTime = std::clock();
+    double cpuUsecs = (double)(cpuTime - _loopbackLastCPUTime) * USECS_PER_SECOND / CLOCKS_PER_SEC;
+    _loopbackLastCPUTime = cpuTime;
+
+    // CPU time covers both sending and receiving, per packet that made it across
+    double lostPercent = _loopbackSentPackets > 0 ?
+        100.0 * (double)(_loopbackSentPackets - std::min(_loopbackSentPackets, _loopbackReceivedPackets)) / _loopbackSentPackets : 0.0;
+    double usecsPerPacket = _loopbackReceivedPackets > 0 ? cpuUsecs / _loopbackReceivedPackets : 0.0;
+
+    qDebug() << qPrintable(QString("%1 | %2 | %3 | %4")
+        .arg(_loopbackSentPackets, 10)
+        .arg(_loopbackReceivedPackets, 14)
+        .arg(lostPercent, 8, 'f', 2)
+        .arg(usecsPerPacket, 10, 'f', 3));
+
+    _loopbackTotalSentPackets += _loopbackSentPackets;
+    _loopbackTotalReceivedPackets += _loopbackReceivedPackets;
+    _loopbackSentPackets = 0;
+    _loopbackReceivedPackets = 0;
+
+    if (--_loopbackSecondsLeft <= 0) {
+        _loopbackSendTimer.stop();
+        qDebug() << "Sent" << _loopbackTotalSentPackets << "packets and received" << _loopbackTotalReceivedPackets;
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+}
+
+void UDTTest::startEmulatedLinkTransfer(int seconds) {
+    // the receiving side uses the same congestion control, since it decides how the sender is ACKed and NAKed
+    _loopbackSocket.reset(new udt::Socket());
+    if (_argumentParser.isSet(CONGESTION_CONTROL)) {
+        _loopbackSocket->setCongestionControlFactory(
+            udt::congestionControlFactoryForName(_argumentParser.value(CONGESTION_CONTROL)));
+    }
+    _loopbackSocket->bind(QHostAddress::LocalHost);
+    _loopbackSocket->setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        _emulatedReceivedBytes += packet->getPayloadSize();
+    });
+
+    LinkEmulator::Parameters parameters;
+    if (_argumentParser.isSet(LINK_LOSS)) {
+        parameters.lossPercent = _argumentParser.value(LINK_LOSS).toDouble();
+    }
+    if (_argumentParser.isSet(LINK_RTT)) {
+        parameters.roundTripMsecs = _argumentParser.value(LINK_RTT).toInt();
+    }
+    if (_argumentParser.isSet(LINK_BANDWIDTH)) {
+        parameters.bottleneckMbps = _argumentParser.value(LINK_BANDWIDTH).toDouble();
+    }
+    if (_argumentParser.isSet(LINK_QUEUE)) {
+        parameters.queueMsecs = _argumentParser.value(LINK_QUEUE).toInt();
+    }
+
+    _linkEmulator.reset(new LinkEmulator(HifiSockAddr(QHostAddress::LocalHost, _loopbackSocket->localPort()),
+                                         parameters));
+
+    _target = HifiSockAddr(QHostAddress::LocalHost, _linkEmulator->localPort());
+    _loopbackSecondsLeft = std::max(seconds, 1);
+
+    qDebug() << "Running a" << _loopbackSecondsLeft << "second transfer over the emulated link with"
+        << (_argumentParser.isSet(CONGESTION_CONTROL) ? _argumentParser.value(CONGESTION_CONTROL) : QString("the default"))
+        << "congestion control";
+    qDebug() << "Time (s) | Goodput (Mb/s) | RTT (ms) | CW (P) | Period (us) | Re-sent (P) | Lost (P) | Dropped (P)";
+
+    sendInitialPackets();
+
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &UDTTest::sampleEmulatedLinkStats);
+    statsTimer->start((int)MSECS_PER_SECOND);
+}
+
+void UDTTest::sampleEmulatedLinkStats() {
+    static const double MEGABITS_PER_BYTE = 8.0 / 1000000.0;
+    static const double USECS_PER_MSEC = 1000.0;
+
+    auto stats = _socket.sampleStatsForConnection(_target);
+
+    qDebug() << qPrintable(QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8")
+        .arg(++_emulatedSecondsElapsed, 8)
+        .arg(_emulatedReceivedBytes * MEGABITS_PER_BYTE, 14, 'f', 2)
+        .arg(stats.rtt / USECS_PER_MSEC, 8, 'f', 2)
+        .arg(stats.congestionWindowSize, 6)
+        .arg(stats.packetSendPeriod, 11)
+        .arg(stats.events[udt::ConnectionStats::Stats::Retransmission], 11)
+        .arg(_linkEmulator->getRandomLossCount(), 8)
+        .arg(_linkEmulator->getQueueDropCount(), 11));
+
+    _emulatedTotalReceivedBytes += _emulatedReceivedBytes;
+    _emulatedReceivedBytes = 0;
+
+    if (--_loopbackSecondsLeft <= 0) {
+        qDebug() << "Average goodput was"
+            << _emulatedTotalReceivedBytes * MEGABITS_PER_BYTE / _emulatedSecondsElapsed << "Mb/s";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
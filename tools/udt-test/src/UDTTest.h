@@ -15,16 +15,20 @@
 #define hifi_UDTTest_h
 
 
+#include <memory>
 #include <random>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QTimer>
 
 #include <udt/Constants.h>
 #include <udt/Socket.h>
 
 #include <ReceivedMessage.h>
 
+#include "LinkEmulator.h"
+
 struct Message {
     udt::MessageNumber messageNumber;
     QByteArray data;
@@ -38,6 +42,9 @@ public:
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+    void sendLoopbackBurst();
+    void sampleLoopbackStats();
+    void sampleEmulatedLinkStats();
     
 private:
     void parseArguments();
@@ -45,6 +52,12 @@ private:
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
+
+    void startLoopbackBenchmark(int seconds); // sends unreliable packets as fast as possible to a second local socket
+
+    // sends reliable packets to a second local socket through a LinkEmulator, to compare congestion control on a
+    // lossy, high latency link
+    void startEmulatedLinkTransfer(int seconds);
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +84,22 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    // loopback benchmark
+    std::unique_ptr<udt::Socket> _loopbackSocket; // receives what _socket sends
+    QTimer _loopbackSendTimer;
+    int _loopbackSecondsLeft { 0 };
+    quint64 _loopbackSentPackets { 0 };
+    quint64 _loopbackReceivedPackets { 0 };
+    quint64 _loopbackTotalSentPackets { 0 };
+    quint64 _loopbackTotalReceivedPackets { 0 };
+    std::clock_t _loopbackLastCPUTime { 0 };
+
+    // emulated link transfer
+    std::unique_ptr<LinkEmulator> _linkEmulator;
+    quint64 _emulatedReceivedBytes { 0 };
+    quint64 _emulatedTotalReceivedBytes { 0 };
+    int _emulatedSecondsElapsed { 0 };
 };
 
 #endif // hifi_UDTTest_h